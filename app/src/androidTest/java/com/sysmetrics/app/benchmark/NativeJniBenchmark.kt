@@ -0,0 +1,95 @@
+package com.sysmetrics.app.benchmark
+
+import android.util.Log
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.sysmetrics.app.native_bridge.NativeJni
+import com.sysmetrics.app.native_bridge.NativeMetrics
+import com.sysmetrics.app.native_bridge.NativeProfiler
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Assume
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Benchmarks for JNI registration and per-call overhead.
+ *
+ * The echo benchmarks call the same native function under each calling
+ * convention, so their difference is the JNI transition cost alone.
+ * Expected: regular > @FastNative > @CriticalNative (API 26+).
+ */
+@RunWith(AndroidJUnit4::class)
+class NativeJniBenchmark {
+
+    @get:Rule
+    val benchmarkRule = BenchmarkRule()
+
+    @Before
+    fun setup() {
+        Assume.assumeTrue(
+            "Native library not available",
+            NativeMetrics.isNativeAvailable()
+        )
+    }
+
+    /**
+     * Startup cost of JNI_OnLoad (class caching, registration, verification).
+     * Target: < 5ms
+     */
+    @Test
+    fun registrationTime() {
+        val ns = NativeJni.registrationTimeNs()
+        Log.i(TAG, "Registered ${NativeJni.registeredMethodCount()} methods in ${ns / 1000} us")
+        assertTrue(NativeJni.registeredMethodCount() > 0)
+        assertTrue("Registration took ${ns / 1000} us", ns < 5_000_000L)
+    }
+
+    @Test
+    fun echoConventionsAgree() {
+        assertEquals(42, NativeJni.echo(42))
+        assertEquals(42, NativeJni.fastEcho(42))
+        assertEquals(42, NativeJni.criticalEcho(42))
+    }
+
+    @Test
+    fun benchmarkRegularCall() {
+        var value = 0
+        benchmarkRule.measureRepeated {
+            value = NativeJni.echo(value)
+        }
+    }
+
+    @Test
+    fun benchmarkFastNativeCall() {
+        var value = 0
+        benchmarkRule.measureRepeated {
+            value = NativeJni.fastEcho(value)
+        }
+    }
+
+    @Test
+    fun benchmarkCriticalNativeCall() {
+        var value = 0
+        benchmarkRule.measureRepeated {
+            value = NativeJni.criticalEcho(value)
+        }
+    }
+
+    /**
+     * A trivial getter on the @CriticalNative path.
+     */
+    @Test
+    fun benchmarkProfilerIsEnabled() {
+        benchmarkRule.measureRepeated {
+            NativeProfiler.isEnabled()
+        }
+    }
+
+    companion object {
+        private const val TAG = "NativeJniBenchmark"
+    }
+}
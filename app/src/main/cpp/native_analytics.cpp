@@ -1,34 +1,137 @@
 #include "native_analytics.h"
-#include <android/log.h>
+#include "native_arena.h"
+#include "native_format.h"
+#include "native_instrument.h"
+#include "native_rules.h"
+#include "native_seqlock.h"
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
 #include <algorithm>
-#include <vector>
 #include <unordered_map>
 #include <mutex>
-#include <malloc.h>  // For memalign on Android
+#include <new>
+#include <shared_mutex>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
 
 #define LOG_TAG "NATIVE_ANALYTICS"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "native_platform.h"
 
 // ============================================================================
 // Internal Storage for Handles
 // ============================================================================
 
-static std::mutex g_mutex;
-static int64_t g_next_handle = 1;
-static std::unordered_map<int64_t, TimeWindowCalculator*> g_twc_map;
-static std::unordered_map<int64_t, ChartBuffer*> g_chart_map;
+// g_mutex guards the maps only: create/destroy take it exclusively, every
+// other call takes it shared. Writers serialise on the object's own
+// update_mutex, recompute, and publish into a seqlock slot; readers copy the
+// last published result and never wait for a recompute.
+
+/**
+ * Normalised chart series as published to readers.
+ */
+struct ChartSeries {
+    int32_t count;
+    float min_value;
+    float max_value;
+    float values[MAX_BUFFER_SIZE];
+};
+
+// Spans of the running windows; index 1 (1 minute) also feeds the percentiles
+static const int64_t TWC_WINDOW_MS[3] = { WINDOW_30S, WINDOW_1M, WINDOW_5M };
+static const int TWC_PERCENTILE_WINDOW = 1;
+
+/**
+ * Running sum of one window. While buffered timestamps are in order the
+ * window is a suffix of the buffer, starting at sequence number first.
+ */
+struct TwcWindow {
+    int64_t first;
+    double sum;
+};
+
+/**
+ * Stats kept up to date point by point, so publishing after an add does not
+ * rescan the buffer. Sequence numbers count pushed points; the oldest
+ * buffered point is next_seq - buffer.count.
+ */
+struct TwcRunning {
+    bool valid;              // False until rebuilt (create, clear, out-of-order point)
+    bool minmax_dirty;       // A point holding the min or max left the buffer
+    int64_t next_seq;
+    int64_t oldest_seq;      // Oldest point accounted for in min/max
+    int64_t inversion_seq;   // Newest point older than the point before it
+    TwcWindow windows[3];
+    float min_value;
+    float max_value;
+    int32_t sorted_count;
+    float sorted_1m[MAX_BUFFER_SIZE];  // 1-minute window, ascending
+};
+
+struct TwcState {
+    TimeWindowCalculator twc;
+    std::mutex update_mutex;
+    AnomalyDetector anomaly;
+    AnomalyResult last_anomaly;  // Scores of the newest point
+    TwcRunning running;
+    SeqlockSlot<StatsResult> published;
+};
+
+struct ChartState {
+    ChartBuffer chart;
+    std::mutex update_mutex;
+    ChartSeries staging;  // chart.normalized_values points into it
+    SeqlockSlot<ChartSeries> published;
+};
 
 struct PeakTracker {
     CircularBuffer buffer;
     int64_t window_ms;
     PeakData current_peak;
+    std::mutex update_mutex;
+    SeqlockSlot<PeakData> published;
 };
+
+static std::shared_mutex g_mutex;
+static int64_t g_next_handle = 1;
+static std::unordered_map<int64_t, TwcState*> g_twc_map;
+static std::unordered_map<int64_t, ChartState*> g_chart_map;
 static std::unordered_map<int64_t, PeakTracker*> g_peak_map;
 
+static_assert(MAX_BUFFER_SIZE * sizeof(DataPoint) <= NATIVE_SLAB_MAX_SIZE,
+              "a full sample buffer must fit the largest slab class");
+static_assert(MAX_BUFFER_SIZE <= NATIVE_SCRATCH_FLOATS,
+              "a full window of values must fit the per-thread scratch");
+
+// Handle objects live in slab blocks, so create/destroy cycles reuse memory
+template<typename T>
+static T* slab_new() {
+    static_assert(sizeof(T) <= NATIVE_SLAB_MAX_SIZE, "handle object exceeds the largest slab class");
+    static_assert(alignof(T) <= NATIVE_SLAB_ALIGN, "handle object needs more than slab alignment");
+    void* block = native_slab_alloc(sizeof(T));
+    return block ? new (block) T() : nullptr;
+}
+
+template<typename T>
+static void slab_delete(T* object) {
+    object->~T();
+    native_slab_free(object, sizeof(T));
+}
+
+/**
+ * Copy the last published value. If every attempt overlapped a publish (the
+ * writer was descheduled mid-copy), wait for that writer once instead of
+ * spinning; under its lock the slot is stable.
+ */
+template<typename T>
+static void read_published(const SeqlockSlot<T>& slot, std::mutex& update_mutex, T* out) {
+    if (slot.read(out)) return;
+    std::lock_guard<std::mutex> lock(update_mutex);
+    slot.read(out);
+}
+
 // ============================================================================
 // Circular Buffer Implementation
 // ============================================================================
@@ -38,8 +141,7 @@ int native_buffer_init(CircularBuffer* buffer, int32_t capacity) {
         return -1;
     }
     
-    buffer->data = (DataPoint*)memalign(CACHE_LINE_SIZE, 
-                                         capacity * sizeof(DataPoint));
+    buffer->data = (DataPoint*)native_slab_alloc(capacity * sizeof(DataPoint));
     if (!buffer->data) {
         LOGE("Failed to allocate buffer memory");
         return -1;
@@ -56,7 +158,7 @@ int native_buffer_init(CircularBuffer* buffer, int32_t capacity) {
 
 void native_buffer_free(CircularBuffer* buffer) {
     if (buffer && buffer->data) {
-        free(buffer->data);
+        native_slab_free(buffer->data, buffer->capacity * sizeof(DataPoint));
         buffer->data = nullptr;
         buffer->capacity = 0;
         buffer->count = 0;
@@ -194,12 +296,12 @@ float native_calc_max(const CircularBuffer* buffer, int64_t window_ms, int64_t n
 }
 
 // QuickSelect algorithm for O(n) average percentile calculation
-static float quickselect(std::vector<float>& arr, int k) {
-    if (arr.empty()) return 0.0f;
+static float quickselect(float* arr, int size, int k) {
+    if (size <= 0) return 0.0f;
     if (k < 0) k = 0;
-    if (k >= (int)arr.size()) k = arr.size() - 1;
+    if (k >= size) k = size - 1;
     
-    int left = 0, right = arr.size() - 1;
+    int left = 0, right = size - 1;
     
     while (left < right) {
         float pivot = arr[(left + right) / 2];
@@ -226,20 +328,22 @@ float native_calc_percentile(const CircularBuffer* buffer, int32_t percentile,
                               int64_t window_ms, int64_t now) {
     if (!buffer || buffer->count == 0) return 0.0f;
     
-    std::vector<float> values;
-    values.reserve(buffer->count);
+    float* values = native_scratch_floats(buffer->count);
+    if (!values) return 0.0f;
+    int size = 0;
     
     iterate_window(buffer, window_ms, now, [&](float value) {
-        values.push_back(value);
+        values[size++] = value;
     });
     
-    if (values.empty()) return 0.0f;
+    if (size == 0) return 0.0f;
     
-    int index = static_cast<int>(std::ceil(values.size() * percentile / 100.0)) - 1;
-    return quickselect(values, std::max(0, index));
+    int index = static_cast<int>(std::ceil(size * percentile / 100.0)) - 1;
+    return quickselect(values, size, std::max(0, index));
 }
 
 void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, int64_t now) {
+    NativeTraceScope trace("native_calc_all_stats", TRACE_CAT_ANALYTICS);
     if (!result) return;
     
     memset(result, 0, sizeof(StatsResult));
@@ -247,10 +351,10 @@ void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, in
     
     if (!buffer || buffer->count == 0) return;
     
-    // Collect values for different windows in single pass
-    std::vector<float> all_values;
-    std::vector<float> values_30s, values_1m, values_5m;
-    all_values.reserve(buffer->count);
+    // Single pass; only the 1-minute window is kept for percentiles
+    float* values_1m = native_scratch_floats(buffer->count);
+    if (!values_1m) return;
+    int count_values_1m = 0;
     
     int64_t cutoff_30s = now - WINDOW_30S;
     int64_t cutoff_1m = now - WINDOW_1M;
@@ -267,7 +371,6 @@ void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, in
         float value = point.value;
         int64_t ts = point.timestamp;
         
-        all_values.push_back(value);
         current = value; // Last value is current
         
         if (value < min_val) min_val = value;
@@ -276,17 +379,15 @@ void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, in
         if (ts >= cutoff_5m) {
             sum_5m += value;
             count_5m++;
-            values_5m.push_back(value);
             
             if (ts >= cutoff_1m) {
                 sum_1m += value;
                 count_1m++;
-                values_1m.push_back(value);
+                values_1m[count_values_1m++] = value;
                 
                 if (ts >= cutoff_30s) {
                     sum_30s += value;
                     count_30s++;
-                    values_30s.push_back(value);
                 }
             }
         }
@@ -301,20 +402,21 @@ void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, in
     result->count = buffer->count;
     
     // Calculate percentiles from 1-minute window
-    if (!values_1m.empty()) {
-        int p50_idx = std::max(0, static_cast<int>(values_1m.size() * 0.50) - 1);
-        int p95_idx = std::max(0, static_cast<int>(values_1m.size() * 0.95) - 1);
-        int p99_idx = std::max(0, static_cast<int>(values_1m.size() * 0.99) - 1);
+    if (count_values_1m > 0) {
+        int p50_idx = std::max(0, static_cast<int>(count_values_1m * 0.50) - 1);
+        int p95_idx = std::max(0, static_cast<int>(count_values_1m * 0.95) - 1);
+        int p99_idx = std::max(0, static_cast<int>(count_values_1m * 0.99) - 1);
         
-        std::vector<float> sorted = values_1m;
-        std::nth_element(sorted.begin(), sorted.begin() + p50_idx, sorted.end());
-        result->p50 = sorted[p50_idx];
+        // Selected in place: the scratch copy is ours until we return
+        float* end = values_1m + count_values_1m;
+        std::nth_element(values_1m, values_1m + p50_idx, end);
+        result->p50 = values_1m[p50_idx];
         
-        std::nth_element(sorted.begin(), sorted.begin() + p95_idx, sorted.end());
-        result->p95 = sorted[p95_idx];
+        std::nth_element(values_1m, values_1m + p95_idx, end);
+        result->p95 = values_1m[p95_idx];
         
-        std::nth_element(sorted.begin(), sorted.begin() + p99_idx, sorted.end());
-        result->p99 = sorted[p99_idx];
+        std::nth_element(values_1m, values_1m + p99_idx, end);
+        result->p99 = values_1m[p99_idx];
     }
 }
 
@@ -322,17 +424,193 @@ void native_calc_all_stats(const CircularBuffer* buffer, StatsResult* result, in
 // Time Window Calculator Implementation
 // ============================================================================
 
+// Buffered point by sequence number. Points trimmed since the last push
+// (seq below the oldest) stay readable until the next push reuses a slot.
+static const DataPoint& twc_point(const TwcState* state, int64_t seq) {
+    const CircularBuffer& buffer = state->twc.buffer;
+    int64_t offset = seq - (state->running.next_seq - buffer.count);
+    int64_t index = (buffer.head + offset) % buffer.capacity;
+    return buffer.data[index < 0 ? index + buffer.capacity : index];
+}
+
+static void sorted_insert(TwcRunning* run, float value) {
+    float* end = run->sorted_1m + run->sorted_count;
+    float* pos = std::upper_bound(run->sorted_1m, end, value);
+    memmove(pos + 1, pos, (end - pos) * sizeof(float));
+    *pos = value;
+    run->sorted_count++;
+}
+
+// False if value is not in the sorted window (NaN input); the caller rebuilds
+static bool sorted_erase(TwcRunning* run, float value) {
+    float* end = run->sorted_1m + run->sorted_count;
+    float* pos = std::lower_bound(run->sorted_1m, end, value);
+    if (pos == end || *pos != value) return false;
+    memmove(pos, pos + 1, (end - pos - 1) * sizeof(float));
+    run->sorted_count--;
+    return true;
+}
+
+static void twc_rescan_minmax(TwcState* state) {
+    TwcRunning& run = state->running;
+    run.min_value = INFINITY;
+    run.max_value = -INFINITY;
+    for (int64_t seq = run.oldest_seq; seq < run.next_seq; seq++) {
+        float value = twc_point(state, seq).value;
+        if (value < run.min_value) run.min_value = value;
+        if (value > run.max_value) run.max_value = value;
+    }
+    run.minmax_dirty = false;
+}
+
+// Rescan the whole buffer into the running stats, summing in the same order
+// as native_calc_all_stats(). Requires in-order timestamps.
+static void twc_rebuild(TwcState* state) {
+    NativeTraceScope trace("twc_rebuild", TRACE_CAT_ANALYTICS);
+    const CircularBuffer& buffer = state->twc.buffer;
+    TwcRunning& run = state->running;
+    int64_t now = buffer.newest_timestamp;
+
+    run.oldest_seq = run.next_seq - buffer.count;
+    for (TwcWindow& window : run.windows) {
+        window.first = run.next_seq;
+        window.sum = 0;
+    }
+    run.sorted_count = 0;
+
+    for (int64_t seq = run.oldest_seq; seq < run.next_seq; seq++) {
+        const DataPoint& point = twc_point(state, seq);
+        for (int w = 0; w < 3; w++) {
+            if (point.timestamp < now - TWC_WINDOW_MS[w]) continue;
+            if (run.windows[w].first == run.next_seq) run.windows[w].first = seq;
+            run.windows[w].sum += point.value;
+        }
+        if (point.timestamp >= now - TWC_WINDOW_MS[TWC_PERCENTILE_WINDOW]) {
+            run.sorted_1m[run.sorted_count++] = point.value;
+        }
+    }
+    std::sort(run.sorted_1m, run.sorted_1m + run.sorted_count);
+    twc_rescan_minmax(state);
+    run.valid = true;
+}
+
+// Retire points that leave the buffer (trimmed, or overwritten by the push
+// about to happen) or age out of a window once the point at now is added.
+// Runs between native_buffer_trim() and native_buffer_push().
+static void twc_retire(TwcState* state, int64_t now) {
+    const CircularBuffer& buffer = state->twc.buffer;
+    TwcRunning& run = state->running;
+    int64_t oldest = run.next_seq - buffer.count + (buffer.count == buffer.capacity ? 1 : 0);
+
+    for (int64_t seq = run.oldest_seq; seq < oldest; seq++) {
+        float value = twc_point(state, seq).value;
+        if (value <= run.min_value || value >= run.max_value) run.minmax_dirty = true;
+    }
+    run.oldest_seq = oldest;
+
+    for (int w = 0; w < 3; w++) {
+        TwcWindow& window = run.windows[w];
+        int64_t cutoff = now - TWC_WINDOW_MS[w];
+        while (window.first < run.next_seq) {
+            const DataPoint& point = twc_point(state, window.first);
+            if (window.first >= oldest && point.timestamp >= cutoff) break;
+            window.sum -= point.value;
+            if (w == TWC_PERCENTILE_WINDOW && !sorted_erase(&run, point.value)) run.valid = false;
+            window.first++;
+        }
+    }
+}
+
+// Trim, push and fold the point into the running stats.
+// Caller holds state->update_mutex
+static void twc_push(TwcState* state, float value, int64_t timestamp) {
+    TimeWindowCalculator* twc = &state->twc;
+    TwcRunning& run = state->running;
+
+    native_buffer_trim(&twc->buffer, timestamp - twc->max_duration_ms);
+    if (twc->buffer.count > 0 && timestamp < twc->buffer.newest_timestamp) {
+        run.inversion_seq = run.next_seq;
+        run.valid = false;
+    }
+    if (run.valid) twc_retire(state, timestamp);
+
+    native_buffer_push(&twc->buffer, value, timestamp);
+    run.next_seq++;
+    if (!run.valid) return;
+
+    for (TwcWindow& window : run.windows) window.sum += value;
+    sorted_insert(&run, value);
+    if (value < run.min_value) run.min_value = value;
+    if (value > run.max_value) run.max_value = value;
+}
+
+static void twc_fill(const TwcState* state, StatsResult* result) {
+    const CircularBuffer& buffer = state->twc.buffer;
+    const TwcRunning& run = state->running;
+
+    memset(result, 0, sizeof(StatsResult));
+    result->timestamp = buffer.newest_timestamp;
+    if (buffer.count == 0) return;
+
+    float* averages[3] = { &result->avg_30s, &result->avg_1m, &result->avg_5m };
+    for (int w = 0; w < 3; w++) {
+        int64_t count = run.next_seq - run.windows[w].first;
+        *averages[w] = count > 0 ? static_cast<float>(run.windows[w].sum / count) : 0;
+    }
+    result->current = twc_point(state, run.next_seq - 1).value;
+    result->min = run.min_value;
+    result->max = run.max_value;
+    result->count = buffer.count;
+
+    // Same indices as native_calc_all_stats(), read off the sorted window
+    int32_t n = run.sorted_count;
+    if (n > 0) {
+        result->p50 = run.sorted_1m[std::max(0, static_cast<int>(n * 0.50) - 1)];
+        result->p95 = run.sorted_1m[std::max(0, static_cast<int>(n * 0.95) - 1)];
+        result->p99 = run.sorted_1m[std::max(0, static_cast<int>(n * 0.99) - 1)];
+    }
+}
+
+// Caller holds state->update_mutex
+static void twc_publish(TwcState* state) {
+    TimeWindowCalculator* twc = &state->twc;
+    TwcRunning& run = state->running;
+    StatsResult result;
+    if (run.inversion_seq > run.next_seq - twc->buffer.count) {
+        // Out-of-order points are still buffered, so windows are not
+        // suffixes; fall back to a full pass until they age out
+        native_calc_all_stats(&twc->buffer, &result, twc->buffer.newest_timestamp);
+    } else {
+        if (!run.valid) {
+            twc_rebuild(state);
+        } else if (run.minmax_dirty) {
+            twc_rescan_minmax(state);
+        }
+        twc_fill(state, &result);
+    }
+    result.ewma_score = state->last_anomaly.ewma_score;
+    result.robust_score = state->last_anomaly.robust_score;
+    result.cusum_score = state->last_anomaly.cusum_score;
+    result.anomaly_flags = state->last_anomaly.flags;
+    state->published.publish(result);
+
+    twc->cache_valid = true;
+    twc->last_cache_update = result.timestamp;
+}
+
 int64_t native_twc_create(int64_t max_duration_ms) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_twc_create", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
-    TimeWindowCalculator* twc = new (std::nothrow) TimeWindowCalculator();
-    if (!twc) return 0;
+    TwcState* state = slab_new<TwcState>();
+    if (!state) return 0;
+    TimeWindowCalculator* twc = &state->twc;
     
     int capacity = static_cast<int>(max_duration_ms / 500) + 10; // ~2 samples/sec
     capacity = std::min(capacity, MAX_BUFFER_SIZE);
     
     if (native_buffer_init(&twc->buffer, capacity) != 0) {
-        delete twc;
+        slab_delete(state);
         return 0;
     }
     
@@ -340,124 +618,197 @@ int64_t native_twc_create(int64_t max_duration_ms) {
     twc->cache_valid = false;
     twc->last_cache_update = 0;
     
+    AnomalyParams params;
+    native_anomaly_default_params(&params);
+    native_anomaly_init(&state->anomaly, &params);
+    
     int64_t handle = g_next_handle++;
-    g_twc_map[handle] = twc;
+    g_twc_map[handle] = state;
     
     LOGD("Created TimeWindowCalculator handle=%lld capacity=%d", (long long)handle, capacity);
     return handle;
 }
 
 void native_twc_destroy(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_twc_destroy", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_twc_map.find(handle);
     if (it != g_twc_map.end()) {
-        native_buffer_free(&it->second->buffer);
-        delete it->second;
+        native_buffer_free(&it->second->twc.buffer);
+        slab_delete(it->second);
         g_twc_map.erase(it);
+        native_rules_detach(handle);
         LOGD("Destroyed TimeWindowCalculator handle=%lld", (long long)handle);
     }
 }
 
 void native_twc_add_point(int64_t handle, float value, int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeProbeScope probe(PROBE_TWC_ADD_POINT);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_twc_map.find(handle);
-    if (it == g_twc_map.end()) return;
-    
-    TimeWindowCalculator* twc = it->second;
+    if (it == g_twc_map.end()) { probe.fail(); return; }
     
-    // Trim old data
-    int64_t cutoff = timestamp - twc->max_duration_ms;
-    native_buffer_trim(&twc->buffer, cutoff);
+    TwcState* state = it->second;
+    std::lock_guard<std::mutex> update(state->update_mutex);
+    TimeWindowCalculator* twc = &state->twc;
     
-    // Add new point
-    native_buffer_push(&twc->buffer, value, timestamp);
+    twc_push(state, value, timestamp);
+    native_anomaly_update(&state->anomaly, value, &state->last_anomaly);
     
-    // Invalidate cache
-    twc->cache_valid = false;
+    twc_publish(state);
+    native_rules_evaluate(handle, &twc->buffer, value, timestamp);
 }
 
-void native_twc_get_stats(int64_t handle, StatsResult* result) {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    
-    if (!result) return;
+// Copy the last published stats; false (and zeros) if the handle is unknown
+static bool twc_read(int64_t handle, StatsResult* result) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     memset(result, 0, sizeof(StatsResult));
     
     auto it = g_twc_map.find(handle);
-    if (it == g_twc_map.end()) return;
+    if (it == g_twc_map.end()) return false;
+    
+    TwcState* state = it->second;
+    read_published(state->published, state->update_mutex, result);
+    return true;
+}
+
+void native_twc_get_stats(int64_t handle, StatsResult* result) {
+    NativeProbeScope probe(PROBE_TWC_GET_STATS);
+    if (!result) return;
+    if (!twc_read(handle, result)) probe.fail();
+}
+
+int32_t native_twc_get_stats_into(int64_t handle, void* out, int32_t out_size) {
+    NativeProbeScope probe(PROBE_TWC_GET_STATS);
+    if (!out || out_size < STATS_OUT_SIZE) return probe.check(-1);
     
-    TimeWindowCalculator* twc = it->second;
-    int64_t now = twc->buffer.newest_timestamp;
+    StatsResult result;
+    bool found = twc_read(handle, &result);
     
-    native_calc_all_stats(&twc->buffer, result, now);
+    float values[9] = {
+        result.current, result.avg_30s, result.avg_1m, result.avg_5m,
+        result.min, result.max, result.p50, result.p95, result.p99
+    };
+    int64_t timestamp = result.timestamp;
+    int64_t count = result.count;
+    float scores[3] = { result.ewma_score, result.robust_score, result.cusum_score };
+    int32_t flags = result.anomaly_flags;
+    
+    uint8_t* bytes = static_cast<uint8_t*>(out);
+    memset(bytes, 0, STATS_OUT_SIZE);
+    memcpy(bytes + STATS_OUT_VALUES, values, sizeof(values));
+    memcpy(bytes + STATS_OUT_TIMESTAMP, &timestamp, sizeof(timestamp));
+    memcpy(bytes + STATS_OUT_COUNT, &count, sizeof(count));
+    memcpy(bytes + STATS_OUT_SCORES, scores, sizeof(scores));
+    memcpy(bytes + STATS_OUT_FLAGS, &flags, sizeof(flags));
+    return probe.check(found ? STATS_OUT_SIZE : -1);
 }
 
 void native_twc_clear(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_twc_clear", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_twc_map.find(handle);
     if (it != g_twc_map.end()) {
-        native_buffer_clear(&it->second->buffer);
-        it->second->cache_valid = false;
+        TwcState* state = it->second;
+        std::lock_guard<std::mutex> update(state->update_mutex);
+        native_buffer_clear(&state->twc.buffer);
+        state->running.valid = false;
+        state->running.inversion_seq = 0;
+        state->running.next_seq = 0;
+        native_anomaly_reset(&state->anomaly);
+        state->last_anomaly = AnomalyResult{};
+        twc_publish(state);
+        native_rules_reset(handle);
     }
 }
 
+int native_twc_set_anomaly_params(int64_t handle, const AnomalyParams* params) {
+    NativeTraceScope trace("native_twc_set_anomaly_params", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    
+    auto it = g_twc_map.find(handle);
+    if (it == g_twc_map.end()) return -1;
+    
+    TwcState* state = it->second;
+    std::lock_guard<std::mutex> update(state->update_mutex);
+    if (native_anomaly_init(&state->anomaly, params) != 0) return -1;
+    state->last_anomaly = AnomalyResult{};
+    return 0;
+}
+
+int32_t native_twc_attach_rule(int64_t handle, const RuleSpec* spec) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (g_twc_map.find(handle) == g_twc_map.end()) return -1;
+    return native_rules_attach(handle, spec);
+}
+
 // ============================================================================
 // Chart Buffer Implementation
 // ============================================================================
 
+// Caller holds state->update_mutex
+static void chart_publish(ChartState* state) {
+    ChartBuffer* chart = &state->chart;
+    state->staging.count = chart->normalized_count;
+    state->staging.min_value = chart->min_value;
+    state->staging.max_value = chart->max_value;
+    state->published.publish(state->staging);
+}
+
 int64_t native_chart_create(int32_t capacity) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_chart_create", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
-    ChartBuffer* chart = new (std::nothrow) ChartBuffer();
-    if (!chart) return 0;
+    ChartState* state = slab_new<ChartState>();
+    if (!state) return 0;
+    ChartBuffer* chart = &state->chart;
     
     capacity = std::min(capacity, MAX_BUFFER_SIZE);
     
     if (native_buffer_init(&chart->buffer, capacity) != 0) {
-        delete chart;
-        return 0;
-    }
-    
-    chart->normalized_values = (float*)calloc(capacity, sizeof(float));
-    if (!chart->normalized_values) {
-        native_buffer_free(&chart->buffer);
-        delete chart;
+        slab_delete(state);
         return 0;
     }
     
+    chart->normalized_values = state->staging.values;
     chart->min_value = 0;
     chart->max_value = 100;
     chart->normalized_count = 0;
+    chart_publish(state);
     
     int64_t handle = g_next_handle++;
-    g_chart_map[handle] = chart;
+    g_chart_map[handle] = state;
     
     LOGD("Created ChartBuffer handle=%lld capacity=%d", (long long)handle, capacity);
     return handle;
 }
 
 void native_chart_destroy(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_chart_destroy", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_chart_map.find(handle);
     if (it != g_chart_map.end()) {
-        native_buffer_free(&it->second->buffer);
-        free(it->second->normalized_values);
-        delete it->second;
+        native_buffer_free(&it->second->chart.buffer);
+        slab_delete(it->second);
         g_chart_map.erase(it);
         LOGD("Destroyed ChartBuffer handle=%lld", (long long)handle);
     }
 }
 
 void native_chart_add_point(int64_t handle, float value, int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeProbeScope probe(PROBE_CHART_ADD_POINT);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_chart_map.find(handle);
-    if (it == g_chart_map.end()) return;
+    if (it == g_chart_map.end()) { probe.fail(); return; }
     
-    ChartBuffer* chart = it->second;
+    ChartState* state = it->second;
+    std::lock_guard<std::mutex> update(state->update_mutex);
+    ChartBuffer* chart = &state->chart;
     native_buffer_push(&chart->buffer, value, timestamp);
     
     // Update min/max
@@ -479,25 +830,31 @@ void native_chart_add_point(int64_t handle, float value, int64_t timestamp) {
         float v = chart->buffer.data[index].value;
         chart->normalized_values[i] = (v - chart->min_value) / range;
     }
+    
+    chart_publish(state);
 }
 
 int32_t native_chart_get_normalized(int64_t handle, float* out, int32_t max_count) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeProbeScope probe(PROBE_CHART_GET_NORMALIZED);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     if (!out || max_count <= 0) return 0;
     
     auto it = g_chart_map.find(handle);
-    if (it == g_chart_map.end()) return 0;
+    if (it == g_chart_map.end()) { probe.fail(); return 0; }
     
-    ChartBuffer* chart = it->second;
-    int32_t count = std::min(chart->normalized_count, max_count);
+    ChartState* state = it->second;
+    ChartSeries series{};
+    read_published(state->published, state->update_mutex, &series);
+    int32_t count = std::min(series.count, max_count);
     
-    memcpy(out, chart->normalized_values, count * sizeof(float));
+    memcpy(out, series.values, count * sizeof(float));
     return count;
 }
 
 void native_chart_get_range(int64_t handle, float* min_out, float* max_out) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_chart_get_range", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_chart_map.find(handle);
     if (it == g_chart_map.end()) {
@@ -506,19 +863,26 @@ void native_chart_get_range(int64_t handle, float* min_out, float* max_out) {
         return;
     }
     
-    if (min_out) *min_out = it->second->min_value;
-    if (max_out) *max_out = it->second->max_value;
+    ChartState* state = it->second;
+    ChartSeries series{};
+    read_published(state->published, state->update_mutex, &series);
+    if (min_out) *min_out = series.min_value;
+    if (max_out) *max_out = series.max_value;
 }
 
 void native_chart_clear(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_chart_clear", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_chart_map.find(handle);
     if (it != g_chart_map.end()) {
-        native_buffer_clear(&it->second->buffer);
-        it->second->min_value = 0;
-        it->second->max_value = 100;
-        it->second->normalized_count = 0;
+        ChartState* state = it->second;
+        std::lock_guard<std::mutex> update(state->update_mutex);
+        native_buffer_clear(&state->chart.buffer);
+        state->chart.min_value = 0;
+        state->chart.max_value = 100;
+        state->chart.normalized_count = 0;
+        chart_publish(state);
     }
 }
 
@@ -527,16 +891,17 @@ void native_chart_clear(int64_t handle) {
 // ============================================================================
 
 int64_t native_peak_create(int64_t window_ms) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_peak_create", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
-    PeakTracker* tracker = new (std::nothrow) PeakTracker();
+    PeakTracker* tracker = slab_new<PeakTracker>();
     if (!tracker) return 0;
     
     int capacity = static_cast<int>(window_ms / 500) + 10;
     capacity = std::min(capacity, MAX_BUFFER_SIZE);
     
     if (native_buffer_init(&tracker->buffer, capacity) != 0) {
-        delete tracker;
+        slab_delete(tracker);
         return 0;
     }
     
@@ -550,23 +915,26 @@ int64_t native_peak_create(int64_t window_ms) {
 }
 
 void native_peak_destroy(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_peak_destroy", TRACE_CAT_ANALYTICS);
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_peak_map.find(handle);
     if (it != g_peak_map.end()) {
         native_buffer_free(&it->second->buffer);
-        delete it->second;
+        slab_delete(it->second);
         g_peak_map.erase(it);
     }
 }
 
 void native_peak_add_value(int64_t handle, float value, int64_t timestamp) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeProbeScope probe(PROBE_PEAK_ADD_VALUE);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_peak_map.find(handle);
-    if (it == g_peak_map.end()) return;
+    if (it == g_peak_map.end()) { probe.fail(); return; }
     
     PeakTracker* tracker = it->second;
+    std::lock_guard<std::mutex> update(tracker->update_mutex);
     
     // Trim old data
     int64_t cutoff = timestamp - tracker->window_ms;
@@ -599,27 +967,55 @@ void native_peak_add_value(int64_t handle, float value, int64_t timestamp) {
     tracker->current_peak.peak_timestamp = max_ts;
     tracker->current_peak.avg_value = count > 0 ? static_cast<float>(sum / count) : 0;
     tracker->current_peak.sample_count = count;
+    tracker->published.publish(tracker->current_peak);
 }
 
-void native_peak_get_data(int64_t handle, PeakData* result) {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    
-    if (!result) return;
+// Copy the last published peak; false (and zeros) if the handle is unknown
+static bool peak_read(int64_t handle, PeakData* result) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     memset(result, 0, sizeof(PeakData));
     
     auto it = g_peak_map.find(handle);
-    if (it != g_peak_map.end()) {
-        *result = it->second->current_peak;
-    }
+    if (it == g_peak_map.end()) return false;
+    
+    read_published(it->second->published, it->second->update_mutex, result);
+    return true;
+}
+
+void native_peak_get_data(int64_t handle, PeakData* result) {
+    NativeProbeScope probe(PROBE_PEAK_GET_DATA);
+    if (!result) return;
+    peak_read(handle, result);
+}
+
+int32_t native_peak_get_data_into(int64_t handle, void* out, int32_t out_size) {
+    NativeProbeScope probe(PROBE_PEAK_GET_DATA);
+    if (!out || out_size < PEAK_OUT_SIZE) return probe.check(-1);
+    
+    PeakData data;
+    bool found = peak_read(handle, &data);
+    int64_t timestamp = data.peak_timestamp;
+    int64_t count = data.sample_count;
+    
+    uint8_t* bytes = static_cast<uint8_t*>(out);
+    memcpy(bytes + PEAK_OUT_VALUE, &data.peak_value, sizeof(float));
+    memcpy(bytes + PEAK_OUT_AVG, &data.avg_value, sizeof(float));
+    memcpy(bytes + PEAK_OUT_TIMESTAMP, &timestamp, sizeof(timestamp));
+    memcpy(bytes + PEAK_OUT_COUNT, &count, sizeof(count));
+    return probe.check(found ? PEAK_OUT_SIZE : -1);
 }
 
 void native_peak_reset(int64_t handle) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    NativeTraceScope trace("native_peak_reset", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
     
     auto it = g_peak_map.find(handle);
     if (it != g_peak_map.end()) {
-        native_buffer_clear(&it->second->buffer);
-        memset(&it->second->current_peak, 0, sizeof(PeakData));
+        PeakTracker* tracker = it->second;
+        std::lock_guard<std::mutex> update(tracker->update_mutex);
+        native_buffer_clear(&tracker->buffer);
+        memset(&tracker->current_peak, 0, sizeof(PeakData));
+        tracker->published.publish(tracker->current_peak);
     }
 }
 
@@ -629,37 +1025,23 @@ void native_peak_reset(int64_t handle) {
 
 int native_format_speed(char* buffer, int buffer_size, int64_t bytes_per_sec) {
     if (!buffer || buffer_size <= 0) return 0;
-    
-    if (bytes_per_sec < 1024) {
-        return snprintf(buffer, buffer_size, "%lldB/s", (long long)bytes_per_sec);
-    } else if (bytes_per_sec < 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1fKB/s", bytes_per_sec / 1024.0);
-    } else if (bytes_per_sec < 1024 * 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1fMB/s", bytes_per_sec / (1024.0 * 1024.0));
-    } else {
-        return snprintf(buffer, buffer_size, "%.2fGB/s", bytes_per_sec / (1024.0 * 1024.0 * 1024.0));
-    }
+    return native_fmt_speed(buffer, buffer_size, nullptr,
+                            bytes_per_sec > 0 ? static_cast<uint64_t>(bytes_per_sec) : 0);
 }
 
 int native_format_percent(char* buffer, int buffer_size, float percent) {
     if (!buffer || buffer_size <= 0) return 0;
-    return snprintf(buffer, buffer_size, "%.1f%%", percent);
+    return native_fmt_percent(buffer, buffer_size, percent);
 }
 
 int native_format_memory(char* buffer, int buffer_size, int64_t bytes) {
     if (!buffer || buffer_size <= 0) return 0;
-    
-    if (bytes < 1024) {
-        return snprintf(buffer, buffer_size, "%lldB", (long long)bytes);
-    } else if (bytes < 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1fKB", bytes / 1024.0);
-    } else if (bytes < 1024 * 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1fMB", bytes / (1024.0 * 1024.0));
-    } else {
-        return snprintf(buffer, buffer_size, "%.2fGB", bytes / (1024.0 * 1024.0 * 1024.0));
-    }
+    return native_fmt_bytes(buffer, buffer_size,
+                            bytes > 0 ? static_cast<uint64_t>(bytes) : 0);
 }
 
+#ifndef SYSMETRICS_NO_JNI
+
 // ============================================================================
 // JNI Functions
 // ============================================================================
@@ -670,24 +1052,28 @@ extern "C" {
 JNIEXPORT jlong JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createTimeWindowCalculator(
         JNIEnv* env, jclass clazz, jlong maxDurationMs) {
+    NativeTraceScope trace("NativeAnalytics.createTimeWindowCalculator", TRACE_CAT_JNI);
     return native_twc_create(maxDurationMs);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyTimeWindowCalculator(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.destroyTimeWindowCalculator", TRACE_CAT_JNI);
     native_twc_destroy(handle);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcAddPoint(
         JNIEnv* env, jclass clazz, jlong handle, jfloat value, jlong timestamp) {
+    NativeTraceScope trace("NativeAnalytics.twcAddPoint", TRACE_CAT_JNI);
     native_twc_add_point(handle, value, timestamp);
 }
 
 JNIEXPORT jfloatArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcGetStats(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.twcGetStats", TRACE_CAT_JNI);
     StatsResult result;
     native_twc_get_stats(handle, &result);
     
@@ -703,49 +1089,96 @@ Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcGetStats(
     return arr;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcGetStatsInto(
+        JNIEnv* env, jclass clazz, jlong handle, jobject out) {
+    NativeTraceScope trace("NativeAnalytics.twcGetStatsInto", TRACE_CAT_JNI);
+    void* address = out ? env->GetDirectBufferAddress(out) : nullptr;
+    if (!address) return JNI_FALSE;
+    
+    jlong capacity = std::min<jlong>(env->GetDirectBufferCapacity(out), STATS_OUT_SIZE);
+    return native_twc_get_stats_into(handle, address, static_cast<int32_t>(capacity)) == STATS_OUT_SIZE
+           ? JNI_TRUE : JNI_FALSE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcClear(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.twcClear", TRACE_CAT_JNI);
     native_twc_clear(handle);
 }
 
+/**
+ * Replace the anomaly detector parameters of a calculator.
+ * Returns false on an unknown handle or out-of-range values.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcSetAnomalyParams(
+        JNIEnv* env, jclass clazz, jlong handle, jfloat ewmaAlpha, jfloat ewmaThreshold,
+        jfloat robustThreshold, jfloat cusumSlack, jfloat cusumThreshold) {
+    NativeTraceScope trace("NativeAnalytics.twcSetAnomalyParams", TRACE_CAT_JNI);
+    AnomalyParams params = { ewmaAlpha, ewmaThreshold, robustThreshold, cusumSlack, cusumThreshold };
+    return native_twc_set_anomaly_params(handle, &params) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
 // Chart Buffer JNI
 JNIEXPORT jlong JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createChartBuffer(
         JNIEnv* env, jclass clazz, jint capacity) {
+    NativeTraceScope trace("NativeAnalytics.createChartBuffer", TRACE_CAT_JNI);
     return native_chart_create(capacity);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyChartBuffer(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.destroyChartBuffer", TRACE_CAT_JNI);
     native_chart_destroy(handle);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartAddPoint(
         JNIEnv* env, jclass clazz, jlong handle, jfloat value, jlong timestamp) {
+    NativeTraceScope trace("NativeAnalytics.chartAddPoint", TRACE_CAT_JNI);
     native_chart_add_point(handle, value, timestamp);
 }
 
 JNIEXPORT jfloatArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetNormalized(
         JNIEnv* env, jclass clazz, jlong handle, jint maxCount) {
-    std::vector<float> values(maxCount);
-    int32_t count = native_chart_get_normalized(handle, values.data(), maxCount);
+    NativeTraceScope trace("NativeAnalytics.chartGetNormalized", TRACE_CAT_JNI);
+    int32_t capacity = std::min<int32_t>(maxCount, MAX_BUFFER_SIZE);
+    float* values = native_scratch_floats(capacity);
+    if (!values) return nullptr;
+    int32_t count = native_chart_get_normalized(handle, values, capacity);
     
     if (count == 0) return nullptr;
     
     jfloatArray arr = env->NewFloatArray(count);
     if (arr == nullptr) return nullptr;
     
-    env->SetFloatArrayRegion(arr, 0, count, values.data());
+    env->SetFloatArrayRegion(arr, 0, count, values);
     return arr;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetNormalizedInto(
+        JNIEnv* env, jclass clazz, jlong handle, jfloatArray out) {
+    NativeTraceScope trace("NativeAnalytics.chartGetNormalizedInto", TRACE_CAT_JNI);
+    if (!out) return 0;
+    int32_t capacity = std::min<int32_t>(env->GetArrayLength(out), MAX_BUFFER_SIZE);
+    float* values = native_scratch_floats(capacity);
+    if (!values) return 0;
+    
+    int32_t count = native_chart_get_normalized(handle, values, capacity);
+    if (count > 0) env->SetFloatArrayRegion(out, 0, count, values);
+    return count;
+}
+
 JNIEXPORT jfloatArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetRange(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.chartGetRange", TRACE_CAT_JNI);
     float min_val, max_val;
     native_chart_get_range(handle, &min_val, &max_val);
     
@@ -757,9 +1190,22 @@ Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetRange(
     return arr;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetRangeInto(
+        JNIEnv* env, jclass clazz, jlong handle, jfloatArray out) {
+    NativeTraceScope trace("NativeAnalytics.chartGetRangeInto", TRACE_CAT_JNI);
+    if (!out || env->GetArrayLength(out) < 2) return JNI_FALSE;
+    
+    jfloat data[2];
+    native_chart_get_range(handle, &data[0], &data[1]);
+    env->SetFloatArrayRegion(out, 0, 2, data);
+    return JNI_TRUE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartClear(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.chartClear", TRACE_CAT_JNI);
     native_chart_clear(handle);
 }
 
@@ -767,24 +1213,28 @@ Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartClear(
 JNIEXPORT jlong JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createPeakTracker(
         JNIEnv* env, jclass clazz, jlong windowMs) {
+    NativeTraceScope trace("NativeAnalytics.createPeakTracker", TRACE_CAT_JNI);
     return native_peak_create(windowMs);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyPeakTracker(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.destroyPeakTracker", TRACE_CAT_JNI);
     native_peak_destroy(handle);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakAddValue(
         JNIEnv* env, jclass clazz, jlong handle, jfloat value, jlong timestamp) {
+    NativeTraceScope trace("NativeAnalytics.peakAddValue", TRACE_CAT_JNI);
     native_peak_add_value(handle, value, timestamp);
 }
 
 JNIEXPORT jfloatArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakGetData(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.peakGetData", TRACE_CAT_JNI);
     PeakData data;
     native_peak_get_data(handle, &data);
     
@@ -802,10 +1252,75 @@ Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakGetData(
     return arr;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakGetDataInto(
+        JNIEnv* env, jclass clazz, jlong handle, jobject out) {
+    NativeTraceScope trace("NativeAnalytics.peakGetDataInto", TRACE_CAT_JNI);
+    void* address = out ? env->GetDirectBufferAddress(out) : nullptr;
+    if (!address) return JNI_FALSE;
+    
+    jlong capacity = std::min<jlong>(env->GetDirectBufferCapacity(out), PEAK_OUT_SIZE);
+    return native_peak_get_data_into(handle, address, static_cast<int32_t>(capacity)) == PEAK_OUT_SIZE
+           ? JNI_TRUE : JNI_FALSE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakReset(
         JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.peakReset", TRACE_CAT_JNI);
     native_peak_reset(handle);
 }
 
 } // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod ANALYTICS_METHODS[] = {
+    NATIVE_METHOD("createTimeWindowCalculator", "(J)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createTimeWindowCalculator),
+    NATIVE_METHOD("destroyTimeWindowCalculator", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyTimeWindowCalculator),
+    NATIVE_METHOD("twcAddPoint", "(JFJ)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcAddPoint),
+    NATIVE_METHOD("twcGetStats", "(J)[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcGetStats),
+    NATIVE_METHOD("twcGetStatsInto", "(JLjava/nio/ByteBuffer;)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcGetStatsInto),
+    NATIVE_METHOD("twcClear", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcClear),
+    NATIVE_METHOD("twcSetAnomalyParams", "(JFFFFF)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_twcSetAnomalyParams),
+    NATIVE_METHOD("createChartBuffer", "(I)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createChartBuffer),
+    NATIVE_METHOD("destroyChartBuffer", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyChartBuffer),
+    NATIVE_METHOD("chartAddPoint", "(JFJ)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartAddPoint),
+    NATIVE_METHOD("chartGetNormalized", "(JI)[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetNormalized),
+    NATIVE_METHOD("chartGetNormalizedInto", "(J[F)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetNormalizedInto),
+    NATIVE_METHOD("chartGetRange", "(J)[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetRange),
+    NATIVE_METHOD("chartGetRangeInto", "(J[F)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartGetRangeInto),
+    NATIVE_METHOD("chartClear", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_chartClear),
+    NATIVE_METHOD("createPeakTracker", "(J)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_createPeakTracker),
+    NATIVE_METHOD("destroyPeakTracker", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_destroyPeakTracker),
+    NATIVE_METHOD("peakAddValue", "(JFJ)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakAddValue),
+    NATIVE_METHOD("peakGetData", "(J)[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakGetData),
+    NATIVE_METHOD("peakGetDataInto", "(JLjava/nio/ByteBuffer;)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakGetDataInto),
+    NATIVE_METHOD("peakReset", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_peakReset),
+};
+const NativeMethodList NATIVE_ANALYTICS_JNI = NATIVE_METHOD_LIST(ANALYTICS_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -1,9 +1,12 @@
 #ifndef SYSMETRICS_NATIVE_ANALYTICS_H
 #define SYSMETRICS_NATIVE_ANALYTICS_H
 
+#ifndef SYSMETRICS_NO_JNI
 #include <jni.h>
+#endif
 #include <stdint.h>
 #include <stdbool.h>
+#include "native_anomaly.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,7 +21,7 @@ extern "C" {
  * - Lock-free circular buffers for O(1) operations
  * - SIMD-friendly data alignment
  * - Cache-optimized memory layout
- * - Minimal allocations during runtime
+ * - No heap allocations in steady state (slab blocks, per-thread scratch)
  * 
  * Performance Targets:
  * - Average calculation: <1μs
@@ -41,6 +44,22 @@ extern "C" {
 #define WINDOW_5M   300000L
 #define WINDOW_10M  600000L
 
+// Byte layouts written by the *_into getters (native byte order). The JNI
+// layer hands them a direct ByteBuffer owned by the Kotlin wrapper, so int64
+// timestamps travel as int64 instead of being squeezed into a float.
+#define STATS_OUT_VALUES     0   // 9 floats: current, avg_30s, avg_1m, avg_5m, min, max, p50, p95, p99
+#define STATS_OUT_TIMESTAMP  40  // int64
+#define STATS_OUT_COUNT      48  // int64
+#define STATS_OUT_SCORES     56  // 3 floats: ewma, robust, cusum (native_anomaly.h)
+#define STATS_OUT_FLAGS      68  // int32 ANOMALY_FLAG_*
+#define STATS_OUT_SIZE       72
+
+#define PEAK_OUT_VALUE       0   // float
+#define PEAK_OUT_AVG         4   // float
+#define PEAK_OUT_TIMESTAMP   8   // int64
+#define PEAK_OUT_COUNT       16  // int64
+#define PEAK_OUT_SIZE        24
+
 // ============================================================================
 // Data Structures (Cache-aligned for performance)
 // ============================================================================
@@ -69,6 +88,10 @@ typedef struct {
     float p99;
     int64_t timestamp;
     int32_t count;
+    float ewma_score;        // Anomaly scores of the current point
+    float robust_score;
+    float cusum_score;
+    int32_t anomaly_flags;   // ANOMALY_FLAG_*
 } StatsResult;
 
 /**
@@ -210,15 +233,30 @@ void native_twc_destroy(int64_t handle);
 void native_twc_add_point(int64_t handle, float value, int64_t timestamp);
 
 /**
- * Get statistics for all time windows.
+ * Get statistics for all time windows, as published by the last
+ * add/clear. Does not recompute and does not wait for a concurrent add.
  */
 void native_twc_get_stats(int64_t handle, StatsResult* result);
 
+/**
+ * Write native_twc_get_stats() into out using the STATS_OUT_* layout.
+ * @return STATS_OUT_SIZE, or -1 if out is too small or the handle is
+ *         unknown (out is zeroed in that case)
+ */
+int32_t native_twc_get_stats_into(int64_t handle, void* out, int32_t out_size);
+
 /**
  * Clear all data.
  */
 void native_twc_clear(int64_t handle);
 
+/**
+ * Replace the anomaly detector parameters (see native_anomaly.h) and
+ * restart detection. Every calculator starts with the defaults.
+ * @return 0 on success, -1 on an unknown handle or invalid params
+ */
+int native_twc_set_anomaly_params(int64_t handle, const AnomalyParams* params);
+
 // ============================================================================
 // Chart Buffer API
 // ============================================================================
@@ -241,7 +279,8 @@ void native_chart_destroy(int64_t handle);
 void native_chart_add_point(int64_t handle, float value, int64_t timestamp);
 
 /**
- * Get normalized values (0-1 range) for rendering.
+ * Get normalized values (0-1 range) for rendering, as published by the
+ * last add/clear. Does not wait for a concurrent add.
  * @param out Output array for normalized values
  * @param max_count Maximum values to return
  * @return Number of values returned
@@ -280,10 +319,17 @@ void native_peak_destroy(int64_t handle);
 void native_peak_add_value(int64_t handle, float value, int64_t timestamp);
 
 /**
- * Get current peak data.
+ * Get current peak data (last published; does not wait for a concurrent add).
  */
 void native_peak_get_data(int64_t handle, PeakData* result);
 
+/**
+ * Write native_peak_get_data() into out using the PEAK_OUT_* layout.
+ * @return PEAK_OUT_SIZE, or -1 if out is too small or the handle is
+ *         unknown (out is zeroed in that case)
+ */
+int32_t native_peak_get_data_into(int64_t handle, void* out, int32_t out_size);
+
 /**
  * Reset peak tracker.
  */
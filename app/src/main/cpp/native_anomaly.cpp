@@ -0,0 +1,151 @@
+#include "native_anomaly.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// ============================================================================
+// Parameters
+// ============================================================================
+
+void native_anomaly_default_params(AnomalyParams* params) {
+    if (!params) return;
+    params->ewma_alpha = 0.02f;
+    params->ewma_threshold = 3.0f;
+    params->robust_threshold = 3.5f;
+    params->cusum_slack = 1.0f;
+    params->cusum_threshold = 5.0f;
+}
+
+static bool params_valid(const AnomalyParams* params) {
+    return params &&
+           params->ewma_alpha > 0.0f && params->ewma_alpha <= 1.0f &&
+           params->ewma_threshold > 0.0f &&
+           params->robust_threshold > 0.0f &&
+           params->cusum_slack >= 0.0f &&
+           params->cusum_threshold > 0.0f;
+}
+
+int native_anomaly_init(AnomalyDetector* detector, const AnomalyParams* params) {
+    if (!detector || !params_valid(params)) return -1;
+    detector->params = *params;
+    native_anomaly_reset(detector);
+    return 0;
+}
+
+void native_anomaly_reset(AnomalyDetector* detector) {
+    if (!detector) return;
+    detector->count = 0;
+    detector->mean = 0.0;
+    detector->variance = 0.0;
+    detector->cusum_high = 0.0f;
+    detector->cusum_low = 0.0f;
+    detector->window_head = 0;
+    detector->window_count = 0;
+}
+
+// ============================================================================
+// Rolling Median / MAD
+// ============================================================================
+
+static float scale_floor(float centre) {
+    return std::max(ANOMALY_SCALE_MIN, ANOMALY_SCALE_FLOOR * std::fabs(centre));
+}
+
+static float median_of_sorted(const float* sorted, int n) {
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) * 0.5f;
+}
+
+// Deviations grow outward from the median on both sides, so the median of
+// |x - med| is found by merging the two sides up to the middle rank
+static float mad_of_sorted(const float* sorted, int n, float median) {
+    int right = static_cast<int>(std::lower_bound(sorted, sorted + n, median) - sorted);
+    int left = right - 1;
+    float prev = 0.0f, cur = 0.0f;
+
+    for (int rank = 0; rank <= n / 2; rank++) {
+        prev = cur;
+        if (left >= 0 && (right >= n || median - sorted[left] <= sorted[right] - median)) {
+            cur = median - sorted[left--];
+        } else {
+            cur = sorted[right++] - median;
+        }
+    }
+    return n % 2 ? cur : (prev + cur) * 0.5f;
+}
+
+static void window_push(AnomalyDetector* d, float value) {
+    int n = d->window_count;
+    if (n == ANOMALY_MEDIAN_WINDOW) {
+        // Drop the oldest point from the sorted copy
+        float oldest = d->window[d->window_head];
+        int pos = static_cast<int>(std::lower_bound(d->sorted, d->sorted + n, oldest) - d->sorted);
+        memmove(d->sorted + pos, d->sorted + pos + 1, (n - pos - 1) * sizeof(float));
+        n--;
+        d->window[d->window_head] = value;
+        d->window_head = (d->window_head + 1) % ANOMALY_MEDIAN_WINDOW;
+    } else {
+        d->window[(d->window_head + n) % ANOMALY_MEDIAN_WINDOW] = value;
+    }
+
+    int pos = static_cast<int>(std::upper_bound(d->sorted, d->sorted + n, value) - d->sorted);
+    memmove(d->sorted + pos + 1, d->sorted + pos, (n - pos) * sizeof(float));
+    d->sorted[pos] = value;
+    d->window_count = n + 1;
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+static float capped(float score) {
+    return std::min(score, ANOMALY_SCORE_MAX);
+}
+
+void native_anomaly_update(AnomalyDetector* d, float value, AnomalyResult* result) {
+    AnomalyResult out = { 0.0f, 0.0f, 0.0f, 0 };
+    if (!d || !std::isfinite(value)) {
+        if (result) *result = out;
+        return;
+    }
+    const AnomalyParams& p = d->params;
+
+    if (d->count >= ANOMALY_WARMUP) {
+        // EWMA z-score against the state before this point
+        float stddev = std::max(static_cast<float>(std::sqrt(d->variance)),
+                                scale_floor(static_cast<float>(d->mean)));
+        float z = static_cast<float>((value - d->mean) / stddev);
+        out.ewma_score = capped(std::fabs(z));
+        if (out.ewma_score >= p.ewma_threshold) out.flags |= ANOMALY_FLAG_EWMA;
+
+        // CUSUM on the same z, clamped so one outlier cannot trip it alone
+        float step = std::max(-p.cusum_threshold * 0.5f, std::min(z, p.cusum_threshold * 0.5f));
+        d->cusum_high = std::max(0.0f, d->cusum_high + step - p.cusum_slack);
+        d->cusum_low = std::max(0.0f, d->cusum_low - step - p.cusum_slack);
+        out.cusum_score = capped(std::max(d->cusum_high, d->cusum_low));
+        if (out.cusum_score >= p.cusum_threshold) out.flags |= ANOMALY_FLAG_CUSUM;
+
+        // Robust z-score over the rolling window
+        int n = d->window_count;
+        float median = median_of_sorted(d->sorted, n);
+        float scale = std::max(1.4826f * mad_of_sorted(d->sorted, n, median), scale_floor(median));
+        out.robust_score = capped(std::fabs(value - median) / scale);
+        if (out.robust_score >= p.robust_threshold) out.flags |= ANOMALY_FLAG_ROBUST;
+    }
+
+    // Fold the point in
+    if (d->count == 0) {
+        d->mean = value;
+        d->variance = 0.0;
+    } else {
+        // Plain running mean/variance until 1/alpha points are in, so the
+        // early variance is not biased towards zero
+        double alpha = std::max(static_cast<double>(p.ewma_alpha), 1.0 / (d->count + 1));
+        double diff = value - d->mean;
+        d->mean += alpha * diff;
+        d->variance = (1.0 - alpha) * (d->variance + alpha * diff * diff);
+    }
+    window_push(d, value);
+    d->count++;
+
+    if (result) *result = out;
+}
@@ -0,0 +1,98 @@
+#ifndef SYSMETRICS_NATIVE_ANOMALY_H
+#define SYSMETRICS_NATIVE_ANOMALY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE ANOMALY - Online detectors for analytics streams
+ * ============================================================================
+ *
+ * Three detectors share one state block per TimeWindowCalculator and are
+ * updated by native_twc_add_point. Each point is scored against the state
+ * before the point is folded in, so a spike cannot hide itself:
+ *
+ * - EWMA: |x - mean| / stddev, exponentially weighted (ewma_alpha)
+ * - Robust z-score: |x - median| / (1.4826 * MAD) over the last
+ *   ANOMALY_MEDIAN_WINDOW points, insensitive to the outliers it flags
+ * - CUSUM: two-sided cumulative sum of the EWMA z-score minus cusum_slack.
+ *   Catches a sustained shift (idle 5% -> steady 35%) that is too small
+ *   per point for the z-scores. Each point adds at most half of
+ *   cusum_threshold, so one outlier alone cannot trip it.
+ *
+ * Updates cost O(1) in the stream length: the robust detector keeps a
+ * sorted copy of its fixed window. Scale estimates have a floor
+ * (ANOMALY_SCALE_FLOOR of |centre|, at least ANOMALY_SCALE_MIN) so a
+ * perfectly flat series does not turn every wobble into an infinite
+ * score. Nothing is scored or flagged during the first ANOMALY_WARMUP
+ * points.
+ */
+
+#define ANOMALY_MEDIAN_WINDOW 31
+#define ANOMALY_WARMUP 10
+#define ANOMALY_SCORE_MAX 100.0f
+#define ANOMALY_SCALE_FLOOR 0.01f
+#define ANOMALY_SCALE_MIN 0.001f
+
+#define ANOMALY_FLAG_EWMA    0x1
+#define ANOMALY_FLAG_ROBUST  0x2
+#define ANOMALY_FLAG_CUSUM   0x4
+
+typedef struct {
+    float ewma_alpha;        // Weight of the newest point, (0, 1]
+    float ewma_threshold;    // Flag at this many standard deviations
+    float robust_threshold;  // Flag at this robust z-score
+    float cusum_slack;       // Drift allowance k, in standard deviations
+    float cusum_threshold;   // Decision interval h, in standard deviations
+} AnomalyParams;
+
+typedef struct {
+    float ewma_score;
+    float robust_score;
+    float cusum_score;
+    int32_t flags;           // ANOMALY_FLAG_*
+} AnomalyResult;
+
+typedef struct {
+    AnomalyParams params;
+    int64_t count;
+    double mean;
+    double variance;
+    float cusum_high;
+    float cusum_low;
+    float window[ANOMALY_MEDIAN_WINDOW];   // Arrival order
+    float sorted[ANOMALY_MEDIAN_WINDOW];
+    int32_t window_head;
+    int32_t window_count;
+} AnomalyDetector;
+
+/**
+ * Defaults: alpha 0.02, 3 sigma, robust 3.5, CUSUM k 1 / h 5.
+ */
+void native_anomaly_default_params(AnomalyParams* params);
+
+/**
+ * Reset the detector and install params.
+ * @return 0 on success, -1 on out-of-range params (detector unchanged)
+ */
+int native_anomaly_init(AnomalyDetector* detector, const AnomalyParams* params);
+
+/**
+ * Forget all history, keeping the params.
+ */
+void native_anomaly_reset(AnomalyDetector* detector);
+
+/**
+ * Score value, then fold it into the detectors.
+ */
+void native_anomaly_update(AnomalyDetector* detector, float value, AnomalyResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_ANOMALY_H
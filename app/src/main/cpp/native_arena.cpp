@@ -0,0 +1,118 @@
+#include "native_arena.h"
+#include <atomic>
+#include <mutex>
+
+#define LOG_TAG "NATIVE_ARENA"
+#include "native_platform.h"
+
+// ============================================================================
+// Slab Classes
+// ============================================================================
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct SlabClass {
+    size_t block_size;
+    FreeBlock* free_list;
+};
+
+static const size_t CLASS_SIZES[NATIVE_SLAB_CLASSES] = NATIVE_SLAB_CLASS_SIZES;
+
+static std::mutex g_slab_mutex;
+static SlabClass g_classes[NATIVE_SLAB_CLASSES];
+static bool g_classes_ready = false;
+static int32_t g_blocks_in_use = 0;
+static std::atomic<uint64_t> g_heap_allocations(0);
+
+// Caller holds g_slab_mutex
+static void init_classes() {
+    if (g_classes_ready) return;
+    for (int i = 0; i < NATIVE_SLAB_CLASSES; i++) {
+        g_classes[i].block_size = CLASS_SIZES[i];
+        g_classes[i].free_list = nullptr;
+    }
+    g_classes_ready = true;
+}
+
+static int class_for_size(size_t size) {
+    for (int i = 0; i < NATIVE_SLAB_CLASSES; i++) {
+        if (size <= CLASS_SIZES[i]) return i;
+    }
+    return -1;
+}
+
+// Caller holds g_slab_mutex. Carves a new chunk into the class free list.
+static bool grow_class(SlabClass* slab) {
+    size_t blocks = NATIVE_SLAB_CHUNK_BYTES / slab->block_size;
+    if (blocks < 2) blocks = 2;
+
+    char* chunk = static_cast<char*>(native_aligned_alloc(NATIVE_SLAB_ALIGN, blocks * slab->block_size));
+    if (!chunk) {
+        LOGE("Failed to allocate slab chunk (%zu x %zu bytes)", blocks, slab->block_size);
+        return false;
+    }
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // Chunks are never released; they belong to the arena for the process lifetime
+    for (size_t i = blocks; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * slab->block_size);
+        block->next = slab->free_list;
+        slab->free_list = block;
+    }
+    LOGD("Slab class %zu grew by %zu blocks", slab->block_size, blocks);
+    return true;
+}
+
+// ============================================================================
+// Slab API
+// ============================================================================
+
+void* native_slab_alloc(size_t size) {
+    int index = class_for_size(size);
+    if (index < 0 || size == 0) return nullptr;
+
+    std::lock_guard<std::mutex> lock(g_slab_mutex);
+    init_classes();
+
+    SlabClass* slab = &g_classes[index];
+    if (!slab->free_list && !grow_class(slab)) return nullptr;
+
+    FreeBlock* block = slab->free_list;
+    slab->free_list = block->next;
+    g_blocks_in_use++;
+    return block;
+}
+
+void native_slab_free(void* ptr, size_t size) {
+    if (!ptr) return;
+    int index = class_for_size(size);
+    if (index < 0) return;
+
+    std::lock_guard<std::mutex> lock(g_slab_mutex);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = g_classes[index].free_list;
+    g_classes[index].free_list = block;
+    g_blocks_in_use--;
+}
+
+int32_t native_slab_blocks_in_use(void) {
+    std::lock_guard<std::mutex> lock(g_slab_mutex);
+    return g_blocks_in_use;
+}
+
+uint64_t native_arena_heap_allocations(void) {
+    return g_heap_allocations.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Per-thread Scratch
+// ============================================================================
+
+float* native_scratch_floats(int32_t count) {
+    // Trivial type: no constructor or destructor runs per thread
+    alignas(NATIVE_SLAB_ALIGN) static thread_local float scratch[NATIVE_SCRATCH_FLOATS];
+    if (count < 0 || count > NATIVE_SCRATCH_FLOATS) return nullptr;
+    return scratch;
+}
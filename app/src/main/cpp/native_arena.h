@@ -0,0 +1,81 @@
+#ifndef SYSMETRICS_NATIVE_ARENA_H
+#define SYSMETRICS_NATIVE_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE ARENA - Slab allocator and per-thread scratch for analytics
+ * ============================================================================
+ *
+ * Analytics objects (calculators, chart buffers, peak trackers) and their
+ * sample buffers come from a handful of fixed size classes. Each class
+ * carves cache-line aligned blocks out of chunks that are allocated the
+ * first time the class is used and never returned; freed blocks go back on
+ * the class free list. Creating and destroying trackers at a steady rate
+ * therefore stops touching the heap once the first chunk of each class is
+ * in place.
+ *
+ * Temporary value sets (percentile selection, JNI copies) use a per-thread
+ * scratch array of fixed size instead of a vector per call.
+ *
+ * native_arena_heap_allocations() counts every chunk taken from the heap so
+ * tests can assert that a steady-state workload allocates nothing.
+ */
+
+// Block alignment; every size class is a multiple of it
+#define NATIVE_SLAB_ALIGN 64
+
+// Size classes in bytes (the largest holds MAX_BUFFER_SIZE data points)
+#define NATIVE_SLAB_CLASSES 4
+#define NATIVE_SLAB_CLASS_SIZES { 256, 1024, 4096, 6144 }
+#define NATIVE_SLAB_MAX_SIZE 6144
+
+// Bytes per chunk; classes larger than half a chunk get 2 blocks per chunk
+#define NATIVE_SLAB_CHUNK_BYTES 16384
+
+// Floats in each thread's scratch array
+#define NATIVE_SCRATCH_FLOATS 512
+
+/**
+ * Allocate a block of at least size bytes, aligned to NATIVE_SLAB_ALIGN.
+ * @return Block, or NULL if size exceeds NATIVE_SLAB_MAX_SIZE or the heap
+ *         is exhausted
+ */
+void* native_slab_alloc(size_t size);
+
+/**
+ * Return a block to its size class.
+ * @param size The size passed to native_slab_alloc
+ */
+void native_slab_free(void* ptr, size_t size);
+
+/**
+ * Blocks currently handed out across all classes.
+ */
+int32_t native_slab_blocks_in_use(void);
+
+/**
+ * Heap allocations made by the arena since process start (chunks only;
+ * block reuse is not counted).
+ */
+uint64_t native_arena_heap_allocations(void);
+
+/**
+ * Calling thread's scratch array. The contents are undefined on entry and
+ * are overwritten by the next caller on the same thread, so it must not be
+ * held across calls into other native_* functions.
+ * @return count floats of scratch, or NULL if count > NATIVE_SCRATCH_FLOATS
+ */
+float* native_scratch_floats(int32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_ARENA_H
@@ -0,0 +1,323 @@
+#include "native_cpufreq.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_CPUFREQ"
+#include "native_platform.h"
+
+#define CPUFREQ_VALUE_BUFFER 32
+#define CPUFREQ_STATE_BUFFER 1024
+
+struct PolicyState {
+    int32_t first_cpu;
+    uint32_t cpu_mask;
+    uint32_t cpuinfo_max_khz;
+    int cur_fd;
+    int max_fd;
+    int tis_fd;
+    int state_count;  // states in the previous time_in_state read, 0 if none
+    uint32_t freqs[CPUFREQ_MAX_STATES];
+    uint64_t times[CPUFREQ_MAX_STATES];
+};
+
+static std::mutex g_cpufreq_mutex;
+static PolicyState g_policies[CPUFREQ_MAX_POLICIES];
+static int g_policy_count = 0;
+static bool g_discovered = false;
+static uint32_t g_discovered_generation = 0;
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static const char* parse_u64(const char* p, uint64_t* out) {
+    while (*p == ' ' || *p == '\t') p++;
+    const char* start = p;
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+int native_cpufreq_parse_time_in_state(const char* text, uint32_t* freqs_khz,
+                                       uint64_t* times, int max_states) {
+    if (!text || !freqs_khz || !times) return 0;
+
+    int count = 0;
+    for (const char* p = text; *p && count < max_states;) {
+        uint64_t freq, time;
+        const char* cursor = parse_u64(p, &freq);
+        if (cursor) cursor = parse_u64(cursor, &time);
+        if (cursor) {
+            freqs_khz[count] = static_cast<uint32_t>(freq);
+            times[count] = time;
+            count++;
+        }
+
+        const char* eol = strchr(p, '\n');
+        if (!eol) break;
+        p = eol + 1;
+    }
+    return count;
+}
+
+// related_cpus: "0 1 2 3" (some kernels print ranges such as "0-3")
+static uint32_t parse_cpu_list(const char* text) {
+    uint32_t mask = 0;
+    const char* p = text;
+    while (*p) {
+        uint64_t first, last;
+        const char* cursor = parse_u64(p, &first);
+        if (!cursor) break;
+        last = first;
+        if (*cursor == '-' && (cursor = parse_u64(cursor + 1, &last)) == nullptr) break;
+        for (uint64_t cpu = first; cpu <= last && cpu < 32; cpu++) mask |= 1u << cpu;
+        p = cursor;
+        while (*p == ' ' || *p == ',' || *p == '\n') p++;
+    }
+    return mask;
+}
+
+// ============================================================================
+// Descriptors
+// ============================================================================
+
+static int open_cpu_file(int cpu, const char* leaf) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_cpu(path, sizeof(path), cpu, leaf) < 0) return -1;
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+// sysfs regenerates the attribute on every read at offset 0
+static ssize_t pread_text(int fd, char* buffer, size_t size) {
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buffer, size - 1, 0);
+    if (n < 0) return -1;
+    buffer[n] = '\0';
+    return n;
+}
+
+static bool pread_u32(int fd, uint32_t* out) {
+    char buffer[CPUFREQ_VALUE_BUFFER];
+    if (pread_text(fd, buffer, sizeof(buffer)) <= 0) return false;
+
+    uint64_t value;
+    if (!parse_u64(buffer, &value)) return false;
+    *out = static_cast<uint32_t>(value);
+    return true;
+}
+
+static bool read_cpu_u32(int cpu, const char* leaf, uint32_t* out) {
+    int fd = open_cpu_file(cpu, leaf);
+    if (fd < 0) return false;
+    bool ok = pread_u32(fd, out);
+    close(fd);
+    return ok;
+}
+
+// Caller holds g_cpufreq_mutex
+static void close_policies() {
+    for (int i = 0; i < g_policy_count; i++) {
+        PolicyState& policy = g_policies[i];
+        if (policy.cur_fd >= 0) close(policy.cur_fd);
+        if (policy.max_fd >= 0) close(policy.max_fd);
+        if (policy.tis_fd >= 0) close(policy.tis_fd);
+    }
+    g_policy_count = 0;
+    g_discovered = false;
+}
+
+// Caller holds g_cpufreq_mutex. Residency baselines of policies that
+// survive a reopen (same CPUs) are kept so replay steps still produce deltas.
+static void discover_policies() {
+    PolicyState previous[CPUFREQ_MAX_POLICIES];
+    int previous_count = g_policy_count;
+    memcpy(previous, g_policies, static_cast<size_t>(previous_count) * sizeof(PolicyState));
+    close_policies();
+
+    uint32_t covered = 0;
+    for (int cpu = 0; cpu < MAX_CPUFREQ_CPUS && g_policy_count < CPUFREQ_MAX_POLICIES; cpu++) {
+        if (covered & (1u << cpu)) continue;
+
+        int cur_fd = open_cpu_file(cpu, "cpufreq/scaling_cur_freq");
+        if (cur_fd < 0) continue;  // offline CPU or no cpufreq driver
+
+        uint32_t mask = 0;
+        int related_fd = open_cpu_file(cpu, "cpufreq/related_cpus");
+        if (related_fd >= 0) {
+            char buffer[CPUFREQ_VALUE_BUFFER * 4];
+            if (pread_text(related_fd, buffer, sizeof(buffer)) > 0) mask = parse_cpu_list(buffer);
+            close(related_fd);
+        }
+        mask |= 1u << cpu;
+        covered |= mask;
+
+        PolicyState& policy = g_policies[g_policy_count++];
+        memset(&policy, 0, sizeof(PolicyState));
+        policy.first_cpu = cpu;
+        policy.cpu_mask = mask;
+        policy.cur_fd = cur_fd;
+        policy.max_fd = open_cpu_file(cpu, "cpufreq/scaling_max_freq");
+        policy.tis_fd = open_cpu_file(cpu, "cpufreq/stats/time_in_state");
+        if (!read_cpu_u32(cpu, "cpufreq/cpuinfo_max_freq", &policy.cpuinfo_max_khz)) {
+            policy.cpuinfo_max_khz = 0;
+        }
+
+        for (int i = 0; i < previous_count; i++) {
+            if (previous[i].first_cpu != cpu || previous[i].cpu_mask != mask) continue;
+            policy.state_count = previous[i].state_count;
+            memcpy(policy.freqs, previous[i].freqs, sizeof(policy.freqs));
+            memcpy(policy.times, previous[i].times, sizeof(policy.times));
+            break;
+        }
+    }
+
+    g_discovered = true;
+    g_discovered_generation = native_paths_generation();
+    LOGI("Discovered %d cpufreq policies", g_policy_count);
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+// Residency-weighted frequency since the previous read; false without a baseline
+static bool sample_residency(PolicyState& policy, uint32_t* avg_khz) {
+    char buffer[CPUFREQ_STATE_BUFFER];
+    if (pread_text(policy.tis_fd, buffer, sizeof(buffer)) <= 0) return false;
+
+    uint32_t freqs[CPUFREQ_MAX_STATES];
+    uint64_t times[CPUFREQ_MAX_STATES];
+    int count = native_cpufreq_parse_time_in_state(buffer, freqs, times, CPUFREQ_MAX_STATES);
+    if (count == 0) return false;
+
+    bool comparable = count == policy.state_count &&
+                      memcmp(freqs, policy.freqs, static_cast<size_t>(count) * sizeof(uint32_t)) == 0;
+
+    uint64_t weighted = 0;
+    uint64_t elapsed = 0;
+    if (comparable) {
+        for (int i = 0; i < count; i++) {
+            if (times[i] < policy.times[i]) {
+                comparable = false;  // stats were reset
+                break;
+            }
+            uint64_t delta = times[i] - policy.times[i];
+            weighted += delta * freqs[i];
+            elapsed += delta;
+        }
+    }
+
+    policy.state_count = count;
+    memcpy(policy.freqs, freqs, static_cast<size_t>(count) * sizeof(uint32_t));
+    memcpy(policy.times, times, static_cast<size_t>(count) * sizeof(uint64_t));
+
+    if (!comparable || elapsed == 0) return false;
+    *avg_khz = static_cast<uint32_t>(weighted / elapsed);
+    return true;
+}
+
+static int cpufreq_sample_impl(CpuFreqPolicy* out, int max_count) {
+    if (!out || max_count <= 0) return -1;
+
+    std::lock_guard<std::mutex> lock(g_cpufreq_mutex);
+    if (!g_discovered || g_discovered_generation != native_paths_generation()) {
+        discover_policies();
+    }
+
+    int written = 0;
+    for (int i = 0; i < g_policy_count && written < max_count; i++) {
+        PolicyState& policy = g_policies[i];
+        CpuFreqPolicy& result = out[written++];
+        memset(&result, 0, sizeof(CpuFreqPolicy));
+
+        result.first_cpu = policy.first_cpu;
+        result.cpu_mask = policy.cpu_mask;
+        result.cpuinfo_max_khz = policy.cpuinfo_max_khz;
+        result.online = pread_u32(policy.cur_fd, &result.cur_khz) ? 1 : 0;
+        if (!pread_u32(policy.max_fd, &result.scaling_max_khz)) {
+            result.scaling_max_khz = policy.cpuinfo_max_khz;
+        }
+
+        result.has_residency = sample_residency(policy, &result.avg_khz) ? 1 : 0;
+        if (!result.has_residency) result.avg_khz = result.cur_khz;
+    }
+
+    return written;
+}
+
+int native_cpufreq_sample(CpuFreqPolicy* out, int max_count) {
+    NativeProbeScope probe(PROBE_READ_CPUFREQ);
+    return probe.check(cpufreq_sample_impl(out, max_count));
+}
+
+void native_cpufreq_close(void) {
+    std::lock_guard<std::mutex> lock(g_cpufreq_mutex);
+    close_policies();
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+#define CPUFREQ_FIELDS 8
+
+extern "C" {
+
+/**
+ * Returns [policyCount, (firstCpu, cpuMask, curKhz, avgKhz, scalingMaxKhz,
+ *          cpuinfoMaxKhz, online, hasResidency) * policyCount]
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuFrequencies(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.getCpuFrequencies", TRACE_CAT_JNI);
+    CpuFreqPolicy policies[CPUFREQ_MAX_POLICIES];
+    int count = native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES);
+    if (count < 0) return nullptr;
+
+    jint values[1 + CPUFREQ_MAX_POLICIES * CPUFREQ_FIELDS];
+    jint* cursor = values;
+    *cursor++ = count;
+    for (int i = 0; i < count; i++) {
+        const CpuFreqPolicy& policy = policies[i];
+        *cursor++ = policy.first_cpu;
+        *cursor++ = static_cast<jint>(policy.cpu_mask);
+        *cursor++ = static_cast<jint>(policy.cur_khz);
+        *cursor++ = static_cast<jint>(policy.avg_khz);
+        *cursor++ = static_cast<jint>(policy.scaling_max_khz);
+        *cursor++ = static_cast<jint>(policy.cpuinfo_max_khz);
+        *cursor++ = policy.online;
+        *cursor++ = policy.has_residency;
+    }
+
+    jsize size = static_cast<jsize>(cursor - values);
+    jintArray result = env->NewIntArray(size);
+    if (result == nullptr) return nullptr;
+
+    env->SetIntArrayRegion(result, 0, size, values);
+    return result;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod CPUFREQ_METHODS[] = {
+    NATIVE_METHOD("getCpuFrequencies", "()[I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuFrequencies),
+};
+const NativeMethodList NATIVE_CPUFREQ_JNI = NATIVE_METHOD_LIST(CPUFREQ_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,68 @@
+#ifndef SYSMETRICS_NATIVE_CPUFREQ_H
+#define SYSMETRICS_NATIVE_CPUFREQ_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE CPUFREQ - Per-policy CPU frequency and time-in-state residency
+ * ============================================================================
+ *
+ * Policies are discovered once from /sys/devices/system/cpu/cpu<N>/cpufreq
+ * (CPUs sharing a clock are grouped via related_cpus). Their
+ * scaling_cur_freq, scaling_max_freq and stats/time_in_state files stay
+ * open and are re-read with pread(fd, ..., 0), so a sample costs a few
+ * syscalls per policy instead of open/read/close per file.
+ *
+ * time_in_state lists "<kHz> <residency in 10ms units>"; the delta between
+ * samples gives the residency-weighted average frequency over the interval,
+ * which catches short throttling dips that a single cur_freq read misses.
+ * A lowered scaling_max_freq against cpuinfo_max_freq shows a thermal cap.
+ *
+ * Descriptors are reopened after a root change (replay, tests).
+ */
+
+#define CPUFREQ_MAX_POLICIES 8
+#define CPUFREQ_MAX_STATES 48
+
+/**
+ * One frequency domain (cluster).
+ */
+typedef struct {
+    int32_t first_cpu;
+    uint32_t cpu_mask;          // CPUs sharing this policy
+    uint32_t cur_khz;           // scaling_cur_freq now
+    uint32_t avg_khz;           // residency-weighted since the previous sample
+    uint32_t scaling_max_khz;   // current cap (lowered by thermal throttling)
+    uint32_t cpuinfo_max_khz;   // hardware maximum
+    int32_t online;             // 0 if scaling_cur_freq could not be read
+    int32_t has_residency;      // 0 if avg_khz is just cur_khz (no stats/ delta yet)
+} CpuFreqPolicy;
+
+/**
+ * Sample every policy (discovering them on first use).
+ * @return Number of policies written, 0 if the kernel has no cpufreq, or -1 on error
+ */
+int native_cpufreq_sample(CpuFreqPolicy* out, int max_count);
+
+/**
+ * Parse time_in_state text into parallel arrays.
+ * @return Number of states parsed
+ */
+int native_cpufreq_parse_time_in_state(const char* text, uint32_t* freqs_khz,
+                                       uint64_t* times, int max_states);
+
+/**
+ * Close all descriptors and forget discovered policies.
+ */
+void native_cpufreq_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_CPUFREQ_H
@@ -0,0 +1,390 @@
+#include "native_disk_stats.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_DISK"
+#include "native_platform.h"
+
+// Android boxes expose dozens of loop devices (APEX mounts); 16 KB covers ~130 lines
+#define DISKSTATS_BUFFER_SIZE 16384
+
+// Counter columns after "major minor name"
+#define DISKSTATS_COUNTERS 11
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static inline const char* skip_spaces(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static inline const char* parse_u64(const char* p, uint64_t* out) {
+    p = skip_spaces(p);
+    const char* start = p;
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool starts_with(const char* name, size_t len, const char* prefix) {
+    size_t prefix_len = strlen(prefix);
+    return len >= prefix_len && memcmp(name, prefix, prefix_len) == 0;
+}
+
+// Virtual layers whose I/O is already counted on the physical device
+static bool is_virtual_device(const char* name, size_t len) {
+    return starts_with(name, len, "loop") || starts_with(name, len, "ram") ||
+           starts_with(name, len, "zram") || starts_with(name, len, "dm-");
+}
+
+// Kernel partition naming: "<disk><n>", or "<disk>p<n>" when the disk name
+// ends in a digit (sda -> sda1, mmcblk0 -> mmcblk0p1, nvme0n1 -> nvme0n1p1).
+// Partitions are listed right after their disk, so the last disk suffices.
+static bool is_partition_of(const char* name, size_t len, const char* disk, size_t disk_len) {
+    if (disk_len == 0 || len <= disk_len || memcmp(name, disk, disk_len) != 0) return false;
+
+    const char* rest = name + disk_len;
+    size_t rest_len = len - disk_len;
+    if (is_digit(disk[disk_len - 1])) {
+        if (rest[0] != 'p') return false;
+        rest++;
+        rest_len--;
+    }
+    if (rest_len == 0) return false;
+
+    for (size_t i = 0; i < rest_len; i++) {
+        if (!is_digit(rest[i])) return false;
+    }
+    return true;
+}
+
+int native_parse_diskstats(const char* text, DiskStatsNative* stats, int max_count) {
+    if (!text || !stats || max_count <= 0) return 0;
+
+    int count = 0;
+    const char* disk = nullptr;
+    size_t disk_len = 0;
+
+    for (const char* p = text; *p && count < max_count;) {
+        const char* eol = strchr(p, '\n');
+        const char* next = eol ? eol + 1 : p + strlen(p);
+
+        uint64_t major, minor;
+        const char* cursor = parse_u64(p, &major);
+        if (cursor) cursor = parse_u64(cursor, &minor);
+        if (!cursor) {
+            p = next;
+            continue;
+        }
+
+        const char* name = skip_spaces(cursor);
+        const char* name_end = name;
+        while (*name_end && *name_end != ' ' && *name_end != '\t' && *name_end != '\n') name_end++;
+        size_t name_len = static_cast<size_t>(name_end - name);
+
+        uint64_t counters[DISKSTATS_COUNTERS];
+        cursor = name_end;
+        int parsed = 0;
+        while (parsed < DISKSTATS_COUNTERS && cursor &&
+               (cursor = parse_u64(cursor, &counters[parsed])) != nullptr) {
+            parsed++;
+        }
+
+        p = next;
+        if (name_len == 0 || parsed < DISKSTATS_COUNTERS) continue;
+        if (is_virtual_device(name, name_len)) continue;
+        if (is_partition_of(name, name_len, disk, disk_len)) continue;
+
+        disk = name;
+        disk_len = name_len;
+
+        // reads_completed == writes_completed == 0: an idle rpmb/boot area
+        if (counters[0] == 0 && counters[4] == 0) continue;
+
+        DiskStatsNative& out = stats[count++];
+        size_t copy_len = name_len < DISK_NAME_MAX - 1 ? name_len : DISK_NAME_MAX - 1;
+        memcpy(out.name, name, copy_len);
+        out.name[copy_len] = '\0';
+        out.major = static_cast<uint32_t>(major);
+        out.minor = static_cast<uint32_t>(minor);
+        out.reads_completed = counters[0];
+        out.sectors_read = counters[2];
+        out.read_time_ms = counters[3];
+        out.writes_completed = counters[4];
+        out.sectors_written = counters[6];
+        out.write_time_ms = counters[7];
+        out.in_flight = counters[8];
+        out.io_time_ms = counters[9];
+    }
+
+    return count;
+}
+
+static int read_diskstats_impl(DiskStatsNative* stats, int max_count) {
+    if (!stats || max_count <= 0) return -1;
+
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PROC_DISKSTATS) < 0) return -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // seq_file hands out at most a page per read()
+    char buffer[DISKSTATS_BUFFER_SIZE];
+    size_t used = 0;
+    ssize_t n;
+    while (used < sizeof(buffer) - 1 &&
+           (n = read(fd, buffer + used, sizeof(buffer) - 1 - used)) > 0) {
+        used += static_cast<size_t>(n);
+    }
+    close(fd);
+    if (used == 0) return -1;
+
+    // Drop a trailing partial line if the file outgrew the buffer
+    if (used == sizeof(buffer) - 1) {
+        while (used > 0 && buffer[used - 1] != '\n') used--;
+    }
+    buffer[used] = '\0';
+
+    return native_parse_diskstats(buffer, stats, max_count);
+}
+
+int native_read_diskstats(DiskStatsNative* stats, int max_count) {
+    NativeProbeScope probe(PROBE_READ_DISKSTATS);
+    return probe.check(read_diskstats_impl(stats, max_count));
+}
+
+// ============================================================================
+// Per-Device Rates
+// ============================================================================
+
+struct DiskSlot {
+    bool used;
+    uint32_t generation;
+    DiskStatsNative prev;
+    int64_t prev_ms;
+};
+
+static std::mutex g_disk_mutex;
+static DiskSlot g_disk_slots[DISK_MAX_DEVICES];
+static uint32_t g_disk_generation = 0;
+
+// Caller holds g_disk_mutex
+static DiskSlot* find_slot(const DiskStatsNative& dev) {
+    DiskSlot* free_slot = nullptr;
+    for (DiskSlot& slot : g_disk_slots) {
+        if (!slot.used) {
+            if (!free_slot) free_slot = &slot;
+            continue;
+        }
+        if (slot.prev.major == dev.major && slot.prev.minor == dev.minor) return &slot;
+    }
+    return free_slot;
+}
+
+static inline float per_second(uint64_t delta, int64_t dt_ms) {
+    return static_cast<float>(delta) * 1000.0f / static_cast<float>(dt_ms);
+}
+
+static bool counters_went_back(const DiskStatsNative& prev, const DiskStatsNative& cur) {
+    return cur.reads_completed < prev.reads_completed || cur.sectors_read < prev.sectors_read ||
+           cur.writes_completed < prev.writes_completed || cur.sectors_written < prev.sectors_written ||
+           cur.io_time_ms < prev.io_time_ms;
+}
+
+static void compute_rate(const DiskSlot& slot, const DiskStatsNative& cur, int64_t now,
+                         DiskRateNative* rate) {
+    memset(rate, 0, sizeof(DiskRateNative));
+    memcpy(rate->name, cur.name, sizeof(rate->name));
+    rate->in_flight = static_cast<uint32_t>(cur.in_flight);
+
+    int64_t dt_ms = now - slot.prev_ms;
+    if (!slot.used || dt_ms <= 0 || counters_went_back(slot.prev, cur)) return;
+
+    const DiskStatsNative& prev = slot.prev;
+    rate->read_bytes_per_sec = static_cast<uint64_t>(
+        (cur.sectors_read - prev.sectors_read) * DISK_SECTOR_SIZE * 1000 / static_cast<uint64_t>(dt_ms));
+    rate->write_bytes_per_sec = static_cast<uint64_t>(
+        (cur.sectors_written - prev.sectors_written) * DISK_SECTOR_SIZE * 1000 / static_cast<uint64_t>(dt_ms));
+    rate->read_iops = per_second(cur.reads_completed - prev.reads_completed, dt_ms);
+    rate->write_iops = per_second(cur.writes_completed - prev.writes_completed, dt_ms);
+
+    float busy = static_cast<float>(cur.io_time_ms - prev.io_time_ms) * 100.0f / static_cast<float>(dt_ms);
+    rate->utilization = busy > 100.0f ? 100.0f : busy;
+    rate->is_valid = 1;
+}
+
+int native_disk_sample(DiskRateNative* out, int max_count, DiskRateNative* total) {
+    if (!out || max_count <= 0) return -1;
+
+    DiskStatsNative devices[DISK_MAX_DEVICES];
+    int count = native_read_diskstats(devices, DISK_MAX_DEVICES);
+    if (count < 0) return -1;
+
+    int64_t now = native_clock_now_ms();
+    if (total) {
+        memset(total, 0, sizeof(DiskRateNative));
+        memcpy(total->name, "total", sizeof("total"));
+    }
+
+    std::lock_guard<std::mutex> lock(g_disk_mutex);
+    uint32_t generation = ++g_disk_generation;
+
+    int written = 0;
+    for (int i = 0; i < count; i++) {
+        DiskSlot* slot = find_slot(devices[i]);
+        if (!slot) continue;  // more devices than slots
+
+        DiskRateNative rate;
+        compute_rate(*slot, devices[i], now, &rate);
+
+        slot->used = true;
+        slot->generation = generation;
+        slot->prev = devices[i];
+        slot->prev_ms = now;
+
+        if (total && rate.is_valid) {
+            total->read_bytes_per_sec += rate.read_bytes_per_sec;
+            total->write_bytes_per_sec += rate.write_bytes_per_sec;
+            total->read_iops += rate.read_iops;
+            total->write_iops += rate.write_iops;
+            total->in_flight += rate.in_flight;
+            if (rate.utilization > total->utilization) total->utilization = rate.utilization;
+            total->is_valid = 1;
+        }
+        if (written < max_count) out[written++] = rate;
+    }
+
+    // Free slots of devices that went away (USB storage unplugged)
+    for (DiskSlot& slot : g_disk_slots) {
+        if (slot.used && slot.generation != generation) slot.used = false;
+    }
+
+    return written;
+}
+
+void native_disk_reset(void) {
+    std::lock_guard<std::mutex> lock(g_disk_mutex);
+    memset(g_disk_slots, 0, sizeof(g_disk_slots));
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+#define DISK_RATE_FIELDS 7
+
+// Device names of the last getDiskStats() result, guarded by g_disk_mutex
+static char g_jni_disk_names[DISK_MAX_DEVICES][DISK_NAME_MAX];
+static int g_jni_disk_count = 0;
+
+extern "C" {
+
+/**
+ * Returns [total, device...] with DISK_RATE_FIELDS values each:
+ * [readBytesPerSec, writeBytesPerSec, readIops, writeIops, utilization,
+ *  inFlight, isValid]. Device names come from getDiskNames() in the same order.
+ */
+JNIEXPORT jdoubleArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getDiskStats(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.getDiskStats", TRACE_CAT_JNI);
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    DiskRateNative total;
+    int count = native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+    if (count < 0) return nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(g_disk_mutex);
+        for (int i = 0; i < count; i++) {
+            memcpy(g_jni_disk_names[i], rates[i].name, DISK_NAME_MAX);
+        }
+        g_jni_disk_count = count;
+    }
+
+    jdouble values[(DISK_MAX_DEVICES + 1) * DISK_RATE_FIELDS];
+    jdouble* cursor = values;
+    for (int i = -1; i < count; i++) {
+        const DiskRateNative& rate = i < 0 ? total : rates[i];
+        *cursor++ = static_cast<jdouble>(rate.read_bytes_per_sec);
+        *cursor++ = static_cast<jdouble>(rate.write_bytes_per_sec);
+        *cursor++ = rate.read_iops;
+        *cursor++ = rate.write_iops;
+        *cursor++ = rate.utilization;
+        *cursor++ = static_cast<jdouble>(rate.in_flight);
+        *cursor++ = static_cast<jdouble>(rate.is_valid);
+    }
+
+    jsize size = static_cast<jsize>(cursor - values);
+    jdoubleArray result = env->NewDoubleArray(size);
+    if (result == nullptr) return nullptr;
+
+    env->SetDoubleArrayRegion(result, 0, size, values);
+    return result;
+}
+
+/**
+ * Device names of the last getDiskStats() result, in the same order.
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getDiskNames(JNIEnv* env, jobject thiz) {
+    char names[DISK_MAX_DEVICES][DISK_NAME_MAX];
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(g_disk_mutex);
+        count = g_jni_disk_count;
+        memcpy(names, g_jni_disk_names, sizeof(names));
+    }
+
+    jclass string_class = native_jni_string_class();
+    if (string_class == nullptr) return nullptr;
+
+    jobjectArray arr = env->NewObjectArray(count, string_class, nullptr);
+    if (arr == nullptr) return nullptr;
+
+    for (int i = 0; i < count; i++) {
+        jstring name = env->NewStringUTF(names[i]);
+        env->SetObjectArrayElement(arr, i, name);
+        env->DeleteLocalRef(name);
+    }
+    return arr;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_resetDiskBaseline(JNIEnv* env, jobject thiz) {
+    native_disk_reset();
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod DISK_STATS_METHODS[] = {
+    NATIVE_METHOD("getDiskStats", "()[D",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getDiskStats),
+    NATIVE_METHOD("getDiskNames", "()[Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getDiskNames),
+    NATIVE_METHOD("resetDiskBaseline", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_resetDiskBaseline),
+};
+const NativeMethodList NATIVE_DISK_STATS_JNI = NATIVE_METHOD_LIST(DISK_STATS_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,93 @@
+#ifndef SYSMETRICS_NATIVE_DISK_STATS_H
+#define SYSMETRICS_NATIVE_DISK_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE DISK STATS - Block-device I/O from /proc/diskstats
+ * ============================================================================
+ *
+ *     179  0 mmcblk0 20000 1500 4000000 30000 10000 2000 800000 50000 0 40000 80000 ...
+ *     maj min name   reads merged sectors ms  writes merged sectors ms inflight io_ms weighted
+ *
+ * The file is parsed in place (no strtok/sscanf copies). Only whole physical
+ * devices are kept: partitions (sda1, mmcblk0p2) would double-count their
+ * disk, and loop/ram/zram/dm devices are virtual layers over it. Devices
+ * that never did any I/O are skipped too.
+ *
+ * native_disk_sample() keeps one slot per device (keyed by major:minor) and
+ * turns consecutive snapshots into bytes/sec, IOPS and utilisation, where
+ * utilisation is the io_ticks delta: the share of the interval the device
+ * had at least one request in flight.
+ */
+
+#define DISK_MAX_DEVICES 16
+#define DISK_NAME_MAX 32
+#define DISK_SECTOR_SIZE 512
+
+/**
+ * Raw counters of one block device.
+ */
+typedef struct {
+    char name[DISK_NAME_MAX];
+    uint32_t major;
+    uint32_t minor;
+    uint64_t reads_completed;
+    uint64_t sectors_read;
+    uint64_t read_time_ms;
+    uint64_t writes_completed;
+    uint64_t sectors_written;
+    uint64_t write_time_ms;
+    uint64_t in_flight;
+    uint64_t io_time_ms;
+} DiskStatsNative;
+
+/**
+ * Rates of one device between two samples.
+ */
+typedef struct {
+    char name[DISK_NAME_MAX];
+    uint64_t read_bytes_per_sec;
+    uint64_t write_bytes_per_sec;
+    float read_iops;
+    float write_iops;
+    float utilization;  // 0-100 %
+    uint32_t in_flight;
+    int is_valid;       // 0 on a device's first sample
+} DiskRateNative;
+
+/**
+ * Parse /proc/diskstats text, keeping whole physical devices only.
+ * @return Number of devices written to stats
+ */
+int native_parse_diskstats(const char* text, DiskStatsNative* stats, int max_count);
+
+/**
+ * Read and parse /proc/diskstats.
+ * @return Number of devices, or -1 on error
+ */
+int native_read_diskstats(DiskStatsNative* stats, int max_count);
+
+/**
+ * Read /proc/diskstats and compute per-device rates against the previous
+ * call. total (optional) sums throughput/IOPS over valid devices and
+ * reports the busiest device's utilisation.
+ * @return Number of devices written to out, or -1 on error
+ */
+int native_disk_sample(DiskRateNative* out, int max_count, DiskRateNative* total);
+
+/**
+ * Forget all per-device baselines.
+ */
+void native_disk_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_DISK_STATS_H
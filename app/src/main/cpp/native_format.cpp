@@ -0,0 +1,220 @@
+#include "native_format.h"
+#include <cmath>
+#include <cstring>
+
+// ============================================================================
+// Tables
+// ============================================================================
+
+// "00" "01" ... "99": two digits per lookup halves the number of divisions
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t POW10[7] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL
+};
+
+#define MAX_DECIMALS 6
+
+// Largest magnitude accepted by native_fmt_put_fixed before clamping,
+// chosen so that value * 10^MAX_DECIMALS still fits comfortably in uint64_t.
+#define MAX_FIXED_MAGNITUDE 1.0e12
+
+static const char* const BINARY_UNITS[4] = { "B", "KB", "MB", "GB" };
+
+const FormatUnitSpec FORMAT_UNITS_SPEED = { { 0, 1, 2, 2 }, "/s" };
+const FormatUnitSpec FORMAT_UNITS_BYTES = { { 0, 1, 1, 2 }, "" };
+
+// ============================================================================
+// Writer Primitives
+// ============================================================================
+
+void native_fmt_init(FormatWriter* writer, char* buffer, int buffer_size) {
+    writer->buffer = buffer;
+    writer->capacity = (buffer && buffer_size > 0) ? buffer_size : 0;
+    writer->length = 0;
+}
+
+int native_fmt_finish(FormatWriter* writer) {
+    if (writer->capacity > 0) {
+        int32_t end = writer->length < writer->capacity - 1
+                          ? writer->length
+                          : writer->capacity - 1;
+        writer->buffer[end] = '\0';
+    }
+    return writer->length;
+}
+
+void native_fmt_put_char(FormatWriter* writer, char c) {
+    if (writer->length < writer->capacity - 1) {
+        writer->buffer[writer->length] = c;
+    }
+    writer->length++;
+}
+
+static void put_bytes(FormatWriter* writer, const char* data, int32_t len) {
+    int32_t room = writer->capacity - 1 - writer->length;
+    if (room > 0) {
+        memcpy(writer->buffer + writer->length, data, len < room ? len : room);
+    }
+    writer->length += len;
+}
+
+void native_fmt_put_str(FormatWriter* writer, const char* str) {
+    if (!str) return;
+    put_bytes(writer, str, static_cast<int32_t>(strlen(str)));
+}
+
+void native_fmt_put_u64(FormatWriter* writer, uint64_t value, int min_digits) {
+    char digits[24];
+    int pos = sizeof(digits);
+
+    while (value >= 100) {
+        uint32_t pair = static_cast<uint32_t>(value % 100) * 2;
+        value /= 100;
+        digits[--pos] = DIGIT_PAIRS[pair + 1];
+        digits[--pos] = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        uint32_t pair = static_cast<uint32_t>(value) * 2;
+        digits[--pos] = DIGIT_PAIRS[pair + 1];
+        digits[--pos] = DIGIT_PAIRS[pair];
+    } else {
+        digits[--pos] = static_cast<char>('0' + value);
+    }
+
+    if (min_digits > 20) min_digits = 20;
+    while (static_cast<int>(sizeof(digits)) - pos < min_digits) {
+        digits[--pos] = '0';
+    }
+
+    put_bytes(writer, digits + pos, static_cast<int32_t>(sizeof(digits)) - pos);
+}
+
+void native_fmt_put_i64(FormatWriter* writer, int64_t value) {
+    if (value < 0) {
+        native_fmt_put_char(writer, '-');
+        // Negate in unsigned space so INT64_MIN does not overflow
+        native_fmt_put_u64(writer, 0ULL - static_cast<uint64_t>(value), 1);
+    } else {
+        native_fmt_put_u64(writer, static_cast<uint64_t>(value), 1);
+    }
+}
+
+void native_fmt_put_fixed(FormatWriter* writer, double value, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > MAX_DECIMALS) decimals = MAX_DECIMALS;
+
+    if (std::isnan(value)) value = 0.0;
+
+    bool negative = value < 0.0;
+    double magnitude = negative ? -value : value;
+    if (magnitude > MAX_FIXED_MAGNITUDE) magnitude = MAX_FIXED_MAGNITUDE;
+
+    uint64_t scale = POW10[decimals];
+    uint64_t scaled = static_cast<uint64_t>(magnitude * static_cast<double>(scale) + 0.5);
+
+    if (negative && scaled != 0) {
+        native_fmt_put_char(writer, '-');
+    }
+
+    native_fmt_put_u64(writer, scaled / scale, 1);
+    if (decimals > 0) {
+        native_fmt_put_char(writer, '.');
+        native_fmt_put_u64(writer, scaled % scale, decimals);
+    }
+}
+
+void native_fmt_put_binary(FormatWriter* writer, uint64_t value, const FormatUnitSpec* spec) {
+    if (value < 1024) {
+        native_fmt_put_u64(writer, value, 1);
+        native_fmt_put_char(writer, ' ');
+        native_fmt_put_str(writer, BINARY_UNITS[0]);
+        native_fmt_put_str(writer, spec->suffix);
+        return;
+    }
+
+    // Largest unit the raw value reaches, capped at GB
+    int unit = 1;
+    while (unit < 3 && value >= (1ULL << (10 * (unit + 1)))) {
+        unit++;
+    }
+
+    uint64_t whole;
+    uint64_t frac;
+    int decimals;
+
+    for (;;) {
+        int shift = 10 * unit;
+        uint64_t divisor = 1ULL << shift;
+        decimals = spec->decimals[unit] > 3 ? 3 : spec->decimals[unit];
+        uint64_t scale = POW10[decimals];
+
+        // Split first so the rounding product stays below 2^40
+        whole = value >> shift;
+        uint64_t remainder = value & (divisor - 1);
+        frac = (remainder * scale + (divisor >> 1)) >> shift;
+        if (frac >= scale) {
+            whole++;
+            frac -= scale;
+        }
+
+        // 1023.96 KB rounds to 1024.0 KB; show it as 1.00 MB instead
+        if (whole >= 1024 && unit < 3) {
+            unit++;
+            continue;
+        }
+        break;
+    }
+
+    native_fmt_put_u64(writer, whole, 1);
+    if (decimals > 0) {
+        native_fmt_put_char(writer, '.');
+        native_fmt_put_u64(writer, frac, decimals);
+    }
+    native_fmt_put_char(writer, ' ');
+    native_fmt_put_str(writer, BINARY_UNITS[unit]);
+    native_fmt_put_str(writer, spec->suffix);
+}
+
+// ============================================================================
+// Composite Formatters
+// ============================================================================
+
+int native_fmt_speed(char* buffer, int buffer_size, const char* prefix, uint64_t bytes_per_sec) {
+    if (!buffer || buffer_size <= 0) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_str(&writer, prefix);
+    native_fmt_put_binary(&writer, bytes_per_sec, &FORMAT_UNITS_SPEED);
+    return native_fmt_finish(&writer);
+}
+
+int native_fmt_bytes(char* buffer, int buffer_size, uint64_t bytes) {
+    if (!buffer || buffer_size <= 0) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_binary(&writer, bytes, &FORMAT_UNITS_BYTES);
+    return native_fmt_finish(&writer);
+}
+
+int native_fmt_percent(char* buffer, int buffer_size, float percent) {
+    if (!buffer || buffer_size <= 0) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_fixed(&writer, percent, 1);
+    native_fmt_put_char(&writer, '%');
+    return native_fmt_finish(&writer);
+}
@@ -0,0 +1,111 @@
+#ifndef SYSMETRICS_NATIVE_FORMAT_H
+#define SYSMETRICS_NATIVE_FORMAT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE FORMAT KERNEL - Shared number formatting for all native formatters
+ * ============================================================================
+ *
+ * Every native format_* entry point routes through this kernel so that
+ * units, thresholds, spacing and rounding are defined in exactly one place.
+ *
+ * - Integer digit-pair table, no snprintf, no varargs, no locale
+ * - Fixed-point rounding (half away from zero) for fractional values
+ * - Binary unit ladder (B, KB, MB, GB) computed in 64-bit integers;
+ *   a value that rounds up to 1024 of a unit is promoted to the next unit
+ * - Never allocates; output is always NUL-terminated when buffer_size > 0
+ */
+
+/**
+ * Bounded output cursor over a caller-owned character buffer.
+ * `length` counts every character that would have been written, so a
+ * result >= buffer_size signals truncation exactly like snprintf.
+ */
+typedef struct {
+    char* buffer;
+    int32_t capacity;
+    int32_t length;
+} FormatWriter;
+
+/**
+ * Decimal places used for each step of the binary unit ladder.
+ * Index 0 is plain bytes and is always printed as an integer.
+ */
+typedef struct {
+    uint8_t decimals[4];  // B, KB, MB, GB
+    const char* suffix;   // Appended after the unit, e.g. "/s"
+} FormatUnitSpec;
+
+/** Unit spec for transfer rates: "512 B/s", "1.5 KB/s", "2.25 MB/s", "1.10 GB/s". */
+extern const FormatUnitSpec FORMAT_UNITS_SPEED;
+
+/** Unit spec for sizes: "512 B", "1.5 KB", "2.3 MB", "1.10 GB". */
+extern const FormatUnitSpec FORMAT_UNITS_BYTES;
+
+/**
+ * Begin writing into buffer. buffer may be NULL only when buffer_size is 0.
+ */
+void native_fmt_init(FormatWriter* writer, char* buffer, int buffer_size);
+
+/**
+ * Terminate the output.
+ * @return Number of characters the full output requires (excluding NUL)
+ */
+int native_fmt_finish(FormatWriter* writer);
+
+/** Append a NUL-terminated string (bytes copied verbatim, UTF-8 safe). */
+void native_fmt_put_str(FormatWriter* writer, const char* str);
+
+/** Append a single character. */
+void native_fmt_put_char(FormatWriter* writer, char c);
+
+/**
+ * Append an unsigned integer, left-padded with zeros to min_digits.
+ */
+void native_fmt_put_u64(FormatWriter* writer, uint64_t value, int min_digits);
+
+/** Append a signed integer. */
+void native_fmt_put_i64(FormatWriter* writer, int64_t value);
+
+/**
+ * Append a fixed-point decimal with the given number of places (0-6).
+ * Rounds half away from zero; NaN prints as 0, infinities are clamped.
+ * Negative values that round to zero print without a sign.
+ */
+void native_fmt_put_fixed(FormatWriter* writer, double value, int decimals);
+
+/**
+ * Append a byte count scaled to the largest fitting binary unit,
+ * separated from the unit by a single space, followed by spec->suffix.
+ */
+void native_fmt_put_binary(FormatWriter* writer, uint64_t value, const FormatUnitSpec* spec);
+
+/**
+ * Formats bytes per second with an optional prefix, e.g. "↓1.5 KB/s".
+ * @return Length of formatted string (snprintf semantics), or -1 on error
+ */
+int native_fmt_speed(char* buffer, int buffer_size, const char* prefix, uint64_t bytes_per_sec);
+
+/**
+ * Formats a byte count, e.g. "2.3 MB".
+ * @return Length of formatted string (snprintf semantics), or -1 on error
+ */
+int native_fmt_bytes(char* buffer, int buffer_size, uint64_t bytes);
+
+/**
+ * Formats a percentage with one decimal place, e.g. "42.5%".
+ * @return Length of formatted string (snprintf semantics), or -1 on error
+ */
+int native_fmt_percent(char* buffer, int buffer_size, float percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_FORMAT_H
@@ -0,0 +1,404 @@
+#include "native_frames.h"
+#include "native_instrument.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <unordered_map>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_FRAMES"
+#include "native_platform.h"
+
+// ============================================================================
+// Histogram Layout
+// ============================================================================
+
+// Log-linear buckets over microseconds: values below 32 us are exact, above
+// that every power of two is split into 32 equal sub-buckets
+#define FRAME_HIST_SUB_BITS 5
+#define FRAME_HIST_SUB_COUNT (1 << FRAME_HIST_SUB_BITS)
+#define FRAME_HIST_MAX_MSB 20  // 2^21 us (~2 s), above FRAME_GAP_MS
+#define FRAME_HIST_BUCKETS ((FRAME_HIST_MAX_MSB - FRAME_HIST_SUB_BITS + 2) * FRAME_HIST_SUB_COUNT)
+
+static inline int bucket_index(uint32_t us) {
+    if (us < FRAME_HIST_SUB_COUNT) return static_cast<int>(us);
+
+    int msb = 31 - __builtin_clz(us);
+    if (msb > FRAME_HIST_MAX_MSB) return FRAME_HIST_BUCKETS - 1;
+
+    int group = msb - FRAME_HIST_SUB_BITS + 1;
+    int sub = static_cast<int>((us >> (msb - FRAME_HIST_SUB_BITS)) & (FRAME_HIST_SUB_COUNT - 1));
+    return (group << FRAME_HIST_SUB_BITS) + sub;
+}
+
+// Representative value of a bucket: its midpoint
+static double bucket_value(int index) {
+    int group = index >> FRAME_HIST_SUB_BITS;
+    int sub = index & (FRAME_HIST_SUB_COUNT - 1);
+    if (group == 0) return sub;
+
+    double lower = static_cast<double>(static_cast<uint32_t>(FRAME_HIST_SUB_COUNT + sub) << (group - 1));
+    double width = static_cast<double>(1u << (group - 1));
+    return lower + width / 2;
+}
+
+// ============================================================================
+// Frame Timer
+// ============================================================================
+
+struct FrameTimer {
+    std::mutex mutex;
+    float refresh_hz;
+    double period_us;
+    int64_t window_us;
+
+    bool has_last;
+    int64_t last_ts_ns;
+
+    // Window ring, oldest at head
+    uint32_t duration_us[FRAME_RING_CAPACITY];
+    uint16_t missed[FRAME_RING_CAPACITY];
+    int32_t head;
+    int32_t count;
+
+    // Aggregates of the frames in the ring
+    int64_t window_sum_us;
+    int32_t jank_frames;
+    int32_t missed_vsyncs;
+    uint32_t histogram[FRAME_HIST_BUCKETS];
+
+    int64_t total_frames;
+    int64_t total_jank;
+};
+
+static std::shared_mutex g_frames_mutex;
+static std::unordered_map<int64_t, FrameTimer*> g_frames;
+static int64_t g_next_frames = 1;
+
+static bool refresh_valid(float hz) {
+    return hz >= FRAME_REFRESH_MIN_HZ && hz <= FRAME_REFRESH_MAX_HZ;
+}
+
+static void clear_window(FrameTimer* t) {
+    t->head = 0;
+    t->count = 0;
+    t->window_sum_us = 0;
+    t->jank_frames = 0;
+    t->missed_vsyncs = 0;
+    memset(t->histogram, 0, sizeof(t->histogram));
+}
+
+static void evict_oldest(FrameTimer* t) {
+    uint32_t duration = t->duration_us[t->head];
+    uint16_t missed = t->missed[t->head];
+    t->histogram[bucket_index(duration)]--;
+    t->window_sum_us -= duration;
+    if (missed > 0) t->jank_frames--;
+    t->missed_vsyncs -= missed;
+    t->head = (t->head + 1) % FRAME_RING_CAPACITY;
+    t->count--;
+}
+
+static void record_frame(FrameTimer* t, uint32_t duration) {
+    // A frame spanning n vsync periods missed n - 1 of them
+    int64_t periods = static_cast<int64_t>(duration / t->period_us + 0.5);
+    uint16_t missed = static_cast<uint16_t>(std::min<int64_t>(std::max<int64_t>(periods - 1, 0), UINT16_MAX));
+
+    if (t->count == FRAME_RING_CAPACITY) evict_oldest(t);
+    int32_t slot = (t->head + t->count) % FRAME_RING_CAPACITY;
+    t->duration_us[slot] = duration;
+    t->missed[slot] = missed;
+    t->count++;
+
+    t->histogram[bucket_index(duration)]++;
+    t->window_sum_us += duration;
+    if (missed > 0) {
+        t->jank_frames++;
+        t->total_jank++;
+    }
+    t->missed_vsyncs += missed;
+    t->total_frames++;
+
+    // Keep the newest frame even if it alone is longer than the window
+    while (t->count > 1 && t->window_sum_us > t->window_us) evict_oldest(t);
+}
+
+static FrameTimer* find_timer(int64_t handle) {
+    auto it = g_frames.find(handle);
+    return it == g_frames.end() ? nullptr : it->second;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+int64_t native_frames_create(float refresh_hz, int64_t window_ms) {
+    if (!refresh_valid(refresh_hz)) return 0;
+
+    FrameTimer* t = new (std::nothrow) FrameTimer();
+    if (!t) return 0;
+    t->refresh_hz = refresh_hz;
+    t->period_us = 1e6 / refresh_hz;
+    t->window_us = (window_ms > 0 ? window_ms : FRAME_WINDOW_DEFAULT_MS) * 1000;
+    t->has_last = false;
+    t->last_ts_ns = 0;
+    t->total_frames = 0;
+    t->total_jank = 0;
+    clear_window(t);
+
+    std::unique_lock<std::shared_mutex> lock(g_frames_mutex);
+    int64_t handle = g_next_frames++;
+    g_frames[handle] = t;
+    return handle;
+}
+
+void native_frames_destroy(int64_t handle) {
+    std::unique_lock<std::shared_mutex> lock(g_frames_mutex);
+    auto it = g_frames.find(handle);
+    if (it == g_frames.end()) return;
+    delete it->second;
+    g_frames.erase(it);
+}
+
+static int32_t frames_add_impl(int64_t handle, const int64_t* timestamps_ns, int32_t count) {
+    std::shared_lock<std::shared_mutex> lock(g_frames_mutex);
+    FrameTimer* t = find_timer(handle);
+    if (!t) return -1;
+    if (!timestamps_ns || count <= 0) return 0;
+
+    std::lock_guard<std::mutex> frame_lock(t->mutex);
+    const int64_t gap_ns = static_cast<int64_t>(FRAME_GAP_MS) * 1000000;
+    int32_t recorded = 0;
+    for (int32_t i = 0; i < count; i++) {
+        int64_t ts = timestamps_ns[i];
+        if (t->has_last) {
+            int64_t delta = ts - t->last_ts_ns;
+            if (delta <= 0) continue;
+            if (delta < gap_ns) {
+                record_frame(t, static_cast<uint32_t>(delta / 1000));
+                recorded++;
+            }
+        }
+        t->has_last = true;
+        t->last_ts_ns = ts;
+    }
+    return recorded;
+}
+
+int32_t native_frames_add(int64_t handle, const int64_t* timestamps_ns, int32_t count) {
+    NativeProbeScope probe(PROBE_FRAMES_ADD);
+    return probe.check(frames_add_impl(handle, timestamps_ns, count));
+}
+
+int native_frames_set_refresh_rate(int64_t handle, float refresh_hz) {
+    if (!refresh_valid(refresh_hz)) return -1;
+    std::shared_lock<std::shared_mutex> lock(g_frames_mutex);
+    FrameTimer* t = find_timer(handle);
+    if (!t) return -1;
+
+    std::lock_guard<std::mutex> frame_lock(t->mutex);
+    if (t->refresh_hz != refresh_hz) {
+        t->refresh_hz = refresh_hz;
+        t->period_us = 1e6 / refresh_hz;
+        clear_window(t);
+    }
+    return 0;
+}
+
+// Statistics from a locked timer
+static void compute_stats(const FrameTimer* t, FrameStats* out) {
+    memset(out, 0, sizeof(FrameStats));
+    out->total_frames = t->total_frames;
+    out->total_jank = t->total_jank;
+    out->frames = t->count;
+    out->jank_frames = t->jank_frames;
+    out->missed_vsyncs = t->missed_vsyncs;
+    out->refresh_hz = t->refresh_hz;
+    if (t->count == 0) return;
+
+    // Newest frames back to one second, and the exact maximum
+    int64_t recent_us = 0;
+    int32_t recent = 0;
+    uint32_t max_us = 0;
+    for (int32_t i = t->count - 1; i >= 0; i--) {
+        uint32_t duration = t->duration_us[(t->head + i) % FRAME_RING_CAPACITY];
+        if (recent_us < 1000000) {
+            recent_us += duration;
+            recent++;
+        }
+        max_us = std::max(max_us, duration);
+    }
+    if (recent_us > 0) out->fps_current = static_cast<float>(recent * 1e6 / recent_us);
+    if (t->window_sum_us > 0) out->fps_average = static_cast<float>(t->count * 1e6 / t->window_sum_us);
+    out->max_ms = max_us / 1000.0f;
+
+    // Percentiles: first bucket whose cumulative count reaches the rank
+    const int32_t percentiles[3] = { 50, 90, 99 };
+    float* targets[3] = { &out->p50_ms, &out->p90_ms, &out->p99_ms };
+    int next = 0;
+    int64_t cumulative = 0;
+    for (int i = 0; i < FRAME_HIST_BUCKETS && next < 3; i++) {
+        cumulative += t->histogram[i];
+        while (next < 3 && cumulative * 100 >= static_cast<int64_t>(t->count) * percentiles[next]) {
+            *targets[next] = static_cast<float>(std::min(bucket_value(i), static_cast<double>(max_us)) / 1000.0);
+            next++;
+        }
+    }
+
+    // 1% low: mean duration of the slowest 1% (at least one frame)
+    int32_t wanted = std::max(1, (t->count + 99) / 100);
+    int32_t taken = 0;
+    double slow_us = 0.0;
+    for (int i = FRAME_HIST_BUCKETS - 1; i >= 0 && taken < wanted; i--) {
+        int32_t take = std::min(static_cast<int32_t>(t->histogram[i]), wanted - taken);
+        slow_us += take * std::min(bucket_value(i), static_cast<double>(max_us));
+        taken += take;
+    }
+    if (slow_us > 0.0) out->fps_low_1pct = static_cast<float>(taken * 1e6 / slow_us);
+}
+
+static int frames_get_stats_impl(int64_t handle, FrameStats* out) {
+    if (!out) return -1;
+    std::shared_lock<std::shared_mutex> lock(g_frames_mutex);
+    FrameTimer* t = find_timer(handle);
+    if (!t) {
+        memset(out, 0, sizeof(FrameStats));
+        return -1;
+    }
+    std::lock_guard<std::mutex> frame_lock(t->mutex);
+    compute_stats(t, out);
+    return 0;
+}
+
+int native_frames_get_stats(int64_t handle, FrameStats* out) {
+    NativeProbeScope probe(PROBE_FRAMES_GET_STATS);
+    return probe.check(frames_get_stats_impl(handle, out));
+}
+
+int32_t native_frames_get_stats_into(int64_t handle, void* out, int32_t out_size) {
+    if (!out || out_size < FRAME_OUT_SIZE) return -1;
+
+    FrameStats stats;
+    int rc = native_frames_get_stats(handle, &stats);
+
+    int64_t totals[2] = { stats.total_frames, stats.total_jank };
+    int32_t counts[3] = { stats.frames, stats.jank_frames, stats.missed_vsyncs };
+    float values[8] = {
+        stats.fps_current, stats.fps_average, stats.fps_low_1pct,
+        stats.p50_ms, stats.p90_ms, stats.p99_ms, stats.max_ms, stats.refresh_hz
+    };
+
+    uint8_t* bytes = static_cast<uint8_t*>(out);
+    memset(bytes, 0, FRAME_OUT_SIZE);
+    memcpy(bytes + FRAME_OUT_TOTALS, totals, sizeof(totals));
+    memcpy(bytes + FRAME_OUT_COUNTS, counts, sizeof(counts));
+    memcpy(bytes + FRAME_OUT_VALUES, values, sizeof(values));
+    return rc == 0 ? FRAME_OUT_SIZE : -1;
+}
+
+void native_frames_reset(int64_t handle) {
+    NativeTraceScope trace("native_frames_reset", TRACE_CAT_ANALYTICS);
+    std::shared_lock<std::shared_mutex> lock(g_frames_mutex);
+    FrameTimer* t = find_timer(handle);
+    if (!t) return;
+
+    std::lock_guard<std::mutex> frame_lock(t->mutex);
+    t->has_last = false;
+    t->last_ts_ns = 0;
+    t->total_frames = 0;
+    t->total_jank = 0;
+    clear_window(t);
+}
+
+#ifndef SYSMETRICS_NO_JNI
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesCreate(
+        JNIEnv* env, jclass clazz, jfloat refreshHz, jlong windowMs) {
+    NativeTraceScope trace("NativeAnalytics.framesCreate", TRACE_CAT_JNI);
+    return native_frames_create(refreshHz, windowMs);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesDestroy(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.framesDestroy", TRACE_CAT_JNI);
+    native_frames_destroy(handle);
+}
+
+/**
+ * Ingest the first count timestamps (int64 ns, native order) of a direct buffer.
+ * Returns the frames recorded, or -1 on an unknown handle or bad buffer.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesAdd(
+        JNIEnv* env, jclass clazz, jlong handle, jobject batch, jint count) {
+    NativeTraceScope trace("NativeAnalytics.framesAdd", TRACE_CAT_JNI);
+    void* address = batch ? env->GetDirectBufferAddress(batch) : nullptr;
+    if (!address || count < 0) return -1;
+
+    jlong capacity = env->GetDirectBufferCapacity(batch) / static_cast<jlong>(sizeof(int64_t));
+    int32_t n = static_cast<int32_t>(std::min<jlong>(count, capacity));
+    return native_frames_add(handle, static_cast<const int64_t*>(address), n);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesSetRefreshRate(
+        JNIEnv* env, jclass clazz, jlong handle, jfloat refreshHz) {
+    NativeTraceScope trace("NativeAnalytics.framesSetRefreshRate", TRACE_CAT_JNI);
+    return native_frames_set_refresh_rate(handle, refreshHz) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesGetStatsInto(
+        JNIEnv* env, jclass clazz, jlong handle, jobject out) {
+    NativeTraceScope trace("NativeAnalytics.framesGetStatsInto", TRACE_CAT_JNI);
+    void* address = out ? env->GetDirectBufferAddress(out) : nullptr;
+    if (!address) return JNI_FALSE;
+
+    jlong capacity = std::min<jlong>(env->GetDirectBufferCapacity(out), FRAME_OUT_SIZE);
+    return native_frames_get_stats_into(handle, address, static_cast<int32_t>(capacity)) == FRAME_OUT_SIZE
+           ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesReset(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativeAnalytics.framesReset", TRACE_CAT_JNI);
+    native_frames_reset(handle);
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod FRAMES_METHODS[] = {
+    NATIVE_METHOD("framesCreate", "(FJ)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesCreate),
+    NATIVE_METHOD("framesDestroy", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesDestroy),
+    NATIVE_METHOD("framesAdd", "(JLjava/nio/ByteBuffer;I)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesAdd),
+    NATIVE_METHOD("framesSetRefreshRate", "(JF)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesSetRefreshRate),
+    NATIVE_METHOD("framesGetStatsInto", "(JLjava/nio/ByteBuffer;)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesGetStatsInto),
+    NATIVE_METHOD("framesReset", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_framesReset),
+};
+const NativeMethodList NATIVE_FRAMES_JNI = NATIVE_METHOD_LIST(FRAMES_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,103 @@
+#ifndef SYSMETRICS_NATIVE_FRAMES_H
+#define SYSMETRICS_NATIVE_FRAMES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE FRAMES - Frame-time analytics for the Choreographer FPS monitor
+ * ============================================================================
+ *
+ * The monitor stores each vsync timestamp (Choreographer frameTimeNanos)
+ * into a batch and hands the batch over about once a second. Ingesting a
+ * frame is O(1): its duration goes into a ring covering the window and a
+ * log-bucketed histogram of the same frames (32 sub-buckets per power of
+ * two microseconds, under 2% error around 16 ms). Statistics are computed
+ * on demand from the histogram and the ring.
+ *
+ * Jank is counted in missed vsyncs for the configured refresh rate: a
+ * frame lasting round(duration / period) periods missed all but one of
+ * them. A gap of FRAME_GAP_MS or more (callbacks paused, app in the
+ * background) starts a new run instead of counting as one long frame.
+ *
+ * 1% low FPS is the frame rate over the slowest 1% of frames in the
+ * window, i.e. 1000 / mean of their durations in ms.
+ */
+
+#define FRAME_RING_CAPACITY 8192           // Frames kept; 68 s at 120 Hz
+#define FRAME_WINDOW_DEFAULT_MS 60000
+#define FRAME_GAP_MS 1000
+#define FRAME_REFRESH_MIN_HZ 1.0f
+#define FRAME_REFRESH_MAX_HZ 500.0f
+
+typedef struct {
+    int64_t total_frames;     // Since create/reset, including evicted ones
+    int64_t total_jank;       // Janky frames since create/reset
+    int32_t frames;           // Frames in the window
+    int32_t jank_frames;      // Frames in the window that missed a vsync
+    int32_t missed_vsyncs;    // Vsyncs missed in the window
+    float fps_current;        // Over the last second of frames
+    float fps_average;        // Over the window
+    float fps_low_1pct;
+    float p50_ms;
+    float p90_ms;
+    float p99_ms;
+    float max_ms;
+    float refresh_hz;
+} FrameStats;
+
+// Layout of native_frames_get_stats_into (native byte order)
+#define FRAME_OUT_TOTALS     0   // 2 int64: total_frames, total_jank
+#define FRAME_OUT_COUNTS     16  // 3 int32: frames, jank_frames, missed_vsyncs
+#define FRAME_OUT_VALUES     28  // 8 floats: fps_current .. refresh_hz, FrameStats order
+#define FRAME_OUT_SIZE       64
+
+/**
+ * Create a frame timer.
+ * @param refresh_hz Display refresh rate (FRAME_REFRESH_MIN_HZ..MAX_HZ)
+ * @param window_ms Statistics window, <= 0 for FRAME_WINDOW_DEFAULT_MS
+ * @return Handle, or 0 on invalid arguments
+ */
+int64_t native_frames_create(float refresh_hz, int64_t window_ms);
+
+void native_frames_destroy(int64_t handle);
+
+/**
+ * Ingest vsync timestamps (ns, oldest first). Timestamps that do not move
+ * forward are skipped.
+ * @return Frame durations recorded, or -1 on an unknown handle
+ */
+int32_t native_frames_add(int64_t handle, const int64_t* timestamps_ns, int32_t count);
+
+/**
+ * Change the refresh rate (e.g. display mode switch). Clears the window,
+ * whose jank was counted against the old period, and keeps the totals.
+ * @return 0 on success, -1 on unknown handle or out-of-range rate
+ */
+int native_frames_set_refresh_rate(int64_t handle, float refresh_hz);
+
+/**
+ * @return 0 on success, -1 on unknown handle (out zeroed)
+ */
+int native_frames_get_stats(int64_t handle, FrameStats* out);
+
+/**
+ * Write native_frames_get_stats() into out using the FRAME_OUT_* layout.
+ * @return FRAME_OUT_SIZE, or -1 if out is too small or the handle is unknown
+ */
+int32_t native_frames_get_stats_into(int64_t handle, void* out, int32_t out_size);
+
+/**
+ * Forget all frames, totals and the last timestamp.
+ */
+void native_frames_reset(int64_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_FRAMES_H
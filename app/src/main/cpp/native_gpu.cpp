@@ -0,0 +1,274 @@
+#include "native_gpu.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_GPU"
+#include "native_platform.h"
+
+#define GPU_VALUE_BUFFER 64
+
+struct GpuState {
+    int32_t vendor;
+    int busy_fd;
+    int clock_fd;
+    int temp_fd;
+    bool temp_is_zone;     // thermal zone temp (always millidegrees)
+    bool has_previous;     // Adreno busy/total baseline
+    uint64_t prev_busy;
+    uint64_t prev_total;
+};
+
+static std::mutex g_gpu_mutex;
+static GpuState g_gpu = { GPU_VENDOR_NONE, -1, -1, -1, false, false, 0, 0 };
+static bool g_detected = false;
+static uint32_t g_detected_generation = 0;
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static const char* parse_u64(const char* p, uint64_t* out) {
+    while (*p == ' ' || *p == '\t') p++;
+    const char* start = p;
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+int native_gpu_parse_busy(const char* text, uint64_t* busy, uint64_t* total) {
+    if (!text || !busy || !total) return -1;
+
+    const char* cursor = parse_u64(text, busy);
+    if (!cursor || !parse_u64(cursor, total)) return -1;
+    return 0;
+}
+
+// ============================================================================
+// Descriptors
+// ============================================================================
+
+static int open_node(const char* abs_path) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), abs_path) < 0) return -1;
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+// sysfs regenerates the attribute on every read at offset 0
+static ssize_t pread_text(int fd, char* buffer, size_t size) {
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buffer, size - 1, 0);
+    if (n < 0) return -1;
+    buffer[n] = '\0';
+    return n;
+}
+
+static bool pread_float(int fd, float* out) {
+    char buffer[GPU_VALUE_BUFFER];
+    if (pread_text(fd, buffer, sizeof(buffer)) <= 0) return false;
+
+    char* end;
+    float value = strtof(buffer, &end);
+    if (end == buffer) return false;
+    *out = value;
+    return true;
+}
+
+// First thermal zone whose type mentions "gpu"; -1 if none
+static int open_gpu_thermal_zone() {
+    for (int zone = 0; zone < MAX_THERMAL_ZONES; zone++) {
+        char path[NATIVE_PATH_MAX];
+        if (native_path_thermal(path, sizeof(path), zone, "type") < 0) continue;
+
+        int type_fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (type_fd < 0) continue;
+        char type[GPU_VALUE_BUFFER];
+        bool is_gpu = pread_text(type_fd, type, sizeof(type)) > 0 && strstr(type, "gpu") != nullptr;
+        close(type_fd);
+        if (!is_gpu) continue;
+
+        if (native_path_thermal(path, sizeof(path), zone, "temp") < 0) continue;
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) return fd;
+    }
+    return -1;
+}
+
+// Caller holds g_gpu_mutex
+static void close_nodes() {
+    if (g_gpu.busy_fd >= 0) close(g_gpu.busy_fd);
+    if (g_gpu.clock_fd >= 0) close(g_gpu.clock_fd);
+    if (g_gpu.temp_fd >= 0) close(g_gpu.temp_fd);
+    g_gpu.busy_fd = g_gpu.clock_fd = g_gpu.temp_fd = -1;
+    g_gpu.vendor = GPU_VENDOR_NONE;
+    g_detected = false;
+}
+
+// Caller holds g_gpu_mutex. The Adreno baseline survives a reopen on the
+// same vendor so replay steps still produce deltas.
+static void detect_gpu() {
+    const int32_t previous_vendor = g_gpu.vendor;
+    close_nodes();
+
+    int fd;
+    if ((fd = open_node(SYS_KGSL_GPU "/gpubusy")) >= 0) {
+        g_gpu.vendor = GPU_VENDOR_ADRENO;
+        g_gpu.busy_fd = fd;
+        g_gpu.clock_fd = open_node(SYS_KGSL_GPU "/gpuclk");
+        g_gpu.temp_fd = open_node(SYS_KGSL_GPU "/temp");
+    } else if ((fd = open_node(SYS_MALI_GPU "/utilization")) >= 0) {
+        g_gpu.vendor = GPU_VENDOR_MALI;
+        g_gpu.busy_fd = fd;
+        g_gpu.clock_fd = open_node(SYS_MALI_GPU "/clock");
+    } else if ((fd = open_node(SYS_DRI_GPU_USAGE)) >= 0) {
+        g_gpu.vendor = GPU_VENDOR_GENERIC;
+        g_gpu.busy_fd = fd;
+    }
+
+    g_gpu.temp_is_zone = false;
+    if (g_gpu.vendor != GPU_VENDOR_NONE && g_gpu.temp_fd < 0) {
+        g_gpu.temp_fd = open_gpu_thermal_zone();
+        g_gpu.temp_is_zone = g_gpu.temp_fd >= 0;
+    }
+    if (g_gpu.vendor != previous_vendor) g_gpu.has_previous = false;
+
+    g_detected = true;
+    g_detected_generation = native_paths_generation();
+    LOGI("Detected GPU vendor %d", g_gpu.vendor);
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+static bool sample_adreno_busy(float* usage) {
+    char buffer[GPU_VALUE_BUFFER];
+    uint64_t busy, total;
+    if (pread_text(g_gpu.busy_fd, buffer, sizeof(buffer)) <= 0) return false;
+    if (native_gpu_parse_busy(buffer, &busy, &total) != 0) return false;
+
+    uint64_t busy_delta = busy;
+    uint64_t total_delta = total;
+    if (g_gpu.has_previous && total > g_gpu.prev_total && busy >= g_gpu.prev_busy) {
+        busy_delta = busy - g_gpu.prev_busy;
+        total_delta = total - g_gpu.prev_total;
+    }
+    g_gpu.prev_busy = busy;
+    g_gpu.prev_total = total;
+    g_gpu.has_previous = true;
+
+    *usage = total_delta > 0 ? 100.0f * static_cast<float>(busy_delta) / static_cast<float>(total_delta)
+                             : 0.0f;
+    return true;
+}
+
+static float clamp_percent(float value) {
+    return value < 0.0f ? 0.0f : (value > 100.0f ? 100.0f : value);
+}
+
+static int gpu_sample_impl(GpuSample* out) {
+    if (!out) return -1;
+
+    std::lock_guard<std::mutex> lock(g_gpu_mutex);
+    if (!g_detected || g_detected_generation != native_paths_generation()) {
+        detect_gpu();
+    }
+
+    memset(out, 0, sizeof(GpuSample));
+    out->vendor = g_gpu.vendor;
+    if (g_gpu.vendor == GPU_VENDOR_NONE) return -1;
+
+    float usage = 0.0f;
+    bool has_usage = g_gpu.vendor == GPU_VENDOR_ADRENO ? sample_adreno_busy(&usage)
+                                                       : pread_float(g_gpu.busy_fd, &usage);
+    out->has_usage = has_usage ? 1 : 0;
+    out->usage_percent = has_usage ? clamp_percent(usage) : 0.0f;
+
+    // Clock nodes report Hz; a few Mali drivers report MHz
+    float clock;
+    if (pread_float(g_gpu.clock_fd, &clock) && clock > 0.0f) {
+        out->freq_mhz = static_cast<int32_t>(clock >= 1000000.0f ? clock / 1000000.0f : clock);
+    }
+
+    // Thermal zones are millidegrees; kgsl temp is either
+    float temp;
+    if (pread_float(g_gpu.temp_fd, &temp)) {
+        if (g_gpu.temp_is_zone || temp > 1000.0f) temp /= 1000.0f;
+        if (temp > 0.0f && temp < 150.0f) out->temp_celsius = temp;
+    }
+    return 0;
+}
+
+int native_gpu_sample(GpuSample* out) {
+    NativeProbeScope probe(PROBE_READ_GPU);
+    return probe.check(gpu_sample_impl(out));
+}
+
+int native_gpu_vendor(void) {
+    std::lock_guard<std::mutex> lock(g_gpu_mutex);
+    return g_gpu.vendor;
+}
+
+void native_gpu_close(void) {
+    std::lock_guard<std::mutex> lock(g_gpu_mutex);
+    close_nodes();
+    g_gpu.has_previous = false;
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+#define GPU_FIELDS 5
+
+extern "C" {
+
+/**
+ * Returns [vendor, usagePercent, freqMhz, tempCelsius, hasUsage],
+ * or null if no supported GPU node exists
+ */
+JNIEXPORT jfloatArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getGpuSample(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.getGpuSample", TRACE_CAT_JNI);
+    GpuSample sample;
+    if (native_gpu_sample(&sample) != 0) return nullptr;
+
+    jfloat values[GPU_FIELDS] = {
+        static_cast<jfloat>(sample.vendor),
+        sample.usage_percent,
+        static_cast<jfloat>(sample.freq_mhz),
+        sample.temp_celsius,
+        static_cast<jfloat>(sample.has_usage),
+    };
+
+    jfloatArray result = env->NewFloatArray(GPU_FIELDS);
+    if (result == nullptr) return nullptr;
+
+    env->SetFloatArrayRegion(result, 0, GPU_FIELDS, values);
+    return result;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod GPU_METHODS[] = {
+    NATIVE_METHOD("getGpuSample", "()[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getGpuSample),
+};
+const NativeMethodList NATIVE_GPU_JNI = NATIVE_METHOD_LIST(GPU_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,76 @@
+#ifndef SYSMETRICS_NATIVE_GPU_H
+#define SYSMETRICS_NATIVE_GPU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE GPU - Load, clock and temperature from vendor sysfs nodes
+ * ============================================================================
+ *
+ * The vendor is detected once by probing, in order:
+ *
+ * - Adreno:  /sys/class/kgsl/kgsl-3d0/{gpubusy,gpuclk,temp}
+ * - Mali:    /sys/devices/platform/mali/{utilization,clock}
+ * - Generic: /sys/kernel/debug/dri/0/gpu_usage
+ *
+ * The busy, clock and temperature files found then stay open and are
+ * re-read with pread(fd, ..., 0). Without a vendor temperature node the
+ * first thermal zone whose type mentions "gpu" is used, again found once.
+ *
+ * Adreno's gpubusy is a "busy total" pair. Load is the busy delta over the
+ * total delta between samples; kernels that report only the last window
+ * (total stays put or goes backwards) fall back to the pair itself.
+ *
+ * Detection is redone after a root change (replay, tests).
+ */
+
+typedef enum {
+    GPU_VENDOR_NONE = 0,
+    GPU_VENDOR_ADRENO,
+    GPU_VENDOR_MALI,
+    GPU_VENDOR_GENERIC
+} GpuVendorNative;
+
+/**
+ * One GPU sample.
+ */
+typedef struct {
+    int32_t vendor;          // GpuVendorNative
+    float usage_percent;     // 0-100
+    int32_t freq_mhz;        // 0 without a clock node
+    float temp_celsius;      // 0 without a sensor
+    int32_t has_usage;       // 0 if the busy node could not be read
+} GpuSample;
+
+/**
+ * Sample the detected GPU (detecting it on first use).
+ * @return 0 on success, -1 if no supported GPU node exists
+ */
+int native_gpu_sample(GpuSample* out);
+
+/**
+ * Parse Adreno gpubusy text ("busy total").
+ * @return 0 on success, -1 on malformed text
+ */
+int native_gpu_parse_busy(const char* text, uint64_t* busy, uint64_t* total);
+
+/**
+ * Vendor found by the last detection (GPU_VENDOR_NONE before the first sample).
+ */
+int native_gpu_vendor(void);
+
+/**
+ * Close all descriptors and forget the detected vendor.
+ */
+void native_gpu_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_GPU_H
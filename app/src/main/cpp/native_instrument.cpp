@@ -0,0 +1,308 @@
+#include "native_instrument.h"
+#include <cstring>
+#include <time.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+// ============================================================================
+// Histogram Layout
+// ============================================================================
+
+// Log-linear buckets: values below 8 ns are exact, above that every power
+// of two is split into 8 equal sub-buckets.
+#define HIST_SUB_BITS 3
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_MAX_MSB 36  // 2^37 ns (~137 s); anything slower lands in the last bucket
+#define HIST_BUCKETS ((HIST_MAX_MSB - HIST_SUB_BITS + 2) * HIST_SUB_COUNT)
+
+#define PROBE_ALIGN 64
+
+struct ProbeInfo {
+    const char* name;
+    const char* category;
+};
+
+static const ProbeInfo PROBE_INFO[] = {
+    { "read_cpu_stats", TRACE_CAT_COLLECTOR },
+    { "read_memory_stats", TRACE_CAT_COLLECTOR },
+    { "read_process_cpu_stats", TRACE_CAT_COLLECTOR },
+    { "read_temperature", TRACE_CAT_COLLECTOR },
+    { "native_read_proc_net_dev", TRACE_CAT_COLLECTOR },
+    { "native_twc_add_point", TRACE_CAT_ANALYTICS },
+    { "native_twc_get_stats", TRACE_CAT_ANALYTICS },
+    { "native_chart_add_point", TRACE_CAT_ANALYTICS },
+    { "native_chart_get_normalized", TRACE_CAT_ANALYTICS },
+    { "native_peak_add_value", TRACE_CAT_ANALYTICS },
+    { "native_peak_get_data", TRACE_CAT_ANALYTICS },
+    { "native_procmem_read", TRACE_CAT_COLLECTOR },
+    { "native_psi_read", TRACE_CAT_COLLECTOR },
+    { "native_pub_submit", TRACE_CAT_ANALYTICS },
+    { "native_read_diskstats", TRACE_CAT_COLLECTOR },
+    { "native_cpufreq_sample", TRACE_CAT_COLLECTOR },
+    { "native_threads_sample", TRACE_CAT_COLLECTOR },
+    { "native_mem_read", TRACE_CAT_COLLECTOR },
+    { "native_uid_traffic_sample", TRACE_CAT_COLLECTOR },
+    { "native_gpu_sample", TRACE_CAT_COLLECTOR },
+    { "native_snapshot_read", TRACE_CAT_ANALYTICS },
+    { "native_rank_top_n", TRACE_CAT_ANALYTICS },
+    { "native_spark_render", TRACE_CAT_ANALYTICS },
+    { "native_frames_add", TRACE_CAT_ANALYTICS },
+    { "native_frames_get_stats", TRACE_CAT_ANALYTICS },
+};
+
+static_assert(sizeof(PROBE_INFO) / sizeof(PROBE_INFO[0]) == PROBE_COUNT,
+              "PROBE_INFO must list every NativeProbeId");
+
+// Cache-line aligned so concurrently hit probes do not false-share
+struct alignas(PROBE_ALIGN) ProbeData {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+    std::atomic<uint32_t> buckets[HIST_BUCKETS];
+};
+
+std::atomic<uint32_t> g_native_instr_flags(0);
+static ProbeData g_probes[PROBE_COUNT];
+
+static inline int bucket_index(uint64_t ns) {
+    if (ns < HIST_SUB_COUNT) return static_cast<int>(ns);
+
+    int msb = 63 - __builtin_clzll(ns);
+    if (msb > HIST_MAX_MSB) return HIST_BUCKETS - 1;
+
+    int group = msb - HIST_SUB_BITS + 1;
+    int sub = static_cast<int>((ns >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+    return (group << HIST_SUB_BITS) + sub;
+}
+
+// Representative value of a bucket: its midpoint
+static uint64_t bucket_value(int index) {
+    int group = index >> HIST_SUB_BITS;
+    int sub = index & (HIST_SUB_COUNT - 1);
+    if (group == 0) return static_cast<uint64_t>(sub);
+
+    uint64_t lower = static_cast<uint64_t>(HIST_SUB_COUNT + sub) << (group - 1);
+    uint64_t width = 1ULL << (group - 1);
+    return lower + width / 2;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void native_instr_set_enabled(bool enabled) {
+    if (enabled) {
+        g_native_instr_flags.fetch_or(INSTR_FLAG_HISTOGRAM, std::memory_order_relaxed);
+    } else {
+        g_native_instr_flags.fetch_and(~INSTR_FLAG_HISTOGRAM, std::memory_order_relaxed);
+    }
+}
+
+uint64_t native_instr_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void native_instr_record(NativeProbeId probe, uint64_t start_ns, bool failed) {
+    native_instr_record_elapsed(probe, native_instr_now_ns() - start_ns, failed);
+}
+
+void native_instr_record_elapsed(NativeProbeId probe, uint64_t elapsed, bool failed) {
+    if (probe < 0 || probe >= PROBE_COUNT) return;
+
+    ProbeData& data = g_probes[probe];
+
+    data.calls.fetch_add(1, std::memory_order_relaxed);
+    if (failed) data.errors.fetch_add(1, std::memory_order_relaxed);
+    data.total_ns.fetch_add(elapsed, std::memory_order_relaxed);
+    data.buckets[bucket_index(elapsed)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t prev_max = data.max_ns.load(std::memory_order_relaxed);
+    while (elapsed > prev_max &&
+           !data.max_ns.compare_exchange_weak(prev_max, elapsed, std::memory_order_relaxed)) {
+    }
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+int native_instr_get_stats(NativeProbeId probe, ProbeStats* out) {
+    if (!out || probe < 0 || probe >= PROBE_COUNT) return -1;
+
+    const ProbeData& data = g_probes[probe];
+    memset(out, 0, sizeof(ProbeStats));
+
+    // Snapshot buckets once; counters may move on while we read (relaxed)
+    uint32_t counts[HIST_BUCKETS];
+    uint64_t histogram_total = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        counts[i] = data.buckets[i].load(std::memory_order_relaxed);
+        histogram_total += counts[i];
+    }
+
+    out->calls = data.calls.load(std::memory_order_relaxed);
+    out->errors = data.errors.load(std::memory_order_relaxed);
+    out->total_ns = data.total_ns.load(std::memory_order_relaxed);
+    out->max_ns = data.max_ns.load(std::memory_order_relaxed);
+
+    if (histogram_total == 0) return 0;
+
+    const uint32_t percentiles[3] = { 50, 90, 99 };
+    uint64_t* targets[3] = { &out->p50_ns, &out->p90_ns, &out->p99_ns };
+
+    int next = 0;
+    uint64_t cumulative = 0;
+    for (int i = 0; i < HIST_BUCKETS && next < 3; i++) {
+        cumulative += counts[i];
+        while (next < 3 && cumulative * 100 >= histogram_total * percentiles[next]) {
+            uint64_t value = bucket_value(i);
+            *targets[next] = value < out->max_ns ? value : out->max_ns;
+            next++;
+        }
+    }
+
+    return 0;
+}
+
+const char* native_instr_probe_name(NativeProbeId probe) {
+    if (probe < 0 || probe >= PROBE_COUNT) return nullptr;
+    return PROBE_INFO[probe].name;
+}
+
+const char* native_instr_probe_category(NativeProbeId probe) {
+    if (probe < 0 || probe >= PROBE_COUNT) return nullptr;
+    return PROBE_INFO[probe].category;
+}
+
+int native_instr_dump_size(void) {
+    return INSTR_DUMP_HEADER + PROBE_COUNT * INSTR_DUMP_FIELDS;
+}
+
+int native_instr_dump(int64_t* out, int out_len) {
+    if (!out || out_len < native_instr_dump_size()) return -1;
+
+    out[0] = INSTR_DUMP_VERSION;
+    out[1] = PROBE_COUNT;
+    out[2] = INSTR_DUMP_FIELDS;
+
+    int64_t* cursor = out + INSTR_DUMP_HEADER;
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        ProbeStats stats;
+        native_instr_get_stats(static_cast<NativeProbeId>(p), &stats);
+        *cursor++ = static_cast<int64_t>(stats.calls);
+        *cursor++ = static_cast<int64_t>(stats.errors);
+        *cursor++ = static_cast<int64_t>(stats.total_ns);
+        *cursor++ = static_cast<int64_t>(stats.max_ns);
+        *cursor++ = static_cast<int64_t>(stats.p50_ns);
+        *cursor++ = static_cast<int64_t>(stats.p90_ns);
+        *cursor++ = static_cast<int64_t>(stats.p99_ns);
+    }
+
+    return native_instr_dump_size();
+}
+
+void native_instr_reset(void) {
+    for (ProbeData& data : g_probes) {
+        data.calls.store(0, std::memory_order_relaxed);
+        data.errors.store(0, std::memory_order_relaxed);
+        data.total_ns.store(0, std::memory_order_relaxed);
+        data.max_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : data.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_setEnabled(
+        JNIEnv* env, jclass clazz, jboolean enabled) {
+    native_instr_set_enabled(enabled == JNI_TRUE);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_isEnabled(
+        JNIEnv* env, jclass clazz) {
+    return native_instr_is_enabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_reset(
+        JNIEnv* env, jclass clazz) {
+    native_instr_reset();
+}
+
+/**
+ * Returns [version, probeCount, fieldsPerProbe,
+ *          (calls, errors, totalNs, maxNs, p50Ns, p90Ns, p99Ns) * probeCount]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_dump(
+        JNIEnv* env, jclass clazz) {
+    const int size = native_instr_dump_size();
+    int64_t values[INSTR_DUMP_HEADER + PROBE_COUNT * INSTR_DUMP_FIELDS];
+    if (native_instr_dump(values, size) < 0) return nullptr;
+
+    jlongArray arr = env->NewLongArray(size);
+    if (arr == nullptr) return nullptr;
+
+    env->SetLongArrayRegion(arr, 0, size, reinterpret_cast<const jlong*>(values));
+    return arr;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_probeNames(
+        JNIEnv* env, jclass clazz) {
+    jclass string_class = native_jni_string_class();
+    if (string_class == nullptr) return nullptr;
+
+    jobjectArray arr = env->NewObjectArray(PROBE_COUNT, string_class, nullptr);
+    if (arr == nullptr) return nullptr;
+
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        jstring name = env->NewStringUTF(PROBE_INFO[p].name);
+        env->SetObjectArrayElement(arr, p, name);
+        env->DeleteLocalRef(name);
+    }
+    return arr;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+// @CriticalNative entry point
+static jboolean is_enabled_critical() {
+    return native_instr_is_enabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+static const NativeMethod INSTRUMENT_METHODS[] = {
+    NATIVE_METHOD("setEnabled", "(Z)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_setEnabled),
+    NATIVE_CRITICAL_METHOD("isEnabled", "()Z",
+                           Java_com_sysmetrics_app_native_1bridge_NativeProfiler_isEnabled,
+                           is_enabled_critical),
+    NATIVE_METHOD("reset", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_reset),
+    NATIVE_METHOD("dump", "()[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_dump),
+    NATIVE_METHOD("probeNames", "()[Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_probeNames),
+};
+const NativeMethodList NATIVE_INSTRUMENT_JNI = NATIVE_METHOD_LIST(INSTRUMENT_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,226 @@
+#ifndef SYSMETRICS_NATIVE_INSTRUMENT_H
+#define SYSMETRICS_NATIVE_INSTRUMENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "native_trace.h"
+
+#ifdef __cplusplus
+#include <atomic>
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE INSTRUMENTATION - Per-entry-point latency histograms
+ * ============================================================================
+ *
+ * Self-instrumentation of the native hot paths, cheap enough to leave on
+ * in the field:
+ *
+ * - CLOCK_MONOTONIC timing around each native entry point
+ * - Lock-free log-linear histograms (8 sub-buckets per power of two,
+ *   <= 6.25% relative error) plus call / error / total / max counters
+ * - Runtime switch; when off, a probe costs one relaxed atomic load
+ * - Compact packed dump for JNI so Kotlin can report p50/p99 per function
+ *
+ * Histograms and trace spans (native_trace.h) share one flags word, so a
+ * scope with both disabled still costs a single relaxed load.
+ */
+
+/**
+ * Instrumented entry points. Append new probes before PROBE_COUNT and add
+ * the matching entry to PROBE_INFO in native_instrument.cpp.
+ */
+typedef enum {
+    PROBE_READ_CPU_STATS = 0,
+    PROBE_READ_MEMORY_STATS,
+    PROBE_READ_PROCESS_CPU_STATS,
+    PROBE_READ_TEMPERATURE,
+    PROBE_READ_PROC_NET_DEV,
+    PROBE_TWC_ADD_POINT,
+    PROBE_TWC_GET_STATS,
+    PROBE_CHART_ADD_POINT,
+    PROBE_CHART_GET_NORMALIZED,
+    PROBE_PEAK_ADD_VALUE,
+    PROBE_PEAK_GET_DATA,
+    PROBE_READ_PROCESS_MEMORY,
+    PROBE_READ_PRESSURE,
+    PROBE_PUBLISH_SUBMIT,
+    PROBE_READ_DISKSTATS,
+    PROBE_READ_CPUFREQ,
+    PROBE_READ_THREADS,
+    PROBE_READ_MEMORY_FIELDS,
+    PROBE_READ_UID_TRAFFIC,
+    PROBE_READ_GPU,
+    PROBE_SNAPSHOT_READ,
+    PROBE_RANK_PROCESSES,
+    PROBE_SPARK_RENDER,
+    PROBE_FRAMES_ADD,
+    PROBE_FRAMES_GET_STATS,
+    PROBE_COUNT
+} NativeProbeId;
+
+/**
+ * Aggregated view of one probe.
+ */
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+} ProbeStats;
+
+// Bits of g_native_instr_flags
+#define INSTR_FLAG_HISTOGRAM 0x1u
+#define INSTR_FLAG_TRACE     0x2u
+
+// Layout of native_instr_dump(): header, then DUMP_FIELDS values per probe
+#define INSTR_DUMP_VERSION 1
+#define INSTR_DUMP_HEADER 3   // [version, probe_count, fields_per_probe]
+#define INSTR_DUMP_FIELDS 7   // ProbeStats field order
+
+/**
+ * Enable or disable timing at runtime (disabled by default).
+ */
+void native_instr_set_enabled(bool enabled);
+
+/**
+ * Monotonic time in nanoseconds (CLOCK_MONOTONIC).
+ */
+uint64_t native_instr_now_ns(void);
+
+/**
+ * Record one call of probe that started at start_ns.
+ */
+void native_instr_record(NativeProbeId probe, uint64_t start_ns, bool failed);
+
+/**
+ * Record one call of probe that took elapsed_ns.
+ */
+void native_instr_record_elapsed(NativeProbeId probe, uint64_t elapsed_ns, bool failed);
+
+/**
+ * Read aggregated statistics for one probe.
+ * @return 0 on success, -1 for an unknown probe
+ */
+int native_instr_get_stats(NativeProbeId probe, ProbeStats* out);
+
+/**
+ * Stable name of a probe (e.g. "read_cpu_stats"), or NULL if unknown.
+ */
+const char* native_instr_probe_name(NativeProbeId probe);
+
+/**
+ * Trace category of a probe (TRACE_CAT_COLLECTOR or TRACE_CAT_ANALYTICS).
+ */
+const char* native_instr_probe_category(NativeProbeId probe);
+
+/**
+ * Write header + ProbeStats for every probe into out.
+ * @return Number of values written, or -1 if out_len is too small
+ */
+int native_instr_dump(int64_t* out, int out_len);
+
+/**
+ * Number of values native_instr_dump() writes.
+ */
+int native_instr_dump_size(void);
+
+/**
+ * Zero all histograms and counters.
+ */
+void native_instr_reset(void);
+
+#ifdef __cplusplus
+}
+
+extern std::atomic<uint32_t> g_native_instr_flags;
+
+static inline uint32_t native_instr_flags() {
+    return g_native_instr_flags.load(std::memory_order_relaxed);
+}
+
+static inline bool native_instr_is_enabled() {
+    return (native_instr_flags() & INSTR_FLAG_HISTOGRAM) != 0;
+}
+
+/**
+ * Times the enclosing scope into a probe histogram and, while tracing,
+ * a trace span named after the probe:
+ *
+ *     NativeProbeScope probe(PROBE_READ_CPU_STATS);
+ *     return probe.check(read_cpu_stats_impl(stats));
+ */
+class NativeProbeScope {
+public:
+    explicit NativeProbeScope(NativeProbeId id)
+        : id_(id), flags_(native_instr_flags()), start_ns_(0), failed_(false) {
+        if (flags_ != 0) start_ns_ = native_instr_now_ns();
+    }
+
+    ~NativeProbeScope() {
+        if (flags_ == 0) return;
+
+        uint64_t end_ns = native_instr_now_ns();
+        if (flags_ & INSTR_FLAG_HISTOGRAM) {
+            native_instr_record_elapsed(id_, end_ns - start_ns_, failed_);
+        }
+        if (flags_ & INSTR_FLAG_TRACE) {
+            native_trace_record(native_instr_probe_name(id_), native_instr_probe_category(id_),
+                                start_ns_, end_ns);
+        }
+    }
+
+    void fail() { failed_ = true; }
+
+    // Marks the call failed when rc is negative and passes rc through
+    int check(int rc) {
+        if (rc < 0) failed_ = true;
+        return rc;
+    }
+
+    NativeProbeScope(const NativeProbeScope&) = delete;
+    NativeProbeScope& operator=(const NativeProbeScope&) = delete;
+
+private:
+    NativeProbeId id_;
+    uint32_t flags_;
+    uint64_t start_ns_;
+    bool failed_;
+};
+
+/**
+ * Records the enclosing scope as a trace span (no histogram), for JNI
+ * entries and operations without a probe. name and category must be
+ * string literals.
+ *
+ *     NativeTraceScope trace("NativeMetrics.getCpuUsage", TRACE_CAT_JNI);
+ */
+class NativeTraceScope {
+public:
+    NativeTraceScope(const char* name, const char* category)
+        : name_(name), category_(category), start_ns_(0) {
+        if (native_instr_flags() & INSTR_FLAG_TRACE) start_ns_ = native_instr_now_ns();
+    }
+
+    ~NativeTraceScope() {
+        if (start_ns_ != 0) {
+            native_trace_record(name_, category_, start_ns_, native_instr_now_ns());
+        }
+    }
+
+    NativeTraceScope(const NativeTraceScope&) = delete;
+    NativeTraceScope& operator=(const NativeTraceScope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    uint64_t start_ns_;
+};
+#endif
+
+#endif // SYSMETRICS_NATIVE_INSTRUMENT_H
@@ -0,0 +1,279 @@
+#include "native_jni.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <android/api-level.h>
+
+#define LOG_TAG "NATIVE_JNI"
+#include "native_platform.h"
+
+// Combined methods of one bridge class's lists; NativeAnalytics is the
+// largest. List sizes live in other translation units, so bridges_fit()
+// checks this at load instead of at compile time.
+#define BRIDGE_MAX_METHODS 48
+#define BRIDGE_MAX_LISTS 6
+
+// ============================================================================
+// NativeJni (registration stats and call-overhead probes)
+// ============================================================================
+
+static uint64_t g_registration_ns = 0;
+static int32_t g_registered_methods = 0;
+
+static jlong jni_registration_time_ns(JNIEnv* env, jclass clazz) {
+    return static_cast<jlong>(g_registration_ns);
+}
+
+static jint jni_registered_method_count(JNIEnv* env, jclass clazz) {
+    return g_registered_methods;
+}
+
+// echo / fastEcho / criticalEcho differ only in calling convention
+static jint jni_echo(JNIEnv* env, jclass clazz, jint value) {
+    return value;
+}
+
+static jint jni_echo_critical(jint value) {
+    return value;
+}
+
+static const NativeMethod JNI_METHODS[] = {
+    NATIVE_METHOD("registrationTimeNs", "()J", jni_registration_time_ns),
+    NATIVE_METHOD("registeredMethodCount", "()I", jni_registered_method_count),
+    NATIVE_METHOD("echo", "(I)I", jni_echo),
+    NATIVE_METHOD("fastEcho", "(I)I", jni_echo),
+    NATIVE_CRITICAL_METHOD("criticalEcho", "(I)I", jni_echo, jni_echo_critical),
+};
+static const NativeMethodList NATIVE_JNI_JNI = NATIVE_METHOD_LIST(JNI_METHODS);
+
+// ============================================================================
+// Registration Table
+// ============================================================================
+
+struct BridgeClass {
+    const char* name;
+    const NativeMethodList* lists[BRIDGE_MAX_LISTS];
+};
+
+static const BridgeClass BRIDGE_CLASSES[] = {
+    { "com/sysmetrics/app/native_bridge/NativeMetrics",
+      { &NATIVE_METRICS_JNI, &NATIVE_PROCESS_MEMORY_JNI, &NATIVE_PROCESS_RANK_JNI,
+        &NATIVE_DISK_STATS_JNI, &NATIVE_CPUFREQ_JNI, &NATIVE_GPU_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeStringFormatter", { &NATIVE_STRING_FORMATTER_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeCpuMetricsCollector", { &NATIVE_CPU_COLLECTOR_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeNetworkMetrics",
+      { &NATIVE_NETWORK_JNI, &NATIVE_UID_TRAFFIC_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeAnalytics",
+      { &NATIVE_ANALYTICS_JNI, &NATIVE_RULES_JNI, &NATIVE_SPARKLINE_JNI, &NATIVE_FRAMES_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeProfiler",
+      { &NATIVE_INSTRUMENT_JNI, &NATIVE_TRACE_JNI, &NATIVE_THREADS_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeMemory", { &NATIVE_MEMORY_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativePressure", { &NATIVE_PRESSURE_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativePublisher", { &NATIVE_PUBLISH_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeSharedSnapshot", { &NATIVE_SHARED_SNAPSHOT_JNI, &NATIVE_SESSION_JNI } },
+    { "com/sysmetrics/app/native_bridge/NativeJni", { &NATIVE_JNI_JNI } },
+};
+
+#define BRIDGE_CLASS_COUNT static_cast<int>(sizeof(BRIDGE_CLASSES) / sizeof(BRIDGE_CLASSES[0]))
+#define NATIVE_JNI_CLASS_INDEX (BRIDGE_CLASS_COUNT - 1)
+
+// ============================================================================
+// Cached Classes and Method IDs
+// ============================================================================
+
+#define JNI_MODIFIER_NATIVE 0x100
+
+static jclass g_string_class = nullptr;
+static jclass g_bridge_classes[BRIDGE_CLASS_COUNT];
+static jmethodID g_get_declared_methods = nullptr;
+static jmethodID g_method_get_name = nullptr;
+static jmethodID g_method_get_modifiers = nullptr;
+
+jclass native_jni_string_class() {
+    return g_string_class;
+}
+
+static jclass global_class(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if (!local) {
+        env->ExceptionClear();
+        LOGE("Class %s not found", name);
+        return nullptr;
+    }
+    jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+static bool cache_ids(JNIEnv* env) {
+    g_string_class = global_class(env, "java/lang/String");
+    jclass class_class = env->FindClass("java/lang/Class");
+    jclass method_class = env->FindClass("java/lang/reflect/Method");
+    if (!g_string_class || !class_class || !method_class) {
+        env->ExceptionClear();
+        return false;
+    }
+
+    g_get_declared_methods = env->GetMethodID(class_class, "getDeclaredMethods",
+                                              "()[Ljava/lang/reflect/Method;");
+    g_method_get_name = env->GetMethodID(method_class, "getName", "()Ljava/lang/String;");
+    g_method_get_modifiers = env->GetMethodID(method_class, "getModifiers", "()I");
+    env->DeleteLocalRef(class_class);
+    env->DeleteLocalRef(method_class);
+    if (!g_get_declared_methods || !g_method_get_name || !g_method_get_modifiers) {
+        env->ExceptionClear();
+        return false;
+    }
+
+    for (int i = 0; i < BRIDGE_CLASS_COUNT; i++) {
+        g_bridge_classes[i] = global_class(env, BRIDGE_CLASSES[i].name);
+        if (!g_bridge_classes[i]) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+// Every bridge class's lists together must fit the registration buffer
+static bool bridges_fit() {
+    bool fit = true;
+    for (int i = 0; i < BRIDGE_CLASS_COUNT; i++) {
+        int count = 0;
+        for (const NativeMethodList* list : BRIDGE_CLASSES[i].lists) {
+            if (!list) break;
+            count += list->count;
+        }
+        if (count > BRIDGE_MAX_METHODS) {
+            LOGE("%s has %d native methods, BRIDGE_MAX_METHODS is %d",
+                 BRIDGE_CLASSES[i].name, count, BRIDGE_MAX_METHODS);
+            fit = false;
+        }
+    }
+    return fit;
+}
+
+// Flattens a bridge class's lists; returns the method count or -1 on overflow
+static int collect_methods(const BridgeClass& bridge, bool critical, JNINativeMethod* out) {
+    int count = 0;
+    for (const NativeMethodList* list : bridge.lists) {
+        if (!list) break;
+        for (int i = 0; i < list->count; i++) {
+            if (count == BRIDGE_MAX_METHODS) return -1;
+            const NativeMethod& method = list->methods[i];
+            out[count].name = method.name;
+            out[count].signature = method.signature;
+            out[count].fnPtr = critical && method.critical_fn ? method.critical_fn : method.fn;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Every native method the class declares must be in the registered set
+static bool verify_declared(JNIEnv* env, jclass clazz, const char* class_name,
+                            const JNINativeMethod* methods, int count) {
+    jobjectArray declared = static_cast<jobjectArray>(
+        env->CallObjectMethod(clazz, g_get_declared_methods));
+    if (!declared || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOGE("Cannot list methods of %s", class_name);
+        return false;
+    }
+
+    bool ok = true;
+    jsize length = env->GetArrayLength(declared);
+    for (jsize i = 0; i < length && ok; i++) {
+        jobject method = env->GetObjectArrayElement(declared, i);
+        if ((env->CallIntMethod(method, g_method_get_modifiers) & JNI_MODIFIER_NATIVE) != 0) {
+            jstring name = static_cast<jstring>(env->CallObjectMethod(method, g_method_get_name));
+            const char* name_str = name ? env->GetStringUTFChars(name, nullptr) : nullptr;
+            bool found = false;
+            for (int m = 0; name_str && m < count && !found; m++) {
+                found = strcmp(methods[m].name, name_str) == 0;
+            }
+            if (!found) {
+                LOGE("%s.%s has no native implementation", class_name, name_str ? name_str : "?");
+                ok = false;
+            }
+            if (name_str) env->ReleaseStringUTFChars(name, name_str);
+            if (name) env->DeleteLocalRef(name);
+        }
+        env->DeleteLocalRef(method);
+    }
+    env->DeleteLocalRef(declared);
+    return ok;
+}
+
+static int register_all(JNIEnv* env, bool critical, bool verify) {
+    JNINativeMethod methods[BRIDGE_MAX_METHODS];
+    int total = 0;
+
+    for (int i = 0; i < BRIDGE_CLASS_COUNT; i++) {
+        const BridgeClass& bridge = BRIDGE_CLASSES[i];
+        int count = collect_methods(bridge, critical, methods);
+        if (count < 0) {
+            LOGE("%s has more than %d native methods", bridge.name, BRIDGE_MAX_METHODS);
+            return -1;
+        }
+        if (env->RegisterNatives(g_bridge_classes[i], methods, count) != JNI_OK) {
+            env->ExceptionClear();
+            LOGE("RegisterNatives failed for %s", bridge.name);
+            return -1;
+        }
+        if (verify && !verify_declared(env, g_bridge_classes[i], bridge.name, methods, count)) {
+            return -1;
+        }
+        total += count;
+    }
+    return total;
+}
+
+// A @CriticalNative entry point called with the regular convention would see
+// JNIEnv* as its first argument. If the annotation did not survive into the
+// dex, the echo probe comes back wrong and the regular functions go back in.
+static bool critical_natives_work(JNIEnv* env) {
+    const jint probe = 0x5a17c0de;
+    jclass clazz = g_bridge_classes[NATIVE_JNI_CLASS_INDEX];
+    jmethodID echo = env->GetStaticMethodID(clazz, "criticalEcho", "(I)I");
+    if (!echo) {
+        env->ExceptionClear();
+        return false;
+    }
+    jint result = env->CallStaticIntMethod(clazz, echo, probe);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return false;
+    }
+    return result == probe;
+}
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    uint64_t start_ns = native_instr_now_ns();
+    if (!bridges_fit()) return JNI_ERR;
+    if (!cache_ids(env)) {
+        LOGE("Failed to cache JNI classes");
+        return JNI_ERR;
+    }
+
+    // ART honours @CriticalNative from Android 8.0 (API 26)
+    bool critical = android_get_device_api_level() >= 26;
+    int registered = register_all(env, critical, true);
+    if (registered < 0) return JNI_ERR;
+
+    if (critical && !critical_natives_work(env)) {
+        LOGW("@CriticalNative not in effect, using regular entry points");
+        if (register_all(env, false, false) < 0) return JNI_ERR;
+    }
+
+    g_registration_ns = native_instr_now_ns() - start_ns;
+    g_registered_methods = registered;
+    LOGI("Registered %d native methods in %llu us", registered,
+         static_cast<unsigned long long>(g_registration_ns / 1000));
+    return JNI_VERSION_1_6;
+}
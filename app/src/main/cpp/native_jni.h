@@ -0,0 +1,79 @@
+#ifndef SYSMETRICS_NATIVE_JNI_H
+#define SYSMETRICS_NATIVE_JNI_H
+
+#include <jni.h>
+#include <stdint.h>
+
+/**
+ * ============================================================================
+ * NATIVE JNI - Method registration for the bridge classes
+ * ============================================================================
+ *
+ * JNI_OnLoad binds every Kotlin external through RegisterNatives instead of
+ * leaving ART to resolve Java_* symbols on first call. Each module exports
+ * the methods it implements as a NativeMethodList at the end of its JNI
+ * section; native_jni.cpp maps every list to its bridge class in one table.
+ *
+ * Loading fails (UnsatisfiedLinkError from System.loadLibrary) when a table
+ * entry has no matching declaration, or when a class declares a native
+ * method that no list registers, so a missing implementation shows up at
+ * startup rather than on its first call.
+ *
+ * Entries may carry a second entry point for @CriticalNative methods: a
+ * function without the JNIEnv and jclass arguments. It is registered on
+ * API 26+, where ART honours the annotation; older releases ignore the
+ * annotation and get the regular function.
+ *
+ * Only compiled into the Android library (the host build defines
+ * SYSMETRICS_NO_JNI and never includes this header).
+ */
+
+struct NativeMethod {
+    const char* name;
+    const char* signature;
+    void* fn;
+    void* critical_fn;  // @CriticalNative entry point, or nullptr
+};
+
+struct NativeMethodList {
+    const NativeMethod* methods;
+    int32_t count;
+};
+
+#define NATIVE_METHOD(name, signature, fn) \
+    { name, signature, reinterpret_cast<void*>(fn), nullptr }
+#define NATIVE_CRITICAL_METHOD(name, signature, fn, critical_fn) \
+    { name, signature, reinterpret_cast<void*>(fn), reinterpret_cast<void*>(critical_fn) }
+#define NATIVE_METHOD_LIST(methods) \
+    { methods, static_cast<int32_t>(sizeof(methods) / sizeof(methods[0])) }
+
+// Per-module lists (defined in each module's JNI section)
+extern const NativeMethodList NATIVE_ANALYTICS_JNI;
+extern const NativeMethodList NATIVE_RULES_JNI;
+extern const NativeMethodList NATIVE_SPARKLINE_JNI;
+extern const NativeMethodList NATIVE_FRAMES_JNI;
+extern const NativeMethodList NATIVE_METRICS_JNI;
+extern const NativeMethodList NATIVE_STRING_FORMATTER_JNI;
+extern const NativeMethodList NATIVE_CPU_COLLECTOR_JNI;
+extern const NativeMethodList NATIVE_PROCESS_MEMORY_JNI;
+extern const NativeMethodList NATIVE_PROCESS_RANK_JNI;
+extern const NativeMethodList NATIVE_DISK_STATS_JNI;
+extern const NativeMethodList NATIVE_CPUFREQ_JNI;
+extern const NativeMethodList NATIVE_GPU_JNI;
+extern const NativeMethodList NATIVE_NETWORK_JNI;
+extern const NativeMethodList NATIVE_UID_TRAFFIC_JNI;
+extern const NativeMethodList NATIVE_INSTRUMENT_JNI;
+extern const NativeMethodList NATIVE_TRACE_JNI;
+extern const NativeMethodList NATIVE_THREADS_JNI;
+extern const NativeMethodList NATIVE_MEMORY_JNI;
+extern const NativeMethodList NATIVE_PRESSURE_JNI;
+extern const NativeMethodList NATIVE_PUBLISH_JNI;
+extern const NativeMethodList NATIVE_SHARED_SNAPSHOT_JNI;
+extern const NativeMethodList NATIVE_SESSION_JNI;
+
+/**
+ * java.lang.String, held as a global reference from JNI_OnLoad on.
+ */
+jclass native_jni_string_class();
+
+#endif // SYSMETRICS_NATIVE_JNI_H
@@ -0,0 +1,433 @@
+#include "native_memory.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_MEMORY"
+#include "native_platform.h"
+
+#define MEMORY_BUFFER_SIZE 8192
+#define ZRAM_BUFFER_SIZE 256
+
+// ============================================================================
+// Perfect Hash
+// ============================================================================
+
+namespace {
+
+enum MemSource : uint8_t { SOURCE_MEMINFO, SOURCE_ZRAM, SOURCE_VMSTAT };
+
+struct MemKey {
+    const char* name;
+    uint8_t length;
+    int8_t field;
+
+    constexpr MemKey(const char* key, MemField mem_field)
+        : name(key), length(const_length(key)), field(static_cast<int8_t>(mem_field)) {}
+
+    static constexpr uint8_t const_length(const char* key) {
+        uint8_t n = 0;
+        while (key[n]) n++;
+        return n;
+    }
+};
+
+constexpr MemKey MEM_KEYS[] = {
+    { "MemTotal", MEM_TOTAL },
+    { "MemFree", MEM_FREE },
+    { "MemAvailable", MEM_AVAILABLE },
+    { "Buffers", MEM_BUFFERS },
+    { "Cached", MEM_CACHED },
+    { "SwapCached", MEM_SWAP_CACHED },
+    { "Active", MEM_ACTIVE },
+    { "Inactive", MEM_INACTIVE },
+    { "SwapTotal", MEM_SWAP_TOTAL },
+    { "SwapFree", MEM_SWAP_FREE },
+    { "Dirty", MEM_DIRTY },
+    { "Writeback", MEM_WRITEBACK },
+    { "AnonPages", MEM_ANON_PAGES },
+    { "Mapped", MEM_MAPPED },
+    { "Shmem", MEM_SHMEM },
+    { "Slab", MEM_SLAB },
+    { "SReclaimable", MEM_SRECLAIMABLE },
+    { "SUnreclaim", MEM_SUNRECLAIM },
+    { "KernelStack", MEM_KERNEL_STACK },
+    { "PageTables", MEM_PAGE_TABLES },
+    { "CmaTotal", MEM_CMA_TOTAL },
+    { "CmaFree", MEM_CMA_FREE },
+
+    { "pgpgin", MEM_VM_PGPGIN },
+    { "pgpgout", MEM_VM_PGPGOUT },
+    { "pswpin", MEM_VM_PSWPIN },
+    { "pswpout", MEM_VM_PSWPOUT },
+    { "pgfault", MEM_VM_PGFAULT },
+    { "pgmajfault", MEM_VM_PGMAJFAULT },
+    { "oom_kill", MEM_VM_OOM_KILL },
+
+    // Single counters on newer kernels, split per zone on older ones
+    { "allocstall", MEM_VM_ALLOCSTALL },
+    { "allocstall_dma", MEM_VM_ALLOCSTALL },
+    { "allocstall_dma32", MEM_VM_ALLOCSTALL },
+    { "allocstall_normal", MEM_VM_ALLOCSTALL },
+    { "allocstall_movable", MEM_VM_ALLOCSTALL },
+    { "pgsteal_kswapd", MEM_VM_PGSTEAL_KSWAPD },
+    { "pgsteal_kswapd_dma", MEM_VM_PGSTEAL_KSWAPD },
+    { "pgsteal_kswapd_dma32", MEM_VM_PGSTEAL_KSWAPD },
+    { "pgsteal_kswapd_normal", MEM_VM_PGSTEAL_KSWAPD },
+    { "pgsteal_kswapd_movable", MEM_VM_PGSTEAL_KSWAPD },
+    { "pgsteal_direct", MEM_VM_PGSTEAL_DIRECT },
+    { "pgsteal_direct_dma", MEM_VM_PGSTEAL_DIRECT },
+    { "pgsteal_direct_dma32", MEM_VM_PGSTEAL_DIRECT },
+    { "pgsteal_direct_normal", MEM_VM_PGSTEAL_DIRECT },
+    { "pgsteal_direct_movable", MEM_VM_PGSTEAL_DIRECT },
+    { "pgscan_kswapd", MEM_VM_PGSCAN_KSWAPD },
+    { "pgscan_kswapd_dma", MEM_VM_PGSCAN_KSWAPD },
+    { "pgscan_kswapd_dma32", MEM_VM_PGSCAN_KSWAPD },
+    { "pgscan_kswapd_normal", MEM_VM_PGSCAN_KSWAPD },
+    { "pgscan_kswapd_movable", MEM_VM_PGSCAN_KSWAPD },
+    { "pgscan_direct", MEM_VM_PGSCAN_DIRECT },
+    { "pgscan_direct_dma", MEM_VM_PGSCAN_DIRECT },
+    { "pgscan_direct_dma32", MEM_VM_PGSCAN_DIRECT },
+    { "pgscan_direct_normal", MEM_VM_PGSCAN_DIRECT },
+    { "pgscan_direct_movable", MEM_VM_PGSCAN_DIRECT },
+    { "workingset_refault", MEM_VM_WORKINGSET_REFAULT },
+    { "workingset_refault_anon", MEM_VM_WORKINGSET_REFAULT },
+    { "workingset_refault_file", MEM_VM_WORKINGSET_REFAULT },
+};
+
+constexpr int MEM_KEY_COUNT = sizeof(MEM_KEYS) / sizeof(MEM_KEYS[0]);
+
+// Power of two, sparse enough that a collision-free seed turns up quickly
+constexpr uint32_t MEM_HASH_SIZE = 512;
+constexpr uint32_t MEM_HASH_MAX_SEED = 4096;
+
+static_assert(MEM_FIELD_COUNT <= 64, "field masks are 64-bit");
+static_assert(MEM_KEY_COUNT < 255, "slots store key index + 1 in a byte");
+
+// FNV-1a over the key, seeded through the offset basis
+constexpr uint32_t key_hash(const char* key, int length, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (int i = 0; i < length; i++) {
+        h ^= static_cast<uint8_t>(key[i]);
+        h *= 16777619u;
+    }
+    return (h ^ (h >> 16)) & (MEM_HASH_SIZE - 1);
+}
+
+struct PerfectHash {
+    uint32_t seed;
+    uint8_t slots[MEM_HASH_SIZE];  // key index + 1, 0 = empty
+};
+
+constexpr PerfectHash build_perfect_hash() {
+    for (uint32_t seed = 1; seed < MEM_HASH_MAX_SEED; seed++) {
+        PerfectHash table{ seed, {} };
+        bool collision = false;
+        for (int k = 0; k < MEM_KEY_COUNT && !collision; k++) {
+            uint32_t slot = key_hash(MEM_KEYS[k].name, MEM_KEYS[k].length, seed);
+            if (table.slots[slot] != 0) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<uint8_t>(k + 1);
+            }
+        }
+        if (!collision) return table;
+    }
+    return PerfectHash{ 0, {} };
+}
+
+constexpr PerfectHash MEM_HASH = build_perfect_hash();
+static_assert(MEM_HASH.seed != 0, "no collision-free seed for MEM_KEYS, grow MEM_HASH_SIZE");
+
+constexpr MemSource field_source(int field) {
+    return field < MEM_ZRAM_ORIG_DATA ? SOURCE_MEMINFO
+         : field < MEM_VM_PGPGIN ? SOURCE_ZRAM
+         : SOURCE_VMSTAT;
+}
+
+constexpr uint64_t source_mask(MemSource source) {
+    uint64_t mask = 0;
+    for (int field = 0; field < MEM_FIELD_COUNT; field++) {
+        if (field_source(field) == source) mask |= 1ull << field;
+    }
+    return mask;
+}
+
+constexpr uint64_t MEMINFO_MASK = source_mask(SOURCE_MEMINFO);
+constexpr uint64_t ZRAM_MASK = source_mask(SOURCE_ZRAM);
+constexpr uint64_t VMSTAT_MASK = source_mask(SOURCE_VMSTAT);
+
+}  // namespace
+
+int native_mem_lookup(const char* key, int length) {
+    if (!key || length <= 0 || length > 255) return -1;
+
+    uint8_t entry = MEM_HASH.slots[key_hash(key, length, MEM_HASH.seed)];
+    if (entry == 0) return -1;
+
+    const MemKey& known = MEM_KEYS[entry - 1];
+    if (known.length != length || memcmp(known.name, key, static_cast<size_t>(length)) != 0) return -1;
+    return known.field;
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+int native_mem_parse(const char* text, uint64_t field_mask, uint64_t* values) {
+    if (!text || !values) return 0;
+
+    int matched = 0;
+    const char* p = text;
+    while (*p) {
+        // "Key:   value kB" (meminfo) or "key value" (vmstat)
+        const char* key_end = p;
+        while (*key_end && *key_end != ':' && *key_end != ' ' && *key_end != '\n') key_end++;
+
+        int field = native_mem_lookup(p, static_cast<int>(key_end - p));
+        const char* cursor = key_end;
+        if (field >= 0 && (field_mask & (1ull << field))) {
+            if (*cursor == ':') cursor++;
+            while (*cursor == ' ' || *cursor == '\t') cursor++;
+
+            uint64_t value = 0;
+            const char* digits = cursor;
+            while (*cursor >= '0' && *cursor <= '9') {
+                value = value * 10 + static_cast<uint64_t>(*cursor - '0');
+                cursor++;
+            }
+            if (cursor != digits) {
+                values[field] += value;
+                matched++;
+            }
+        }
+
+        const char* eol = strchr(cursor, '\n');
+        if (!eol) break;
+        p = eol + 1;
+    }
+    return matched;
+}
+
+static int read_text_file(const char* abs_path, char* buffer, size_t size) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), abs_path) < 0) return -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // seq_file hands out at most a page per read()
+    size_t used = 0;
+    ssize_t n;
+    while (used < size - 1 && (n = read(fd, buffer + used, size - 1 - used)) > 0) {
+        used += static_cast<size_t>(n);
+    }
+    close(fd);
+    if (used == 0) return -1;
+
+    // Drop a trailing partial line if the file outgrew the buffer
+    if (used == size - 1) {
+        while (used > 0 && buffer[used - 1] != '\n') used--;
+    }
+    buffer[used] = '\0';
+    return static_cast<int>(used);
+}
+
+// mm_stat: orig_data_size compr_data_size mem_used_total ... (bytes)
+static void read_zram(uint64_t* values) {
+    char buffer[ZRAM_BUFFER_SIZE];
+    if (read_text_file(SYS_ZRAM_MM_STAT, buffer, sizeof(buffer)) < 0) return;
+
+    const char* p = buffer;
+    for (int field = MEM_ZRAM_ORIG_DATA; field <= MEM_ZRAM_USED; field++) {
+        while (*p == ' ') p++;
+        uint64_t value = 0;
+        while (*p >= '0' && *p <= '9') value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+        values[field] = value / 1024;
+    }
+}
+
+int native_mem_read_raw(uint64_t field_mask, uint64_t* values) {
+    if (!values) return -1;
+    memset(values, 0, MEM_FIELD_COUNT * sizeof(uint64_t));
+
+    char buffer[MEMORY_BUFFER_SIZE];
+    if (field_mask & MEMINFO_MASK) {
+        if (read_text_file(PROC_MEMINFO, buffer, sizeof(buffer)) < 0) return -1;
+        native_mem_parse(buffer, field_mask & MEMINFO_MASK, values);
+    }
+    if (field_mask & VMSTAT_MASK) {
+        if (read_text_file(PROC_VMSTAT, buffer, sizeof(buffer)) < 0) return -1;
+        native_mem_parse(buffer, field_mask & VMSTAT_MASK, values);
+    }
+    if (field_mask & ZRAM_MASK) read_zram(values);
+    return 0;
+}
+
+// ============================================================================
+// Registered Field Sets
+// ============================================================================
+
+struct MemQuery {
+    uint64_t mask;
+    int32_t count;
+    int8_t fields[MEM_FIELD_COUNT];
+    uint64_t previous[MEM_FIELD_COUNT];  // raw vmstat counters of the last read
+    int64_t previous_ms;
+    bool primed;
+};
+
+static std::mutex g_mem_mutex;
+static int64_t g_mem_next_handle = 1;
+static std::unordered_map<int64_t, MemQuery*> g_mem_map;
+
+int64_t native_mem_register(const int32_t* fields, int32_t count) {
+    if (!fields || count <= 0 || count > MEM_FIELD_COUNT) return 0;
+
+    uint64_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        if (fields[i] < 0 || fields[i] >= MEM_FIELD_COUNT) return 0;
+        uint64_t bit = 1ull << fields[i];
+        if (mask & bit) return 0;
+        mask |= bit;
+    }
+
+    MemQuery* query = new (std::nothrow) MemQuery();
+    if (!query) return 0;
+
+    query->mask = mask;
+    query->count = count;
+    for (int i = 0; i < count; i++) query->fields[i] = static_cast<int8_t>(fields[i]);
+
+    std::lock_guard<std::mutex> lock(g_mem_mutex);
+    int64_t handle = g_mem_next_handle++;
+    g_mem_map[handle] = query;
+    return handle;
+}
+
+void native_mem_unregister(int64_t handle) {
+    std::lock_guard<std::mutex> lock(g_mem_mutex);
+    auto it = g_mem_map.find(handle);
+    if (it != g_mem_map.end()) {
+        delete it->second;
+        g_mem_map.erase(it);
+    }
+}
+
+static int mem_read_impl(int64_t handle, double* out, int32_t max_count) {
+    if (!out) return -1;
+
+    uint64_t mask;
+    {
+        std::lock_guard<std::mutex> lock(g_mem_mutex);
+        auto it = g_mem_map.find(handle);
+        if (it == g_mem_map.end() || max_count < it->second->count) return -1;
+        mask = it->second->mask;
+    }
+
+    // Files are read outside the lock
+    uint64_t raw[MEM_FIELD_COUNT];
+    if (native_mem_read_raw(mask, raw) != 0) return -1;
+
+    const int64_t now = native_clock_now_ms();
+
+    std::lock_guard<std::mutex> lock(g_mem_mutex);
+    auto it = g_mem_map.find(handle);
+    if (it == g_mem_map.end()) return -1;  // unregistered meanwhile
+    MemQuery* query = it->second;
+
+    const int64_t elapsed_ms = now - query->previous_ms;
+    const bool has_interval = query->primed && elapsed_ms > 0;
+    for (int i = 0; i < query->count; i++) {
+        int field = query->fields[i];
+        if (field_source(field) != SOURCE_VMSTAT) {
+            out[i] = static_cast<double>(raw[field]);
+        } else if (has_interval && raw[field] >= query->previous[field]) {
+            out[i] = static_cast<double>(raw[field] - query->previous[field]) * 1000.0 /
+                     static_cast<double>(elapsed_ms);
+        } else {
+            out[i] = 0.0;  // first read, or the counter went backwards (reboot, replay)
+        }
+        query->previous[field] = raw[field];
+    }
+    query->previous_ms = now;
+    query->primed = true;
+    return query->count;
+}
+
+int native_mem_read(int64_t handle, double* out, int32_t max_count) {
+    NativeProbeScope probe(PROBE_READ_MEMORY_FIELDS);
+    return probe.check(mem_read_impl(handle, out, max_count));
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMemory_register(
+        JNIEnv* env, jclass clazz, jintArray fields) {
+    NativeTraceScope trace("NativeMemory.register", TRACE_CAT_JNI);
+    if (fields == nullptr) return 0;
+
+    jsize count = env->GetArrayLength(fields);
+    if (count <= 0 || count > MEM_FIELD_COUNT) return 0;
+
+    int32_t values[MEM_FIELD_COUNT];
+    env->GetIntArrayRegion(fields, 0, count, reinterpret_cast<jint*>(values));
+    return native_mem_register(values, count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMemory_unregister(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    native_mem_unregister(handle);
+}
+
+/**
+ * Fills out with the registered fields in registration order.
+ * @return Number of values written, or -1 on error
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMemory_read(
+        JNIEnv* env, jclass clazz, jlong handle, jdoubleArray out) {
+    NativeTraceScope trace("NativeMemory.read", TRACE_CAT_JNI);
+    if (out == nullptr) return -1;
+
+    double values[MEM_FIELD_COUNT];
+    jsize capacity = env->GetArrayLength(out);
+    int count = native_mem_read(handle, values, capacity < MEM_FIELD_COUNT ? capacity : MEM_FIELD_COUNT);
+    if (count > 0) env->SetDoubleArrayRegion(out, 0, count, values);
+    return count;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod MEMORY_METHODS[] = {
+    NATIVE_METHOD("register", "([I)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMemory_register),
+    NATIVE_METHOD("unregister", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMemory_unregister),
+    NATIVE_METHOD("read", "(J[D)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMemory_read),
+};
+const NativeMethodList NATIVE_MEMORY_JNI = NATIVE_METHOD_LIST(MEMORY_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,117 @@
+#ifndef SYSMETRICS_NATIVE_MEMORY_H
+#define SYSMETRICS_NATIVE_MEMORY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE MEMORY - /proc/meminfo, /proc/vmstat and zram in one pass each
+ * ============================================================================
+ *
+ * Every known key ("MemTotal", "pgmajfault", ...) sits in a perfect hash
+ * table built at compile time, so a line costs one hash of its key, one
+ * table load and one memcmp, whatever the number of fields. Unknown keys
+ * fall out at the memcmp.
+ *
+ * Callers register the fields they need once and get a handle; each read
+ * then fills a dense array in registration order and only opens the files
+ * those fields live in:
+ *
+ * - meminfo fields in kB, as reported
+ * - zram fields in kB from /sys/block/zram0/mm_stat (0 without zram)
+ * - vmstat fields as events per second since the handle's previous read
+ *   (0 on the first read). Kernels that split a counter per zone
+ *   (allocstall_normal, pgsteal_kswapd_dma, ...) are summed into one field.
+ */
+
+typedef enum {
+    // /proc/meminfo (kB)
+    MEM_TOTAL = 0,
+    MEM_FREE,
+    MEM_AVAILABLE,
+    MEM_BUFFERS,
+    MEM_CACHED,
+    MEM_SWAP_CACHED,
+    MEM_ACTIVE,
+    MEM_INACTIVE,
+    MEM_SWAP_TOTAL,
+    MEM_SWAP_FREE,
+    MEM_DIRTY,
+    MEM_WRITEBACK,
+    MEM_ANON_PAGES,
+    MEM_MAPPED,
+    MEM_SHMEM,
+    MEM_SLAB,
+    MEM_SRECLAIMABLE,
+    MEM_SUNRECLAIM,
+    MEM_KERNEL_STACK,
+    MEM_PAGE_TABLES,
+    MEM_CMA_TOTAL,
+    MEM_CMA_FREE,
+
+    // /sys/block/zram0/mm_stat (kB)
+    MEM_ZRAM_ORIG_DATA,
+    MEM_ZRAM_COMPR_DATA,
+    MEM_ZRAM_USED,
+
+    // /proc/vmstat (events per second)
+    MEM_VM_PGPGIN,
+    MEM_VM_PGPGOUT,
+    MEM_VM_PSWPIN,
+    MEM_VM_PSWPOUT,
+    MEM_VM_PGFAULT,
+    MEM_VM_PGMAJFAULT,
+    MEM_VM_ALLOCSTALL,
+    MEM_VM_PGSTEAL_KSWAPD,
+    MEM_VM_PGSTEAL_DIRECT,
+    MEM_VM_PGSCAN_KSWAPD,
+    MEM_VM_PGSCAN_DIRECT,
+    MEM_VM_WORKINGSET_REFAULT,
+    MEM_VM_OOM_KILL,
+
+    MEM_FIELD_COUNT
+} MemField;
+
+/**
+ * Find the field a meminfo or vmstat key maps to.
+ * @return MemField, or -1 for an unknown key
+ */
+int native_mem_lookup(const char* key, int length);
+
+/**
+ * Parse /proc/meminfo or /proc/vmstat text, adding every field set in
+ * field_mask (bit = MemField) into values[MEM_FIELD_COUNT].
+ * @return Number of lines that matched a requested field
+ */
+int native_mem_parse(const char* text, uint64_t field_mask, uint64_t* values);
+
+/**
+ * Read the raw counters of every field in field_mask (no rates) into
+ * values[MEM_FIELD_COUNT], opening only the files those fields live in.
+ * @return 0 on success, -1 if meminfo or vmstat is unreadable
+ */
+int native_mem_read_raw(uint64_t field_mask, uint64_t* values);
+
+/**
+ * Register a field set.
+ * @return Handle, or 0 if a field is out of range or repeated
+ */
+int64_t native_mem_register(const int32_t* fields, int32_t count);
+
+void native_mem_unregister(int64_t handle);
+
+/**
+ * Read the registered fields into out, in registration order.
+ * @return Number of values written, or -1 on error
+ */
+int native_mem_read(int64_t handle, double* out, int32_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_MEMORY_H
@@ -1,26 +1,31 @@
-#include <jni.h>
-#include <android/log.h>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <unistd.h>
 #include "native_metrics.h"
+#include "native_format.h"
+#include "native_paths.h"
+#include "native_memory.h"
+#include "native_instrument.h"
 
-#define LOG_TAG "SysMetricsNative"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
 
-// Static storage for previous CPU stats
-static CpuStats prev_stats = {0};
-static bool has_prev_stats = false;
+#define LOG_TAG "SysMetricsNative"
+#include "native_platform.h"
 
 /**
  * Reads CPU statistics from /proc/stat.
  * Optimized for minimal allocations and fast parsing.
  */
-int read_cpu_stats(CpuStats* stats) {
-    FILE* fp = fopen("/proc/stat", "r");
+static int read_cpu_stats_impl(CpuStats* stats) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PROC_STAT) < 0) return -1;
+
+    FILE* fp = fopen(path, "r");
     if (!fp) {
-        LOGE("Failed to open /proc/stat");
+        LOGE("Failed to open %s", path);
         return -1;
     }
 
@@ -52,6 +57,11 @@ int read_cpu_stats(CpuStats* stats) {
     return 0;
 }
 
+int read_cpu_stats(CpuStats* stats) {
+    NativeProbeScope probe(PROBE_READ_CPU_STATS);
+    return probe.check(read_cpu_stats_impl(stats));
+}
+
 /**
  * Calculates CPU usage percentage between two snapshots.
  * Uses integer arithmetic where possible for performance.
@@ -87,56 +97,37 @@ float calculate_cpu_usage(const CpuStats* prev, const CpuStats* curr) {
 
 /**
  * Reads memory statistics from /proc/meminfo.
- * Uses optimized line-by-line parsing.
+ * Keys are matched through the native_memory perfect hash.
  */
-int read_memory_stats(MemoryStats* stats) {
-    FILE* fp = fopen("/proc/meminfo", "r");
-    if (!fp) {
-        LOGE("Failed to open /proc/meminfo");
+static int read_memory_stats_impl(MemoryStats* stats) {
+    const uint64_t mask = (1ull << MEM_TOTAL) | (1ull << MEM_FREE) | (1ull << MEM_AVAILABLE) |
+                          (1ull << MEM_BUFFERS) | (1ull << MEM_CACHED);
+    uint64_t values[MEM_FIELD_COUNT];
+    if (native_mem_read_raw(mask, values) != 0) {
+        LOGE("Failed to read /proc/meminfo");
         return -1;
     }
 
-    char line[256];
-    int found = 0;
-    const int needed = 5;
-
-    memset(stats, 0, sizeof(MemoryStats));
-
-    while (fgets(line, sizeof(line), fp) && found < needed) {
-        char key[64];
-        long value;
-
-        if (sscanf(line, "%63[^:]: %ld", key, &value) == 2) {
-            if (strcmp(key, "MemTotal") == 0) {
-                stats->total_kb = value;
-                found++;
-            } else if (strcmp(key, "MemFree") == 0) {
-                stats->free_kb = value;
-                found++;
-            } else if (strcmp(key, "MemAvailable") == 0) {
-                stats->available_kb = value;
-                found++;
-            } else if (strcmp(key, "Buffers") == 0) {
-                stats->buffers_kb = value;
-                found++;
-            } else if (strcmp(key, "Cached") == 0) {
-                stats->cached_kb = value;
-                found++;
-            }
-        }
-    }
+    stats->total_kb = static_cast<long>(values[MEM_TOTAL]);
+    stats->free_kb = static_cast<long>(values[MEM_FREE]);
+    stats->available_kb = static_cast<long>(values[MEM_AVAILABLE]);
+    stats->buffers_kb = static_cast<long>(values[MEM_BUFFERS]);
+    stats->cached_kb = static_cast<long>(values[MEM_CACHED]);
+    return (stats->total_kb > 0) ? 0 : -1; // MemTotal required
+}
 
-    fclose(fp);
-    return (found >= 2) ? 0 : -1; // At least MemTotal and MemFree required
+int read_memory_stats(MemoryStats* stats) {
+    NativeProbeScope probe(PROBE_READ_MEMORY_STATS);
+    return probe.check(read_memory_stats_impl(stats));
 }
 
 /**
  * Reads CPU stats for specific PID from /proc/pid/stat.
  * Highly optimized for frequent calls.
  */
-int read_process_cpu_stats(int pid, ProcessCpuStats* stats) {
-    char path[64];
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+static int read_process_cpu_stats_impl(int pid, ProcessCpuStats* stats) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_pid(path, sizeof(path), pid, "stat") < 0) return -1;
 
     FILE* fp = fopen(path, "r");
     if (!fp) {
@@ -171,56 +162,91 @@ int read_process_cpu_stats(int pid, ProcessCpuStats* stats) {
     return 0;
 }
 
+int read_process_cpu_stats(int pid, ProcessCpuStats* stats) {
+    NativeProbeScope probe(PROBE_READ_PROCESS_CPU_STATS);
+    return probe.check(read_process_cpu_stats_impl(pid, stats));
+}
+
 /**
  * Optimized time string formatting.
  */
 int format_time_string(char* buffer, int buffer_size, int hour, int minute, bool use_24h) {
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+
     if (use_24h) {
-        return snprintf(buffer, buffer_size, "%02d:%02d", hour, minute);
+        native_fmt_put_u64(&writer, (uint64_t)hour, 2);
+        native_fmt_put_char(&writer, ':');
+        native_fmt_put_u64(&writer, (uint64_t)minute, 2);
     } else {
-        const char* am_pm = (hour >= 12) ? "PM" : "AM";
         int display_hour = hour % 12;
         if (display_hour == 0) display_hour = 12;
-        return snprintf(buffer, buffer_size, "%d:%02d %s", display_hour, minute, am_pm);
+        native_fmt_put_u64(&writer, (uint64_t)display_hour, 1);
+        native_fmt_put_char(&writer, ':');
+        native_fmt_put_u64(&writer, (uint64_t)minute, 2);
+        native_fmt_put_str(&writer, (hour >= 12) ? " PM" : " AM");
     }
+
+    return native_fmt_finish(&writer);
 }
 
 /**
  * Format CPU usage string.
+ * Precision grows as the value shrinks so low loads stay readable.
  */
 int format_cpu_string(char* buffer, int buffer_size, float cpu_percent) {
+    int decimals = 1;
     if (cpu_percent >= 10.0f) {
-        return snprintf(buffer, buffer_size, "CPU: %.0f%%", cpu_percent);
+        decimals = 0;
     } else if (cpu_percent >= 1.0f) {
-        return snprintf(buffer, buffer_size, "CPU: %.1f%%", cpu_percent);
+        decimals = 1;
     } else if (cpu_percent >= 0.1f) {
-        return snprintf(buffer, buffer_size, "CPU: %.2f%%", cpu_percent);
-    } else {
-        return snprintf(buffer, buffer_size, "CPU: %.1f%%", cpu_percent);
+        decimals = 2;
     }
+
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_str(&writer, "CPU: ");
+    native_fmt_put_fixed(&writer, cpu_percent, decimals);
+    native_fmt_put_char(&writer, '%');
+    return native_fmt_finish(&writer);
 }
 
 /**
  * Format RAM usage string.
  */
 int format_ram_string(char* buffer, int buffer_size, long used_mb, long total_mb) {
-    return snprintf(buffer, buffer_size, "RAM: %ld/%ld MB", used_mb, total_mb);
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_str(&writer, "RAM: ");
+    native_fmt_put_i64(&writer, used_mb);
+    native_fmt_put_char(&writer, '/');
+    native_fmt_put_i64(&writer, total_mb);
+    native_fmt_put_str(&writer, " MB");
+    return native_fmt_finish(&writer);
 }
 
 /**
  * Format self stats string.
  */
 int format_self_stats_string(char* buffer, int buffer_size, float cpu_percent, long ram_mb) {
-    return snprintf(buffer, buffer_size, "Self: %.1f%% / %ldM", cpu_percent, ram_mb);
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, buffer_size);
+    native_fmt_put_str(&writer, "Self: ");
+    native_fmt_put_fixed(&writer, cpu_percent, 1);
+    native_fmt_put_str(&writer, "% / ");
+    native_fmt_put_i64(&writer, ram_mb);
+    native_fmt_put_char(&writer, 'M');
+    return native_fmt_finish(&writer);
 }
 
 /**
  * Read temperature from thermal zone.
  * Returns temperature in Celsius, or -1 if unavailable.
  */
-float read_temperature(int zone) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/temp", zone);
+static float read_temperature_impl(int zone) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_thermal(path, sizeof(path), zone, "temp") < 0) return -1.0f;
 
     FILE* fp = fopen(path, "r");
     if (!fp) {
@@ -237,10 +263,23 @@ float read_temperature(int zone) {
     return (float)temp_millidegrees / 1000.0f;
 }
 
+float read_temperature(int zone) {
+    NativeProbeScope probe(PROBE_READ_TEMPERATURE);
+    float temp = read_temperature_impl(zone);
+    if (temp < 0.0f) probe.fail();
+    return temp;
+}
+
+#ifndef SYSMETRICS_NO_JNI
+
 // ============================================================================
 // JNI Functions
 // ============================================================================
 
+// Static storage for previous CPU stats
+static CpuStats prev_stats = {};
+static bool has_prev_stats = false;
+
 extern "C" {
 
 /**
@@ -249,6 +288,7 @@ extern "C" {
  */
 JNIEXPORT jfloat JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuUsage(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.getCpuUsage", TRACE_CAT_JNI);
     CpuStats curr_stats;
 
     if (read_cpu_stats(&curr_stats) != 0) {
@@ -274,40 +314,68 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuUsage(JNIEnv* env, jo
  */
 JNIEXPORT void JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_resetCpuBaseline(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.resetCpuBaseline", TRACE_CAT_JNI);
     has_prev_stats = false;
     memset(&prev_stats, 0, sizeof(CpuStats));
     LOGI("CPU baseline reset");
 }
 
+// [totalMb, usedMb, availableMb, usagePercent]; zeros if meminfo is unreadable
+static bool memory_values(jfloat values[4]) {
+    MemoryStats stats;
+    values[0] = values[1] = values[2] = values[3] = 0.0f;
+
+    if (read_memory_stats(&stats) != 0) {
+        return false;
+    }
+
+    float total_mb = (float)stats.total_kb / 1024.0f;
+    float available_mb = (float)stats.available_kb / 1024.0f;
+    float used_mb = total_mb - available_mb;
+    float usage_percent = (total_mb > 0) ? (used_mb / total_mb * 100.0f) : 0.0f;
+
+    values[0] = total_mb;
+    values[1] = used_mb;
+    values[2] = available_mb;
+    values[3] = usage_percent;
+    return true;
+}
+
 /**
  * Get memory statistics.
  * Returns array: [totalMb, usedMb, availableMb, usagePercent]
  */
 JNIEXPORT jfloatArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getMemoryStats(JNIEnv* env, jobject thiz) {
-    MemoryStats stats;
+    NativeTraceScope trace("NativeMetrics.getMemoryStats", TRACE_CAT_JNI);
 
     jfloatArray result = env->NewFloatArray(4);
     if (!result) {
         return nullptr;
     }
 
-    float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-
-    if (read_memory_stats(&stats) == 0) {
-        float total_mb = (float)stats.total_kb / 1024.0f;
-        float available_mb = (float)stats.available_kb / 1024.0f;
-        float used_mb = total_mb - available_mb;
-        float usage_percent = (total_mb > 0) ? (used_mb / total_mb * 100.0f) : 0.0f;
+    jfloat values[4];
+    memory_values(values);
+    env->SetFloatArrayRegion(result, 0, 4, values);
+    return result;
+}
 
-        values[0] = total_mb;
-        values[1] = used_mb;
-        values[2] = available_mb;
-        values[3] = usage_percent;
+/**
+ * Memory statistics into a caller-owned array (no allocation).
+ * Writes [totalMb, usedMb, availableMb, usagePercent] to out[0..3].
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getMemoryStatsInto(JNIEnv* env, jobject thiz,
+                                                                       jfloatArray out) {
+    NativeTraceScope trace("NativeMetrics.getMemoryStatsInto", TRACE_CAT_JNI);
+    if (!out || env->GetArrayLength(out) < 4) {
+        return JNI_FALSE;
     }
 
-    env->SetFloatArrayRegion(result, 0, 4, values);
-    return result;
+    jfloat values[4];
+    bool ok = memory_values(values);
+    env->SetFloatArrayRegion(out, 0, 4, values);
+    return ok ? JNI_TRUE : JNI_FALSE;
 }
 
 /**
@@ -316,8 +384,9 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getMemoryStats(JNIEnv* env,
  */
 JNIEXPORT jfloat JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getTemperature(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.getTemperature", TRACE_CAT_JNI);
     // Try multiple thermal zones, return first valid one
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < MAX_THERMAL_ZONES; i++) {
         float temp = read_temperature(i);
         if (temp > 0.0f && temp < 150.0f) { // Sanity check
             return temp;
@@ -331,15 +400,27 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getTemperature(JNIEnv* env,
  */
 JNIEXPORT jboolean JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_isAvailable(JNIEnv* env, jobject thiz) {
+    NativeTraceScope trace("NativeMetrics.isAvailable", TRACE_CAT_JNI);
     return JNI_TRUE;
 }
 
+/**
+ * Number of configured CPU cores, or -1 if unavailable.
+ * Read once; the count does not change while the process runs.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuCoreCount(JNIEnv* env, jobject thiz) {
+    static const long cores = sysconf(_SC_NPROCESSORS_CONF);
+    return cores > 0 ? static_cast<jint>(cores) : -1;
+}
+
 /**
  * Get CPU stats for specific PID.
  * Returns array: [utime, stime, total_time] or null if failed.
  */
 JNIEXPORT jlongArray JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStats(JNIEnv* env, jobject thiz, jint pid) {
+    NativeTraceScope trace("NativeMetrics.getProcessCpuStats", TRACE_CAT_JNI);
     ProcessCpuStats stats;
 
     if (read_process_cpu_stats(pid, &stats) != 0) {
@@ -356,12 +437,32 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStats(JNIEnv*
     return result;
 }
 
+/**
+ * CPU stats for a PID into a caller-owned array (no allocation).
+ * Writes [utime, stime, total_time] to out[0..2]; false if unreadable.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStatsInto(JNIEnv* env, jobject thiz,
+                                                                           jint pid, jlongArray out) {
+    NativeTraceScope trace("NativeMetrics.getProcessCpuStatsInto", TRACE_CAT_JNI);
+    ProcessCpuStats stats;
+
+    if (!out || env->GetArrayLength(out) < 3 || read_process_cpu_stats(pid, &stats) != 0) {
+        return JNI_FALSE;
+    }
+
+    jlong values[3] = {stats.utime, stats.stime, stats.total_time};
+    env->SetLongArrayRegion(out, 0, 3, values);
+    return JNI_TRUE;
+}
+
 /**
  * Format time string natively.
  */
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatTimeString(JNIEnv* env, jobject thiz,
                                                                      jint hour, jint minute, jboolean use24h) {
+    NativeTraceScope trace("NativeMetrics.formatTimeString", TRACE_CAT_JNI);
     char buffer[16];
     int len = format_time_string(buffer, sizeof(buffer), hour, minute, use24h);
     return env->NewStringUTF(buffer);
@@ -372,6 +473,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatTimeString(JNIEnv* en
  */
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatCpuString(JNIEnv* env, jobject thiz, jfloat cpuPercent) {
+    NativeTraceScope trace("NativeMetrics.formatCpuString", TRACE_CAT_JNI);
     char buffer[32];
     format_cpu_string(buffer, sizeof(buffer), cpuPercent);
     return env->NewStringUTF(buffer);
@@ -383,6 +485,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatCpuString(JNIEnv* env
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatRamString(JNIEnv* env, jobject thiz,
                                                                     jlong usedMb, jlong totalMb) {
+    NativeTraceScope trace("NativeMetrics.formatRamString", TRACE_CAT_JNI);
     char buffer[32];
     format_ram_string(buffer, sizeof(buffer), usedMb, totalMb);
     return env->NewStringUTF(buffer);
@@ -394,9 +497,106 @@ Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatRamString(JNIEnv* env
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatSelfStatsString(JNIEnv* env, jobject thiz,
                                                                           jfloat cpuPercent, jlong ramMb) {
+    NativeTraceScope trace("NativeMetrics.formatSelfStatsString", TRACE_CAT_JNI);
     char buffer[32];
     format_self_stats_string(buffer, sizeof(buffer), cpuPercent, ramMb);
     return env->NewStringUTF(buffer);
 }
 
+/**
+ * Point all native collectors at a different proc/sys root ("" = live system).
+ * Returns true on success.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_setProcRoot(JNIEnv* env, jobject thiz, jstring root) {
+    NativeTraceScope trace("NativeMetrics.setProcRoot", TRACE_CAT_JNI);
+    const char* root_str = root ? env->GetStringUTFChars(root, nullptr) : nullptr;
+    int result = native_paths_set_root(root_str);
+    if (root_str) {
+        env->ReleaseStringUTFChars(root, root_str);
+    }
+    return result == 0 ? JNI_TRUE : JNI_FALSE;
 }
+
+/**
+ * Snapshot the relevant proc/sys files into <dir>/<index>/ for offline replay.
+ * Returns number of files recorded, or -1 on error.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_recordSnapshot(JNIEnv* env, jobject thiz,
+                                                                   jstring dir, jint index) {
+    NativeTraceScope trace("NativeMetrics.recordSnapshot", TRACE_CAT_JNI);
+    if (!dir) return -1;
+    const char* dir_str = env->GetStringUTFChars(dir, nullptr);
+    if (!dir_str) return -1;
+    int result = native_record_snapshot(dir_str, index);
+    env->ReleaseStringUTFChars(dir, dir_str);
+    return result;
+}
+}
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod METRICS_METHODS[] = {
+    NATIVE_METHOD("getCpuUsage", "()F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuUsage),
+    NATIVE_METHOD("resetCpuBaseline", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_resetCpuBaseline),
+    NATIVE_METHOD("getMemoryStats", "()[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getMemoryStats),
+    NATIVE_METHOD("getMemoryStatsInto", "([F)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getMemoryStatsInto),
+    NATIVE_METHOD("getTemperature", "()F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getTemperature),
+    NATIVE_METHOD("isAvailable", "()Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_isAvailable),
+    NATIVE_METHOD("getCpuCoreCount", "()I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuCoreCount),
+    NATIVE_METHOD("getProcessCpuStats", "(I)[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStats),
+    NATIVE_METHOD("getProcessCpuStatsInto", "(I[J)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStatsInto),
+    NATIVE_METHOD("formatTimeString", "(IIZ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatTimeString),
+    NATIVE_METHOD("formatCpuString", "(F)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatCpuString),
+    NATIVE_METHOD("formatRamString", "(JJ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatRamString),
+    NATIVE_METHOD("formatSelfStatsString", "(FJ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatSelfStatsString),
+    NATIVE_METHOD("setProcRoot", "(Ljava/lang/String;)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_setProcRoot),
+    NATIVE_METHOD("recordSnapshot", "(Ljava/lang/String;I)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_recordSnapshot),
+};
+const NativeMethodList NATIVE_METRICS_JNI = NATIVE_METHOD_LIST(METRICS_METHODS);
+
+// NativeStringFormatter and NativeCpuMetricsCollector declare their own
+// externals for the same functions
+static const NativeMethod STRING_FORMATTER_METHODS[] = {
+    NATIVE_METHOD("formatTimeString", "(IIZ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatTimeString),
+    NATIVE_METHOD("formatCpuString", "(F)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatCpuString),
+    NATIVE_METHOD("formatRamString", "(JJ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatRamString),
+    NATIVE_METHOD("formatSelfStatsString", "(FJ)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_formatSelfStatsString),
+};
+const NativeMethodList NATIVE_STRING_FORMATTER_JNI = NATIVE_METHOD_LIST(STRING_FORMATTER_METHODS);
+
+static const NativeMethod CPU_COLLECTOR_METHODS[] = {
+    NATIVE_METHOD("getCpuUsageNative", "()F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuUsage),
+    NATIVE_METHOD("resetCpuBaselineNative", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_resetCpuBaseline),
+    NATIVE_METHOD("getCpuCoreCountNative", "()I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getCpuCoreCount),
+    NATIVE_METHOD("getProcessCpuStats", "(I)[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessCpuStats),
+};
+const NativeMethodList NATIVE_CPU_COLLECTOR_JNI = NATIVE_METHOD_LIST(CPU_COLLECTOR_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
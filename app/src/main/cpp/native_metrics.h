@@ -1,7 +1,9 @@
 #ifndef SYSMETRICS_NATIVE_METRICS_H
 #define SYSMETRICS_NATIVE_METRICS_H
 
+#ifndef SYSMETRICS_NO_JNI
 #include <jni.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +52,12 @@ float calculate_cpu_usage(const CpuStats* prev, const CpuStats* curr);
  */
 int read_memory_stats(MemoryStats* stats);
 
+/**
+ * Reads temperature from /sys/class/thermal/thermal_zone<zone>/temp.
+ * Returns temperature in Celsius, or -1 if unavailable.
+ */
+float read_temperature(int zone);
+
 /**
  * Process statistics for CPU calculation.
  */
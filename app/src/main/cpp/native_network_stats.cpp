@@ -1,24 +1,25 @@
 #include "native_network_stats.h"
+#include "native_format.h"
+#include "native_paths.h"
+#include "native_instrument.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <sys/time.h>
 #include <errno.h>
 #include <inttypes.h>
 
-// Path to /proc/net/dev
-static const char* PROC_NET_DEV = "/proc/net/dev";
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
 
 // Buffer size for reading file
 #define READ_BUFFER_SIZE 4096
 
-// Get current timestamp in milliseconds
+// Get current timestamp in milliseconds (recorded time while replaying)
 static int64_t get_timestamp_ms() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    return native_clock_now_ms();
 }
 
 // Check if interface is loopback
@@ -74,10 +75,13 @@ static int parse_interface_line(const char* line, InterfaceStatsNative* stats, i
     return 0;
 }
 
-int native_read_proc_net_dev(InterfaceStatsNative* stats, int max_count) {
+static int read_proc_net_dev_impl(InterfaceStatsNative* stats, int max_count) {
     if (!stats || max_count <= 0) return -1;
     
-    int fd = open(PROC_NET_DEV, O_RDONLY);
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PROC_NET_DEV) < 0) return -1;
+
+    int fd = open(path, O_RDONLY);
     if (fd < 0) return -1;
     
     char buffer[READ_BUFFER_SIZE];
@@ -108,6 +112,11 @@ int native_read_proc_net_dev(InterfaceStatsNative* stats, int max_count) {
     return count;
 }
 
+int native_read_proc_net_dev(InterfaceStatsNative* stats, int max_count) {
+    NativeProbeScope probe(PROBE_READ_PROC_NET_DEV);
+    return probe.check(read_proc_net_dev_impl(stats, max_count));
+}
+
 int native_aggregate_network_stats(
     const InterfaceStatsNative* interfaces,
     int count,
@@ -200,33 +209,11 @@ int native_format_speed_string(
     int buffer_size,
     const char* prefix
 ) {
-    if (!buffer || buffer_size <= 0) return -1;
-    
-    const char* pfx = prefix ? prefix : "";
-    
-    if (bytes_per_sec < 1024) {
-        return snprintf(buffer, buffer_size, "%s%" PRIu64 " B/s", pfx, bytes_per_sec);
-    } else if (bytes_per_sec < 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%s%.1f KB/s", pfx, bytes_per_sec / 1024.0f);
-    } else if (bytes_per_sec < 1024ULL * 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%s%.2f MB/s", pfx, bytes_per_sec / (1024.0f * 1024.0f));
-    } else {
-        return snprintf(buffer, buffer_size, "%s%.2f GB/s", pfx, bytes_per_sec / (1024.0f * 1024.0f * 1024.0f));
-    }
+    return native_fmt_speed(buffer, buffer_size, prefix, bytes_per_sec);
 }
 
 int native_format_bytes_string(uint64_t bytes, char* buffer, int buffer_size) {
-    if (!buffer || buffer_size <= 0) return -1;
-    
-    if (bytes < 1024) {
-        return snprintf(buffer, buffer_size, "%" PRIu64 " B", bytes);
-    } else if (bytes < 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1f KB", bytes / 1024.0f);
-    } else if (bytes < 1024ULL * 1024 * 1024) {
-        return snprintf(buffer, buffer_size, "%.1f MB", bytes / (1024.0f * 1024.0f));
-    } else {
-        return snprintf(buffer, buffer_size, "%.2f GB", bytes / (1024.0f * 1024.0f * 1024.0f));
-    }
+    return native_fmt_bytes(buffer, buffer_size, bytes);
 }
 
 float native_bytes_to_mbps(uint64_t bytes_per_sec) {
@@ -235,12 +222,17 @@ float native_bytes_to_mbps(uint64_t bytes_per_sec) {
 }
 
 int native_is_proc_net_dev_available(void) {
-    int fd = open(PROC_NET_DEV, O_RDONLY);
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PROC_NET_DEV) < 0) return 0;
+
+    int fd = open(path, O_RDONLY);
     if (fd < 0) return 0;
     close(fd);
     return 1;
 }
 
+#ifndef SYSMETRICS_NO_JNI
+
 /* JNI Implementations */
 
 JNIEXPORT jlong JNICALL
@@ -248,6 +240,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetTotalRxByte
     JNIEnv* env,
     jobject thiz
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeGetTotalRxBytes", TRACE_CAT_JNI);
     uint64_t rx_bytes, tx_bytes;
     if (native_get_total_bytes(&rx_bytes, &tx_bytes) < 0) {
         return -1;
@@ -260,6 +253,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetTotalTxByte
     JNIEnv* env,
     jobject thiz
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeGetTotalTxBytes", TRACE_CAT_JNI);
     uint64_t rx_bytes, tx_bytes;
     if (native_get_total_bytes(&rx_bytes, &tx_bytes) < 0) {
         return -1;
@@ -272,6 +266,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnap
     JNIEnv* env,
     jobject thiz
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeGetNetworkSnapshot", TRACE_CAT_JNI);
     uint64_t rx_bytes, tx_bytes;
     if (native_get_total_bytes(&rx_bytes, &tx_bytes) < 0) {
         return NULL;
@@ -289,20 +284,32 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnap
     return result;
 }
 
-JNIEXPORT jfloatArray JNICALL
-Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeed(
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnapshotInto(
     JNIEnv* env,
     jobject thiz,
-    jlong prev_rx,
-    jlong prev_tx,
-    jlong prev_time,
-    jlong curr_rx,
-    jlong curr_tx,
-    jlong curr_time
+    jlongArray out
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeGetNetworkSnapshotInto", TRACE_CAT_JNI);
+    if (out == NULL || env->GetArrayLength(out) < 3) return JNI_FALSE;
+    
+    uint64_t rx_bytes, tx_bytes;
+    if (native_get_total_bytes(&rx_bytes, &tx_bytes) < 0) {
+        return JNI_FALSE;
+    }
+    
+    // Same layout as nativeGetNetworkSnapshot: [rx_bytes, tx_bytes, timestamp]
+    jlong data[3] = { (jlong)rx_bytes, (jlong)tx_bytes, (jlong)get_timestamp_ms() };
+    env->SetLongArrayRegion(out, 0, 3, data);
+    return JNI_TRUE;
+}
+
+/* [rx_bytes_per_sec, tx_bytes_per_sec, rx_mbps, tx_mbps]; false if time did not advance */
+static bool calculate_speed(jlong prev_rx, jlong prev_tx, jlong prev_time,
+                            jlong curr_rx, jlong curr_tx, jlong curr_time, jfloat data[4]) {
     int64_t time_delta_ms = curr_time - prev_time;
     if (time_delta_ms <= 0) {
-        return NULL;
+        return false;
     }
     
     uint64_t rx_delta = (curr_rx > prev_rx) ? (curr_rx - prev_rx) : 0;
@@ -312,19 +319,62 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeed
     uint64_t rx_bps = (uint64_t)(rx_delta / time_delta_sec);
     uint64_t tx_bps = (uint64_t)(tx_delta / time_delta_sec);
     
-    float rx_mbps = native_bytes_to_mbps(rx_bps);
-    float tx_mbps = native_bytes_to_mbps(tx_bps);
+    data[0] = (jfloat)rx_bps;
+    data[1] = (jfloat)tx_bps;
+    data[2] = native_bytes_to_mbps(rx_bps);
+    data[3] = native_bytes_to_mbps(tx_bps);
+    return true;
+}
+
+JNIEXPORT jfloatArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeed(
+    JNIEnv* env,
+    jobject thiz,
+    jlong prev_rx,
+    jlong prev_tx,
+    jlong prev_time,
+    jlong curr_rx,
+    jlong curr_tx,
+    jlong curr_time
+) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeCalculateSpeed", TRACE_CAT_JNI);
+    jfloat data[4];
+    if (!calculate_speed(prev_rx, prev_tx, prev_time, curr_rx, curr_tx, curr_time, data)) {
+        return NULL;
+    }
     
     // Return array: [rx_bytes_per_sec, tx_bytes_per_sec, rx_mbps, tx_mbps]
     jfloatArray result = env->NewFloatArray(4);
     if (result == NULL) return NULL;
     
-    jfloat data[4] = { (jfloat)rx_bps, (jfloat)tx_bps, rx_mbps, tx_mbps };
     env->SetFloatArrayRegion(result, 0, 4, data);
     
     return result;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeedInto(
+    JNIEnv* env,
+    jobject thiz,
+    jlong prev_rx,
+    jlong prev_tx,
+    jlong prev_time,
+    jlong curr_rx,
+    jlong curr_tx,
+    jlong curr_time,
+    jfloatArray out
+) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeCalculateSpeedInto", TRACE_CAT_JNI);
+    if (out == NULL || env->GetArrayLength(out) < 4) return JNI_FALSE;
+    
+    jfloat data[4];
+    if (!calculate_speed(prev_rx, prev_tx, prev_time, curr_rx, curr_tx, curr_time, data)) {
+        return JNI_FALSE;
+    }
+    env->SetFloatArrayRegion(out, 0, 4, data);
+    return JNI_TRUE;
+}
+
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeFormatSpeed(
     JNIEnv* env,
@@ -332,6 +382,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeFormatSpeed(
     jlong bytes_per_sec,
     jstring prefix
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeFormatSpeed", TRACE_CAT_JNI);
     const char* prefix_str = NULL;
     if (prefix != NULL) {
         prefix_str = env->GetStringUTFChars(prefix, NULL);
@@ -352,6 +403,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeIsAvailable(
     JNIEnv* env,
     jobject thiz
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeIsAvailable", TRACE_CAT_JNI);
     return native_is_proc_net_dev_available() ? JNI_TRUE : JNI_FALSE;
 }
 
@@ -360,6 +412,7 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetInterfaceCo
     JNIEnv* env,
     jobject thiz
 ) {
+    NativeTraceScope trace("NativeNetworkMetrics.nativeGetInterfaceCount", TRACE_CAT_JNI);
     InterfaceStatsNative interfaces[MAX_INTERFACES];
     int count = native_read_proc_net_dev(interfaces, MAX_INTERFACES);
     
@@ -375,3 +428,31 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetInterfaceCo
     
     return valid_count;
 }
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod NETWORK_METHODS[] = {
+    NATIVE_METHOD("nativeGetTotalRxBytes", "()J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetTotalRxBytes),
+    NATIVE_METHOD("nativeGetTotalTxBytes", "()J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetTotalTxBytes),
+    NATIVE_METHOD("nativeGetNetworkSnapshot", "()[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnapshot),
+    NATIVE_METHOD("nativeGetNetworkSnapshotInto", "([J)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnapshotInto),
+    NATIVE_METHOD("nativeCalculateSpeed", "(JJJJJJ)[F",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeed),
+    NATIVE_METHOD("nativeCalculateSpeedInto", "(JJJJJJ[F)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeedInto),
+    NATIVE_METHOD("nativeFormatSpeed", "(JLjava/lang/String;)Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeFormatSpeed),
+    NATIVE_METHOD("nativeIsAvailable", "()Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeIsAvailable),
+    NATIVE_METHOD("nativeGetInterfaceCount", "()I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetInterfaceCount),
+};
+const NativeMethodList NATIVE_NETWORK_JNI = NATIVE_METHOD_LIST(NETWORK_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
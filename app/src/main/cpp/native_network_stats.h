@@ -1,7 +1,9 @@
 #ifndef SYSMETRICS_NATIVE_NETWORK_STATS_H
 #define SYSMETRICS_NATIVE_NETWORK_STATS_H
 
+#ifndef SYSMETRICS_NO_JNI
 #include <jni.h>
+#endif
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -153,6 +155,8 @@ float native_bytes_to_mbps(uint64_t bytes_per_sec);
  */
 int native_is_proc_net_dev_available(void);
 
+#ifndef SYSMETRICS_NO_JNI
+
 /* JNI function declarations */
 
 JNIEXPORT jlong JNICALL
@@ -185,6 +189,26 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeed
     jlong curr_time
 );
 
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetNetworkSnapshotInto(
+    JNIEnv* env,
+    jobject thiz,
+    jlongArray out
+);
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeCalculateSpeedInto(
+    JNIEnv* env,
+    jobject thiz,
+    jlong prev_rx,
+    jlong prev_tx,
+    jlong prev_time,
+    jlong curr_rx,
+    jlong curr_tx,
+    jlong curr_time,
+    jfloatArray out
+);
+
 JNIEXPORT jstring JNICALL
 Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeFormatSpeed(
     JNIEnv* env,
@@ -205,6 +229,8 @@ Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeGetInterfaceCo
     jobject thiz
 );
 
+#endif // SYSMETRICS_NO_JNI
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,426 @@
+#include "native_paths.h"
+#include "native_format.h"
+#include "native_seqlock.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#define LOG_TAG "NATIVE_PATHS"
+#include "native_platform.h"
+
+// ============================================================================
+// Root Prefix
+// ============================================================================
+
+struct RootPrefix {
+    int32_t len;
+    char path[NATIVE_PATH_MAX];
+};
+
+// Readers copy the prefix out of a seqlock and retry when a set_root
+// overlapped the copy; set_root calls are serialised by the mutex
+static SeqlockSlot<RootPrefix> g_root;
+static std::mutex g_root_writer_mutex;
+static std::atomic<uint32_t> g_root_generation(0);
+
+static void load_root(RootPrefix* out) {
+    if (g_root.read(out)) return;
+    std::lock_guard<std::mutex> lock(g_root_writer_mutex);
+    g_root.read(out);
+}
+
+int native_paths_set_root(const char* root) {
+    size_t len = root ? strlen(root) : 0;
+
+    // "/" and "/tmp/fixture/" behave like "" and "/tmp/fixture"
+    while (len > 0 && root[len - 1] == '/') len--;
+    if (len >= NATIVE_PATH_MAX) {
+        LOGE("Root prefix too long (%zu bytes)", len);
+        return -1;
+    }
+
+    RootPrefix prefix = {};
+    if (len > 0) memcpy(prefix.path, root, len);
+    prefix.len = static_cast<int32_t>(len);
+
+    std::lock_guard<std::mutex> lock(g_root_writer_mutex);
+    g_root.publish(prefix);
+    g_root_generation.fetch_add(1, std::memory_order_release);
+    return 0;
+}
+
+uint32_t native_paths_generation(void) {
+    return g_root_generation.load(std::memory_order_acquire);
+}
+
+const char* native_paths_get_root(void) {
+    static thread_local RootPrefix copy;
+    load_root(&copy);
+    return copy.path;
+}
+
+static void put_root(FormatWriter* writer) {
+    RootPrefix prefix;
+    load_root(&prefix);
+    if (prefix.len > 0) {
+        native_fmt_put_str(writer, prefix.path);
+    }
+}
+
+static int finish_path(FormatWriter* writer, int out_size) {
+    int len = native_fmt_finish(writer);
+    return len < out_size ? len : -1;
+}
+
+int native_path(char* out, int out_size, const char* abs_path) {
+    if (!out || out_size <= 0 || !abs_path) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, out, out_size);
+    put_root(&writer);
+    native_fmt_put_str(&writer, abs_path);
+    return finish_path(&writer, out_size);
+}
+
+int native_path_pid(char* out, int out_size, int pid, const char* leaf) {
+    if (!out || out_size <= 0 || !leaf) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, out, out_size);
+    put_root(&writer);
+    native_fmt_put_str(&writer, "/proc/");
+    native_fmt_put_i64(&writer, pid);
+    native_fmt_put_char(&writer, '/');
+    native_fmt_put_str(&writer, leaf);
+    return finish_path(&writer, out_size);
+}
+
+int native_path_task(char* out, int out_size, int pid, int tid, const char* leaf) {
+    if (!out || out_size <= 0 || !leaf) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, out, out_size);
+    put_root(&writer);
+    native_fmt_put_str(&writer, "/proc/");
+    native_fmt_put_i64(&writer, pid);
+    native_fmt_put_str(&writer, "/task/");
+    native_fmt_put_i64(&writer, tid);
+    native_fmt_put_char(&writer, '/');
+    native_fmt_put_str(&writer, leaf);
+    return finish_path(&writer, out_size);
+}
+
+int native_path_thermal(char* out, int out_size, int zone, const char* leaf) {
+    if (!out || out_size <= 0 || !leaf) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, out, out_size);
+    put_root(&writer);
+    native_fmt_put_str(&writer, SYS_THERMAL_ZONE);
+    native_fmt_put_i64(&writer, zone);
+    native_fmt_put_char(&writer, '/');
+    native_fmt_put_str(&writer, leaf);
+    return finish_path(&writer, out_size);
+}
+
+int native_path_cpu(char* out, int out_size, int cpu, const char* leaf) {
+    if (!out || out_size <= 0 || !leaf) return -1;
+
+    FormatWriter writer;
+    native_fmt_init(&writer, out, out_size);
+    put_root(&writer);
+    native_fmt_put_str(&writer, SYS_CPU);
+    native_fmt_put_i64(&writer, cpu);
+    native_fmt_put_char(&writer, '/');
+    native_fmt_put_str(&writer, leaf);
+    return finish_path(&writer, out_size);
+}
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+static std::atomic<bool> g_replay_active(false);
+static std::atomic<int64_t> g_replay_now_ms(0);
+
+static int64_t wall_clock_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+int64_t native_clock_now_ms(void) {
+    if (g_replay_active.load(std::memory_order_acquire)) {
+        return g_replay_now_ms.load(std::memory_order_relaxed);
+    }
+    return wall_clock_ms();
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+/**
+ * Files captured per snapshot. A "%d" in the path is expanded for
+ * indices 0..index_count-1 (index_count 0 means a single literal path).
+ */
+struct RecordedFile {
+    const char* path;
+    int index_count;
+};
+
+static const RecordedFile RECORDED_FILES[] = {
+    { PROC_STAT, 0 },
+    { PROC_MEMINFO, 0 },
+    { PROC_NET_DEV, 0 },
+    { SYS_THERMAL_ZONE "%d/temp", MAX_THERMAL_ZONES },
+    { SYS_THERMAL_ZONE "%d/type", MAX_THERMAL_ZONES },
+    { PROC_PRESSURE_CPU, 0 },
+    { PROC_PRESSURE_MEMORY, 0 },
+    { PROC_PRESSURE_IO, 0 },
+    { PROC_DISKSTATS, 0 },
+    { PROC_VMSTAT, 0 },
+    { SYS_ZRAM_MM_STAT, 0 },
+    { PROC_XT_QTAGUID, 0 },
+    { SYS_KGSL_GPU "/gpubusy", 0 },
+    { SYS_KGSL_GPU "/gpuclk", 0 },
+    { SYS_KGSL_GPU "/temp", 0 },
+    { SYS_MALI_GPU "/utilization", 0 },
+    { SYS_MALI_GPU "/clock", 0 },
+    { SYS_DRI_GPU_USAGE, 0 },
+    { SYS_CPU "%d/cpufreq/related_cpus", MAX_CPUFREQ_CPUS },
+    { SYS_CPU "%d/cpufreq/scaling_cur_freq", MAX_CPUFREQ_CPUS },
+    { SYS_CPU "%d/cpufreq/scaling_max_freq", MAX_CPUFREQ_CPUS },
+    { SYS_CPU "%d/cpufreq/cpuinfo_max_freq", MAX_CPUFREQ_CPUS },
+    { SYS_CPU "%d/cpufreq/stats/time_in_state", MAX_CPUFREQ_CPUS },
+};
+
+static void expand_pattern(std::string& out, const char* pattern, int index) {
+    out.clear();
+    const char* marker = strstr(pattern, "%d");
+    if (!marker) {
+        out.append(pattern);
+        return;
+    }
+
+    char digits[24];
+    FormatWriter writer;
+    native_fmt_init(&writer, digits, sizeof(digits));
+    native_fmt_put_i64(&writer, index);
+    native_fmt_finish(&writer);
+
+    out.append(pattern, marker - pattern);
+    out.append(digits);
+    out.append(marker + 2);
+}
+
+static std::string snapshot_dir(const char* recording_dir, int index) {
+    char digits[24];
+    FormatWriter writer;
+    native_fmt_init(&writer, digits, sizeof(digits));
+    native_fmt_put_u64(&writer, static_cast<uint64_t>(index), 6);
+    native_fmt_finish(&writer);
+
+    std::string dir(recording_dir);
+    while (!dir.empty() && dir.back() == '/') dir.pop_back();
+    dir.push_back('/');
+    dir.append(digits);
+    return dir;
+}
+
+// mkdir -p for every parent directory of path
+static int make_parent_dirs(const std::string& path) {
+    for (size_t pos = 1; (pos = path.find('/', pos)) != std::string::npos; pos++) {
+        std::string dir = path.substr(0, pos);
+        if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static bool read_whole_file(const char* path, std::vector<char>& data) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    data.clear();
+    char chunk[4096];
+    ssize_t n;
+    while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    close(fd);
+    return n == 0;
+}
+
+static bool write_whole_file(const std::string& path, const char* data, size_t size) {
+    if (make_parent_dirs(path) != 0) return false;
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        if (n <= 0) break;
+        written += static_cast<size_t>(n);
+    }
+    close(fd);
+    return written == size;
+}
+
+int native_record_snapshot(const char* recording_dir, int index) {
+    if (!recording_dir || index < 0) return -1;
+
+    std::string dir = snapshot_dir(recording_dir, index);
+    std::string abs_path;
+    std::vector<char> data;
+    char source[NATIVE_PATH_MAX];
+    int recorded = 0;
+
+    // Stamp first so the time matches the start of the capture
+    int64_t timestamp = wall_clock_ms();
+
+    for (const RecordedFile& file : RECORDED_FILES) {
+        int count = file.index_count > 0 ? file.index_count : 1;
+        for (int i = 0; i < count; i++) {
+            expand_pattern(abs_path, file.path, i);
+            if (native_path(source, sizeof(source), abs_path.c_str()) < 0) continue;
+            if (!read_whole_file(source, data)) continue;
+
+            if (!write_whole_file(dir + abs_path, data.data(), data.size())) {
+                LOGE("Failed to write snapshot file %s%s", dir.c_str(), abs_path.c_str());
+                return -1;
+            }
+            recorded++;
+        }
+    }
+
+    char stamp[24];
+    int stamp_len = 0;
+    {
+        FormatWriter writer;
+        native_fmt_init(&writer, stamp, sizeof(stamp));
+        native_fmt_put_i64(&writer, timestamp);
+        native_fmt_put_char(&writer, '\n');
+        stamp_len = native_fmt_finish(&writer);
+    }
+    if (!write_whole_file(dir + "/" SNAPSHOT_TIMESTAMP_FILE, stamp, stamp_len)) {
+        return -1;
+    }
+
+    LOGD("Recorded %d files into %s", recorded, dir.c_str());
+    return recorded;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+struct ReplayState {
+    std::vector<std::string> snapshot_roots;
+    std::vector<int64_t> timestamps;
+    int index = -1;
+    int64_t loop_offset = 0;
+    std::string saved_root;
+};
+
+static ReplayState g_replay;
+
+static bool read_timestamp(const std::string& dir, int64_t* out) {
+    std::vector<char> data;
+    if (!read_whole_file((dir + "/" SNAPSHOT_TIMESTAMP_FILE).c_str(), data)) return false;
+
+    int64_t value = 0;
+    bool any = false;
+    for (char c : data) {
+        if (c < '0' || c > '9') break;
+        value = value * 10 + (c - '0');
+        any = true;
+    }
+    *out = value;
+    return any;
+}
+
+static void activate_snapshot(int index) {
+    g_replay.index = index;
+    native_paths_set_root(g_replay.snapshot_roots[index].c_str());
+    g_replay_now_ms.store(g_replay.timestamps[index] + g_replay.loop_offset,
+                          std::memory_order_relaxed);
+}
+
+int native_replay_open(const char* recording_dir) {
+    if (!recording_dir) return -1;
+    if (native_replay_is_active()) native_replay_close();
+
+    std::vector<std::string> roots;
+    std::vector<int64_t> timestamps;
+    for (int i = 0;; i++) {
+        std::string dir = snapshot_dir(recording_dir, i);
+        int64_t ts;
+        if (!read_timestamp(dir, &ts)) break;
+        roots.push_back(dir);
+        timestamps.push_back(ts);
+    }
+
+    if (roots.empty()) {
+        LOGE("No snapshots found in %s", recording_dir);
+        return -1;
+    }
+
+    g_replay.saved_root = native_paths_get_root();
+    g_replay.snapshot_roots.swap(roots);
+    g_replay.timestamps.swap(timestamps);
+    g_replay.loop_offset = 0;
+    activate_snapshot(0);
+    g_replay_active.store(true, std::memory_order_release);
+
+    return static_cast<int>(g_replay.snapshot_roots.size());
+}
+
+int native_replay_step(void) {
+    if (!native_replay_is_active()) return -1;
+
+    // Hold the last snapshot: wrapping would make the cumulative counters
+    // in /proc/stat, /proc/net/dev etc. drop under the collectors
+    int next = g_replay.index + 1;
+    if (next >= static_cast<int>(g_replay.snapshot_roots.size())) return -1;
+
+    activate_snapshot(next);
+    return next;
+}
+
+int native_replay_rewind(void) {
+    if (!native_replay_is_active()) return -1;
+
+    // Continue the clock past the last snapshot by one recorded interval
+    int count = static_cast<int>(g_replay.snapshot_roots.size());
+    int64_t span = g_replay.timestamps[count - 1] - g_replay.timestamps[0];
+    int64_t interval = count > 1 ? g_replay.timestamps[1] - g_replay.timestamps[0] : 1000;
+    g_replay.loop_offset += span + (interval > 0 ? interval : 1000);
+
+    activate_snapshot(0);
+    return 0;
+}
+
+void native_replay_close(void) {
+    if (!native_replay_is_active()) return;
+
+    g_replay_active.store(false, std::memory_order_release);
+    native_paths_set_root(g_replay.saved_root.c_str());
+    g_replay.snapshot_roots.clear();
+    g_replay.timestamps.clear();
+    g_replay.index = -1;
+    g_replay.loop_offset = 0;
+}
+
+int native_replay_is_active(void) {
+    return g_replay_active.load(std::memory_order_acquire) ? 1 : 0;
+}
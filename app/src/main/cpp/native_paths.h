@@ -0,0 +1,170 @@
+#ifndef SYSMETRICS_NATIVE_PATHS_H
+#define SYSMETRICS_NATIVE_PATHS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE PATHS - Rooted procfs/sysfs access with record & replay
+ * ============================================================================
+ *
+ * Every native collector resolves its kernel files through this module
+ * instead of hard-coding "/proc/..." literals. That allows:
+ *
+ * - A root prefix, so a fake tree (e.g. "/tmp/fixture") can stand in for "/"
+ * - Recording: snapshot the relevant proc/sys files of a live box into
+ *   <dir>/000000/, <dir>/000001/, ... together with a timestamp_ms file
+ * - Replay: step the root through recorded snapshots and serve the recorded
+ *   timestamps from native_clock_now_ms(), so rate calculations (network
+ *   speed, CPU deltas) reproduce exactly and can run far faster than real time
+ *
+ * The root is published through a seqlock: readers copy it and retry when a
+ * change overlapped the copy, so a reader never sees a half-written prefix.
+ * Root changes are intended for startup, tests and replay driven from the
+ * sampling thread.
+ */
+
+#define NATIVE_PATH_MAX 256
+
+// Canonical absolute paths (resolved against the configured root)
+#define PROC_STAT         "/proc/stat"
+#define PROC_MEMINFO      "/proc/meminfo"
+#define PROC_NET_DEV      "/proc/net/dev"
+#define SYS_THERMAL_ZONE  "/sys/class/thermal/thermal_zone"
+#define SYS_CPU           "/sys/devices/system/cpu/cpu"
+#define PROC_PRESSURE_CPU    "/proc/pressure/cpu"
+#define PROC_PRESSURE_MEMORY "/proc/pressure/memory"
+#define PROC_PRESSURE_IO     "/proc/pressure/io"
+#define PROC_DISKSTATS    "/proc/diskstats"
+#define PROC_VMSTAT       "/proc/vmstat"
+#define PROC_XT_QTAGUID   "/proc/net/xt_qtaguid/stats"
+#define SYS_ZRAM_MM_STAT  "/sys/block/zram0/mm_stat"
+#define SYS_KGSL_GPU      "/sys/class/kgsl/kgsl-3d0"
+#define SYS_MALI_GPU      "/sys/devices/platform/mali"
+#define SYS_DRI_GPU_USAGE "/sys/kernel/debug/dri/0/gpu_usage"
+
+// Number of thermal zones probed by collectors and the recorder
+#define MAX_THERMAL_ZONES 10
+
+// Number of CPUs probed for cpufreq policies by collectors and the recorder
+#define MAX_CPUFREQ_CPUS 16
+
+// Name of the per-snapshot timestamp file written by the recorder
+#define SNAPSHOT_TIMESTAMP_FILE "timestamp_ms"
+
+// ============================================================================
+// Root Prefix API
+// ============================================================================
+
+/**
+ * Set the root prefix prepended to every kernel path.
+ * @param root Directory standing in for "/", or NULL/"" for the live system
+ * @return 0 on success, -1 if the prefix is too long
+ */
+int native_paths_set_root(const char* root);
+
+/**
+ * Current root prefix ("" when reading the live system), copied into a
+ * per-thread buffer that the next call on the same thread overwrites.
+ */
+const char* native_paths_get_root(void);
+
+/**
+ * Incremented on every root change (including replay steps). Collectors
+ * that keep files open compare it to know when to reopen them.
+ */
+uint32_t native_paths_generation(void);
+
+/**
+ * Resolve an absolute kernel path (e.g. PROC_STAT) against the root.
+ * @return Length of the resolved path, or -1 if it does not fit
+ */
+int native_path(char* out, int out_size, const char* abs_path);
+
+/**
+ * Resolve /proc/<pid>/<leaf> against the root.
+ * @return Length of the resolved path, or -1 if it does not fit
+ */
+int native_path_pid(char* out, int out_size, int pid, const char* leaf);
+
+/**
+ * Resolve /proc/<pid>/task/<tid>/<leaf> against the root.
+ * @return Length of the resolved path, or -1 if it does not fit
+ */
+int native_path_task(char* out, int out_size, int pid, int tid, const char* leaf);
+
+/**
+ * Resolve /sys/class/thermal/thermal_zone<zone>/<leaf> against the root.
+ * @return Length of the resolved path, or -1 if it does not fit
+ */
+int native_path_thermal(char* out, int out_size, int zone, const char* leaf);
+
+/**
+ * Resolve /sys/devices/system/cpu/cpu<cpu>/<leaf> against the root.
+ * @return Length of the resolved path, or -1 if it does not fit
+ */
+int native_path_cpu(char* out, int out_size, int cpu, const char* leaf);
+
+// ============================================================================
+// Clock API
+// ============================================================================
+
+/**
+ * Wall-clock milliseconds, or the recorded snapshot time while replaying.
+ * Collectors stamp samples with this so replayed rates match the recording.
+ */
+int64_t native_clock_now_ms(void);
+
+// ============================================================================
+// Record & Replay API
+// ============================================================================
+
+/**
+ * Copy the relevant proc/sys files from the current root into
+ * <recording_dir>/<index as 6 digits>/, mirroring their absolute paths,
+ * and write the capture time to SNAPSHOT_TIMESTAMP_FILE.
+ * Files missing on this device are skipped.
+ * @return Number of files recorded, or -1 on error
+ */
+int native_record_snapshot(const char* recording_dir, int index);
+
+/**
+ * Start replaying a recording: the root is pointed at snapshot 0.
+ * @return Number of snapshots found, or -1 if none
+ */
+int native_replay_open(const char* recording_dir);
+
+/**
+ * Advance to the next snapshot.
+ * @return Index of the snapshot now active, or -1 if not replaying or the
+ *         last snapshot is already active (it stays active, clock unchanged)
+ */
+int native_replay_step(void);
+
+/**
+ * Go back to snapshot 0 to replay the recording again. The replay clock
+ * keeps increasing, but the recorded counters start over: callers must
+ * retake rate baselines (CPU, network, per-UID traffic) after a rewind.
+ * @return 0, or -1 if not replaying
+ */
+int native_replay_rewind(void);
+
+/**
+ * Stop replaying and return to the root that was active before.
+ */
+void native_replay_close(void);
+
+/**
+ * @return 1 while a recording is being replayed, 0 otherwise
+ */
+int native_replay_is_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_PATHS_H
@@ -0,0 +1,110 @@
+#ifndef SYSMETRICS_NATIVE_PLATFORM_H
+#define SYSMETRICS_NATIVE_PLATFORM_H
+
+/**
+ * ============================================================================
+ * NATIVE PLATFORM SHIM - Logging and allocation portability
+ * ============================================================================
+ *
+ * Lets the collectors and analytics engine compile both for Android (NDK)
+ * and for a plain Linux/macOS host, where the benchmark and test suites run.
+ *
+ * - LOGD/LOGI/LOGW/LOGE: __android_log_print on Android, stderr on host
+ *   (debug/info are compiled out on host unless SYSMETRICS_HOST_VERBOSE)
+ * - native_aligned_alloc: memalign on Android, posix_memalign elsewhere;
+ *   memory is always released with native_aligned_free
+ * - native_thread_id / native_thread_name: kernel tid and comm of the caller
+ * - SYSMETRICS_NO_JNI: defined by the host build to drop every JNI symbol
+ *
+ * Each translation unit defines LOG_TAG before including this header.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifndef LOG_TAG
+#define LOG_TAG "SysMetricsNative"
+#endif
+
+#if defined(__ANDROID__)
+
+#include <android/log.h>
+#include <malloc.h>  // For memalign on Android
+
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static inline void* native_aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+#else
+
+#include <stdio.h>
+
+#define NATIVE_HOST_LOG(level, ...)                         \
+    do {                                                    \
+        fprintf(stderr, "%s/%s: ", level, LOG_TAG);         \
+        fprintf(stderr, __VA_ARGS__);                       \
+        fputc('\n', stderr);                                \
+    } while (0)
+
+#ifdef SYSMETRICS_HOST_VERBOSE
+#define LOGD(...) NATIVE_HOST_LOG("D", __VA_ARGS__)
+#define LOGI(...) NATIVE_HOST_LOG("I", __VA_ARGS__)
+#else
+#define LOGD(...) ((void)0)
+#define LOGI(...) ((void)0)
+#endif
+#define LOGW(...) NATIVE_HOST_LOG("W", __VA_ARGS__)
+#define LOGE(...) NATIVE_HOST_LOG("E", __VA_ARGS__)
+
+static inline void* native_aligned_alloc(size_t alignment, size_t size) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return NULL;
+    }
+    return ptr;
+}
+
+#endif
+
+static inline void native_aligned_free(void* ptr) {
+    free(ptr);
+}
+
+#if defined(__linux__)
+
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static inline int native_thread_id(void) {
+    return (int)syscall(SYS_gettid);
+}
+
+// name must hold at least 16 bytes
+static inline void native_thread_name(char* name) {
+    if (prctl(PR_GET_NAME, name, 0, 0, 0) != 0) name[0] = '\0';
+}
+
+#else
+
+#include <pthread.h>
+#include <stdint.h>
+
+static inline int native_thread_id(void) {
+    uint64_t tid = 0;
+    pthread_threadid_np(NULL, &tid);
+    return (int)tid;
+}
+
+static inline void native_thread_name(char* name) {
+    if (pthread_getname_np(pthread_self(), name, 16) != 0) name[0] = '\0';
+}
+
+#endif
+
+#endif // SYSMETRICS_NATIVE_PLATFORM_H
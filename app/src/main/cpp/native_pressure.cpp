@@ -0,0 +1,384 @@
+#include "native_pressure.h"
+#include "native_paths.h"
+#include "native_format.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_PSI"
+#include "native_platform.h"
+
+#define PSI_BUFFER_SIZE 256
+#define PSI_TRIGGER_TEXT_MAX 64
+
+static const char* const PSI_PATHS[PSI_RESOURCE_COUNT] = {
+    PROC_PRESSURE_CPU,
+    PROC_PRESSURE_MEMORY,
+    PROC_PRESSURE_IO,
+};
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+// Parses "12.34" style values; PSI never prints signs or exponents
+static const char* parse_decimal(const char* p, float* out) {
+    uint64_t integer = 0;
+    uint64_t fraction = 0;
+    uint64_t scale = 1;
+    const char* start = p;
+
+    while (*p >= '0' && *p <= '9') integer = integer * 10 + static_cast<uint64_t>(*p++ - '0');
+    if (*p == '.') {
+        p++;
+        while (*p >= '0' && *p <= '9') {
+            if (scale < 1000000) {
+                fraction = fraction * 10 + static_cast<uint64_t>(*p - '0');
+                scale *= 10;
+            }
+            p++;
+        }
+    }
+
+    *out = static_cast<float>(integer) + static_cast<float>(fraction) / static_cast<float>(scale);
+    return p == start ? nullptr : p;
+}
+
+static const char* parse_field(const char* p, const char* key, size_t key_len) {
+    while (*p == ' ') p++;
+    return strncmp(p, key, key_len) == 0 ? p + key_len : nullptr;
+}
+
+static const char* parse_line(const char* p, PsiLine* line) {
+    if ((p = parse_field(p, "avg10=", 6)) == nullptr) return nullptr;
+    if ((p = parse_decimal(p, &line->avg10)) == nullptr) return nullptr;
+    if ((p = parse_field(p, "avg60=", 6)) == nullptr) return nullptr;
+    if ((p = parse_decimal(p, &line->avg60)) == nullptr) return nullptr;
+    if ((p = parse_field(p, "avg300=", 7)) == nullptr) return nullptr;
+    if ((p = parse_decimal(p, &line->avg300)) == nullptr) return nullptr;
+    if ((p = parse_field(p, "total=", 6)) == nullptr) return nullptr;
+
+    uint64_t total = 0;
+    const char* start = p;
+    while (*p >= '0' && *p <= '9') total = total * 10 + static_cast<uint64_t>(*p++ - '0');
+    if (p == start) return nullptr;
+
+    line->total_us = total;
+    return p;
+}
+
+int native_psi_parse(const char* text, PsiStats* out) {
+    if (!text || !out) return -1;
+
+    memset(out, 0, sizeof(PsiStats));
+    bool has_some = false;
+
+    for (const char* p = text; *p;) {
+        if (strncmp(p, "some ", 5) == 0) {
+            has_some = parse_line(p + 5, &out->some) != nullptr;
+        } else if (strncmp(p, "full ", 5) == 0) {
+            out->has_full = parse_line(p + 5, &out->full) != nullptr ? 1 : 0;
+        }
+
+        const char* eol = strchr(p, '\n');
+        if (!eol) break;
+        p = eol + 1;
+    }
+
+    return has_some ? 0 : -1;
+}
+
+static int read_psi_impl(PsiResource resource, PsiStats* out) {
+    if (resource < 0 || resource >= PSI_RESOURCE_COUNT || !out) return -1;
+
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PSI_PATHS[resource]) < 0) return -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char buffer[PSI_BUFFER_SIZE];
+    ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (n <= 0) return -1;
+
+    buffer[n] = '\0';
+    return native_psi_parse(buffer, out);
+}
+
+int native_psi_read(PsiResource resource, PsiStats* out) {
+    NativeProbeScope probe(PROBE_READ_PRESSURE);
+    return probe.check(read_psi_impl(resource, out));
+}
+
+// ============================================================================
+// Triggers
+// ============================================================================
+
+static std::mutex g_psi_mutex;
+static int g_trigger_fds[PSI_MAX_TRIGGERS] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+static int g_wake_pipe[2] = { -1, -1 };
+
+// Waits currently polling copies of g_trigger_fds. Triggers removed while
+// one is in flight are retired instead of closed, so their numbers cannot
+// be reused under that poll(); the last wait to return closes them.
+static int g_waiters = 0;
+static std::vector<int> g_retired_fds;
+
+static_assert(sizeof(g_trigger_fds) / sizeof(g_trigger_fds[0]) == PSI_MAX_TRIGGERS,
+              "g_trigger_fds must have PSI_MAX_TRIGGERS slots");
+
+// Caller holds g_psi_mutex
+static int ensure_wake_pipe() {
+    if (g_wake_pipe[0] >= 0) return 0;
+
+    if (pipe(g_wake_pipe) != 0) {
+        g_wake_pipe[0] = g_wake_pipe[1] = -1;
+        return -1;
+    }
+    for (int fd : g_wake_pipe) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return 0;
+}
+
+int native_psi_trigger_add(PsiResource resource, int full, int64_t stall_us, int64_t window_us) {
+    if (resource < 0 || resource >= PSI_RESOURCE_COUNT) return -1;
+    if (window_us < PSI_MIN_WINDOW_US || window_us > PSI_MAX_WINDOW_US) return -1;
+    if (stall_us <= 0 || stall_us > window_us) return -1;
+
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PSI_PATHS[resource]) < 0) return -1;
+
+    char trigger[PSI_TRIGGER_TEXT_MAX];
+    FormatWriter writer;
+    native_fmt_init(&writer, trigger, sizeof(trigger));
+    native_fmt_put_str(&writer, full ? "full " : "some ");
+    native_fmt_put_i64(&writer, stall_us);
+    native_fmt_put_char(&writer, ' ');
+    native_fmt_put_i64(&writer, window_us);
+    int trigger_len = native_fmt_finish(&writer);
+
+    std::lock_guard<std::mutex> lock(g_psi_mutex);
+
+    int slot = -1;
+    for (int i = 0; i < PSI_MAX_TRIGGERS; i++) {
+        if (g_trigger_fds[i] < 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0 || ensure_wake_pipe() != 0) return -1;
+
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        LOGW("Cannot open %s for PSI trigger (errno %d)", path, errno);
+        return -1;
+    }
+
+    // The kernel expects the terminating NUL as part of the write
+    if (write(fd, trigger, trigger_len + 1) < 0) {
+        LOGW("Kernel rejected PSI trigger \"%s\" on %s (errno %d)", trigger, path, errno);
+        close(fd);
+        return -1;
+    }
+
+    g_trigger_fds[slot] = fd;
+    LOGD("PSI trigger %d: %s on %s", slot, trigger, path);
+    return slot;
+}
+
+void native_psi_trigger_remove(int trigger_id) {
+    if (trigger_id < 0 || trigger_id >= PSI_MAX_TRIGGERS) return;
+
+    std::lock_guard<std::mutex> lock(g_psi_mutex);
+    int fd = g_trigger_fds[trigger_id];
+    if (fd < 0) return;
+
+    g_trigger_fds[trigger_id] = -1;
+    if (g_waiters == 0) {
+        close(fd);
+        return;
+    }
+
+    // Still being polled: wake the waiters so they return and close it
+    g_retired_fds.push_back(fd);
+    char byte = 1;
+    ssize_t ignored = write(g_wake_pipe[1], &byte, 1);
+    (void)ignored;
+}
+
+void native_psi_trigger_clear(void) {
+    for (int i = 0; i < PSI_MAX_TRIGGERS; i++) {
+        native_psi_trigger_remove(i);
+    }
+}
+
+int native_psi_wait(int timeout_ms) {
+    struct pollfd fds[PSI_MAX_TRIGGERS + 1];
+    int ids[PSI_MAX_TRIGGERS];
+    int count = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(g_psi_mutex);
+        for (int i = 0; i < PSI_MAX_TRIGGERS; i++) {
+            if (g_trigger_fds[i] < 0) continue;
+            fds[count].fd = g_trigger_fds[i];
+            fds[count].events = POLLPRI;
+            fds[count].revents = 0;
+            ids[count] = i;
+            count++;
+        }
+        if (count == 0 || g_wake_pipe[0] < 0) return -1;
+
+        fds[count].fd = g_wake_pipe[0];
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        g_waiters++;
+    }
+
+    int ready;
+    do {
+        ready = poll(fds, count + 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    int poll_errno = errno;
+
+    {
+        std::lock_guard<std::mutex> lock(g_psi_mutex);
+        if (--g_waiters == 0) {
+            for (int fd : g_retired_fds) close(fd);
+            g_retired_fds.clear();
+        }
+    }
+
+    if (ready < 0) {
+        LOGE("PSI poll failed (errno %d)", poll_errno);
+        return -1;
+    }
+    if (ready == 0) return 0;
+
+    if (fds[count].revents & POLLIN) {
+        char drain[16];
+        while (read(fds[count].fd, drain, sizeof(drain)) > 0) {
+        }
+    }
+
+    int fired = 0;
+    for (int i = 0; i < count; i++) {
+        if (fds[i].revents & POLLERR) {
+            // Kernel dropped the trigger (e.g. the pressure file went away)
+            LOGE("PSI trigger %d failed", ids[i]);
+            return -1;
+        }
+        if (fds[i].revents & POLLPRI) fired |= 1 << ids[i];
+    }
+    return fired;
+}
+
+void native_psi_wake(void) {
+    std::lock_guard<std::mutex> lock(g_psi_mutex);
+    if (ensure_wake_pipe() != 0) return;
+
+    char byte = 1;
+    ssize_t ignored = write(g_wake_pipe[1], &byte, 1);
+    (void)ignored;
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+/**
+ * Returns [someAvg10, someAvg60, someAvg300, someTotalUs,
+ *          fullAvg10, fullAvg60, fullAvg300, fullTotalUs, hasFull]
+ */
+JNIEXPORT jdoubleArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_read(
+        JNIEnv* env, jclass clazz, jint resource) {
+    NativeTraceScope trace("NativePressure.read", TRACE_CAT_JNI);
+    PsiStats stats;
+    if (native_psi_read(static_cast<PsiResource>(resource), &stats) != 0) return nullptr;
+
+    jdouble values[9] = {
+        stats.some.avg10, stats.some.avg60, stats.some.avg300,
+        static_cast<jdouble>(stats.some.total_us),
+        stats.full.avg10, stats.full.avg60, stats.full.avg300,
+        static_cast<jdouble>(stats.full.total_us),
+        static_cast<jdouble>(stats.has_full),
+    };
+
+    jdoubleArray result = env->NewDoubleArray(9);
+    if (result == nullptr) return nullptr;
+
+    env->SetDoubleArrayRegion(result, 0, 9, values);
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_addTrigger(
+        JNIEnv* env, jclass clazz, jint resource, jboolean full, jlong stallUs, jlong windowUs) {
+    return native_psi_trigger_add(static_cast<PsiResource>(resource), full == JNI_TRUE ? 1 : 0,
+                                  stallUs, windowUs);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_removeTrigger(
+        JNIEnv* env, jclass clazz, jint triggerId) {
+    native_psi_trigger_remove(triggerId);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_clearTriggers(
+        JNIEnv* env, jclass clazz) {
+    native_psi_trigger_clear();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_waitForTrigger(
+        JNIEnv* env, jclass clazz, jint timeoutMs) {
+    return native_psi_wait(timeoutMs);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePressure_wake(
+        JNIEnv* env, jclass clazz) {
+    native_psi_wake();
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod PRESSURE_METHODS[] = {
+    NATIVE_METHOD("read", "(I)[D",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_read),
+    NATIVE_METHOD("addTrigger", "(IZJJ)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_addTrigger),
+    NATIVE_METHOD("removeTrigger", "(I)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_removeTrigger),
+    NATIVE_METHOD("clearTriggers", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_clearTriggers),
+    NATIVE_METHOD("waitForTrigger", "(I)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_waitForTrigger),
+    NATIVE_METHOD("wake", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativePressure_wake),
+};
+const NativeMethodList NATIVE_PRESSURE_JNI = NATIVE_METHOD_LIST(PRESSURE_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,106 @@
+#ifndef SYSMETRICS_NATIVE_PRESSURE_H
+#define SYSMETRICS_NATIVE_PRESSURE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE PRESSURE - Pressure Stall Information (PSI) and triggers
+ * ============================================================================
+ *
+ * Reads /proc/pressure/{cpu,memory,io} (Linux 4.20+, Android 10+ kernels):
+ *
+ *     some avg10=0.12 avg60=0.05 avg300=0.01 total=123456
+ *     full avg10=0.00 avg60=0.00 avg300=0.00 total=2345
+ *
+ * and registers kernel PSI triggers: "<some|full> <stall_us> <window_us>"
+ * is written to the pressure file and the kernel raises POLLPRI on that fd
+ * whenever stall time within the window crosses the threshold. A sampler
+ * can therefore run slowly and block in native_psi_wait() to be woken
+ * exactly when the system starts stalling.
+ *
+ * Paths resolve through native_paths.h, so a fixture root works on a host.
+ */
+
+typedef enum {
+    PSI_CPU = 0,
+    PSI_MEMORY,
+    PSI_IO,
+    PSI_RESOURCE_COUNT
+} PsiResource;
+
+/**
+ * One "some" or "full" line. Averages are percentages of wall time.
+ */
+typedef struct {
+    float avg10;
+    float avg60;
+    float avg300;
+    uint64_t total_us;  // Cumulative stall time
+} PsiLine;
+
+typedef struct {
+    PsiLine some;  // At least one task stalled
+    PsiLine full;  // All non-idle tasks stalled
+    int has_full;  // 0 for cpu on kernels before 5.13
+} PsiStats;
+
+// Registered triggers across all resources
+#define PSI_MAX_TRIGGERS 8
+
+// Kernel limits for trigger windows
+#define PSI_MIN_WINDOW_US 500000
+#define PSI_MAX_WINDOW_US 10000000
+
+/**
+ * Parse the pressure file of one resource.
+ * @return 0 on success, -1 if PSI is unavailable or malformed
+ */
+int native_psi_read(PsiResource resource, PsiStats* out);
+
+/**
+ * Parse PSI text (the file contents) into out.
+ * @return 0 on success, -1 if no "some" line was found
+ */
+int native_psi_parse(const char* text, PsiStats* out);
+
+/**
+ * Register a trigger firing when stall time within window_us exceeds
+ * stall_us. full selects the "full" line instead of "some".
+ * @return Trigger id (0..PSI_MAX_TRIGGERS-1), or -1 on error
+ */
+int native_psi_trigger_add(PsiResource resource, int full, int64_t stall_us, int64_t window_us);
+
+/**
+ * Unregister a trigger. Safe while another thread is in native_psi_wait():
+ * that wait is woken and the descriptor is closed once it has returned.
+ */
+void native_psi_trigger_remove(int trigger_id);
+
+/**
+ * Unregister every trigger.
+ */
+void native_psi_trigger_clear(void);
+
+/**
+ * Block until a trigger fires, native_psi_wake() is called or timeout_ms
+ * elapses (-1 waits forever).
+ * @return Bitmask of fired trigger ids (bit n = id n), 0 on timeout or
+ *         wake, -1 if no trigger is registered or polling failed
+ */
+int native_psi_wait(int timeout_ms);
+
+/**
+ * Make a concurrent native_psi_wait() return 0 immediately.
+ */
+void native_psi_wake(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_PRESSURE_H
@@ -0,0 +1,397 @@
+#include "native_process_memory.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_PROCMEM"
+#include "native_platform.h"
+
+#define STAT_BUFFER_SIZE 1024
+#define SMAPS_CHUNK_SIZE 4096
+
+// /proc/<pid>/stat: starttime is field 22, i.e. the 20th field after "comm)"
+#define STAT_FIELDS_BEFORE_STARTTIME 19
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+struct ProcessMemoryEntry {
+    ProcessMemoryStats stats;
+    int64_t last_read_ms;
+    int64_t last_detail_attempt_ms;
+};
+
+static std::mutex g_procmem_mutex;
+static std::unordered_map<int32_t, ProcessMemoryEntry> g_procmem_cache;
+static std::atomic<int64_t> g_detail_interval_ms(PROCMEM_DEFAULT_DETAIL_INTERVAL_MS);
+
+static long page_size_kb() {
+    static const long kb = sysconf(_SC_PAGESIZE) / 1024;
+    return kb > 0 ? kb : 4;
+}
+
+// Caller holds g_procmem_mutex
+static void evict_stale(int64_t now) {
+    for (auto it = g_procmem_cache.begin(); it != g_procmem_cache.end();) {
+        if (now - it->second.last_read_ms >= PROCMEM_EXPIRY_MS) {
+            it = g_procmem_cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Still full: drop the least recently read process
+    while (g_procmem_cache.size() >= PROCMEM_CACHE_MAX) {
+        auto oldest = g_procmem_cache.begin();
+        for (auto it = g_procmem_cache.begin(); it != g_procmem_cache.end(); ++it) {
+            if (it->second.last_read_ms < oldest->second.last_read_ms) oldest = it;
+        }
+        g_procmem_cache.erase(oldest);
+    }
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static int read_small_file(const char* path, char* buffer, int size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+
+    buffer[n] = '\0';
+    return static_cast<int>(n);
+}
+
+static const char* skip_spaces(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static const char* parse_u64(const char* p, uint64_t* out) {
+    p = skip_spaces(p);
+    uint64_t value = 0;
+    const char* start = p;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        p++;
+    }
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+static int read_start_time(int pid, uint64_t* start_time) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_pid(path, sizeof(path), pid, "stat") < 0) return -1;
+
+    char buffer[STAT_BUFFER_SIZE];
+    if (read_small_file(path, buffer, sizeof(buffer)) < 0) return -1;
+
+    // comm may contain spaces and ')', so scan from the last ')'
+    const char* p = strrchr(buffer, ')');
+    if (!p) return -1;
+    p++;
+
+    for (int field = 0; field < STAT_FIELDS_BEFORE_STARTTIME; field++) {
+        p = skip_spaces(p);
+        while (*p && *p != ' ') p++;
+        if (!*p) return -1;
+    }
+
+    return parse_u64(p, start_time) ? 0 : -1;
+}
+
+static int read_statm(int pid, int64_t* rss_kb, int64_t* shared_kb) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_pid(path, sizeof(path), pid, "statm") < 0) return -1;
+
+    char buffer[STAT_BUFFER_SIZE];
+    if (read_small_file(path, buffer, sizeof(buffer)) < 0) return -1;
+
+    // size resident shared text lib data dt (pages)
+    uint64_t size_pages, resident_pages, shared_pages;
+    const char* p = parse_u64(buffer, &size_pages);
+    if (p) p = parse_u64(p, &resident_pages);
+    if (p) p = parse_u64(p, &shared_pages);
+    if (!p) return -1;
+
+    *rss_kb = static_cast<int64_t>(resident_pages) * page_size_kb();
+    *shared_kb = static_cast<int64_t>(shared_pages) * page_size_kb();
+    return 0;
+}
+
+struct SmapsTotals {
+    int64_t pss_kb;
+    int64_t private_kb;
+    int64_t swap_kb;
+    int64_t swap_pss_kb;
+    int matched;
+};
+
+static bool match_key(const char* line, const char* key, size_t key_len, int64_t* total) {
+    if (strncmp(line, key, key_len) != 0) return false;
+
+    uint64_t value;
+    if (parse_u64(line + key_len, &value)) {
+        *total += static_cast<int64_t>(value);
+    }
+    return true;
+}
+
+// Sums every occurrence, so smaps_rollup (one block) and smaps (one block
+// per mapping) parse the same way
+static void parse_smaps_line(const char* line, SmapsTotals* totals) {
+    if (line[0] == 'P') {
+        if (match_key(line, "Pss:", 4, &totals->pss_kb) ||
+            match_key(line, "Private_Clean:", 14, &totals->private_kb) ||
+            match_key(line, "Private_Dirty:", 14, &totals->private_kb)) {
+            totals->matched++;
+        }
+    } else if (line[0] == 'S') {
+        if (match_key(line, "Swap:", 5, &totals->swap_kb) ||
+            match_key(line, "SwapPss:", 8, &totals->swap_pss_kb)) {
+            totals->matched++;
+        }
+    }
+}
+
+static int parse_smaps_file(const char* path, SmapsTotals* totals) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    memset(totals, 0, sizeof(SmapsTotals));
+
+    char buffer[SMAPS_CHUNK_SIZE + 1];
+    int carry = 0;
+    for (;;) {
+        ssize_t n = read(fd, buffer + carry, SMAPS_CHUNK_SIZE - carry);
+        if (n < 0) {
+            close(fd);
+            return -1;
+        }
+
+        int len = carry + static_cast<int>(n);
+        int start = 0;
+        for (int i = carry; i < len; i++) {
+            if (buffer[i] == '\n') {
+                buffer[i] = '\0';
+                parse_smaps_line(buffer + start, totals);
+                start = i + 1;
+            }
+        }
+
+        if (n == 0) {
+            if (start < len) {
+                buffer[len] = '\0';
+                parse_smaps_line(buffer + start, totals);
+            }
+            break;
+        }
+
+        carry = len - start;
+        if (carry == SMAPS_CHUNK_SIZE) {
+            carry = 0;  // Over-long mapping path; none of our keys
+        } else if (carry > 0) {
+            memmove(buffer, buffer + start, carry);
+        }
+    }
+
+    close(fd);
+    return totals->matched > 0 ? 0 : -1;
+}
+
+static int read_smaps_detail(int pid, ProcessMemoryStats* stats) {
+    char path[NATIVE_PATH_MAX];
+    SmapsTotals totals;
+
+    if (native_path_pid(path, sizeof(path), pid, "smaps_rollup") < 0) return -1;
+    if (parse_smaps_file(path, &totals) != 0) {
+        // Kernels before 4.14 have no smaps_rollup
+        if (native_path_pid(path, sizeof(path), pid, "smaps") < 0) return -1;
+        if (parse_smaps_file(path, &totals) != 0) return -1;
+    }
+
+    stats->pss_kb = totals.pss_kb;
+    stats->uss_kb = totals.private_kb;
+    stats->swap_kb = totals.swap_kb;
+    stats->swap_pss_kb = totals.swap_pss_kb;
+    return 0;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void native_procmem_set_detail_interval(int64_t interval_ms) {
+    g_detail_interval_ms.store(interval_ms > 0 ? interval_ms : 0, std::memory_order_relaxed);
+}
+
+static int read_process_memory_impl(int pid, ProcessMemoryStats* out) {
+    if (!out || pid <= 0) return -1;
+
+    uint64_t start_time;
+    int64_t rss_kb, shared_kb;
+    if (read_start_time(pid, &start_time) != 0 || read_statm(pid, &rss_kb, &shared_kb) != 0) {
+        std::lock_guard<std::mutex> lock(g_procmem_mutex);
+        g_procmem_cache.erase(pid);
+        return -1;
+    }
+
+    const int64_t now = native_clock_now_ms();
+    ProcessMemoryEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(g_procmem_mutex);
+        auto it = g_procmem_cache.find(pid);
+        if (it != g_procmem_cache.end() && it->second.stats.start_time == start_time) {
+            entry = it->second;
+        } else {
+            // New process, or the pid was recycled
+            memset(&entry, 0, sizeof(entry));
+            entry.stats.pid = pid;
+            entry.stats.start_time = start_time;
+            entry.stats.pss_kb = -1;
+            entry.stats.uss_kb = -1;
+            entry.stats.swap_kb = -1;
+            entry.stats.swap_pss_kb = -1;
+            entry.last_detail_attempt_ms = INT64_MIN;
+        }
+    }
+
+    entry.stats.rss_kb = rss_kb;
+    entry.stats.shared_kb = shared_kb;
+    entry.last_read_ms = now;
+
+    // smaps walks every mapping in the kernel; keep it off the fast path
+    int64_t interval = g_detail_interval_ms.load(std::memory_order_relaxed);
+    if (entry.last_detail_attempt_ms == INT64_MIN ||
+        now - entry.last_detail_attempt_ms >= interval) {
+        entry.last_detail_attempt_ms = now;
+        if (read_smaps_detail(pid, &entry.stats) == 0) {
+            entry.stats.detail_timestamp_ms = now;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_procmem_mutex);
+        if (g_procmem_cache.size() >= PROCMEM_CACHE_MAX &&
+            g_procmem_cache.find(pid) == g_procmem_cache.end()) {
+            evict_stale(now);
+        }
+        g_procmem_cache[pid] = entry;
+    }
+
+    *out = entry.stats;
+    return 0;
+}
+
+int native_procmem_read(int pid, ProcessMemoryStats* out) {
+    NativeProbeScope probe(PROBE_READ_PROCESS_MEMORY);
+    return probe.check(read_process_memory_impl(pid, out));
+}
+
+int native_procmem_read_batch(const int32_t* pids, int count, int64_t* out, int out_len) {
+    if (!pids || !out || count < 0) return -1;
+    if (out_len < count * PROCMEM_FIELDS) return -1;
+
+    for (int i = 0; i < count; i++) {
+        int64_t* row = out + i * PROCMEM_FIELDS;
+        ProcessMemoryStats stats;
+        bool ok = native_procmem_read(pids[i], &stats) == 0;
+
+        row[0] = pids[i];
+        row[1] = ok ? 0 : -1;
+        row[2] = ok ? stats.rss_kb : -1;
+        row[3] = ok ? stats.shared_kb : -1;
+        row[4] = ok ? stats.pss_kb : -1;
+        row[5] = ok ? stats.uss_kb : -1;
+        row[6] = ok ? stats.swap_kb : -1;
+        row[7] = ok ? stats.swap_pss_kb : -1;
+        row[8] = ok ? stats.detail_timestamp_ms : 0;
+    }
+
+    std::lock_guard<std::mutex> lock(g_procmem_mutex);
+    evict_stale(native_clock_now_ms());
+    return count;
+}
+
+void native_procmem_clear_cache(void) {
+    std::lock_guard<std::mutex> lock(g_procmem_mutex);
+    g_procmem_cache.clear();
+}
+
+int native_procmem_cache_size(void) {
+    std::lock_guard<std::mutex> lock(g_procmem_mutex);
+    return static_cast<int>(g_procmem_cache.size());
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+/**
+ * Returns PROCMEM_FIELDS longs per requested pid:
+ * [pid, status, rssKb, sharedKb, pssKb, ussKb, swapKb, swapPssKb, detailTimestampMs]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessMemoryBatch(
+        JNIEnv* env, jobject thiz, jintArray pids) {
+    NativeTraceScope trace("NativeMetrics.getProcessMemoryBatch", TRACE_CAT_JNI);
+    if (pids == nullptr) return nullptr;
+
+    jsize count = env->GetArrayLength(pids);
+    std::vector<int32_t> pid_values(count);
+    env->GetIntArrayRegion(pids, 0, count, reinterpret_cast<jint*>(pid_values.data()));
+
+    std::vector<int64_t> values(static_cast<size_t>(count) * PROCMEM_FIELDS);
+    if (native_procmem_read_batch(pid_values.data(), count, values.data(),
+                                  static_cast<int>(values.size())) < 0) {
+        return nullptr;
+    }
+
+    jlongArray result = env->NewLongArray(static_cast<jsize>(values.size()));
+    if (result == nullptr) return nullptr;
+
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(values.size()),
+                            reinterpret_cast<const jlong*>(values.data()));
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_setProcessMemoryDetailInterval(
+        JNIEnv* env, jobject thiz, jlong intervalMs) {
+    native_procmem_set_detail_interval(intervalMs);
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod PROCESS_MEMORY_METHODS[] = {
+    NATIVE_METHOD("getProcessMemoryBatch", "([I)[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_getProcessMemoryBatch),
+    NATIVE_METHOD("setProcessMemoryDetailInterval", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_setProcessMemoryDetailInterval),
+};
+const NativeMethodList NATIVE_PROCESS_MEMORY_JNI = NATIVE_METHOD_LIST(PROCESS_MEMORY_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
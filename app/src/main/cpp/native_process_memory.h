@@ -0,0 +1,88 @@
+#ifndef SYSMETRICS_NATIVE_PROCESS_MEMORY_H
+#define SYSMETRICS_NATIVE_PROCESS_MEMORY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE PROCESS MEMORY - Per-process RSS/PSS/USS/swap from procfs
+ * ============================================================================
+ *
+ * Replaces one ActivityManager.getProcessMemoryInfo Binder call per pid:
+ *
+ * - RSS and shared pages from /proc/<pid>/statm on every read (one small read)
+ * - PSS, USS (private clean + dirty), swap and swap PSS from
+ *   /proc/<pid>/smaps_rollup on a slower cadence; kernels without
+ *   smaps_rollup (< 4.14) fall back to summing /proc/<pid>/smaps
+ * - Results cached per (pid, starttime), so a recycled pid never inherits
+ *   the previous process's PSS
+ * - Batch reads fill a packed int64 array for many pids in one JNI call
+ */
+
+/**
+ * Memory of one process. Detail fields (pss/uss/swap) are -1 until
+ * smaps has been read successfully for this process.
+ */
+typedef struct {
+    int32_t pid;
+    uint64_t start_time;          // Clock ticks after boot (stat field 22)
+    int64_t rss_kb;
+    int64_t shared_kb;
+    int64_t pss_kb;
+    int64_t uss_kb;
+    int64_t swap_kb;
+    int64_t swap_pss_kb;
+    int64_t detail_timestamp_ms;  // When detail fields were read, 0 if never
+} ProcessMemoryStats;
+
+// Default interval between smaps_rollup reads of the same process
+#define PROCMEM_DEFAULT_DETAIL_INTERVAL_MS 5000
+
+// Cached processes; entries not read for PROCMEM_EXPIRY_MS are dropped first
+#define PROCMEM_CACHE_MAX 512
+#define PROCMEM_EXPIRY_MS 60000
+
+// Packed batch layout, PROCMEM_FIELDS values per requested pid:
+// [pid, status (0 ok / -1 unreadable), rss_kb, shared_kb, pss_kb, uss_kb,
+//  swap_kb, swap_pss_kb, detail_timestamp_ms]
+#define PROCMEM_FIELDS 9
+
+/**
+ * Set how often smaps_rollup is re-read per process.
+ * 0 reads it on every call.
+ */
+void native_procmem_set_detail_interval(int64_t interval_ms);
+
+/**
+ * Read memory of one process, refreshing detail fields when due.
+ * @return 0 on success, -1 if the process is gone or unreadable
+ */
+int native_procmem_read(int pid, ProcessMemoryStats* out);
+
+/**
+ * Read many processes into a packed array (see PROCMEM_FIELDS).
+ * Unreadable pids are reported with status -1 rather than skipped, so
+ * out[i * PROCMEM_FIELDS] always matches pids[i].
+ * @return Number of pids written, or -1 if out_len is too small
+ */
+int native_procmem_read_batch(const int32_t* pids, int count, int64_t* out, int out_len);
+
+/**
+ * Drop all cached processes.
+ */
+void native_procmem_clear_cache(void);
+
+/**
+ * Number of cached processes.
+ */
+int native_procmem_cache_size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_PROCESS_MEMORY_H
@@ -0,0 +1,166 @@
+#include "native_process_rank.h"
+#include "native_instrument.h"
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_RANK"
+#include "native_platform.h"
+
+// ============================================================================
+// Bounded Heap
+// ============================================================================
+
+struct RankItem {
+    double key;     // Exact for whole megabytes as well as float scores
+    int32_t index;
+};
+
+// Lower key loses; on equal keys the later row loses (stable order)
+static inline bool worse(const RankItem& a, const RankItem& b) {
+    return a.key < b.key || (a.key == b.key && a.index > b.index);
+}
+
+// Min-heap on worse(): the root is the weakest of the current winners
+static void sift_down(RankItem* heap, int size, int pos) {
+    for (;;) {
+        int weakest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < size && worse(heap[left], heap[weakest])) weakest = left;
+        if (right < size && worse(heap[right], heap[weakest])) weakest = right;
+        if (weakest == pos) return;
+
+        RankItem tmp = heap[pos];
+        heap[pos] = heap[weakest];
+        heap[weakest] = tmp;
+        pos = weakest;
+    }
+}
+
+static void sift_up(RankItem* heap, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!worse(heap[pos], heap[parent])) return;
+
+        RankItem tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+// ============================================================================
+// Ranking
+// ============================================================================
+
+static double rank_key(float cpu_percent, int64_t ram_mb, const RankParams& params) {
+    switch (params.key) {
+        case RANK_BY_CPU:
+            return cpu_percent;
+        case RANK_BY_RAM:
+            return static_cast<double>(ram_mb);
+        default:
+            // Same float arithmetic as AppStats.combinedScore
+            return cpu_percent * params.cpu_weight + static_cast<float>(ram_mb) / params.ram_mb_divisor;
+    }
+}
+
+static int rank_top_n_impl(const float* cpu_percent, const int64_t* ram_kb, int count,
+                           const RankParams* params, int top_n, int32_t* out) {
+    if (!cpu_percent || !ram_kb || !params || !out) return -1;
+    if (count < 0 || count > RANK_MAX_PROCESSES || top_n < 0) return -1;
+    if (params->key < RANK_BY_CPU || params->key > RANK_BY_COMBINED) return -1;
+    if (params->key == RANK_BY_COMBINED && !(params->ram_mb_divisor > 0.0f)) return -1;
+    if (top_n > RANK_TOP_MAX) top_n = RANK_TOP_MAX;
+    if (top_n == 0) return 0;
+
+    RankItem heap[RANK_TOP_MAX];
+    int size = 0;
+
+    for (int i = 0; i < count; i++) {
+        int64_t ram_mb = ram_kb[i] > 0 ? ram_kb[i] / 1024 : 0;
+        if (!(cpu_percent[i] > params->min_cpu_percent) && ram_mb <= params->min_ram_mb) continue;
+
+        RankItem item = { rank_key(cpu_percent[i], ram_mb, *params), i };
+        if (size < top_n) {
+            heap[size] = item;
+            sift_up(heap, size++);
+        } else if (worse(heap[0], item)) {
+            heap[0] = item;
+            sift_down(heap, size, 0);
+        }
+    }
+
+    // Pop weakest first into the back of out
+    int written = size;
+    while (size > 0) {
+        out[size - 1] = heap[0].index;
+        heap[0] = heap[--size];
+        sift_down(heap, size, 0);
+    }
+    return written;
+}
+
+int native_rank_top_n(const float* cpu_percent, const int64_t* ram_kb, int count,
+                      const RankParams* params, int top_n, int32_t* out) {
+    NativeProbeScope probe(PROBE_RANK_PROCESSES);
+    return probe.check(rank_top_n_impl(cpu_percent, ram_kb, count, params, top_n, out));
+}
+
+#ifndef SYSMETRICS_NO_JNI
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+extern "C" {
+
+/**
+ * Ranks the first count rows of (cpuPercent, ramKb) and writes the winning
+ * row indices into out, best first.
+ * Returns the number of indices written, or -1 on error.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeMetrics_rankProcesses(
+        JNIEnv* env, jobject thiz, jfloatArray cpuPercent, jlongArray ramKb, jint count,
+        jint key, jint topN, jfloat minCpuPercent, jlong minRamMb, jfloat cpuWeight,
+        jfloat ramMbDivisor, jintArray out) {
+    NativeTraceScope trace("NativeMetrics.rankProcesses", TRACE_CAT_JNI);
+    if (cpuPercent == nullptr || ramKb == nullptr || out == nullptr) return -1;
+    if (count < 0 || count > RANK_MAX_PROCESSES ||
+        env->GetArrayLength(cpuPercent) < count || env->GetArrayLength(ramKb) < count) {
+        return -1;
+    }
+
+    jsize capacity = env->GetArrayLength(out);
+    if (topN > capacity) topN = capacity;
+
+    float cpu[RANK_MAX_PROCESSES];
+    int64_t ram[RANK_MAX_PROCESSES];
+    env->GetFloatArrayRegion(cpuPercent, 0, count, cpu);
+    env->GetLongArrayRegion(ramKb, 0, count, reinterpret_cast<jlong*>(ram));
+
+    RankParams params = { key, minCpuPercent, minRamMb, cpuWeight, ramMbDivisor };
+    int32_t winners[RANK_TOP_MAX];
+    int written = native_rank_top_n(cpu, ram, count, &params, topN, winners);
+    if (written > 0) {
+        env->SetIntArrayRegion(out, 0, written, winners);
+    }
+    return written;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod PROCESS_RANK_METHODS[] = {
+    NATIVE_METHOD("rankProcesses", "([F[JIIIFJFF[I)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeMetrics_rankProcesses),
+};
+const NativeMethodList NATIVE_PROCESS_RANK_JNI = NATIVE_METHOD_LIST(PROCESS_RANK_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
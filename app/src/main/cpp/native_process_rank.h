@@ -0,0 +1,57 @@
+#ifndef SYSMETRICS_NATIVE_PROCESS_RANK_H
+#define SYSMETRICS_NATIVE_PROCESS_RANK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE PROCESS RANK - Top-N processes by CPU, RAM or combined score
+ * ============================================================================
+ *
+ * Ranks a packed process table (one column of CPU percentages, one of RAM
+ * in kB, row i = candidate i) and returns the row indices of the winners,
+ * best first. Selection keeps a bounded min-heap of top_n rows, so ranking
+ * n candidates costs O(n log top_n) and only the winners need names or
+ * objects on the Kotlin side.
+ *
+ * The order matches a stable descending sort of the qualifying rows:
+ * - RANK_BY_CPU: cpu_percent
+ * - RANK_BY_RAM: whole megabytes (ram_kb / 1024)
+ * - RANK_BY_COMBINED: cpu_percent * cpu_weight + ram_mb / ram_mb_divisor
+ * Rows with equal keys keep table order. A row qualifies when its CPU is
+ * above min_cpu_percent or its RAM is above min_ram_mb.
+ */
+
+#define RANK_BY_CPU 0
+#define RANK_BY_RAM 1
+#define RANK_BY_COMBINED 2
+
+#define RANK_TOP_MAX 32
+#define RANK_MAX_PROCESSES 1024
+
+typedef struct {
+    int32_t key;              // RANK_BY_*
+    float min_cpu_percent;
+    int64_t min_ram_mb;
+    float cpu_weight;
+    float ram_mb_divisor;
+} RankParams;
+
+/**
+ * Write the row indices of the top_n qualifying rows into out, best first.
+ * top_n above RANK_TOP_MAX is clamped. Negative ram_kb counts as 0.
+ * @return Number of indices written, or -1 on invalid arguments (unknown
+ *         key, count above RANK_MAX_PROCESSES, non-positive divisor)
+ */
+int native_rank_top_n(const float* cpu_percent, const int64_t* ram_kb, int count,
+                      const RankParams* params, int top_n, int32_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_PROCESS_RANK_H
@@ -0,0 +1,293 @@
+#include "native_publish.h"
+#include "native_instrument.h"
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_PUBLISH"
+#include "native_platform.h"
+
+struct Publisher {
+    int32_t count;
+    int64_t max_silence_ms;
+    bool primed;  // false until the first publish, and again after force()
+    float deadband_abs[PUBLISH_MAX_METRICS];
+    float deadband_rel[PUBLISH_MAX_METRICS];
+    float last_value[PUBLISH_MAX_METRICS];
+    int64_t last_time[PUBLISH_MAX_METRICS];
+    PublishStats stats;
+};
+
+static std::mutex g_pub_mutex;
+static int64_t g_pub_next_handle = 1;
+static std::unordered_map<int64_t, Publisher*> g_pub_map;
+
+// Caller holds g_pub_mutex
+static Publisher* find_publisher(int64_t handle) {
+    auto it = g_pub_map.find(handle);
+    return it != g_pub_map.end() ? it->second : nullptr;
+}
+
+// ============================================================================
+// Publisher Lifecycle
+// ============================================================================
+
+int64_t native_pub_create(int32_t metric_count, int64_t max_silence_ms) {
+    NativeTraceScope trace("native_pub_create", TRACE_CAT_ANALYTICS);
+    if (metric_count <= 0 || metric_count > PUBLISH_MAX_METRICS) return 0;
+
+    Publisher* pub = new (std::nothrow) Publisher();
+    if (!pub) return 0;
+
+    pub->count = metric_count;
+    pub->max_silence_ms = max_silence_ms;
+    pub->primed = false;
+
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+    int64_t handle = g_pub_next_handle++;
+    g_pub_map[handle] = pub;
+
+    LOGD("Created publisher handle=%lld metrics=%d", (long long)handle, metric_count);
+    return handle;
+}
+
+void native_pub_destroy(int64_t handle) {
+    NativeTraceScope trace("native_pub_destroy", TRACE_CAT_ANALYTICS);
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+
+    auto it = g_pub_map.find(handle);
+    if (it != g_pub_map.end()) {
+        delete it->second;
+        g_pub_map.erase(it);
+    }
+}
+
+int native_pub_set_deadband(int64_t handle, int32_t index, float absolute, float relative) {
+    if (!(absolute >= 0.0f) || !(relative >= 0.0f)) return -1;
+
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+    Publisher* pub = find_publisher(handle);
+    if (!pub || index < 0 || index >= pub->count) return -1;
+
+    pub->deadband_abs[index] = absolute;
+    pub->deadband_rel[index] = relative;
+    return 0;
+}
+
+void native_pub_force(int64_t handle) {
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+    Publisher* pub = find_publisher(handle);
+    if (pub) pub->primed = false;
+}
+
+int native_pub_get_stats(int64_t handle, PublishStats* out) {
+    if (!out) return -1;
+
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+    Publisher* pub = find_publisher(handle);
+    if (!pub) return -1;
+
+    *out = pub->stats;
+    return 0;
+}
+
+// ============================================================================
+// Submit
+// ============================================================================
+
+// Bit test instead of std::isnan, which -ffast-math (Android release) folds to false
+static inline bool is_nan_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x7fffffffu) > 0x7f800000u;
+}
+
+static inline bool exceeds_deadband(const Publisher* pub, int i, float value) {
+    float last = pub->last_value[i];
+
+    // NaN marks a missing reading; entering or leaving that state is a change
+    bool value_nan = is_nan_bits(value);
+    bool last_nan = is_nan_bits(last);
+    if (value_nan || last_nan) return value_nan != last_nan;
+
+    float band = pub->deadband_rel[i] * std::fabs(last);
+    if (band < pub->deadband_abs[i]) band = pub->deadband_abs[i];
+    return std::fabs(value - last) > band;
+}
+
+static int pub_submit_impl(int64_t handle, const float* values, int32_t count, int64_t timestamp,
+                           uint32_t* mask_out, float* changed_out) {
+    if (!values || !mask_out) return -1;
+
+    std::lock_guard<std::mutex> lock(g_pub_mutex);
+    Publisher* pub = find_publisher(handle);
+    if (!pub || count != pub->count) return -1;
+
+    uint32_t mask = 0;
+    int published = 0;
+    int heartbeats = 0;
+
+    for (int i = 0; i < count; i++) {
+        bool publish;
+        if (!pub->primed) {
+            publish = true;
+        } else if (exceeds_deadband(pub, i, values[i])) {
+            publish = true;
+        } else {
+            // Clock going backwards (replay restart) also republishes
+            int64_t silent = timestamp - pub->last_time[i];
+            publish = silent < 0 || (pub->max_silence_ms > 0 && silent >= pub->max_silence_ms);
+            if (publish) heartbeats++;
+        }
+
+        if (!publish) continue;
+
+        mask |= 1u << i;
+        pub->last_value[i] = values[i];
+        pub->last_time[i] = timestamp;
+        if (changed_out) changed_out[published] = values[i];
+        published++;
+    }
+
+    pub->primed = true;
+
+    PublishStats& stats = pub->stats;
+    stats.submitted++;
+    if (published > 0) {
+        stats.published_ticks++;
+    } else {
+        stats.suppressed_ticks++;
+    }
+    stats.published_values += static_cast<uint64_t>(published);
+    stats.suppressed_values += static_cast<uint64_t>(count - published);
+    stats.heartbeat_values += static_cast<uint64_t>(heartbeats);
+
+    *mask_out = mask;
+    return published;
+}
+
+int native_pub_submit(int64_t handle, const float* values, int32_t count, int64_t timestamp,
+                      uint32_t* mask_out, float* changed_out) {
+    NativeProbeScope probe(PROBE_PUBLISH_SUBMIT);
+    return probe.check(pub_submit_impl(handle, values, count, timestamp, mask_out, changed_out));
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_create(
+        JNIEnv* env, jclass clazz, jint metricCount, jlong maxSilenceMs) {
+    NativeTraceScope trace("NativePublisher.create", TRACE_CAT_JNI);
+    return native_pub_create(metricCount, maxSilenceMs);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_destroy(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    NativeTraceScope trace("NativePublisher.destroy", TRACE_CAT_JNI);
+    native_pub_destroy(handle);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_setDeadband(
+        JNIEnv* env, jclass clazz, jlong handle, jint index, jfloat absolute, jfloat relative) {
+    return native_pub_set_deadband(handle, index, absolute, relative) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Publishes changed values packed into changedOut.
+ * Returns the change mask (bit i = metric i), or -1 on error.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_submit(
+        JNIEnv* env, jclass clazz, jlong handle, jfloatArray values, jlong timestampMs,
+        jfloatArray changedOut) {
+    NativeTraceScope trace("NativePublisher.submit", TRACE_CAT_JNI);
+    if (values == nullptr || changedOut == nullptr) return -1;
+
+    jsize count = env->GetArrayLength(values);
+    if (count <= 0 || count > PUBLISH_MAX_METRICS || env->GetArrayLength(changedOut) < count) {
+        return -1;
+    }
+
+    float input[PUBLISH_MAX_METRICS];
+    float changed[PUBLISH_MAX_METRICS];
+    env->GetFloatArrayRegion(values, 0, count, input);
+
+    uint32_t mask = 0;
+    int published = native_pub_submit(handle, input, count, timestampMs, &mask, changed);
+    if (published < 0) return -1;
+
+    if (published > 0) {
+        env->SetFloatArrayRegion(changedOut, 0, published, changed);
+    }
+    return static_cast<jlong>(mask);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_force(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    native_pub_force(handle);
+}
+
+/**
+ * Returns [submitted, publishedTicks, suppressedTicks,
+ *          publishedValues, suppressedValues, heartbeatValues]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativePublisher_getStats(
+        JNIEnv* env, jclass clazz, jlong handle) {
+    PublishStats stats;
+    if (native_pub_get_stats(handle, &stats) != 0) return nullptr;
+
+    jlong values[PUBLISH_STATS_FIELDS] = {
+        static_cast<jlong>(stats.submitted),
+        static_cast<jlong>(stats.published_ticks),
+        static_cast<jlong>(stats.suppressed_ticks),
+        static_cast<jlong>(stats.published_values),
+        static_cast<jlong>(stats.suppressed_values),
+        static_cast<jlong>(stats.heartbeat_values),
+    };
+
+    jlongArray arr = env->NewLongArray(PUBLISH_STATS_FIELDS);
+    if (arr == nullptr) return nullptr;
+
+    env->SetLongArrayRegion(arr, 0, PUBLISH_STATS_FIELDS, values);
+    return arr;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod PUBLISH_METHODS[] = {
+    NATIVE_METHOD("create", "(IJ)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_create),
+    NATIVE_METHOD("destroy", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_destroy),
+    NATIVE_METHOD("setDeadband", "(JIFF)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_setDeadband),
+    NATIVE_METHOD("submit", "(J[FJ[F)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_submit),
+    NATIVE_METHOD("force", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_force),
+    NATIVE_METHOD("getStats", "(J)[J",
+                  Java_com_sysmetrics_app_native_1bridge_NativePublisher_getStats),
+};
+const NativeMethodList NATIVE_PUBLISH_JNI = NATIVE_METHOD_LIST(PUBLISH_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
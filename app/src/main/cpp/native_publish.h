@@ -0,0 +1,83 @@
+#ifndef SYSMETRICS_NATIVE_PUBLISH_H
+#define SYSMETRICS_NATIVE_PUBLISH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE PUBLISH - Change-driven sample suppression
+ * ============================================================================
+ *
+ * Sits between the collectors and their consumers (overlay text, analytics
+ * buffers). Every tick the full sample vector is submitted; only metrics
+ * that moved beyond their dead-band since they were last published come
+ * back, as a bitmask plus the packed changed values. A metric that stayed
+ * inside its dead-band for max_silence_ms is republished anyway so
+ * consumers never go stale.
+ *
+ * On an idle box most ticks return an empty mask, so formatting, JNI
+ * copies and buffer pushes scale with activity instead of wall-clock time.
+ */
+
+#define PUBLISH_MAX_METRICS 32
+
+/**
+ * Publisher counters since creation.
+ */
+typedef struct {
+    uint64_t submitted;          // submit() calls
+    uint64_t published_ticks;    // ticks with at least one changed metric
+    uint64_t suppressed_ticks;   // ticks where nothing was published
+    uint64_t published_values;   // metric values published
+    uint64_t suppressed_values;  // metric values held back by a dead-band
+    uint64_t heartbeat_values;   // values published only because max silence expired
+} PublishStats;
+
+#define PUBLISH_STATS_FIELDS 6
+
+/**
+ * Create a publisher for a fixed-size sample vector.
+ * Dead-bands start at 0 (any change publishes).
+ * @param metric_count Number of metrics per sample (1..PUBLISH_MAX_METRICS)
+ * @param max_silence_ms Republish an unchanged metric after this long; <= 0 disables
+ * @return Handle, or 0 on failure
+ */
+int64_t native_pub_create(int32_t metric_count, int64_t max_silence_ms);
+
+void native_pub_destroy(int64_t handle);
+
+/**
+ * Set the dead-band of one metric. A new value is published when
+ * |value - last_published| > max(absolute, relative * |last_published|).
+ * @return 0 on success, -1 on bad handle/index/negative band
+ */
+int native_pub_set_deadband(int64_t handle, int32_t index, float absolute, float relative);
+
+/**
+ * Submit one sample vector.
+ * @param values metric_count values in metric order
+ * @param timestamp Sample time in milliseconds
+ * @param mask_out Bit i set if metric i is published this tick
+ * @param changed_out Receives the published values packed in metric order
+ *                    (room for metric_count floats); may be null
+ * @return Number of published values (popcount of mask), or -1 on error
+ */
+int native_pub_submit(int64_t handle, const float* values, int32_t count, int64_t timestamp,
+                      uint32_t* mask_out, float* changed_out);
+
+/**
+ * Publish every metric on the next submit (e.g. after the UI was rebuilt).
+ */
+void native_pub_force(int64_t handle);
+
+int native_pub_get_stats(int64_t handle, PublishStats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_PUBLISH_H
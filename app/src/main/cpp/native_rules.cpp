@@ -0,0 +1,339 @@
+#include "native_rules.h"
+#include "native_instrument.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_RULES"
+#include "native_platform.h"
+
+// ============================================================================
+// Rule Table and Transition Queue
+// ============================================================================
+
+struct Rule {
+    int32_t id;              // 0 = free slot
+    int64_t handle;
+    RuleSpec spec;
+    bool active;
+    int64_t pending_since;   // First sample of the current candidate flip, -1 if none
+    int64_t last_timestamp;
+    float last_value;
+};
+
+// g_rules_mutex is taken under the calculator's update lock (evaluate) and
+// under the analytics map lock (attach, detach); it never calls back into
+// analytics
+static std::mutex g_rules_mutex;
+static Rule g_rules[RULE_MAX];
+static int32_t g_next_rule_id = 1;
+
+// Fast path for calculators without rules: evaluate returns without locking
+static std::atomic<int32_t> g_rule_count{0};
+
+static RuleTransition g_queue[RULE_QUEUE_CAPACITY];
+static int32_t g_queue_head = 0;
+static int32_t g_queue_count = 0;
+static int64_t g_dropped = 0;
+
+// Caller holds g_rules_mutex
+static void queue_push(int32_t rule_id, bool active, float value, int64_t timestamp) {
+    if (g_queue_count == RULE_QUEUE_CAPACITY) {
+        g_queue_head = (g_queue_head + 1) % RULE_QUEUE_CAPACITY;
+        g_queue_count--;
+        g_dropped++;
+    }
+    RuleTransition& slot = g_queue[(g_queue_head + g_queue_count) % RULE_QUEUE_CAPACITY];
+    slot.rule_id = rule_id;
+    slot.active = active ? 1 : 0;
+    slot.value = value;
+    slot.timestamp = timestamp;
+    g_queue_count++;
+}
+
+// Caller holds g_rules_mutex
+static Rule* find_rule(int32_t rule_id) {
+    if (rule_id <= 0) return nullptr;
+    for (Rule& rule : g_rules) {
+        if (rule.id == rule_id) return &rule;
+    }
+    return nullptr;
+}
+
+// Caller holds g_rules_mutex
+static void free_rule(Rule& rule) {
+    rule.id = 0;
+    g_rule_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static bool spec_valid(const RuleSpec* spec) {
+    if (!spec) return false;
+    if (!std::isfinite(spec->enter) || !std::isfinite(spec->exit)) return false;
+    if (spec->enter_hold_ms < 0 || spec->exit_hold_ms < 0) return false;
+
+    switch (spec->source) {
+        case RULE_SOURCE_VALUE:
+            break;
+        case RULE_SOURCE_PERCENTILE:
+            if (spec->percentile < 1 || spec->percentile > 100) return false;
+            // fall through
+        case RULE_SOURCE_AVERAGE:
+            if (spec->window_ms <= 0) return false;
+            break;
+        default:
+            return false;
+    }
+
+    switch (spec->direction) {
+        case RULE_ABOVE: return spec->exit <= spec->enter;
+        case RULE_BELOW: return spec->exit >= spec->enter;
+        default: return false;
+    }
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+static float source_value(const RuleSpec& spec, const CircularBuffer* buffer, float value, int64_t timestamp) {
+    switch (spec.source) {
+        case RULE_SOURCE_AVERAGE:
+            return native_calc_average(buffer, spec.window_ms, timestamp);
+        case RULE_SOURCE_PERCENTILE:
+            return native_calc_percentile(buffer, spec.percentile, spec.window_ms, timestamp);
+        default:
+            return value;
+    }
+}
+
+// NaN satisfies neither condition, so it only ever restarts a pending flip
+static bool wants_flip(const Rule& rule, float x) {
+    const RuleSpec& spec = rule.spec;
+    if (spec.direction == RULE_ABOVE) {
+        return rule.active ? x < spec.exit : x >= spec.enter;
+    }
+    return rule.active ? x > spec.exit : x <= spec.enter;
+}
+
+// Caller holds g_rules_mutex
+static void step(Rule& rule, float x, int64_t timestamp) {
+    rule.last_timestamp = timestamp;
+    rule.last_value = x;
+
+    if (!wants_flip(rule, x)) {
+        rule.pending_since = -1;
+        return;
+    }
+    if (rule.pending_since < 0) rule.pending_since = timestamp;
+
+    int64_t hold = rule.active ? rule.spec.exit_hold_ms : rule.spec.enter_hold_ms;
+    if (timestamp - rule.pending_since < hold) return;
+
+    rule.active = !rule.active;
+    rule.pending_since = -1;
+    queue_push(rule.id, rule.active, x, timestamp);
+}
+
+void native_rules_evaluate(int64_t handle, const CircularBuffer* buffer, float value, int64_t timestamp) {
+    if (g_rule_count.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    for (Rule& rule : g_rules) {
+        if (rule.id == 0 || rule.handle != handle) continue;
+        step(rule, source_value(rule.spec, buffer, value, timestamp), timestamp);
+    }
+}
+
+// ============================================================================
+// Rule Management
+// ============================================================================
+
+int32_t native_rule_add(int64_t handle, const RuleSpec* spec) {
+    if (handle == 0 || !spec_valid(spec)) return -1;
+
+    // Checks the handle and calls native_rules_attach under the map lock
+    return native_twc_attach_rule(handle, spec);
+}
+
+int32_t native_rules_attach(int64_t handle, const RuleSpec* spec) {
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    for (Rule& rule : g_rules) {
+        if (rule.id != 0) continue;
+
+        rule.id = g_next_rule_id++;
+        rule.handle = handle;
+        rule.spec = *spec;
+        rule.active = false;
+        rule.pending_since = -1;
+        rule.last_timestamp = 0;
+        rule.last_value = 0.0f;
+        g_rule_count.fetch_add(1, std::memory_order_relaxed);
+        return rule.id;
+    }
+
+    LOGW("Rule table full (%d rules)", RULE_MAX);
+    return -1;
+}
+
+int native_rule_remove(int32_t rule_id) {
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    Rule* rule = find_rule(rule_id);
+    if (!rule) return -1;
+    free_rule(*rule);
+    return 0;
+}
+
+int native_rule_state(int32_t rule_id) {
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    Rule* rule = find_rule(rule_id);
+    if (!rule) return -1;
+    return rule->active ? 1 : 0;
+}
+
+int native_rule_drain(RuleTransition* out, int max) {
+    if (!out || max <= 0) return 0;
+
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    int count = max < g_queue_count ? max : g_queue_count;
+    for (int i = 0; i < count; i++) {
+        out[i] = g_queue[(g_queue_head + i) % RULE_QUEUE_CAPACITY];
+    }
+    g_queue_head = (g_queue_head + count) % RULE_QUEUE_CAPACITY;
+    g_queue_count -= count;
+    return count;
+}
+
+int64_t native_rule_dropped(void) {
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    return g_dropped;
+}
+
+void native_rules_reset(int64_t handle) {
+    if (g_rule_count.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    for (Rule& rule : g_rules) {
+        if (rule.id == 0 || rule.handle != handle) continue;
+        if (rule.active) {
+            queue_push(rule.id, false, rule.last_value, rule.last_timestamp);
+        }
+        rule.active = false;
+        rule.pending_since = -1;
+    }
+}
+
+void native_rules_detach(int64_t handle) {
+    if (g_rule_count.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    for (Rule& rule : g_rules) {
+        if (rule.id != 0 && rule.handle == handle) free_rule(rule);
+    }
+}
+
+void native_rules_clear_all(void) {
+    std::lock_guard<std::mutex> lock(g_rules_mutex);
+    memset(g_rules, 0, sizeof(g_rules));
+    g_rule_count.store(0, std::memory_order_relaxed);
+    g_queue_head = 0;
+    g_queue_count = 0;
+    g_dropped = 0;
+}
+
+#ifndef SYSMETRICS_NO_JNI
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+extern "C" {
+
+/**
+ * Attach a threshold rule to a TimeWindowCalculator.
+ * Returns the rule id, or -1 on an unknown handle, an invalid spec or a full table.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleAdd(
+        JNIEnv* env, jclass clazz, jlong handle, jint source, jint percentile, jlong windowMs,
+        jint direction, jfloat enter, jfloat exit, jlong enterHoldMs, jlong exitHoldMs) {
+    NativeTraceScope trace("NativeAnalytics.ruleAdd", TRACE_CAT_JNI);
+    RuleSpec spec = { source, percentile, windowMs, direction, enter, exit, enterHoldMs, exitHoldMs };
+    return native_rule_add(handle, &spec);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleRemove(
+        JNIEnv* env, jclass clazz, jint ruleId) {
+    NativeTraceScope trace("NativeAnalytics.ruleRemove", TRACE_CAT_JNI);
+    return native_rule_remove(ruleId) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleState(
+        JNIEnv* env, jclass clazz, jint ruleId) {
+    return native_rule_state(ruleId);
+}
+
+/**
+ * Drain queued transitions into out, RULE_OUT_FIELDS longs per transition.
+ * Returns the number of transitions written (at most out.size / 4).
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleDrainInto(
+        JNIEnv* env, jclass clazz, jlongArray out) {
+    NativeTraceScope trace("NativeAnalytics.ruleDrainInto", TRACE_CAT_JNI);
+    if (out == nullptr) return 0;
+
+    int max = env->GetArrayLength(out) / RULE_OUT_FIELDS;
+    if (max > RULE_QUEUE_CAPACITY) max = RULE_QUEUE_CAPACITY;
+
+    RuleTransition transitions[RULE_QUEUE_CAPACITY];
+    int count = native_rule_drain(transitions, max);
+    if (count == 0) return 0;
+
+    jlong packed[RULE_QUEUE_CAPACITY * RULE_OUT_FIELDS];
+    for (int i = 0; i < count; i++) {
+        int32_t bits;
+        memcpy(&bits, &transitions[i].value, sizeof(bits));
+        jlong* row = packed + i * RULE_OUT_FIELDS;
+        row[RULE_OUT_ID] = transitions[i].rule_id;
+        row[RULE_OUT_ACTIVE] = transitions[i].active;
+        row[RULE_OUT_VALUE] = bits;
+        row[RULE_OUT_TIMESTAMP] = transitions[i].timestamp;
+    }
+    env->SetLongArrayRegion(out, 0, count * RULE_OUT_FIELDS, packed);
+    return count;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleDroppedCount(
+        JNIEnv* env, jclass clazz) {
+    return native_rule_dropped();
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod RULES_METHODS[] = {
+    NATIVE_METHOD("ruleAdd", "(JIIJIFFJJ)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleAdd),
+    NATIVE_METHOD("ruleRemove", "(I)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleRemove),
+    NATIVE_METHOD("ruleState", "(I)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleState),
+    NATIVE_METHOD("ruleDrainInto", "([J)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleDrainInto),
+    NATIVE_METHOD("ruleDroppedCount", "()J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_ruleDroppedCount),
+};
+const NativeMethodList NATIVE_RULES_JNI = NATIVE_METHOD_LIST(RULES_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,137 @@
+#ifndef SYSMETRICS_NATIVE_RULES_H
+#define SYSMETRICS_NATIVE_RULES_H
+
+#include <stdint.h>
+#include "native_analytics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE RULES - Threshold rules with hysteresis and debounce
+ * ============================================================================
+ *
+ * Declarative rules attached to a TimeWindowCalculator handle, evaluated in
+ * native_twc_add_point as each point lands in the buffer. A rule watches
+ * one source (the point itself, a windowed mean or a windowed percentile):
+ *
+ * - RULE_ABOVE enters when source >= enter and leaves when source < exit
+ * - RULE_BELOW enters when source <= enter and leaves when source > exit
+ *
+ * The gap between enter and exit is the hysteresis band. A condition has
+ * to hold for enter_hold_ms (or exit_hold_ms) of sample time before the
+ * rule flips; a single sample that breaks the condition restarts the wait.
+ * Only flips are recorded, into one bounded queue shared by all rules that
+ * callers drain in batches. When the queue is full the oldest transition
+ * is dropped and counted.
+ *
+ * Rules of a destroyed calculator are removed with it. Clearing a
+ * calculator resets its rules; active ones record a final exit.
+ */
+
+#define RULE_SOURCE_VALUE       0   // The point just added
+#define RULE_SOURCE_AVERAGE     1   // Mean over window_ms
+#define RULE_SOURCE_PERCENTILE  2   // percentile over window_ms
+
+#define RULE_ABOVE 0
+#define RULE_BELOW 1
+
+#define RULE_MAX 64
+#define RULE_QUEUE_CAPACITY 256
+
+// Packed layout of ruleDrainInto: one row of int64 per transition
+#define RULE_OUT_ID         0   // rule id
+#define RULE_OUT_ACTIVE     1   // 1 entered, 0 left
+#define RULE_OUT_VALUE      2   // source value as float bits
+#define RULE_OUT_TIMESTAMP  3
+#define RULE_OUT_FIELDS     4
+
+typedef struct {
+    int32_t source;          // RULE_SOURCE_*
+    int32_t percentile;      // 1..100, RULE_SOURCE_PERCENTILE only
+    int64_t window_ms;       // Averaging / percentile window
+    int32_t direction;       // RULE_ABOVE or RULE_BELOW
+    float enter;
+    float exit;              // <= enter for RULE_ABOVE, >= enter for RULE_BELOW
+    int64_t enter_hold_ms;
+    int64_t exit_hold_ms;
+} RuleSpec;
+
+typedef struct {
+    int32_t rule_id;
+    int32_t active;          // State after the transition
+    float value;             // Source value that completed it
+    int64_t timestamp;       // Sample timestamp that completed it
+} RuleTransition;
+
+/**
+ * Attach a rule to a calculator handle. The rule starts inactive.
+ * @return Rule id (> 0), or -1 on an unknown handle, an invalid spec or a
+ *         full table
+ */
+int32_t native_rule_add(int64_t handle, const RuleSpec* spec);
+
+/**
+ * Remove a rule. Its queued transitions stay in the queue.
+ * @return 0 on success, -1 if the id is unknown
+ */
+int native_rule_remove(int32_t rule_id);
+
+/**
+ * @return 1 if the rule is active, 0 if inactive, -1 if the id is unknown
+ */
+int native_rule_state(int32_t rule_id);
+
+/**
+ * Move up to max queued transitions into out, oldest first.
+ * @return Number of transitions written
+ */
+int native_rule_drain(RuleTransition* out, int max);
+
+/**
+ * Transitions dropped because the queue was full.
+ */
+int64_t native_rule_dropped(void);
+
+/**
+ * Look handle up and, if it exists, native_rules_attach() while holding the
+ * analytics map lock, so a concurrent native_twc_destroy cannot leave an
+ * orphaned rule behind (defined in native_analytics.cpp).
+ * @return Rule id, or -1 on an unknown handle or a full table
+ */
+int32_t native_twc_attach_rule(int64_t handle, const RuleSpec* spec);
+
+/**
+ * Store a validated rule for a handle known to exist. Caller holds the
+ * analytics map lock.
+ */
+int32_t native_rules_attach(int64_t handle, const RuleSpec* spec);
+
+/**
+ * Evaluate the handle's rules against the buffer after value was pushed.
+ * Caller holds the calculator's update lock.
+ */
+void native_rules_evaluate(int64_t handle, const CircularBuffer* buffer, float value, int64_t timestamp);
+
+/**
+ * Return the handle's rules to inactive (native_twc_clear).
+ */
+void native_rules_reset(int64_t handle);
+
+/**
+ * Remove the handle's rules (native_twc_destroy).
+ */
+void native_rules_detach(int64_t handle);
+
+/**
+ * Remove every rule, empty the queue and zero the drop counter (tests).
+ */
+void native_rules_clear_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_RULES_H
@@ -0,0 +1,82 @@
+#ifndef SYSMETRICS_NATIVE_SEQLOCK_H
+#define SYSMETRICS_NATIVE_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * ============================================================================
+ * NATIVE SEQLOCK - Single-writer slot that readers copy without locking
+ * ============================================================================
+ *
+ * The writer bumps the sequence to odd, stores the value, then bumps it to
+ * even; a reader copies between two sequence loads and retries when they
+ * differ or are odd. Readers never block the writer and never block each
+ * other. The value is stored as relaxed 32-bit atomic words so the
+ * concurrent copy is well defined.
+ *
+ * Writers must be serialised by the caller. read() gives up after
+ * max_attempts so a caller can fall back to the writer's own lock instead
+ * of spinning behind a writer that was descheduled mid-publish.
+ */
+
+template <typename T>
+class SeqlockSlot {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqlockSlot needs a trivially copyable type");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "SeqlockSlot type must be a whole number of words");
+
+    static constexpr size_t WORDS = sizeof(T) / sizeof(uint32_t);
+
+public:
+    static constexpr int DEFAULT_ATTEMPTS = 16;
+
+    SeqlockSlot() : sequence_(0) {
+        for (std::atomic<uint32_t>& word : words_) word.store(0, std::memory_order_relaxed);
+    }
+
+    void publish(const T& value) {
+        uint32_t words[WORDS];
+        memcpy(words, &value, sizeof(T));
+
+        uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(words[i], std::memory_order_relaxed);
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @return true with a consistent copy in out, false if every attempt
+     *         overlapped a publish
+     */
+    bool read(T* out, int max_attempts = DEFAULT_ATTEMPTS) const {
+        uint32_t words[WORDS];
+        for (int attempt = 0; attempt < max_attempts; attempt++) {
+            uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+
+            for (size_t i = 0; i < WORDS; i++) words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) != before) continue;
+
+            memcpy(out, words, sizeof(T));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Number of completed publishes.
+     */
+    uint32_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    std::atomic<uint32_t> sequence_;
+    std::atomic<uint32_t> words_[WORDS];
+};
+
+#endif // SYSMETRICS_NATIVE_SEQLOCK_H
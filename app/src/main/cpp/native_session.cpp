@@ -0,0 +1,407 @@
+#include "native_session.h"
+#include "native_analytics.h"
+#include "native_instrument.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_SESSION"
+#include "native_platform.h"
+
+static_assert(SNAPSHOT_METRIC_COUNT <= 32, "changed mask must fit a 32-bit varint");
+
+// Longest record: two varints and every value
+#define SESSION_MAX_RECORD (10 + 5 + SNAPSHOT_METRIC_COUNT * 4)
+
+// Bits both sides start from, so metrics never collected cost nothing.
+// Narrowing a double NaN gives this quiet NaN.
+#define SESSION_NAN_BITS 0x7fc00000u
+
+// Bit test instead of std::isnan, which -ffast-math (Android release) folds to false
+static inline bool is_nan_bits(uint32_t bits) {
+    return (bits & 0x7fffffffu) > 0x7f800000u;
+}
+
+// ============================================================================
+// Varints (LEB128)
+// ============================================================================
+
+static inline size_t put_varint(uint8_t* out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+// @return false if the varint runs past end or is longer than 10 bytes
+static inline bool get_varint(const uint8_t* data, size_t end, size_t* pos, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= end) return false;
+        uint8_t byte = data[(*pos)++];
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+struct SessionRecorder {
+    int fd = -1;
+    int64_t count = 0;
+    int64_t last_mono_ns = 0;     // As the reader will rebuild it (whole us)
+    int64_t last_flush_ns = 0;
+    uint32_t bits[SNAPSHOT_METRIC_COUNT];
+    size_t used = 0;
+    uint8_t buffer[SESSION_FLUSH_BYTES + SESSION_MAX_RECORD];
+};
+
+// Fast path for native_snapshot_publish: no lock while not recording
+static std::atomic<bool> g_session_active{false};
+static std::mutex g_session_mutex;
+static SessionRecorder g_recorder;
+
+static bool write_all(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool flush_locked(SessionRecorder& rec) {
+    bool ok = write_all(rec.fd, rec.buffer, rec.used);
+    rec.used = 0;
+    return ok;
+}
+
+static int64_t close_locked(SessionRecorder& rec) {
+    if (rec.fd < 0) return -1;
+
+    if (!flush_locked(rec)) LOGE("Failed to flush session log: %s", strerror(errno));
+    close(rec.fd);
+    rec.fd = -1;
+    g_session_active.store(false, std::memory_order_relaxed);
+    return rec.count;
+}
+
+int native_session_start(const char* path) {
+    if (!path) return -1;
+
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    SessionRecorder& rec = g_recorder;
+    close_locked(rec);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOGE("Failed to create session log %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    int64_t start_wall_ms = static_cast<int64_t>(wall.tv_sec) * 1000 + wall.tv_nsec / 1000000;
+    int64_t start_mono_ns = static_cast<int64_t>(native_instr_now_ns());
+
+    uint8_t header[SESSION_HEADER_SIZE] = {};
+    uint32_t magic = SESSION_MAGIC;
+    uint16_t version = SESSION_VERSION;
+    uint16_t metric_count = SNAPSHOT_METRIC_COUNT;
+    memcpy(header + SESSION_HDR_MAGIC, &magic, sizeof(magic));
+    memcpy(header + SESSION_HDR_VERSION, &version, sizeof(version));
+    memcpy(header + SESSION_HDR_METRIC_COUNT, &metric_count, sizeof(metric_count));
+    memcpy(header + SESSION_HDR_START_WALL, &start_wall_ms, sizeof(start_wall_ms));
+    memcpy(header + SESSION_HDR_START_MONO, &start_mono_ns, sizeof(start_mono_ns));
+    if (!write_all(fd, header, sizeof(header))) {
+        LOGE("Failed to write session header: %s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    rec.fd = fd;
+    rec.count = 0;
+    rec.last_mono_ns = start_mono_ns;
+    rec.last_flush_ns = start_mono_ns;
+    rec.used = 0;
+    for (uint32_t& bits : rec.bits) bits = SESSION_NAN_BITS;
+    g_session_active.store(true, std::memory_order_relaxed);
+    LOGI("Recording session to %s", path);
+    return 0;
+}
+
+int native_session_record(const MetricsSnapshot* snapshot, int64_t mono_ns) {
+    if (!snapshot || !g_session_active.load(std::memory_order_relaxed)) return -1;
+
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    SessionRecorder& rec = g_recorder;
+    if (rec.fd < 0) return -1;
+
+    // Monotonic time never steps back, but a caller-supplied one might
+    int64_t dt_us = mono_ns > rec.last_mono_ns ? (mono_ns - rec.last_mono_ns) / 1000 : 0;
+    rec.last_mono_ns += dt_us * 1000;
+
+    uint32_t changed = 0;
+    uint32_t bits[SNAPSHOT_METRIC_COUNT];
+    for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+        float value = static_cast<float>(snapshot->values[i]);
+        memcpy(&bits[i], &value, sizeof(bits[i]));
+        if (is_nan_bits(bits[i])) bits[i] = SESSION_NAN_BITS;
+        if (bits[i] != rec.bits[i]) changed |= 1u << i;
+    }
+
+    uint8_t* out = rec.buffer + rec.used;
+    size_t n = put_varint(out, static_cast<uint64_t>(dt_us));
+    n += put_varint(out + n, changed);
+    for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+        if (!(changed & (1u << i))) continue;
+        memcpy(out + n, &bits[i], sizeof(bits[i]));
+        n += sizeof(bits[i]);
+        rec.bits[i] = bits[i];
+    }
+    rec.used += n;
+    rec.count++;
+
+    bool due = rec.last_mono_ns - rec.last_flush_ns >= SESSION_FLUSH_INTERVAL_MS * 1000000LL;
+    if (rec.used >= SESSION_FLUSH_BYTES || due) {
+        rec.last_flush_ns = rec.last_mono_ns;
+        if (!flush_locked(rec)) {
+            LOGE("Session log write failed, recording stopped: %s", strerror(errno));
+            close(rec.fd);
+            rec.fd = -1;
+            g_session_active.store(false, std::memory_order_relaxed);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int64_t native_session_stop(void) {
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    int64_t count = close_locked(g_recorder);
+    if (count >= 0) LOGI("Session recording stopped after %lld samples", static_cast<long long>(count));
+    return count;
+}
+
+int64_t native_session_recorded(void) {
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    return g_recorder.fd >= 0 ? g_recorder.count : -1;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+int native_session_reader_open(SessionReader* reader, const void* data, size_t size) {
+    if (!reader || !data || size < SESSION_HEADER_SIZE) return -1;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t magic;
+    uint16_t version, metric_count;
+    memcpy(&magic, bytes + SESSION_HDR_MAGIC, sizeof(magic));
+    memcpy(&version, bytes + SESSION_HDR_VERSION, sizeof(version));
+    memcpy(&metric_count, bytes + SESSION_HDR_METRIC_COUNT, sizeof(metric_count));
+    if (magic != SESSION_MAGIC || version != SESSION_VERSION || metric_count != SNAPSHOT_METRIC_COUNT) {
+        return -1;
+    }
+
+    reader->data = bytes;
+    reader->size = size;
+    reader->pos = SESSION_HEADER_SIZE;
+    memcpy(&reader->start_wall_ms, bytes + SESSION_HDR_START_WALL, sizeof(reader->start_wall_ms));
+    memcpy(&reader->start_mono_ns, bytes + SESSION_HDR_START_MONO, sizeof(reader->start_mono_ns));
+    reader->mono_ns = reader->start_mono_ns;
+    for (uint32_t& bits : reader->bits) bits = SESSION_NAN_BITS;
+    return 0;
+}
+
+int native_session_reader_next(SessionReader* reader, SessionSample* out) {
+    if (!reader || !out || !reader->data) return -1;
+    if (reader->pos >= reader->size) return 0;
+
+    // Decode into locals and commit only a complete record
+    size_t pos = reader->pos;
+    uint64_t dt_us, changed;
+    if (!get_varint(reader->data, reader->size, &pos, &dt_us) ||
+        !get_varint(reader->data, reader->size, &pos, &changed) ||
+        changed >> SNAPSHOT_METRIC_COUNT) {
+        return -1;
+    }
+    if (reader->size - pos < static_cast<size_t>(__builtin_popcountll(changed)) * sizeof(uint32_t)) return -1;
+
+    for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+        if (!(changed & (1u << i))) continue;
+        memcpy(&reader->bits[i], reader->data + pos, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+    }
+    reader->pos = pos;
+    reader->mono_ns += static_cast<int64_t>(dt_us) * 1000;
+
+    out->mono_ns = reader->mono_ns;
+    out->timestamp_ms = reader->start_wall_ms + (reader->mono_ns - reader->start_mono_ns) / 1000000;
+    memcpy(out->values, reader->bits, sizeof(out->values));
+    return 1;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+int native_replay_targets_create(ReplayTargets* targets, int32_t chart_capacity, int64_t peak_window_ms) {
+    if (!targets) return -1;
+    memset(targets, 0, sizeof(*targets));
+
+    for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+        targets->twc[i] = native_twc_create(WINDOW_5M);
+        targets->chart[i] = native_chart_create(chart_capacity);
+        targets->peak[i] = native_peak_create(peak_window_ms);
+        if (!targets->twc[i] || !targets->chart[i] || !targets->peak[i]) {
+            native_replay_targets_destroy(targets);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void native_replay_targets_destroy(ReplayTargets* targets) {
+    if (!targets) return;
+
+    for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+        if (targets->twc[i]) native_twc_destroy(targets->twc[i]);
+        if (targets->chart[i]) native_chart_destroy(targets->chart[i]);
+        if (targets->peak[i]) native_peak_destroy(targets->peak[i]);
+    }
+    memset(targets, 0, sizeof(*targets));
+}
+
+int native_session_replay(const void* data, size_t size, const ReplayTargets* targets, ReplayStats* stats) {
+    if (!targets || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+
+    SessionReader reader;
+    if (native_session_reader_open(&reader, data, size) != 0) return -1;
+
+    uint64_t start_ns = native_instr_now_ns();
+    SessionSample sample;
+    int64_t first_ms = 0;
+    int64_t last_ms = 0;
+    int result;
+    while ((result = native_session_reader_next(&reader, &sample)) == 1) {
+        if (stats->samples++ == 0) first_ms = sample.timestamp_ms;
+        last_ms = sample.timestamp_ms;
+
+        for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+            uint32_t bits;
+            memcpy(&bits, &sample.values[i], sizeof(bits));
+            if (is_nan_bits(bits)) continue;
+
+            float value = sample.values[i];
+            if (targets->twc[i]) native_twc_add_point(targets->twc[i], value, sample.timestamp_ms);
+            if (targets->chart[i]) native_chart_add_point(targets->chart[i], value, sample.timestamp_ms);
+            if (targets->peak[i]) native_peak_add_value(targets->peak[i], value, sample.timestamp_ms);
+            stats->values++;
+        }
+    }
+
+    stats->elapsed_ns = static_cast<int64_t>(native_instr_now_ns() - start_ns);
+    stats->span_ms = last_ms - first_ms;
+    stats->truncated = result < 0 ? 1 : 0;
+    return 0;
+}
+
+int native_session_replay_file(const char* path, const ReplayTargets* targets, ReplayStats* stats) {
+    if (!path || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < SESSION_HEADER_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return -1;
+
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    int result = native_session_replay(mapped, size, targets, stats);
+    munmap(mapped, size);
+    return result;
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_startRecording(
+        JNIEnv* env, jclass clazz, jstring path) {
+    NativeTraceScope trace("NativeSharedSnapshot.startRecording", TRACE_CAT_JNI);
+    if (path == nullptr) return JNI_FALSE;
+
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    if (chars == nullptr) return JNI_FALSE;
+    int result = native_session_start(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    return result == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_stopRecording(JNIEnv* env, jclass clazz) {
+    NativeTraceScope trace("NativeSharedSnapshot.stopRecording", TRACE_CAT_JNI);
+    return native_session_stop();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_recordedSamples(JNIEnv* env, jclass clazz) {
+    return native_session_recorded();
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod SESSION_METHODS[] = {
+    NATIVE_METHOD("startRecording", "(Ljava/lang/String;)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_startRecording),
+    NATIVE_METHOD("stopRecording", "()J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_stopRecording),
+    NATIVE_METHOD("recordedSamples", "()J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_recordedSamples),
+};
+const NativeMethodList NATIVE_SESSION_JNI = NATIVE_METHOD_LIST(SESSION_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
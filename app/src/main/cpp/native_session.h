@@ -0,0 +1,165 @@
+#ifndef SYSMETRICS_NATIVE_SESSION_H
+#define SYSMETRICS_NATIVE_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "native_shared_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE SESSION - Binary session recorder and offline replay
+ * ============================================================================
+ *
+ * While recording, every snapshot the overlay publishes is appended to a
+ * log file with its CLOCK_MONOTONIC timestamp. Records are delta-coded
+ * against the previous one:
+ *
+ *   varint  dt_us     Microseconds since the previous record (or start)
+ *   varint  changed   Bit i set if metric i differs from the previous record
+ *   float32 value     One per set bit, lowest metric first (NaN = not collected)
+ *
+ * A 1 s tick where only CPU moved costs 8 bytes. The 32-byte header
+ * pairs the monotonic start with the wall clock so replay can rebuild the
+ * wall timestamps the analytics engine expects without wall-clock jumps.
+ * Records are buffered and written out every SESSION_FLUSH_BYTES or
+ * SESSION_FLUSH_INTERVAL_MS of sample time, so a killed process loses at
+ * most that much; readers stop cleanly at a truncated tail.
+ *
+ * Replay decodes a log and feeds fresh TimeWindowCalculator, ChartBuffer
+ * and PeakTracker instances back to back, with no sleeping, so analytics,
+ * anomaly scores and rules attached to the calculators can be re-run on a
+ * Linux host (see test/cpp/tools/replay_session.cpp).
+ */
+
+#define SESSION_MAGIC 0x534D5352u   // "SMSR"
+#define SESSION_VERSION 1
+#define SESSION_HEADER_SIZE 32
+
+#define SESSION_FLUSH_BYTES 4096
+#define SESSION_FLUSH_INTERVAL_MS 10000
+
+// Header layout (native byte order)
+#define SESSION_HDR_MAGIC         0   // uint32
+#define SESSION_HDR_VERSION       4   // uint16
+#define SESSION_HDR_METRIC_COUNT  6   // uint16
+#define SESSION_HDR_START_WALL    8   // int64 wall clock ms at start
+#define SESSION_HDR_START_MONO    16  // int64 CLOCK_MONOTONIC ns at start
+                                      // 24..31 reserved, zero
+
+// ============================================================================
+// Recorder (one per process)
+// ============================================================================
+
+/**
+ * Create (truncate) path and start recording published snapshots. A
+ * recording already in progress is finished first.
+ * @return 0 on success, -1 if the file cannot be written
+ */
+int native_session_start(const char* path);
+
+/**
+ * Append one sample taken at mono_ns (CLOCK_MONOTONIC). Called by
+ * native_snapshot_publish; a no-op when not recording. The snapshot's
+ * wall timestamp is not stored.
+ * @return 0 when recorded, -1 when not recording or the write failed
+ *         (which ends the recording)
+ */
+int native_session_record(const MetricsSnapshot* snapshot, int64_t mono_ns);
+
+/**
+ * Flush and close the log.
+ * @return Samples recorded, or -1 if not recording
+ */
+int64_t native_session_stop(void);
+
+/**
+ * @return Samples recorded so far, or -1 if not recording
+ */
+int64_t native_session_recorded(void);
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+typedef struct {
+    int64_t mono_ns;          // CLOCK_MONOTONIC at the sample
+    int64_t timestamp_ms;     // Wall clock rebuilt from the header anchor
+    float values[SNAPSHOT_METRIC_COUNT];
+} SessionSample;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    int64_t start_wall_ms;
+    int64_t start_mono_ns;
+    int64_t mono_ns;
+    uint32_t bits[SNAPSHOT_METRIC_COUNT];   // Previous record's values
+} SessionReader;
+
+/**
+ * Start reading a log held in memory (the reader does not copy it).
+ * @return 0 on success, -1 if the header is missing or not a session log
+ */
+int native_session_reader_open(SessionReader* reader, const void* data, size_t size);
+
+/**
+ * Decode the next sample.
+ * @return 1 with out filled, 0 at the clean end of the log, -1 at a
+ *         truncated or corrupt record (the reader stays there)
+ */
+int native_session_reader_next(SessionReader* reader, SessionSample* out);
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+/**
+ * Analytics instances fed by replay, one per metric. A 0 handle skips
+ * that metric/engine. Callers may attach rules or anomaly parameters to
+ * the calculators before replaying.
+ */
+typedef struct {
+    int64_t twc[SNAPSHOT_METRIC_COUNT];
+    int64_t chart[SNAPSHOT_METRIC_COUNT];
+    int64_t peak[SNAPSHOT_METRIC_COUNT];
+} ReplayTargets;
+
+typedef struct {
+    int64_t samples;          // Records decoded
+    int64_t values;           // Non-NaN metric values fed
+    int64_t elapsed_ns;       // Decode + feed time
+    int64_t span_ms;          // Sample time covered
+    int32_t truncated;        // 1 if the log ended mid-record
+} ReplayStats;
+
+/**
+ * Create fresh instances for every metric: calculators over WINDOW_5M,
+ * chart buffers of chart_capacity points, peak trackers over peak_window_ms.
+ * @return 0 on success, -1 on failure (nothing is left allocated)
+ */
+int native_replay_targets_create(ReplayTargets* targets, int32_t chart_capacity, int64_t peak_window_ms);
+
+void native_replay_targets_destroy(ReplayTargets* targets);
+
+/**
+ * Feed every sample of an in-memory log to the targets as fast as possible.
+ * NaN values are skipped.
+ * @return 0 on success (including a truncated tail), -1 on a bad header
+ */
+int native_session_replay(const void* data, size_t size, const ReplayTargets* targets, ReplayStats* stats);
+
+/**
+ * native_session_replay() over a memory-mapped log file.
+ */
+int native_session_replay_file(const char* path, const ReplayTargets* targets, ReplayStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_SESSION_H
@@ -0,0 +1,347 @@
+#include "native_shared_snapshot.h"
+#include "native_instrument.h"
+#include "native_session.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_SHARED_SNAPSHOT"
+#include "native_platform.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+// timestamp_ms followed by the metric values, one 64-bit word each
+#define SNAPSHOT_WORDS (1 + SNAPSHOT_METRIC_COUNT)
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "snapshot words must be lock-free to be shared across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "snapshot sequence must be lock-free to be shared across processes");
+static_assert(sizeof(MetricsSnapshot) == SNAPSHOT_WORDS * sizeof(uint64_t),
+              "MetricsSnapshot must be a whole number of 64-bit words");
+
+/**
+ * Layout of the shared region. Header fields are written before the fd is
+ * handed out and never change; only sequence and the words move.
+ */
+struct SnapshotRegion {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t metric_count;
+    uint32_t region_size;
+    std::atomic<uint32_t> sequence;        // Odd while the writer is mid-update
+    uint32_t reserved;
+    std::atomic<uint64_t> publish_count;
+    std::atomic<uint64_t> words[SNAPSHOT_WORDS];
+};
+
+// Writer side: one region per process, publishes serialised by the mutex
+static std::mutex g_writer_mutex;
+static SnapshotRegion* g_writer_region = nullptr;
+static int g_writer_fd = -1;
+
+// Reader side
+static std::mutex g_reader_mutex;
+static int64_t g_reader_next_handle = 1;
+static std::unordered_map<int64_t, const SnapshotRegion*> g_reader_map;
+
+// ============================================================================
+// Region Allocation
+// ============================================================================
+
+#if defined(__ANDROID__)
+// <linux/ashmem.h>, for kernels older than memfd_create (3.17)
+#define ASHMEM_NAME_LEN 256
+#define ASHMEM_SET_NAME _IOW(0x77, 1, char[ASHMEM_NAME_LEN])
+#define ASHMEM_SET_SIZE _IOW(0x77, 3, size_t)
+#define ASHMEM_GET_SIZE _IO(0x77, 4)
+
+static int create_ashmem(size_t size) {
+    int fd = open("/dev/ashmem", O_RDWR | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char name[ASHMEM_NAME_LEN] = "sysmetrics_snapshot";
+    if (ioctl(fd, ASHMEM_SET_NAME, name) < 0 || ioctl(fd, ASHMEM_SET_SIZE, size) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+static int create_shared_fd(size_t size) {
+#ifdef __NR_memfd_create
+    int fd = static_cast<int>(syscall(__NR_memfd_create, "sysmetrics_snapshot", MFD_CLOEXEC));
+    if (fd >= 0) {
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0) return fd;
+        close(fd);
+    }
+#endif
+#if defined(__ANDROID__)
+    return create_ashmem(size);
+#else
+    return -1;
+#endif
+}
+
+// ashmem reports st_size 0 through fstat; only memfd has a real file size
+static off_t shared_fd_size(int fd) {
+#if defined(__ANDROID__)
+    int ashmem_size = ioctl(fd, ASHMEM_GET_SIZE, nullptr);
+    if (ashmem_size >= 0) return static_cast<off_t>(ashmem_size);
+#endif
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    return st.st_size;
+}
+
+int native_snapshot_create(void) {
+    std::lock_guard<std::mutex> lock(g_writer_mutex);
+    if (g_writer_region) return g_writer_fd;
+
+    const size_t size = sizeof(SnapshotRegion);
+    int fd = create_shared_fd(size);
+    if (fd < 0) {
+        LOGE("Failed to create snapshot region");
+        return -1;
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        LOGE("Failed to map snapshot region");
+        close(fd);
+        return -1;
+    }
+
+    // Fresh shared memory is zero-filled: sequence 0, nothing published
+    SnapshotRegion* region = static_cast<SnapshotRegion*>(mapped);
+    region->magic = SNAPSHOT_MAGIC;
+    region->version = SNAPSHOT_VERSION;
+    region->metric_count = SNAPSHOT_METRIC_COUNT;
+    region->region_size = static_cast<uint32_t>(size);
+
+    g_writer_region = region;
+    g_writer_fd = fd;
+    LOGI("Snapshot region created (fd %d, %zu bytes)", fd, size);
+    return fd;
+}
+
+int native_snapshot_fd(void) {
+    std::lock_guard<std::mutex> lock(g_writer_mutex);
+    return g_writer_fd;
+}
+
+int native_snapshot_publish(const MetricsSnapshot* snapshot) {
+    if (!snapshot) return -1;
+
+    // Session log (native_session.h); returns at once when not recording
+    native_session_record(snapshot, static_cast<int64_t>(native_instr_now_ns()));
+
+    std::lock_guard<std::mutex> lock(g_writer_mutex);
+    SnapshotRegion* region = g_writer_region;
+    if (!region) return -1;
+
+    uint64_t words[SNAPSHOT_WORDS];
+    memcpy(words, snapshot, sizeof(words));
+
+    uint32_t seq = region->sequence.load(std::memory_order_relaxed);
+    region->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < SNAPSHOT_WORDS; i++) {
+        region->words[i].store(words[i], std::memory_order_relaxed);
+    }
+    region->publish_count.fetch_add(1, std::memory_order_relaxed);
+    region->sequence.store(seq + 2, std::memory_order_release);
+    return 0;
+}
+
+void native_snapshot_destroy(void) {
+    std::lock_guard<std::mutex> lock(g_writer_mutex);
+    if (!g_writer_region) return;
+
+    munmap(g_writer_region, sizeof(SnapshotRegion));
+    close(g_writer_fd);
+    g_writer_region = nullptr;
+    g_writer_fd = -1;
+}
+
+// ============================================================================
+// Readers
+// ============================================================================
+
+int64_t native_snapshot_attach(int fd) {
+    if (fd < 0) return 0;
+
+    if (shared_fd_size(fd) < static_cast<off_t>(sizeof(SnapshotRegion))) return 0;
+
+    void* mapped = mmap(nullptr, sizeof(SnapshotRegion), PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) return 0;
+
+    const SnapshotRegion* region = static_cast<const SnapshotRegion*>(mapped);
+    if (region->magic != SNAPSHOT_MAGIC || region->version != SNAPSHOT_VERSION ||
+        region->metric_count != SNAPSHOT_METRIC_COUNT) {
+        munmap(mapped, sizeof(SnapshotRegion));
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(g_reader_mutex);
+    int64_t handle = g_reader_next_handle++;
+    g_reader_map[handle] = region;
+    return handle;
+}
+
+void native_snapshot_detach(int64_t handle) {
+    std::lock_guard<std::mutex> lock(g_reader_mutex);
+    auto it = g_reader_map.find(handle);
+    if (it == g_reader_map.end()) return;
+
+    munmap(const_cast<SnapshotRegion*>(it->second), sizeof(SnapshotRegion));
+    g_reader_map.erase(it);
+}
+
+// Never blocks the writer: the reader mutex only guards the handle map
+static int64_t snapshot_read_impl(int64_t handle, MetricsSnapshot* out) {
+    if (!out) return -1;
+
+    const SnapshotRegion* region;
+    {
+        std::lock_guard<std::mutex> lock(g_reader_mutex);
+        auto it = g_reader_map.find(handle);
+        if (it == g_reader_map.end()) return -1;
+        region = it->second;
+    }
+
+    uint64_t words[SNAPSHOT_WORDS];
+    for (int attempt = 0; attempt < SNAPSHOT_READ_RETRIES; attempt++) {
+        uint32_t before = region->sequence.load(std::memory_order_acquire);
+        if (before & 1u) continue;
+
+        uint64_t count = region->publish_count.load(std::memory_order_relaxed);
+        for (int i = 0; i < SNAPSHOT_WORDS; i++) {
+            words[i] = region->words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (region->sequence.load(std::memory_order_relaxed) != before) continue;
+
+        if (count == 0) return 0;
+        memcpy(out, words, sizeof(words));
+        return static_cast<int64_t>(count);
+    }
+    return -1;
+}
+
+int64_t native_snapshot_read(int64_t handle, MetricsSnapshot* out) {
+    NativeProbeScope probe(PROBE_SNAPSHOT_READ);
+    int64_t result = snapshot_read_impl(handle, out);
+    if (result < 0) probe.fail();
+    return result;
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_create(JNIEnv* env, jclass clazz) {
+    NativeTraceScope trace("NativeSharedSnapshot.create", TRACE_CAT_JNI);
+    return native_snapshot_create();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_regionFd(JNIEnv* env, jclass clazz) {
+    return native_snapshot_fd();
+}
+
+/**
+ * values holds SNAPSHOT_METRIC_COUNT doubles in SnapshotMetric order.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_publish(
+        JNIEnv* env, jclass clazz, jlong timestampMs, jdoubleArray values) {
+    NativeTraceScope trace("NativeSharedSnapshot.publish", TRACE_CAT_JNI);
+    if (values == nullptr || env->GetArrayLength(values) < SNAPSHOT_METRIC_COUNT) return JNI_FALSE;
+
+    MetricsSnapshot snapshot;
+    snapshot.timestamp_ms = timestampMs;
+    env->GetDoubleArrayRegion(values, 0, SNAPSHOT_METRIC_COUNT, snapshot.values);
+    return native_snapshot_publish(&snapshot) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_destroy(JNIEnv* env, jclass clazz) {
+    native_snapshot_destroy();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_attach(JNIEnv* env, jclass clazz, jint fd) {
+    NativeTraceScope trace("NativeSharedSnapshot.attach", TRACE_CAT_JNI);
+    return native_snapshot_attach(fd);
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_detach(JNIEnv* env, jclass clazz, jlong handle) {
+    native_snapshot_detach(handle);
+}
+
+/**
+ * Fills out with [timestampMs, values...] (SNAPSHOT_METRIC_COUNT + 1 doubles).
+ * Returns the publish count, 0 before the first publish, or -1 on error.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_read(
+        JNIEnv* env, jclass clazz, jlong handle, jdoubleArray out) {
+    NativeTraceScope trace("NativeSharedSnapshot.read", TRACE_CAT_JNI);
+    if (out == nullptr || env->GetArrayLength(out) < SNAPSHOT_METRIC_COUNT + 1) return -1;
+
+    MetricsSnapshot snapshot;
+    int64_t count = native_snapshot_read(handle, &snapshot);
+    if (count <= 0) return count;
+
+    jdouble timestamp = static_cast<jdouble>(snapshot.timestamp_ms);
+    env->SetDoubleArrayRegion(out, 0, 1, &timestamp);
+    env->SetDoubleArrayRegion(out, 1, SNAPSHOT_METRIC_COUNT, snapshot.values);
+    return count;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod SHARED_SNAPSHOT_METHODS[] = {
+    NATIVE_METHOD("create", "()I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_create),
+    NATIVE_METHOD("regionFd", "()I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_regionFd),
+    NATIVE_METHOD("publish", "(J[D)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_publish),
+    NATIVE_METHOD("destroy", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_destroy),
+    NATIVE_METHOD("attach", "(I)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_attach),
+    NATIVE_METHOD("detach", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_detach),
+    NATIVE_METHOD("read", "(J[D)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeSharedSnapshot_read),
+};
+const NativeMethodList NATIVE_SHARED_SNAPSHOT_JNI = NATIVE_METHOD_LIST(SHARED_SNAPSHOT_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
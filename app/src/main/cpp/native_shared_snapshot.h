@@ -0,0 +1,102 @@
+#ifndef SYSMETRICS_NATIVE_SHARED_SNAPSHOT_H
+#define SYSMETRICS_NATIVE_SHARED_SNAPSHOT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE SHARED SNAPSHOT - Latest metrics in shared memory behind a seqlock
+ * ============================================================================
+ *
+ * The sampling owner (overlay service) publishes every tick into a small
+ * memfd region (ashmem on kernels without memfd_create). Any other
+ * component, in this process or in one the fd was passed to, maps the
+ * region read-only and copies the latest snapshot with plain loads: no
+ * syscall, no lock, no second read of /proc.
+ *
+ * Seqlock protocol: the writer bumps the sequence to odd, stores the
+ * payload, then bumps it to even. A reader copies the payload between two
+ * sequence loads and retries when they differ or are odd, so a copy that
+ * overlapped an update is never returned. Payload words are 64-bit
+ * lock-free atomics, which keeps the concurrent copy well defined.
+ */
+
+#define SNAPSHOT_MAGIC 0x534D534Eu   // "SMSN"
+#define SNAPSHOT_VERSION 1
+
+// Reader attempts before giving up on a writer that keeps the sequence odd
+#define SNAPSHOT_READ_RETRIES 64
+
+typedef enum {
+    SNAPSHOT_CPU_PERCENT = 0,
+    SNAPSHOT_RAM_USED_MB,
+    SNAPSHOT_RAM_TOTAL_MB,
+    SNAPSHOT_RAM_PERCENT,
+    SNAPSHOT_NET_RX_BPS,
+    SNAPSHOT_NET_TX_BPS,
+    SNAPSHOT_SELF_CPU_PERCENT,
+    SNAPSHOT_SELF_RAM_MB,
+    SNAPSHOT_TEMPERATURE_C,
+    SNAPSHOT_GPU_PERCENT,
+
+    SNAPSHOT_METRIC_COUNT
+} SnapshotMetric;
+
+/**
+ * One published sample. NaN marks a metric the publisher did not collect.
+ */
+typedef struct {
+    int64_t timestamp_ms;
+    double values[SNAPSHOT_METRIC_COUNT];
+} MetricsSnapshot;
+
+/**
+ * Create the shared region (once; later calls return the same fd).
+ * @return File descriptor of the region, or -1 on failure
+ */
+int native_snapshot_create(void);
+
+/**
+ * The region created by this process, without creating one. In-process
+ * readers attach to this fd; only the publisher calls create().
+ * @return File descriptor of the region, or -1 if none exists
+ */
+int native_snapshot_fd(void);
+
+/**
+ * Publish a snapshot into the region created by this process. While a
+ * session is recording (native_session.h) the snapshot is logged even if
+ * no region exists.
+ * @return 0 on success, -1 if no region exists
+ */
+int native_snapshot_publish(const MetricsSnapshot* snapshot);
+
+/**
+ * Unmap and close the region created by this process.
+ */
+void native_snapshot_destroy(void);
+
+/**
+ * Map a region read-only. The fd is not kept and may be closed afterwards.
+ * @return Handle, or 0 if fd is not a snapshot region
+ */
+int64_t native_snapshot_attach(int fd);
+
+void native_snapshot_detach(int64_t handle);
+
+/**
+ * Copy the latest consistent snapshot.
+ * @return Number of snapshots published so far (0 before the first, out
+ *         untouched), or -1 on a bad handle or a writer stuck mid-update
+ */
+int64_t native_snapshot_read(int64_t handle, MetricsSnapshot* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_SHARED_SNAPSHOT_H
@@ -0,0 +1,514 @@
+#include "native_sparkline.h"
+#include "native_instrument.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <unordered_map>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifndef SYSMETRICS_NO_JNI
+#include <android/bitmap.h>
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_SPARKLINE"
+#include "native_platform.h"
+
+// ============================================================================
+// Pixels (premultiplied, bytes R G B A)
+// ============================================================================
+
+static uint32_t premultiply(uint32_t argb) {
+    uint32_t a = argb >> 24;
+    uint32_t r = ((argb >> 16) & 0xff) * a;
+    uint32_t g = ((argb >> 8) & 0xff) * a;
+    uint32_t b = (argb & 0xff) * a;
+    return ((r + 127) / 255) | (((g + 127) / 255) << 8) | (((b + 127) / 255) << 16) | (a << 24);
+}
+
+static inline float channel(uint32_t px, int shift) {
+    return static_cast<float>((px >> shift) & 0xff);
+}
+
+static inline uint32_t pack(float r, float g, float b, float a) {
+    auto byte = [](float v) { return static_cast<uint32_t>(std::min(255.0f, std::max(0.0f, v)) + 0.5f); };
+    return byte(r) | (byte(g) << 8) | (byte(b) << 16) | (byte(a) << 24);
+}
+
+// a * (1 - t) + b * t
+static uint32_t mix(uint32_t a, uint32_t b, float t) {
+    float u = 1.0f - t;
+    return pack(channel(a, 0) * u + channel(b, 0) * t, channel(a, 8) * u + channel(b, 8) * t,
+                channel(a, 16) * u + channel(b, 16) * t, channel(a, 24) * u + channel(b, 24) * t);
+}
+
+// src at coverage over dst
+static uint32_t over(uint32_t src, float coverage, uint32_t dst) {
+    float keep = 1.0f - channel(src, 24) / 255.0f * coverage;
+    return pack(channel(src, 0) * coverage + channel(dst, 0) * keep,
+                channel(src, 8) * coverage + channel(dst, 8) * keep,
+                channel(src, 16) * coverage + channel(dst, 16) * keep,
+                channel(src, 24) * coverage + channel(dst, 24) * keep);
+}
+
+// Row r: fill where the line is at or above the row's top edge
+static void fill_row(uint32_t* row, const float* column_y, float r, uint32_t fill, uint32_t background,
+                     int c0, int c1) {
+    int c = c0;
+#if defined(__ARM_NEON)
+    uint32x4_t fill_v = vdupq_n_u32(fill);
+    uint32x4_t background_v = vdupq_n_u32(background);
+    float32x4_t r_v = vdupq_n_f32(r);
+    for (; c + 4 <= c1; c += 4) {
+        uint32x4_t below = vcleq_f32(vld1q_f32(column_y + c), r_v);
+        vst1q_u32(row + c, vbslq_u32(below, fill_v, background_v));
+    }
+#endif
+    for (; c < c1; c++) {
+        row[c] = column_y[c] <= r ? fill : background;
+    }
+}
+
+// ============================================================================
+// Geometry
+// ============================================================================
+
+// Column without data. Finite: release builds use -ffast-math
+static const float NO_LINE = FLT_MAX;
+
+static inline float slot_x(const SparkState* s, int slot) {
+    return s->style.padding + slot * s->step;
+}
+
+static inline float value_y(const SparkState* s, float v) {
+    float pad = s->style.padding;
+    return pad + (1.0f - v) * (s->height - 2.0f * pad);
+}
+
+// Columns either side of a changed point that its segments can reach
+static inline int reach_px(const SparkState* s) {
+    return static_cast<int>(std::ceil(s->style.line_width * 0.5f + 1.0f)) + 1;
+}
+
+static float line_y_at(const SparkState* s, float cx) {
+    int n = s->count;
+    if (n < 2 || cx < slot_x(s, 0) || cx > slot_x(s, n - 1)) return NO_LINE;
+    int seg = std::min(static_cast<int>(std::floor((cx - s->style.padding) / s->step)), n - 2);
+    float t = (cx - slot_x(s, seg)) / s->step;
+    float y0 = value_y(s, s->values[seg]);
+    float y1 = value_y(s, s->values[seg + 1]);
+    return y0 + t * (y1 - y0);
+}
+
+// Anti-aliased line pixels of one column, over what the fill pass left
+static void draw_line_column(const SparkState* s, uint32_t* pixels, int32_t stride, int c) {
+    int n = s->count;
+    if (n == 0) return;
+
+    float half = s->style.line_width * 0.5f;
+    float reach = half + 1.0f;
+    float cx = c + 0.5f;
+    int first = std::max(0, static_cast<int>(std::floor((cx - reach - s->style.padding) / s->step)));
+    int last = std::min(n - 1, static_cast<int>(std::floor((cx + reach - s->style.padding) / s->step)) + 1);
+    if (first > last) return;
+    if (slot_x(s, first) > cx + reach || slot_x(s, last) < cx - reach) return;
+
+    float y_min = FLT_MAX, y_max = -FLT_MAX;
+    for (int i = first; i <= last; i++) {
+        float y = value_y(s, s->values[i]);
+        y_min = std::min(y_min, y);
+        y_max = std::max(y_max, y);
+    }
+    int r0 = std::max(0, static_cast<int>(std::floor(y_min - reach)));
+    int r1 = std::min(s->height - 1, static_cast<int>(std::ceil(y_max + reach)));
+
+    // Nearest squared distance per row, each segment (or the lone point)
+    // only over the rows it can reach. Coordinates are relative to the pixel
+    // column so a scrolled column computes bit-identical coverage to the
+    // column it was shifted from.
+    float dist2[SPARK_MAX_HEIGHT];
+    for (int r = r0; r <= r1; r++) dist2[r] = FLT_MAX;
+    for (int i = first; i < last || i == first; i++) {
+        int j = std::min(i + 1, last);
+        float y0 = value_y(s, s->values[i]), y1 = value_y(s, s->values[j]);
+        float ax = slot_x(s, i) - cx;
+        float dx = slot_x(s, j) - slot_x(s, i), dy = y1 - y0;
+        float len2 = dx * dx + dy * dy;
+        float inv_len2 = len2 > 0.0f ? 1.0f / len2 : 0.0f;
+
+        int lo = std::max(r0, static_cast<int>(std::floor(std::min(y0, y1) - reach)));
+        int hi = std::min(r1, static_cast<int>(std::ceil(std::max(y0, y1) + reach)));
+        for (int r = lo; r <= hi; r++) {
+            float ay = y0 - (r + 0.5f);
+            float t = std::max(0.0f, std::min(1.0f, -(ax * dx + ay * dy) * inv_len2));
+            float ex = ax + t * dx, ey = ay + t * dy;
+            dist2[r] = std::min(dist2[r], ex * ex + ey * ey);
+        }
+    }
+
+    float edge = half + 0.5f;
+    for (int r = r0; r <= r1; r++) {
+        if (dist2[r] >= edge * edge) continue;
+        float coverage = std::min(1.0f, edge - std::sqrt(dist2[r]));
+        uint32_t* px = pixels + static_cast<size_t>(r) * stride + c;
+        *px = over(s->line_px, coverage, *px);
+    }
+}
+
+// Repaint columns [c0, c1) from s->values
+static void render_columns(SparkState* s, uint32_t* pixels, int32_t stride, int c0, int c1) {
+    for (int c = c0; c < c1; c++) s->column_y[c] = line_y_at(s, c + 0.5f);
+
+    for (int r = 0; r < s->height; r++) {
+        fill_row(pixels + static_cast<size_t>(r) * stride, s->column_y, static_cast<float>(r),
+                 s->fill_px[r], s->background_px, c0, c1);
+    }
+
+    for (int c = c0; c < c1; c++) {
+        // Partially covered row where the fill meets the line
+        float y = s->column_y[c];
+        if (y > 0.0f && y < s->height) {
+            int r = static_cast<int>(y);
+            float coverage = (r + 1) - y;
+            uint32_t* px = pixels + static_cast<size_t>(r) * stride + c;
+            *px = mix(s->background_px, s->fill_px[r], coverage);
+        }
+        draw_line_column(s, pixels, stride, c);
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+// Premultiplied pixels and the gradient rows from style colors and size
+static void derive_colors(SparkState* s) {
+    s->background_px = premultiply(s->style.background);
+    s->line_px = premultiply(s->style.line);
+    uint32_t top = premultiply(s->style.fill_top);
+    uint32_t bottom = premultiply(s->style.fill_bottom);
+    float padding = s->style.padding;
+    float span = s->height - 2.0f * padding;
+    for (int r = 0; r < s->height; r++) {
+        float t = std::max(0.0f, std::min(1.0f, (r + 0.5f - padding) / span));
+        s->fill_px[r] = over(mix(top, bottom, t), 1.0f, s->background_px);
+    }
+}
+
+int native_spark_init(SparkState* spark, int32_t width, int32_t height, int32_t slots,
+                      const SparkStyle* style) {
+    if (!spark || !style) return -1;
+    if (width < 1 || width > SPARK_MAX_WIDTH || height < 1 || height > SPARK_MAX_HEIGHT) return -1;
+    if (slots < 2 || slots > SPARK_MAX_SLOTS) return -1;
+    if (!(style->line_width > 0.0f) || !(style->padding >= 0.0f)) return -1;
+
+    float padding = std::round(style->padding * 2.0f) * 0.5f;
+    if (2.0f * padding >= std::min(width, height)) return -1;
+
+    spark->width = width;
+    spark->height = height;
+    spark->slots = slots;
+    spark->style = *style;
+    spark->style.padding = padding;
+    spark->step = (width - 2.0f * padding) / (slots - 1);
+
+    derive_colors(spark);
+
+    spark->count = 0;
+    native_spark_invalidate(spark);
+    return 0;
+}
+
+int native_spark_set_colors(SparkState* spark, uint32_t background, uint32_t line,
+                            uint32_t fill_top, uint32_t fill_bottom) {
+    if (!spark) return -1;
+    SparkStyle& style = spark->style;
+    if (style.background == background && style.line == line &&
+        style.fill_top == fill_top && style.fill_bottom == fill_bottom) {
+        return 0;
+    }
+
+    style.background = background;
+    style.line = line;
+    style.fill_top = fill_top;
+    style.fill_bottom = fill_bottom;
+    derive_colors(spark);
+    native_spark_invalidate(spark);
+    return 0;
+}
+
+void native_spark_invalidate(SparkState* spark) {
+    if (!spark) return;
+    spark->last_pixels = nullptr;
+    spark->last_stride = 0;
+}
+
+// Whole-point scroll of a full series: new[i] == old[i + k]
+static int find_scroll(const SparkState* s, const float* values, int32_t count) {
+    if (count != s->slots || s->count != s->slots) return 0;
+    if (s->step != std::floor(s->step)) return 0;
+
+    const int max_scroll = std::min(count - 1, 8);
+    for (int k = 1; k <= max_scroll; k++) {
+        if (memcmp(values, s->values + k, (count - k) * sizeof(float)) == 0) return k;
+    }
+    return 0;
+}
+
+static int spark_render_impl(SparkState* s, const float* input, int32_t count, uint32_t* pixels, int32_t stride) {
+    if (!s || !pixels || stride < s->width || count < 0 || count > s->slots) return -1;
+    if (count > 0 && !input) return -1;
+
+    float values[SPARK_MAX_SLOTS];
+    for (int i = 0; i < count; i++) {
+        float v = input[i];
+        values[i] = std::isfinite(v) ? std::max(0.0f, std::min(1.0f, v)) : 0.0f;
+    }
+
+    const int w = s->width;
+    const int reach = reach_px(s);
+    bool full = pixels != s->last_pixels || stride != s->last_stride;
+    int c0 = 0, c1 = w;       // Repaint range
+    int left_end = 0;         // Extra range [0, left_end) after a scroll
+
+    if (!full) {
+        int scroll = find_scroll(s, values, count);
+        if (scroll > 0) {
+            int dx = static_cast<int>(s->step) * scroll;
+            for (int r = 0; r < s->height; r++) {
+                uint32_t* row = pixels + static_cast<size_t>(r) * stride;
+                memmove(row, row + dx, (w - dx) * sizeof(uint32_t));
+            }
+            left_end = std::min(w, static_cast<int>(std::ceil(slot_x(s, 0))) + reach);
+            c0 = std::max(0, static_cast<int>(std::floor(slot_x(s, count - 1 - scroll))) - reach);
+        } else {
+            int n = std::max(count, s->count);
+            int first = 0;
+            while (first < n && first < count && first < s->count && values[first] == s->values[first]) first++;
+            if (first == n) return 0;
+            int last = n - 1;
+            while (last > first && last < count && last < s->count && values[last] == s->values[last]) last--;
+
+            // Columns beyond the outer points are background in both renders
+            c0 = std::max(0, static_cast<int>(std::floor(slot_x(s, std::max(first - 1, 0)))) - reach);
+            c1 = std::min(w, static_cast<int>(std::ceil(slot_x(s, std::min(last + 1, n - 1)))) + reach);
+        }
+    }
+
+    memcpy(s->values, values, count * sizeof(float));
+    s->count = count;
+    s->last_pixels = pixels;
+    s->last_stride = stride;
+
+    if (left_end > c0) {
+        render_columns(s, pixels, stride, 0, c1);
+        return c1;
+    }
+    if (left_end > 0) render_columns(s, pixels, stride, 0, left_end);
+    render_columns(s, pixels, stride, c0, c1);
+    return left_end + (c1 - c0);
+}
+
+int native_spark_render(SparkState* spark, const float* values, int32_t count,
+                        uint32_t* pixels, int32_t stride) {
+    NativeProbeScope probe(PROBE_SPARK_RENDER);
+    return probe.check(spark_render_impl(spark, values, count, pixels, stride));
+}
+
+int native_spark_render_chart(SparkState* spark, int64_t chart_handle,
+                              uint32_t* pixels, int32_t stride) {
+    if (!spark) return -1;
+    float values[SPARK_MAX_SLOTS];
+    int32_t count = native_chart_get_normalized(chart_handle, values, SPARK_MAX_SLOTS);
+    int32_t skip = std::max(0, count - spark->slots);  // Newest points when the chart holds more
+    return native_spark_render(spark, values + skip, count - skip, pixels, stride);
+}
+
+#ifndef SYSMETRICS_NO_JNI
+
+// ============================================================================
+// Handles
+// ============================================================================
+
+struct SparkHandle {
+    std::mutex render_mutex;
+    SparkState state;
+};
+
+static std::shared_mutex g_spark_mutex;
+static std::unordered_map<int64_t, SparkHandle*> g_sparks;
+static int64_t g_next_spark = 1;
+
+// Lock a bitmap that matches the sparkline's size; nullptr otherwise
+static uint32_t* lock_bitmap(JNIEnv* env, jobject bitmap, const SparkState& state, int32_t* stride) {
+    AndroidBitmapInfo info;
+    if (!bitmap || AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) return nullptr;
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+        static_cast<int32_t>(info.width) != state.width || static_cast<int32_t>(info.height) != state.height) {
+        LOGW("Bitmap %ux%u format %d does not match sparkline %dx%d",
+             info.width, info.height, info.format, state.width, state.height);
+        return nullptr;
+    }
+    void* pixels = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) return nullptr;
+    *stride = static_cast<int32_t>(info.stride / sizeof(uint32_t));
+    return static_cast<uint32_t*>(pixels);
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+extern "C" {
+
+/**
+ * Create a sparkline renderer for width x height bitmaps.
+ * Colors are ARGB ints. Returns a handle, or 0 on invalid arguments.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkCreate(
+        JNIEnv* env, jclass clazz, jint width, jint height, jint slots, jint background,
+        jint line, jint fillTop, jint fillBottom, jfloat lineWidth, jfloat padding) {
+    NativeTraceScope trace("NativeAnalytics.sparkCreate", TRACE_CAT_JNI);
+    SparkHandle* handle = new (std::nothrow) SparkHandle();
+    if (!handle) return 0;
+
+    SparkStyle style = {
+        static_cast<uint32_t>(background), static_cast<uint32_t>(line),
+        static_cast<uint32_t>(fillTop), static_cast<uint32_t>(fillBottom), lineWidth, padding
+    };
+    if (native_spark_init(&handle->state, width, height, slots, &style) != 0) {
+        delete handle;
+        return 0;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(g_spark_mutex);
+    int64_t id = g_next_spark++;
+    g_sparks[id] = handle;
+    return id;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkDestroy(
+        JNIEnv* env, jclass clazz, jlong spark) {
+    NativeTraceScope trace("NativeAnalytics.sparkDestroy", TRACE_CAT_JNI);
+    std::unique_lock<std::shared_mutex> lock(g_spark_mutex);
+    auto it = g_sparks.find(spark);
+    if (it == g_sparks.end()) return;
+    delete it->second;
+    g_sparks.erase(it);
+}
+
+/**
+ * Render a ChartBuffer into an ARGB_8888 bitmap of the sparkline's size.
+ * Returns the number of columns repainted, or -1 on error.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkRenderChart(
+        JNIEnv* env, jclass clazz, jlong spark, jlong chart, jobject bitmap) {
+    NativeTraceScope trace("NativeAnalytics.sparkRenderChart", TRACE_CAT_JNI);
+    std::shared_lock<std::shared_mutex> lock(g_spark_mutex);
+    auto it = g_sparks.find(spark);
+    if (it == g_sparks.end()) return -1;
+
+    SparkHandle* handle = it->second;
+    std::lock_guard<std::mutex> render(handle->render_mutex);
+    int32_t stride = 0;
+    uint32_t* pixels = lock_bitmap(env, bitmap, handle->state, &stride);
+    if (!pixels) return -1;
+
+    int result = native_spark_render_chart(&handle->state, chart, pixels, stride);
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return result;
+}
+
+/**
+ * Render the first count normalised values into the bitmap.
+ * Returns the number of columns repainted, or -1 on error.
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkRenderValues(
+        JNIEnv* env, jclass clazz, jlong spark, jfloatArray values, jint count, jobject bitmap) {
+    NativeTraceScope trace("NativeAnalytics.sparkRenderValues", TRACE_CAT_JNI);
+    if (values == nullptr || count < 0 || count > SPARK_MAX_SLOTS || env->GetArrayLength(values) < count) {
+        return -1;
+    }
+    float copy[SPARK_MAX_SLOTS];
+    env->GetFloatArrayRegion(values, 0, count, copy);
+
+    std::shared_lock<std::shared_mutex> lock(g_spark_mutex);
+    auto it = g_sparks.find(spark);
+    if (it == g_sparks.end()) return -1;
+
+    SparkHandle* handle = it->second;
+    std::lock_guard<std::mutex> render(handle->render_mutex);
+    int32_t stride = 0;
+    uint32_t* pixels = lock_bitmap(env, bitmap, handle->state, &stride);
+    if (!pixels) return -1;
+
+    int result = native_spark_render(&handle->state, copy, count, pixels, stride);
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return result;
+}
+
+/**
+ * Repaint everything on the next render (e.g. after the bitmap was drawn over).
+ */
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkInvalidate(
+        JNIEnv* env, jclass clazz, jlong spark) {
+    NativeTraceScope trace("NativeAnalytics.sparkInvalidate", TRACE_CAT_JNI);
+    std::shared_lock<std::shared_mutex> lock(g_spark_mutex);
+    auto it = g_sparks.find(spark);
+    if (it == g_sparks.end()) return;
+    std::lock_guard<std::mutex> render(it->second->render_mutex);
+    native_spark_invalidate(&it->second->state);
+}
+
+/**
+ * Replace the colors (ARGB ints) without reallocating; the next render
+ * repaints everything. Returns false on an unknown handle.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkSetColors(
+        JNIEnv* env, jclass clazz, jlong spark, jint background, jint line, jint fillTop, jint fillBottom) {
+    NativeTraceScope trace("NativeAnalytics.sparkSetColors", TRACE_CAT_JNI);
+    std::shared_lock<std::shared_mutex> lock(g_spark_mutex);
+    auto it = g_sparks.find(spark);
+    if (it == g_sparks.end()) return JNI_FALSE;
+    std::lock_guard<std::mutex> render(it->second->render_mutex);
+    return native_spark_set_colors(&it->second->state, static_cast<uint32_t>(background),
+                                   static_cast<uint32_t>(line), static_cast<uint32_t>(fillTop),
+                                   static_cast<uint32_t>(fillBottom)) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod SPARKLINE_METHODS[] = {
+    NATIVE_METHOD("sparkCreate", "(IIIIIIIFF)J",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkCreate),
+    NATIVE_METHOD("sparkDestroy", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkDestroy),
+    NATIVE_METHOD("sparkRenderChart", "(JJLandroid/graphics/Bitmap;)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkRenderChart),
+    NATIVE_METHOD("sparkRenderValues", "(J[FILandroid/graphics/Bitmap;)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkRenderValues),
+    NATIVE_METHOD("sparkInvalidate", "(J)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkInvalidate),
+    NATIVE_METHOD("sparkSetColors", "(JIIII)Z",
+                  Java_com_sysmetrics_app_native_1bridge_NativeAnalytics_sparkSetColors),
+};
+const NativeMethodList NATIVE_SPARKLINE_JNI = NATIVE_METHOD_LIST(SPARKLINE_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,115 @@
+#ifndef SYSMETRICS_NATIVE_SPARKLINE_H
+#define SYSMETRICS_NATIVE_SPARKLINE_H
+
+#include <stdint.h>
+#include "native_analytics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE SPARKLINE - Line + gradient fill rasteriser into bitmap pixels
+ * ============================================================================
+ *
+ * Renders a series of normalised values (0 = bottom, 1 = top, oldest
+ * first) straight into a caller-owned pixel buffer in Android's ARGB_8888
+ * memory layout: bytes R, G, B, A with premultiplied alpha, i.e. the
+ * layout AndroidBitmap_lockPixels hands out. The overlay and the widget
+ * blit the bitmap instead of tessellating paths every frame.
+ *
+ * Geometry: `slots` points span the area inside `padding`, point i at
+ * slot i, so a growing series extends to the right and a full one scrolls.
+ * The line is a polyline with round joins and caps, anti-aliased by
+ * distance to the nearest segment; the fill runs from the line to the
+ * bottom edge with a vertical gradient from fill_top to fill_bottom.
+ * Padding is rounded to half pixels.
+ *
+ * Every pixel column depends only on the segments within a line width of
+ * it, so a render only repaints the columns whose segments changed since
+ * the previous render into the same buffer. When a full series scrolls by
+ * whole points and the slot pitch is a whole number of pixels, rows are
+ * shifted with memmove and only the new columns on the right plus the
+ * left edge are repainted. Otherwise the columns between the first and
+ * last changed points are repainted. A new buffer or stride repaints
+ * everything. The result is identical to a full render either way.
+ *
+ * Rows are filled with NEON compare/select where available (4 pixels per
+ * instruction); the per-column anti-aliased edge and line pixels are few.
+ */
+
+#define SPARK_MAX_WIDTH 1024
+#define SPARK_MAX_HEIGHT 256
+#define SPARK_MAX_SLOTS MAX_BUFFER_SIZE
+
+typedef struct {
+    uint32_t background;     // Colors as ARGB ints (android.graphics.Color)
+    uint32_t line;
+    uint32_t fill_top;
+    uint32_t fill_bottom;
+    float line_width;        // Pixels
+    float padding;           // Pixels on every side
+} SparkStyle;
+
+typedef struct {
+    int32_t width;
+    int32_t height;
+    int32_t slots;
+    SparkStyle style;
+
+    // Derived from style and size (premultiplied RGBA)
+    uint32_t background_px;
+    uint32_t line_px;
+    float step;                            // Pixels between slots
+    uint32_t fill_px[SPARK_MAX_HEIGHT];    // Gradient row over background
+
+    // Last render, for dirty-column tracking
+    const void* last_pixels;
+    int32_t last_stride;
+    int32_t count;
+    float values[SPARK_MAX_SLOTS];
+    float column_y[SPARK_MAX_WIDTH];       // Line height per column, FLT_MAX without data
+} SparkState;
+
+/**
+ * Set up a sparkline of width x height pixels with `slots` points (>= 2).
+ * @return 0 on success, -1 on invalid sizes or style
+ */
+int native_spark_init(SparkState* spark, int32_t width, int32_t height, int32_t slots,
+                      const SparkStyle* style);
+
+/**
+ * Replace the style colors (ARGB) keeping size, slots and geometry. The
+ * next render repaints everything unless the colors are unchanged.
+ * @return 0 on success, -1 if spark is null
+ */
+int native_spark_set_colors(SparkState* spark, uint32_t background, uint32_t line,
+                            uint32_t fill_top, uint32_t fill_bottom);
+
+/**
+ * Force the next render to repaint everything.
+ */
+void native_spark_invalidate(SparkState* spark);
+
+/**
+ * Render values (count <= slots) into pixels, row stride in pixels.
+ * @return Columns repainted (0 if nothing changed), or -1 on invalid arguments
+ */
+int native_spark_render(SparkState* spark, const float* values, int32_t count,
+                        uint32_t* pixels, int32_t stride);
+
+/**
+ * Render the normalised series of a ChartBuffer handle, as published by
+ * its last add/clear, keeping the newest `slots` points. An unknown handle
+ * renders as an empty chart.
+ * @return As native_spark_render
+ */
+int native_spark_render_chart(SparkState* spark, int64_t chart_handle,
+                              uint32_t* pixels, int32_t stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_SPARKLINE_H
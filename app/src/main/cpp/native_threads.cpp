@@ -0,0 +1,318 @@
+#include "native_threads.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_THREADS"
+#include "native_platform.h"
+
+#define TASK_STAT_BUFFER 1024
+#define TASK_STATUS_BUFFER 4096
+
+// /proc/<pid>/task/<tid>/stat: utime is field 14 and starttime field 22,
+// i.e. 11 and 19 fields after "comm)"
+#define STAT_FIELDS_BEFORE_UTIME 11
+#define STAT_FIELDS_UTIME_TO_STARTTIME 8
+
+struct ThreadSlot {
+    uint64_t start_time;
+    uint64_t cpu_ticks;
+    uint64_t voluntary;
+    uint64_t involuntary;
+    uint32_t generation;
+};
+
+struct ThreadRead {
+    int32_t tid;
+    char name[THREAD_NAME_MAX];
+    uint64_t start_time;
+    uint64_t cpu_ticks;
+    uint64_t voluntary;
+    uint64_t involuntary;
+};
+
+static std::mutex g_threads_mutex;
+static std::unordered_map<int32_t, ThreadSlot> g_thread_slots;
+static std::vector<ThreadStatsNative> g_thread_scratch;
+static int32_t g_tracked_pid = 0;
+static int64_t g_last_sample_ms = 0;
+static uint32_t g_generation = 0;
+
+static long clock_ticks_per_sec() {
+    static const long hz = sysconf(_SC_CLK_TCK);
+    return hz > 0 ? hz : 100;
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static int read_small_file(const char* path, char* buffer, int size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n <= 0) return -1;
+
+    buffer[n] = '\0';
+    return static_cast<int>(n);
+}
+
+static const char* skip_fields(const char* p, int count) {
+    for (int field = 0; field < count; field++) {
+        while (*p == ' ') p++;
+        while (*p && *p != ' ') p++;
+        if (!*p) return nullptr;
+    }
+    while (*p == ' ') p++;
+    return p;
+}
+
+static const char* parse_u64(const char* p, uint64_t* out) {
+    while (*p == ' ' || *p == '\t') p++;
+    const char* start = p;
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+static int read_task_stat(int pid, ThreadRead* thread) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path_task(path, sizeof(path), pid, thread->tid, "stat") < 0) return -1;
+
+    char buffer[TASK_STAT_BUFFER];
+    if (read_small_file(path, buffer, sizeof(buffer)) < 0) return -1;
+
+    // comm may contain spaces and ')', so it spans from the first '(' to the last ')'
+    const char* open_paren = strchr(buffer, '(');
+    const char* close_paren = strrchr(buffer, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren) return -1;
+
+    size_t name_len = static_cast<size_t>(close_paren - open_paren - 1);
+    if (name_len >= THREAD_NAME_MAX) name_len = THREAD_NAME_MAX - 1;
+    for (size_t i = 0; i < name_len; i++) {
+        char c = open_paren[1 + i];
+        thread->name[i] = (c >= 0x20 && c < 0x7f) ? c : '?';  // JNI wants modified UTF-8
+    }
+    thread->name[name_len] = '\0';
+
+    uint64_t utime, stime;
+    const char* p = skip_fields(close_paren + 1, STAT_FIELDS_BEFORE_UTIME);
+    if (!p || !(p = parse_u64(p, &utime)) || !(p = parse_u64(p, &stime))) return -1;
+
+    p = skip_fields(p, STAT_FIELDS_UTIME_TO_STARTTIME - 2);
+    if (!p || !parse_u64(p, &thread->start_time)) return -1;
+
+    thread->cpu_ticks = utime + stime;
+    return 0;
+}
+
+static uint64_t status_value(const char* text, const char* key) {
+    const char* line = strstr(text, key);
+    if (!line) return 0;
+
+    uint64_t value;
+    return parse_u64(line + strlen(key), &value) ? value : 0;
+}
+
+// Context switches are optional: a missing status leaves them at 0
+static void read_task_status(int pid, ThreadRead* thread) {
+    char path[NATIVE_PATH_MAX];
+    char buffer[TASK_STATUS_BUFFER];
+    thread->voluntary = 0;
+    thread->involuntary = 0;
+    if (native_path_task(path, sizeof(path), pid, thread->tid, "status") < 0) return;
+    if (read_small_file(path, buffer, sizeof(buffer)) < 0) return;
+
+    thread->voluntary = status_value(buffer, "\nvoluntary_ctxt_switches:");
+    thread->involuntary = status_value(buffer, "\nnonvoluntary_ctxt_switches:");
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+static bool more_expensive(const ThreadStatsNative& a, const ThreadStatsNative& b) {
+    if (a.cpu_percent != b.cpu_percent) return a.cpu_percent > b.cpu_percent;
+    if (a.cpu_time_ms != b.cpu_time_ms) return a.cpu_time_ms > b.cpu_time_ms;
+    return a.tid < b.tid;
+}
+
+static int threads_sample_impl(int pid, ThreadStatsNative* out, int max_count) {
+    if (!out || max_count < 0) return -1;
+    if (pid <= 0) pid = getpid();
+
+    char path[NATIVE_PATH_MAX];
+    if (native_path_pid(path, sizeof(path), pid, "task") < 0) return -1;
+
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+
+    std::lock_guard<std::mutex> lock(g_threads_mutex);
+    if (pid != g_tracked_pid) {
+        g_thread_slots.clear();
+        g_tracked_pid = pid;
+        g_last_sample_ms = 0;
+    }
+
+    const int64_t now = native_clock_now_ms();
+    const int64_t elapsed_ms = g_last_sample_ms > 0 ? now - g_last_sample_ms : 0;
+    const uint64_t hz = static_cast<uint64_t>(clock_ticks_per_sec());
+    g_last_sample_ms = now;
+    g_generation++;
+
+    g_thread_scratch.clear();
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr &&
+           g_thread_scratch.size() < static_cast<size_t>(THREADS_MAX)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+
+        ThreadRead thread;
+        thread.tid = static_cast<int32_t>(atoi(entry->d_name));
+        if (read_task_stat(pid, &thread) != 0) continue;  // exited while we looked
+        read_task_status(pid, &thread);
+
+        ThreadStatsNative stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.tid = thread.tid;
+        memcpy(stats.name, thread.name, sizeof(stats.name));
+        stats.cpu_time_ms = thread.cpu_ticks * 1000 / hz;
+
+        auto it = g_thread_slots.find(thread.tid);
+        if (it != g_thread_slots.end() && it->second.start_time == thread.start_time &&
+            elapsed_ms > 0 && thread.cpu_ticks >= it->second.cpu_ticks) {
+            const ThreadSlot& prev = it->second;
+            uint64_t delta_ms = (thread.cpu_ticks - prev.cpu_ticks) * 1000 / hz;
+            stats.cpu_percent = static_cast<float>(delta_ms) * 100.0f / static_cast<float>(elapsed_ms);
+            stats.voluntary_switches = static_cast<uint32_t>(
+                thread.voluntary >= prev.voluntary ? thread.voluntary - prev.voluntary : 0);
+            stats.involuntary_switches = static_cast<uint32_t>(
+                thread.involuntary >= prev.involuntary ? thread.involuntary - prev.involuntary : 0);
+            stats.is_valid = 1;
+        }
+
+        ThreadSlot& slot = g_thread_slots[thread.tid];
+        slot.start_time = thread.start_time;
+        slot.cpu_ticks = thread.cpu_ticks;
+        slot.voluntary = thread.voluntary;
+        slot.involuntary = thread.involuntary;
+        slot.generation = g_generation;
+
+        g_thread_scratch.push_back(stats);
+    }
+    closedir(dir);
+
+    // Threads not seen this round have exited
+    for (auto it = g_thread_slots.begin(); it != g_thread_slots.end();) {
+        if (it->second.generation != g_generation) {
+            it = g_thread_slots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    int count = std::min(max_count, static_cast<int>(g_thread_scratch.size()));
+    std::partial_sort(g_thread_scratch.begin(), g_thread_scratch.begin() + count,
+                      g_thread_scratch.end(), more_expensive);
+    memcpy(out, g_thread_scratch.data(), static_cast<size_t>(count) * sizeof(ThreadStatsNative));
+    return count;
+}
+
+int native_threads_sample(int pid, ThreadStatsNative* out, int max_count) {
+    NativeProbeScope probe(PROBE_READ_THREADS);
+    return probe.check(threads_sample_impl(pid, out, max_count));
+}
+
+void native_threads_reset(void) {
+    std::lock_guard<std::mutex> lock(g_threads_mutex);
+    g_thread_slots.clear();
+    g_tracked_pid = 0;
+    g_last_sample_ms = 0;
+}
+
+int native_threads_tracked_count(void) {
+    std::lock_guard<std::mutex> lock(g_threads_mutex);
+    return static_cast<int>(g_thread_slots.size());
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+// Longs per thread written by sampleThreads()
+#define THREAD_FIELDS 6
+
+extern "C" {
+
+/**
+ * Samples this process's threads into out, THREAD_FIELDS longs each:
+ * [tid, cpuCentiPercent, cpuTimeMs, voluntarySwitches, involuntarySwitches, isValid]
+ * @return Thread names in the same order (length = threads written), or null
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_sampleThreads(
+        JNIEnv* env, jclass clazz, jlongArray out) {
+    NativeTraceScope trace("NativeProfiler.sampleThreads", TRACE_CAT_JNI);
+    if (out == nullptr) return nullptr;
+
+    int capacity = std::min(static_cast<int>(env->GetArrayLength(out)) / THREAD_FIELDS, THREADS_MAX);
+    std::vector<ThreadStatsNative> threads(static_cast<size_t>(capacity));
+    int count = native_threads_sample(0, threads.data(), capacity);
+    if (count < 0) return nullptr;
+
+    std::vector<jlong> values(static_cast<size_t>(count) * THREAD_FIELDS);
+    for (int i = 0; i < count; i++) {
+        const ThreadStatsNative& thread = threads[i];
+        jlong* row = values.data() + i * THREAD_FIELDS;
+        row[0] = thread.tid;
+        row[1] = static_cast<jlong>(thread.cpu_percent * 100.0f + 0.5f);
+        row[2] = static_cast<jlong>(thread.cpu_time_ms);
+        row[3] = thread.voluntary_switches;
+        row[4] = thread.involuntary_switches;
+        row[5] = thread.is_valid;
+    }
+    env->SetLongArrayRegion(out, 0, static_cast<jsize>(values.size()), values.data());
+
+    jclass string_class = native_jni_string_class();
+    if (string_class == nullptr) return nullptr;
+
+    jobjectArray names = env->NewObjectArray(count, string_class, nullptr);
+    if (names == nullptr) return nullptr;
+
+    for (int i = 0; i < count; i++) {
+        jstring name = env->NewStringUTF(threads[i].name);
+        env->SetObjectArrayElement(names, i, name);
+        env->DeleteLocalRef(name);
+    }
+    return names;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod THREADS_METHODS[] = {
+    NATIVE_METHOD("sampleThreads", "([J)[Ljava/lang/String;",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_sampleThreads),
+};
+const NativeMethodList NATIVE_THREADS_JNI = NATIVE_METHOD_LIST(THREADS_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,65 @@
+#ifndef SYSMETRICS_NATIVE_THREADS_H
+#define SYSMETRICS_NATIVE_THREADS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE THREADS - Per-thread CPU and scheduling cost of one process
+ * ============================================================================
+ *
+ * Enumerates /proc/<pid>/task/ and reads each thread's stat (name,
+ * utime + stime, starttime) and status (voluntary / nonvoluntary context
+ * switches). Counters are tracked per tid against the previous sample, so
+ * every call reports the interval since the last one:
+ *
+ * - cpu_percent is relative to one core, like top's per-thread view
+ * - a tid whose starttime changed is a new thread, not a continuation
+ * - threads that exited are dropped from tracking
+ *
+ * Results are sorted by cost (CPU over the interval, then total CPU time),
+ * so the first entries answer "which of our threads is expensive".
+ */
+
+#define THREADS_MAX 256
+#define THREAD_NAME_MAX 16
+
+/**
+ * One thread between two samples.
+ */
+typedef struct {
+    int32_t tid;
+    char name[THREAD_NAME_MAX];        // comm, at most 15 chars
+    float cpu_percent;                 // Of one core over the interval
+    uint64_t cpu_time_ms;              // utime + stime since the thread started
+    uint32_t voluntary_switches;       // Blocked (I/O, locks, sleeps) in the interval
+    uint32_t involuntary_switches;     // Preempted in the interval
+    int is_valid;                      // 0 on a thread's first sample
+} ThreadStatsNative;
+
+/**
+ * Sample every thread of pid (0 = this process) and write the most
+ * expensive max_count of them to out, most expensive first.
+ * @return Number of threads written, or -1 if the task directory is unreadable
+ */
+int native_threads_sample(int pid, ThreadStatsNative* out, int max_count);
+
+/**
+ * Forget all per-thread baselines.
+ */
+void native_threads_reset(void);
+
+/**
+ * Number of threads currently tracked.
+ */
+int native_threads_tracked_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_THREADS_H
@@ -0,0 +1,366 @@
+#include "native_trace.h"
+#include "native_instrument.h"
+#include "native_format.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_TRACE"
+#include "native_platform.h"
+
+static_assert((TRACE_RING_CAPACITY & (TRACE_RING_CAPACITY - 1)) == 0,
+              "TRACE_RING_CAPACITY must be a power of two");
+
+#define TRACE_RING_MASK (TRACE_RING_CAPACITY - 1)
+#define TRACE_THREAD_NAME_MAX 16
+#define TRACE_WRITE_CHUNK 16384
+#define TRACE_MAX_EVENT_JSON 512  // Upper bound of one serialized event
+
+// ============================================================================
+// Per-thread Rings
+// ============================================================================
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t start_ns;
+    uint64_t dur_ns;
+};
+
+struct TraceRing {
+    std::atomic<uint64_t> claimed;  // Bumped before a slot is overwritten
+    std::atomic<uint64_t> written;  // Spans ever recorded; slot = index & mask
+    std::atomic<bool> in_use;       // Cleared when the owning thread exits
+    uint64_t flushed;               // First span not yet flushed (g_rings_mutex)
+    int32_t tid;
+    char thread_name[TRACE_THREAD_NAME_MAX];
+    TraceEvent events[TRACE_RING_CAPACITY];
+};
+
+static std::mutex g_rings_mutex;
+static TraceRing* g_rings[TRACE_MAX_THREADS];
+static int g_ring_count = 0;
+
+// Releases the ring for reuse when its thread exits
+struct ThreadRing {
+    TraceRing* ring = nullptr;
+    bool acquired = false;
+
+    ~ThreadRing() {
+        if (ring) ring->in_use.store(false, std::memory_order_release);
+    }
+};
+
+static thread_local ThreadRing t_ring;
+
+static TraceRing* acquire_ring() {
+    std::lock_guard<std::mutex> lock(g_rings_mutex);
+
+    TraceRing* ring = nullptr;
+    if (g_ring_count < TRACE_MAX_THREADS) {
+        ring = new (std::nothrow) TraceRing();
+        if (!ring) return nullptr;
+        g_rings[g_ring_count++] = ring;
+    } else {
+        for (int i = 0; i < g_ring_count; i++) {
+            if (!g_rings[i]->in_use.load(std::memory_order_acquire)) {
+                ring = g_rings[i];
+                // Unflushed spans of the exited thread are dropped
+                ring->flushed = ring->written.load(std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (!ring) {
+            LOGW("All %d trace rings in use, thread not traced", TRACE_MAX_THREADS);
+            return nullptr;
+        }
+    }
+
+    ring->tid = native_thread_id();
+    native_thread_name(ring->thread_name);
+    ring->in_use.store(true, std::memory_order_relaxed);
+    return ring;
+}
+
+void native_trace_set_enabled(bool enabled) {
+    if (enabled) {
+        g_native_instr_flags.fetch_or(INSTR_FLAG_TRACE, std::memory_order_relaxed);
+    } else {
+        g_native_instr_flags.fetch_and(~INSTR_FLAG_TRACE, std::memory_order_relaxed);
+    }
+}
+
+bool native_trace_is_enabled(void) {
+    return (native_instr_flags() & INSTR_FLAG_TRACE) != 0;
+}
+
+void native_trace_record(const char* name, const char* category,
+                         uint64_t start_ns, uint64_t end_ns) {
+    ThreadRing& owner = t_ring;
+    if (!owner.acquired) {
+        owner.ring = acquire_ring();
+        owner.acquired = true;
+    }
+
+    TraceRing* ring = owner.ring;
+    if (!ring || !name) return;
+
+    uint64_t index = ring->written.load(std::memory_order_relaxed);
+    ring->claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceEvent& event = ring->events[index & TRACE_RING_MASK];
+    event.name = name;
+    event.category = category ? category : "";
+    event.start_ns = start_ns;
+    event.dur_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    ring->written.store(index + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// JSON Export
+// ============================================================================
+
+struct JsonFile {
+    int fd;
+    bool ok;
+    char buffer[TRACE_WRITE_CHUNK];
+    FormatWriter writer;
+};
+
+static void json_drain(JsonFile* out) {
+    int32_t len = out->writer.length;
+    ssize_t written = 0;
+    while (out->ok && written < len) {
+        ssize_t n = write(out->fd, out->buffer + written, len - written);
+        if (n <= 0) {
+            out->ok = false;
+            break;
+        }
+        written += n;
+    }
+    native_fmt_init(&out->writer, out->buffer, sizeof(out->buffer));
+}
+
+// Keep room for one more event in the chunk
+static void json_reserve(JsonFile* out) {
+    if (out->writer.length > TRACE_WRITE_CHUNK - TRACE_MAX_EVENT_JSON) {
+        json_drain(out);
+    }
+}
+
+// Nanoseconds as microseconds with three decimals (trace-event "ts" unit)
+static void put_micros(FormatWriter* writer, uint64_t ns) {
+    native_fmt_put_u64(writer, ns / 1000, 1);
+    native_fmt_put_char(writer, '.');
+    native_fmt_put_u64(writer, ns % 1000, 3);
+}
+
+// Thread names come from the kernel; keep them valid inside a JSON string
+static void put_json_safe(FormatWriter* writer, const char* str) {
+    for (; *str; str++) {
+        char c = *str;
+        native_fmt_put_char(writer, (c == '"' || c == '\\' || (unsigned char)c < 0x20) ? '_' : c);
+    }
+}
+
+static void put_thread_name(JsonFile* out, int pid, const TraceRing* ring, bool* first) {
+    json_reserve(out);
+    FormatWriter* w = &out->writer;
+    if (!*first) native_fmt_put_str(w, ",\n");
+    *first = false;
+
+    native_fmt_put_str(w, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":");
+    native_fmt_put_i64(w, pid);
+    native_fmt_put_str(w, ",\"tid\":");
+    native_fmt_put_i64(w, ring->tid);
+    native_fmt_put_str(w, ",\"args\":{\"name\":\"");
+    put_json_safe(w, ring->thread_name);
+    native_fmt_put_str(w, "\"}}");
+}
+
+static void put_span(JsonFile* out, int pid, int tid, const TraceEvent& event, bool* first) {
+    json_reserve(out);
+    FormatWriter* w = &out->writer;
+    if (!*first) native_fmt_put_str(w, ",\n");
+    *first = false;
+
+    native_fmt_put_str(w, "{\"name\":\"");
+    native_fmt_put_str(w, event.name);
+    native_fmt_put_str(w, "\",\"cat\":\"");
+    native_fmt_put_str(w, event.category);
+    native_fmt_put_str(w, "\",\"ph\":\"X\",\"ts\":");
+    put_micros(w, event.start_ns);
+    native_fmt_put_str(w, ",\"dur\":");
+    put_micros(w, event.dur_ns);
+    native_fmt_put_str(w, ",\"pid\":");
+    native_fmt_put_i64(w, pid);
+    native_fmt_put_str(w, ",\"tid\":");
+    native_fmt_put_i64(w, tid);
+    native_fmt_put_char(w, '}');
+}
+
+/**
+ * Copy the unflushed spans of one ring. The owner may keep writing, so
+ * spans whose slot could have been overwritten during the copy are
+ * discarded afterwards (seqlock-style validation against `claimed`).
+ * @return Index of the first valid span in events
+ */
+static size_t snapshot_ring(TraceRing* ring, std::vector<TraceEvent>& events, uint64_t* end) {
+    uint64_t written = ring->written.load(std::memory_order_acquire);
+    uint64_t begin = ring->flushed;
+    if (written > TRACE_RING_CAPACITY && begin < written - TRACE_RING_CAPACITY) {
+        begin = written - TRACE_RING_CAPACITY;
+    }
+
+    events.clear();
+    for (uint64_t i = begin; i < written; i++) {
+        events.push_back(ring->events[i & TRACE_RING_MASK]);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t claimed = ring->claimed.load(std::memory_order_relaxed);
+    uint64_t valid_from = claimed > TRACE_RING_CAPACITY ? claimed - TRACE_RING_CAPACITY : 0;
+
+    *end = written;
+    return valid_from > begin ? static_cast<size_t>(valid_from - begin) : 0;
+}
+
+int native_trace_flush(const char* path) {
+    if (!path) return -1;
+
+    std::lock_guard<std::mutex> lock(g_rings_mutex);
+
+    JsonFile* out = new (std::nothrow) JsonFile();
+    if (!out) return -1;
+
+    out->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out->fd < 0) {
+        LOGE("Failed to open trace file %s", path);
+        delete out;
+        return -1;
+    }
+    out->ok = true;
+    native_fmt_init(&out->writer, out->buffer, sizeof(out->buffer));
+
+    const int pid = static_cast<int>(getpid());
+    native_fmt_put_str(&out->writer, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    bool first = true;
+    int span_count = 0;
+    std::vector<TraceEvent> events;
+    events.reserve(TRACE_RING_CAPACITY);
+
+    for (int r = 0; r < g_ring_count; r++) {
+        TraceRing* ring = g_rings[r];
+        uint64_t end = 0;
+        size_t valid = snapshot_ring(ring, events, &end);
+        ring->flushed = end;
+        if (valid >= events.size()) continue;
+
+        put_thread_name(out, pid, ring, &first);
+        for (size_t i = valid; i < events.size(); i++) {
+            put_span(out, pid, ring->tid, events[i], &first);
+            span_count++;
+        }
+    }
+
+    native_fmt_put_str(&out->writer, "\n]}\n");
+    json_drain(out);
+
+    bool ok = out->ok;
+    if (close(out->fd) != 0) ok = false;
+    delete out;
+
+    if (!ok) {
+        LOGE("Failed to write trace file %s", path);
+        return -1;
+    }
+
+    LOGD("Flushed %d trace spans to %s", span_count, path);
+    return span_count;
+}
+
+int native_trace_pending(void) {
+    std::lock_guard<std::mutex> lock(g_rings_mutex);
+
+    uint64_t pending = 0;
+    for (int r = 0; r < g_ring_count; r++) {
+        uint64_t written = g_rings[r]->written.load(std::memory_order_acquire);
+        uint64_t unflushed = written - g_rings[r]->flushed;
+        pending += unflushed < TRACE_RING_CAPACITY ? unflushed : TRACE_RING_CAPACITY;
+    }
+    return static_cast<int>(pending);
+}
+
+void native_trace_clear(void) {
+    std::lock_guard<std::mutex> lock(g_rings_mutex);
+
+    for (int r = 0; r < g_ring_count; r++) {
+        g_rings[r]->flushed = g_rings[r]->written.load(std::memory_order_acquire);
+    }
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_setTracingEnabled(
+        JNIEnv* env, jclass clazz, jboolean enabled) {
+    native_trace_set_enabled(enabled == JNI_TRUE);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_isTracingEnabled(
+        JNIEnv* env, jclass clazz) {
+    return native_trace_is_enabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeProfiler_flushTrace(
+        JNIEnv* env, jclass clazz, jstring path) {
+    if (path == nullptr) return -1;
+
+    const char* chars = env->GetStringUTFChars(path, nullptr);
+    if (chars == nullptr) return -1;
+
+    int result = native_trace_flush(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    return result;
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+// @CriticalNative entry point
+static jboolean is_tracing_enabled_critical() {
+    return native_trace_is_enabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+static const NativeMethod TRACE_METHODS[] = {
+    NATIVE_METHOD("setTracingEnabled", "(Z)V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_setTracingEnabled),
+    NATIVE_CRITICAL_METHOD("isTracingEnabled", "()Z",
+                           Java_com_sysmetrics_app_native_1bridge_NativeProfiler_isTracingEnabled,
+                           is_tracing_enabled_critical),
+    NATIVE_METHOD("flushTrace", "(Ljava/lang/String;)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeProfiler_flushTrace),
+};
+const NativeMethodList NATIVE_TRACE_JNI = NATIVE_METHOD_LIST(TRACE_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,78 @@
+#ifndef SYSMETRICS_NATIVE_TRACE_H
+#define SYSMETRICS_NATIVE_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE TRACE - Chrome trace-event timelines of native hot paths
+ * ============================================================================
+ *
+ * Optional span recording to see how a JNI tick overlaps with file reads
+ * and stats computation:
+ *
+ * - Complete ("X") spans for every collector, analytics operation and
+ *   JNI entry, timestamped with CLOCK_MONOTONIC
+ * - One fixed-size ring per thread; the owning thread is the only writer,
+ *   so recording takes no lock and never allocates after the first span
+ * - Off by default; when off a span costs a single relaxed atomic load
+ *   (shared with the latency histograms in native_instrument.h)
+ * - Flushed on demand to Chrome trace-event JSON, loadable in Perfetto
+ *   (ui.perfetto.dev) or chrome://tracing
+ *
+ * Spans are recorded through NativeProbeScope / NativeTraceScope.
+ */
+
+#define TRACE_RING_CAPACITY 4096  // Spans per thread, power of two
+#define TRACE_MAX_THREADS 16      // Rings of exited threads are reused
+
+// Span categories ("cat" in the JSON)
+#define TRACE_CAT_COLLECTOR "collector"
+#define TRACE_CAT_ANALYTICS "analytics"
+#define TRACE_CAT_JNI       "jni"
+
+/**
+ * Start or stop recording spans. Already recorded spans are kept.
+ */
+void native_trace_set_enabled(bool enabled);
+
+/**
+ * @return true while spans are being recorded
+ */
+bool native_trace_is_enabled(void);
+
+/**
+ * Append a span to the calling thread's ring, overwriting the oldest span
+ * when full. name and category must outlive the trace (string literals).
+ */
+void native_trace_record(const char* name, const char* category,
+                         uint64_t start_ns, uint64_t end_ns);
+
+/**
+ * Write all spans recorded since the previous flush to path as Chrome
+ * trace-event JSON and drop them from the rings. Safe to call while other
+ * threads keep recording.
+ * @return Number of spans written, or -1 if the file cannot be written
+ */
+int native_trace_flush(const char* path);
+
+/**
+ * Number of spans recorded and not yet flushed (capped per ring).
+ */
+int native_trace_pending(void);
+
+/**
+ * Drop all recorded spans without writing them.
+ */
+void native_trace_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_TRACE_H
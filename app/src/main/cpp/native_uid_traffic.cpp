@@ -0,0 +1,314 @@
+#include "native_uid_traffic.h"
+#include "native_paths.h"
+#include "native_instrument.h"
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SYSMETRICS_NO_JNI
+#include "native_jni.h"
+#endif
+
+#define LOG_TAG "NATIVE_UID_TRAFFIC"
+#include "native_platform.h"
+
+#define QTAGUID_CHUNK_SIZE 4096
+#define UID_EMPTY (-1)
+
+// Stop inserting at 3/4 load so probe sequences stay short
+#define UID_TABLE_MAX_LOAD (UID_TABLE_CAPACITY / 4 * 3)
+
+static_assert((UID_TABLE_CAPACITY & (UID_TABLE_CAPACITY - 1)) == 0,
+              "UID_TABLE_CAPACITY must be a power of two");
+
+struct UidEntry {
+    int32_t uid;           // UID_EMPTY for a free slot
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t session_rx;   // Totals when the UID was first seen
+    uint64_t session_tx;
+};
+
+struct UidTable {
+    UidEntry slots[UID_TABLE_CAPACITY];
+    int count;
+};
+
+// Current and previous sample; swapped after each successful read
+static std::mutex g_uid_mutex;
+static UidTable g_uid_tables[2];
+static int g_uid_current = 0;
+static bool g_uid_primed = false;
+static int64_t g_uid_previous_ms = 0;
+
+// ============================================================================
+// Open-Addressing Table
+// ============================================================================
+
+static inline uint32_t uid_slot(int32_t uid) {
+    return (static_cast<uint32_t>(uid) * 2654435761u) & (UID_TABLE_CAPACITY - 1);
+}
+
+static void table_clear(UidTable* table) {
+    for (UidEntry& entry : table->slots) entry.uid = UID_EMPTY;
+    table->count = 0;
+}
+
+static const UidEntry* table_find(const UidTable* table, int32_t uid) {
+    for (uint32_t i = uid_slot(uid), probes = 0; probes < UID_TABLE_CAPACITY;
+         i = (i + 1) & (UID_TABLE_CAPACITY - 1), probes++) {
+        const UidEntry& entry = table->slots[i];
+        if (entry.uid == uid) return &entry;
+        if (entry.uid == UID_EMPTY) return nullptr;
+    }
+    return nullptr;
+}
+
+// nullptr when the table is at its load limit and uid is new
+static UidEntry* table_upsert(UidTable* table, int32_t uid) {
+    for (uint32_t i = uid_slot(uid);; i = (i + 1) & (UID_TABLE_CAPACITY - 1)) {
+        UidEntry& entry = table->slots[i];
+        if (entry.uid == uid) return &entry;
+        if (entry.uid == UID_EMPTY) {
+            if (table->count >= UID_TABLE_MAX_LOAD) return nullptr;
+            entry.uid = uid;
+            entry.rx_bytes = 0;
+            entry.tx_bytes = 0;
+            table->count++;
+            return &entry;
+        }
+    }
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+static const char* next_field(const char* p, const char* end) {
+    while (p < end && *p != ' ') p++;
+    while (p < end && *p == ' ') p++;
+    return p;
+}
+
+static const char* parse_u64(const char* p, const char* end, uint64_t* out) {
+    const char* start = p;
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        p++;
+    }
+    *out = value;
+    return p == start ? nullptr : p;
+}
+
+// "idx iface acct_tag_hex uid_tag_int cnt_set rx_bytes rx_packets tx_bytes ..."
+static void parse_line(const char* p, const char* end, UidTable* table) {
+    while (p < end && *p == ' ') p++;
+    if (p >= end || *p < '0' || *p > '9') return;  // header or blank
+
+    p = next_field(p, end);                   // iface
+    const char* tag = next_field(p, end);     // acct_tag_hex
+    if (end - tag < 4 || memcmp(tag, "0x0 ", 4) != 0) return;  // tagged breakdown
+
+    uint64_t uid, cnt_set, rx, rx_packets, tx;
+    p = next_field(tag, end);
+    if (!(p = parse_u64(p, end, &uid))) return;
+    if (!(p = parse_u64(next_field(p, end), end, &cnt_set))) return;
+    if (!(p = parse_u64(next_field(p, end), end, &rx))) return;
+    if (!(p = parse_u64(next_field(p, end), end, &rx_packets))) return;
+    if (!parse_u64(next_field(p, end), end, &tx)) return;
+
+    // Foreground and background counter sets both count
+    UidEntry* entry = table_upsert(table, static_cast<int32_t>(uid));
+    if (!entry) return;
+    entry->rx_bytes += rx;
+    entry->tx_bytes += tx;
+}
+
+static int read_qtaguid(UidTable* table) {
+    char path[NATIVE_PATH_MAX];
+    if (native_path(path, sizeof(path), PROC_XT_QTAGUID) < 0) return -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char buffer[QTAGUID_CHUNK_SIZE];
+    size_t carry = 0;
+    bool read_any = false;
+    ssize_t n;
+    while ((n = read(fd, buffer + carry, sizeof(buffer) - carry)) > 0) {
+        read_any = true;
+        const char* data_end = buffer + carry + n;
+        const char* line = buffer;
+        const char* eol;
+        while ((eol = static_cast<const char*>(memchr(line, '\n', data_end - line))) != nullptr) {
+            parse_line(line, eol, table);
+            line = eol + 1;
+        }
+
+        carry = static_cast<size_t>(data_end - line);
+        if (carry == sizeof(buffer)) {
+            carry = 0;  // a single line longer than the buffer: drop it
+        } else if (carry > 0) {
+            memmove(buffer, line, carry);
+        }
+    }
+    close(fd);
+
+    if (n < 0 || !read_any) return -1;
+    if (carry > 0) parse_line(buffer, buffer + carry, table);
+    return 0;
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+struct UidRate {
+    const UidEntry* entry;
+    uint64_t rx_per_sec;
+    uint64_t tx_per_sec;
+};
+
+// Keep the top_n busiest in descending order; top_n is at most UID_TOP_MAX
+static void insert_top(UidRate* top, int* count, int top_n, const UidRate& rate) {
+    uint64_t total = rate.rx_per_sec + rate.tx_per_sec;
+    int pos = *count;
+    while (pos > 0 && top[pos - 1].rx_per_sec + top[pos - 1].tx_per_sec < total) pos--;
+    if (pos >= top_n) return;
+
+    int last = *count < top_n ? *count : top_n - 1;
+    for (int i = last; i > pos; i--) top[i] = top[i - 1];
+    top[pos] = rate;
+    if (*count < top_n) (*count)++;
+}
+
+static uint64_t per_second(uint64_t current, uint64_t previous, int64_t elapsed_ms) {
+    if (current < previous) return 0;  // counters reset (iface down, reboot)
+    return (current - previous) * 1000 / static_cast<uint64_t>(elapsed_ms);
+}
+
+static int uid_traffic_sample_impl(int64_t* out, int top_n) {
+    if (!out || top_n <= 0) return -1;
+    if (top_n > UID_TOP_MAX) top_n = UID_TOP_MAX;
+
+    std::lock_guard<std::mutex> lock(g_uid_mutex);
+    UidTable* previous = &g_uid_tables[g_uid_current];
+    UidTable* current = &g_uid_tables[g_uid_current ^ 1];
+    table_clear(current);
+    if (read_qtaguid(current) != 0) return -1;
+
+    const int64_t now = native_clock_now_ms();
+    const int64_t elapsed_ms = now - g_uid_previous_ms;
+    const bool has_interval = g_uid_primed && elapsed_ms > 0;
+
+    UidRate top[UID_TOP_MAX];
+    int top_count = 0;
+    for (UidEntry& entry : current->slots) {
+        if (entry.uid == UID_EMPTY) continue;
+
+        const UidEntry* prev = g_uid_primed ? table_find(previous, entry.uid) : nullptr;
+        if (prev && entry.rx_bytes >= prev->session_rx && entry.tx_bytes >= prev->session_tx) {
+            entry.session_rx = prev->session_rx;
+            entry.session_tx = prev->session_tx;
+        } else {
+            entry.session_rx = entry.rx_bytes;
+            entry.session_tx = entry.tx_bytes;
+        }
+
+        if (!has_interval || !prev) continue;
+        UidRate rate = { &entry, per_second(entry.rx_bytes, prev->rx_bytes, elapsed_ms),
+                         per_second(entry.tx_bytes, prev->tx_bytes, elapsed_ms) };
+        if (rate.rx_per_sec + rate.tx_per_sec > 0) insert_top(top, &top_count, top_n, rate);
+    }
+
+    for (int i = 0; i < top_count; i++) {
+        const UidEntry& entry = *top[i].entry;
+        int64_t* row = out + i * UID_TRAFFIC_FIELDS;
+        row[0] = entry.uid;
+        row[1] = static_cast<int64_t>(top[i].rx_per_sec);
+        row[2] = static_cast<int64_t>(top[i].tx_per_sec);
+        row[3] = static_cast<int64_t>(entry.rx_bytes);
+        row[4] = static_cast<int64_t>(entry.tx_bytes);
+        row[5] = static_cast<int64_t>(entry.rx_bytes - entry.session_rx);
+        row[6] = static_cast<int64_t>(entry.tx_bytes - entry.session_tx);
+    }
+
+    g_uid_current ^= 1;
+    g_uid_primed = true;
+    g_uid_previous_ms = now;
+    return top_count;
+}
+
+int native_uid_traffic_sample(int64_t* out, int top_n) {
+    NativeProbeScope probe(PROBE_READ_UID_TRAFFIC);
+    return probe.check(uid_traffic_sample_impl(out, top_n));
+}
+
+int native_uid_traffic_uid_count(void) {
+    std::lock_guard<std::mutex> lock(g_uid_mutex);
+    return g_uid_primed ? g_uid_tables[g_uid_current].count : 0;
+}
+
+void native_uid_traffic_reset(void) {
+    std::lock_guard<std::mutex> lock(g_uid_mutex);
+    table_clear(&g_uid_tables[0]);
+    table_clear(&g_uid_tables[1]);
+    g_uid_primed = false;
+    g_uid_previous_ms = 0;
+}
+
+// ============================================================================
+// JNI Functions
+// ============================================================================
+
+#ifndef SYSMETRICS_NO_JNI
+
+extern "C" {
+
+/**
+ * Fills out with UID_TRAFFIC_FIELDS longs per UID, busiest first:
+ * [uid, rxBytesPerSec, txBytesPerSec, totalRx, totalTx, sessionRx, sessionTx]
+ * @return Number of UIDs written, or -1 if xt_qtaguid is unavailable
+ */
+JNIEXPORT jint JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeSampleUidTraffic(
+        JNIEnv* env, jobject thiz, jlongArray out, jint topN) {
+    NativeTraceScope trace("NativeNetworkMetrics.sampleUidTraffic", TRACE_CAT_JNI);
+    if (out == nullptr) return -1;
+
+    int capacity = static_cast<int>(env->GetArrayLength(out)) / UID_TRAFFIC_FIELDS;
+    if (topN > capacity) topN = capacity;
+    if (topN > UID_TOP_MAX) topN = UID_TOP_MAX;
+
+    int64_t values[UID_TOP_MAX * UID_TRAFFIC_FIELDS];
+    int count = native_uid_traffic_sample(values, topN);
+    if (count > 0) {
+        env->SetLongArrayRegion(out, 0, count * UID_TRAFFIC_FIELDS,
+                                reinterpret_cast<const jlong*>(values));
+    }
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeResetUidTraffic(
+        JNIEnv* env, jobject thiz) {
+    native_uid_traffic_reset();
+}
+
+} // extern "C"
+
+// ============================================================================
+// Registration (see native_jni.h)
+// ============================================================================
+
+static const NativeMethod UID_TRAFFIC_METHODS[] = {
+    NATIVE_METHOD("nativeSampleUidTraffic", "([JI)I",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeSampleUidTraffic),
+    NATIVE_METHOD("nativeResetUidTraffic", "()V",
+                  Java_com_sysmetrics_app_native_1bridge_NativeNetworkMetrics_nativeResetUidTraffic),
+};
+const NativeMethodList NATIVE_UID_TRAFFIC_JNI = NATIVE_METHOD_LIST(UID_TRAFFIC_METHODS);
+
+#endif // SYSMETRICS_NO_JNI
@@ -0,0 +1,60 @@
+#ifndef SYSMETRICS_NATIVE_UID_TRAFFIC_H
+#define SYSMETRICS_NATIVE_UID_TRAFFIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ============================================================================
+ * NATIVE UID TRAFFIC - Per-UID bytes from /proc/net/xt_qtaguid/stats
+ * ============================================================================
+ *
+ *     idx iface acct_tag_hex uid_tag_int cnt_set rx_bytes rx_packets tx_bytes ...
+ *     2 wlan0 0x0 10057 0 1048576 900 65536 300 ...
+ *
+ * The file has one line per (iface, tag, uid, counter set) and runs to
+ * thousands of lines on a busy box. It is streamed through a fixed buffer
+ * and summed per UID into an open-addressing table; only untagged lines
+ * (acct_tag 0x0) are counted, since tagged lines are a breakdown of the
+ * same bytes.
+ *
+ * Each sample is diffed against the previous one in a second table, and
+ * the top-N UIDs by rx + tx rate come back as a packed array. UIDs that
+ * vanished from the file are dropped; session bytes count from the first
+ * sample that saw the UID (or the last reset).
+ */
+
+#define UID_TABLE_CAPACITY 1024   // Power of two
+#define UID_TOP_MAX 32
+
+// Packed layout, UID_TRAFFIC_FIELDS values per UID:
+// [uid, rx_bytes_per_sec, tx_bytes_per_sec, total_rx_bytes, total_tx_bytes,
+//  session_rx_bytes, session_tx_bytes]
+#define UID_TRAFFIC_FIELDS 7
+
+/**
+ * Read xt_qtaguid, diff against the previous sample and write the top_n
+ * UIDs with traffic, busiest first.
+ * @return Number of UIDs written (0 on the first sample), or -1 if the
+ *         file is unreadable (kernels without xt_qtaguid)
+ */
+int native_uid_traffic_sample(int64_t* out, int top_n);
+
+/**
+ * Number of UIDs in the last sample.
+ */
+int native_uid_traffic_uid_count(void);
+
+/**
+ * Forget the previous sample and session baselines.
+ */
+void native_uid_traffic_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSMETRICS_NATIVE_UID_TRAFFIC_H
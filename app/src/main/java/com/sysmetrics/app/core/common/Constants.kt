@@ -129,4 +129,37 @@ object Constants {
         const val VERY_SLOW = 5000L
         const val CHECK_INTERVAL_MS = 10_000L
     }
+
+    /**
+     * Session recording (native_session.h), toggled from Settings. The log is
+     * truncated each time recording starts.
+     */
+    object SessionRecording {
+        const val PREF_KEY = "record_session"
+        const val FILE_NAME = "session.smsr"
+    }
+
+    /**
+     * Overlay change-driven publishing: dead-bands below which a new sample
+     * does not refresh the overlay, and the longest a value may stay stale.
+     */
+    object Publishing {
+        const val MAX_SILENCE_MS = 5_000L
+        const val CPU_DEADBAND_PERCENT = 0.5f
+        const val RAM_DEADBAND_MB = 1f
+        const val NET_DEADBAND_BYTES = 512f
+        const val NET_DEADBAND_RELATIVE = 0.05f
+    }
+
+    /**
+     * Kernel PSI trigger thresholds (microseconds).
+     * Windows are 2s so unprivileged triggers are accepted on newer kernels.
+     */
+    object PressureTriggers {
+        const val WINDOW_US = 2_000_000L
+        const val MEMORY_STALL_US = 300_000L
+        const val CPU_STALL_US = 1_000_000L
+        const val POLL_TIMEOUT_MS = 60_000
+        const val STOP_TIMEOUT_MS = 500L
+    }
 }
@@ -14,7 +14,8 @@ data class TimeWindowStats(
     val max: Float,
     val p95: Float,
     val p99: Float,
-    val timestamp: Long = System.currentTimeMillis()
+    val timestamp: Long = System.currentTimeMillis(),
+    val anomaly: AnomalyScores = AnomalyScores.NONE
 ) {
     companion object {
         fun empty(metricType: MetricType) = TimeWindowStats(
@@ -31,6 +32,23 @@ data class TimeWindowStats(
     }
 }
 
+/**
+ * Online anomaly scores of the newest point (native backend only).
+ * Scores are in standard deviations; flags are NativeAnalytics.ANOMALY_FLAG_*.
+ */
+data class AnomalyScores(
+    val ewma: Float,
+    val robust: Float,
+    val cusum: Float,
+    val flags: Int
+) {
+    val isAnomalous: Boolean get() = flags != 0
+    
+    companion object {
+        val NONE = AnomalyScores(0f, 0f, 0f, 0)
+    }
+}
+
 /**
  * Types of metrics that can be tracked.
  */
@@ -40,6 +58,9 @@ enum class MetricType(val displayName: String, val unit: String) {
     TEMPERATURE("Temperature", "°C"),
     NETWORK_INGRESS("Network ↓", "MB/s"),
     NETWORK_EGRESS("Network ↑", "MB/s"),
+    DISK_READ("Disk read", "MB/s"),
+    DISK_WRITE("Disk write", "MB/s"),
+    DISK_UTILIZATION("Disk busy", "%"),
     FPS("FPS", "fps"),
     BATTERY("Battery", "%")
 }
@@ -3,6 +3,7 @@ package com.sysmetrics.app.data.source
 import com.sysmetrics.app.core.di.DispatcherProvider
 import com.sysmetrics.app.data.model.GpuInfo
 import com.sysmetrics.app.data.model.GpuVendor
+import com.sysmetrics.app.native_bridge.NativeMetrics
 import kotlinx.coroutines.withContext
 import timber.log.Timber
 import java.io.File
@@ -15,6 +16,10 @@ import java.io.File
  * - Qualcomm Adreno: /sys/class/kgsl/kgsl-3d0/
  * - ARM Mali: /sys/devices/platform/mali/
  * - Generic: /sys/kernel/debug/dri/0/
+ *
+ * When the native library is loaded the nodes are probed once and kept open
+ * by [NativeMetrics.getGpuSampleNative]; the Kotlin readers below are the
+ * fallback without it, or when the native probe finds no GPU node.
  */
 
 class GpuDataSource constructor(
@@ -45,6 +50,7 @@ class GpuDataSource constructor(
     private var cachedGpuInfo: GpuInfo? = null
     private var cacheTimestamp: Long = 0L
     private var detectedVendor: GpuVendor? = null
+    private var nativeGpuMissing = false
 
     /**
      * Reads GPU usage and temperature.
@@ -61,6 +67,18 @@ class GpuDataSource constructor(
         }
         
         try {
+            if (!nativeGpuMissing && NativeMetrics.isNativeAvailable()) {
+                val gpuInfo = readNativeGpu()
+                if (gpuInfo != null) {
+                    cachedGpuInfo = gpuInfo
+                    cacheTimestamp = now
+                    return@withContext gpuInfo
+                }
+                // The native probe knows fewer node layouts than the readers below
+                nativeGpuMissing = true
+                Timber.tag(TAG).i("No GPU node found natively - using Kotlin readers")
+            }
+
             // Detect vendor on first call
             if (detectedVendor == null) {
                 detectedVendor = detectGpuVendor()
@@ -89,6 +107,33 @@ class GpuDataSource constructor(
         }
     }
 
+    /**
+     * Reads GPU metrics through the native sampler.
+     * @return null if the native probe found no GPU node
+     */
+    private fun readNativeGpu(): GpuInfo? {
+        val sample = NativeMetrics.getGpuSampleNative() ?: return null
+
+        val vendor = when (sample.vendor) {
+            NativeMetrics.GPU_VENDOR_ADRENO -> GpuVendor.ADRENO
+            NativeMetrics.GPU_VENDOR_MALI -> GpuVendor.MALI
+            NativeMetrics.GPU_VENDOR_GENERIC -> GpuVendor.GENERIC
+            else -> GpuVendor.UNKNOWN
+        }
+        if (detectedVendor != vendor) {
+            detectedVendor = vendor
+            Timber.tag(TAG).i("Detected GPU vendor (native): ${vendor.displayName}")
+        }
+
+        return GpuInfo(
+            usagePercent = sample.usagePercent,
+            frequencyMhz = sample.frequencyMhz,
+            temperatureCelsius = sample.temperatureCelsius,
+            vendor = vendor,
+            isAvailable = sample.hasUsage
+        )
+    }
+
     /**
      * Detects GPU vendor based on available paths.
      */
@@ -9,6 +9,7 @@ import android.os.Build
 import android.os.Process
 import com.sysmetrics.app.core.di.DispatcherProvider
 import com.sysmetrics.app.data.model.network.PerAppTrafficStats
+import com.sysmetrics.app.native_bridge.NativeNetworkMetrics
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.withContext
@@ -22,8 +23,10 @@ import java.util.concurrent.ConcurrentHashMap
  * Data source for per-application network traffic statistics.
  * 
  * ## Data Sources (in order of preference):
- * 1. /proc/net/xt_qtaguid/stats - Most accurate, requires elevated permissions
- * 2. TrafficStats API - Works on all devices, but limited to UID-level stats
+ * 1. /proc/net/xt_qtaguid/stats via [NativeNetworkMetrics] - parsed, diffed and
+ *    ranked in C++ without per-line allocations
+ * 2. /proc/net/xt_qtaguid/stats parsed in Kotlin, if the native library is missing
+ * 3. TrafficStats API - Works on all devices, but limited to UID-level stats
  * 
  * ## Implementation Notes:
  * - Caches app info (name, icon) to avoid repeated PackageManager queries
@@ -47,6 +50,8 @@ class PerAppTrafficDataSource(
 
     private val packageManager: PackageManager = context.packageManager
 
+    private val nativeMetrics = NativeNetworkMetrics()
+
     // Cache for app info to avoid repeated PM queries
     private val appInfoCache = ConcurrentHashMap<Int, CachedAppInfo>()
 
@@ -92,6 +97,13 @@ class PerAppTrafficDataSource(
      */
     suspend fun getPerAppStats(topN: Int = 5): List<PerAppTrafficStats> = withContext(dispatcherProvider.io) {
         try {
+            nativeMetrics.sampleUidTraffic(topN)?.let { rates ->
+                if (appInfoCache.size > CACHE_CLEANUP_THRESHOLD) {
+                    cleanupCache()
+                }
+                return@withContext rates.map { toPerAppStats(it) }
+            }
+
             val currentSnapshot = readCurrentSnapshot()
             val currentTime = System.currentTimeMillis()
 
@@ -156,6 +168,26 @@ class PerAppTrafficDataSource(
         }
     }
 
+    /**
+     * Maps a native per-UID sample onto app info.
+     */
+    private fun toPerAppStats(rate: NativeNetworkMetrics.UidTrafficRate): PerAppTrafficStats {
+        val appInfo = getAppInfo(rate.uid)
+        return PerAppTrafficStats(
+            uid = rate.uid,
+            packageName = appInfo.packageName,
+            appName = appInfo.appName,
+            appIcon = appInfo.appIcon,
+            ingressBytesPerSec = rate.rxBytesPerSec,
+            egressBytesPerSec = rate.txBytesPerSec,
+            totalIngressBytes = rate.totalRxBytes,
+            totalEgressBytes = rate.totalTxBytes,
+            sessionIngressBytes = rate.sessionRxBytes,
+            sessionEgressBytes = rate.sessionTxBytes,
+            lastActiveTimestamp = System.currentTimeMillis()
+        )
+    }
+
     /**
      * Observes per-app traffic as a Flow.
      *
@@ -210,7 +242,8 @@ class PerAppTrafficDataSource(
 
                     try {
                         val parts = line.split(" ").filter { it.isNotBlank() }
-                        if (parts.size >= 8) {
+                        // Tagged lines (acct_tag != 0x0) break down the untagged totals
+                        if (parts.size >= 8 && parts[2] == "0x0") {
                             val uid = parts[3].toIntOrNull() ?: return@forEachLine
                             val rxBytes = parts[5].toLongOrNull() ?: 0L
                             val txBytes = parts[7].toLongOrNull() ?: 0L
@@ -372,6 +405,7 @@ class PerAppTrafficDataSource(
         previousSnapshot = emptyMap()
         previousTimestamp = 0L
         sessionStartBytes.clear()
+        nativeMetrics.resetUidTraffic()
         Timber.tag(TAG).d("Per-app traffic baseline reset")
     }
 
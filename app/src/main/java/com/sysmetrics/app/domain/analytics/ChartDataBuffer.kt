@@ -5,6 +5,7 @@ import com.sysmetrics.app.data.model.advanced.ChartDataPoint
 import com.sysmetrics.app.data.model.advanced.MetricType
 import com.sysmetrics.app.data.model.advanced.Severity
 import com.sysmetrics.app.native_bridge.NativeAnalytics
+import com.sysmetrics.app.native_bridge.NativeMetrics
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
@@ -33,7 +34,14 @@ class ChartDataBuffer(
     
     private val _chartData = MutableStateFlow(ChartData.empty(metricType))
     val chartData: StateFlow<ChartData> = _chartData.asStateFlow()
-    
+
+    /**
+     * Native ChartBuffer handle for renderers that read it directly
+     * (SparklineBitmap), or 0 on the Kotlin fallback.
+     */
+    val nativeChartHandle: Long
+        get() = if (useNative) nativeHandle else 0L
+
     init {
         useNative = NativeAnalytics.isAvailable()
         if (useNative) {
@@ -89,6 +97,28 @@ class ChartDataBuffer(
         }
     }
     
+    /**
+     * Copy normalized values (0-1 range) into a caller-owned array, e.g. one
+     * kept by the chart view across frames. Native path allocates nothing.
+     * @return Number of values written (at most out.size)
+     */
+    fun getNormalizedValuesInto(out: FloatArray): Int {
+        if (useNative && nativeHandle != 0L) {
+            return NativeAnalytics.chartGetNormalizedInto(nativeHandle, out)
+        }
+        synchronized(lock) {
+            if (buffer.isEmpty()) return 0
+            val min = buffer.minOf { it.value }
+            val max = buffer.maxOf { it.value }
+            val range = (max - min).coerceAtLeast(0.001f)
+            val count = minOf(buffer.size, out.size)
+            for (i in 0 until count) {
+                out[i] = (buffer[i].value - min) / range
+            }
+            return count
+        }
+    }
+    
     fun getPoints(): List<ChartDataPoint> = synchronized(lock) { buffer.toList() }
     
     fun getLatest(): ChartDataPoint? = synchronized(lock) { buffer.lastOrNull() }
@@ -146,6 +176,17 @@ class ChartBufferManager(private val maxHistorySize: Int = 60) {
     fun addDataPoint(metricType: MetricType, value: Float) {
         getBuffer(metricType).add(value)
     }
+
+    /**
+     * Push one diskstats sample (totals) into the disk series.
+     * Baseline samples without rates are skipped.
+     */
+    fun addDiskSample(disk: NativeMetrics.DiskIoData) {
+        if (!disk.total.isValid) return
+        addDataPoint(MetricType.DISK_READ, disk.total.readMbPerSec)
+        addDataPoint(MetricType.DISK_WRITE, disk.total.writeMbPerSec)
+        addDataPoint(MetricType.DISK_UTILIZATION, disk.total.utilizationPercent)
+    }
     
     fun getChartData(metricType: MetricType): ChartData {
         return getBuffer(metricType).chartData.value
@@ -3,15 +3,24 @@ package com.sysmetrics.app.domain.analytics
 import android.os.Handler
 import android.os.Looper
 import android.view.Choreographer
+import com.sysmetrics.app.native_bridge.NativeAnalytics
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
 import timber.log.Timber
+import java.nio.ByteBuffer
+import kotlin.math.roundToInt
 
 /**
  * Real-time FPS monitoring using Choreographer API.
  * Tracks frame rate, detects jank, and provides FPS statistics.
  * 
+ * With the native library, each frame is one store of its vsync timestamp
+ * into a direct batch buffer; the batch is handed to the native frame-time
+ * engine once a second, which keeps the frame-duration histogram and
+ * counts jank in missed vsyncs for the refresh rate. Without it, frames
+ * are counted in Kotlin.
+ * 
  * Must be started on the main thread.
  */
 class FpsMonitor {
@@ -30,46 +39,40 @@ class FpsMonitor {
     val fpsStats: StateFlow<FpsStats> = _fpsStats.asStateFlow()
     
     private var isMonitoring = false
-    private var jankThresholdMs = 16.67f // 60fps threshold
+    private var refreshPeriodMs = 16.67f // 60fps vsync period
     private var fpsThreshold = 30
     
-    private val fpsHistory = mutableListOf<Int>()
+    // Per-second FPS over the last minute
+    private val fpsHistory = ArrayDeque<Int>(MAX_HISTORY_SIZE)
     private var jankFrameCount = 0
+    private var missedVsyncCount = 0
     private var totalFrameCount = 0
     
+    // Native frame-time engine (0 = Kotlin fallback), touched on the main thread only
+    private var nativeHandle = 0L
+    private val frameBatch: ByteBuffer? by lazy {
+        if (NativeAnalytics.isAvailable()) NativeAnalytics.newFrameBatchBuffer(BATCH_CAPACITY) else null
+    }
+    private var batchCount = 0
+    private val statsBuffer: ByteBuffer by lazy { NativeAnalytics.newFrameStatsBuffer() }
+    
     private val frameCallback = object : Choreographer.FrameCallback {
         override fun doFrame(frameTimeNanos: Long) {
             if (!isMonitoring) return
             
-            frameCount++
-            totalFrameCount++
-            
-            // Detect jank (frame took longer than threshold)
-            if (lastFrameTime > 0) {
-                val frameTimeMs = (frameTimeNanos - lastFrameTime) / 1_000_000f
-                if (frameTimeMs > jankThresholdMs * 2) { // Missed frame
-                    jankFrameCount++
-                    Timber.tag(TAG).v("Jank detected: frame took %.2fms", frameTimeMs)
-                }
+            val batch = frameBatch
+            if (nativeHandle != 0L && batch != null) {
+                batch.putLong(batchCount * 8, frameTimeNanos)
+                if (++batchCount == BATCH_CAPACITY) flushBatch()
+            } else {
+                recordFrame(frameTimeNanos)
             }
-            lastFrameTime = frameTimeNanos
             
             val now = System.nanoTime()
             val elapsedNs = now - lastSecondTime
             
             if (elapsedNs >= ONE_SECOND_NS) {
-                val fps = frameCount
-                _currentFps.value = fps
-                
-                // Update history
-                fpsHistory.add(fps)
-                if (fpsHistory.size > MAX_HISTORY_SIZE) {
-                    fpsHistory.removeAt(0)
-                }
-                
-                // Update stats
-                updateStats(fps)
-                
+                if (nativeHandle != 0L) publishNativeStats() else publishStats()
                 frameCount = 0
                 lastSecondTime = now
             }
@@ -82,7 +85,7 @@ class FpsMonitor {
         if (isMonitoring) return
         
         this.fpsThreshold = fpsThreshold
-        this.jankThresholdMs = 1000f / refreshRateHz
+        this.refreshPeriodMs = 1000f / refreshRateHz
         
         mainHandler.post {
             isMonitoring = true
@@ -91,10 +94,12 @@ class FpsMonitor {
             lastFrameTime = 0L
             fpsHistory.clear()
             jankFrameCount = 0
+            missedVsyncCount = 0
             totalFrameCount = 0
+            startNative(refreshRateHz.toFloat())
             
             choreographer.postFrameCallback(frameCallback)
-            Timber.tag(TAG).d("FPS monitoring started (threshold: $fpsThreshold, refresh: ${refreshRateHz}Hz)")
+            Timber.tag(TAG).d("FPS monitoring started (threshold: $fpsThreshold, refresh: ${refreshRateHz}Hz, native: ${nativeHandle != 0L})")
         }
     }
     
@@ -104,46 +109,141 @@ class FpsMonitor {
         mainHandler.post {
             isMonitoring = false
             choreographer.removeFrameCallback(frameCallback)
+            flushBatch()
             Timber.tag(TAG).d("FPS monitoring stopped")
         }
     }
     
-    private fun updateStats(currentFps: Int) {
-        if (fpsHistory.isEmpty()) return
+    /**
+     * Stop and free the native engine; start() creates a new one.
+     */
+    fun release() {
+        stop()
+        mainHandler.post {
+            if (nativeHandle != 0L) {
+                NativeAnalytics.framesDestroy(nativeHandle)
+                nativeHandle = 0L
+            }
+        }
+    }
+    
+    private fun startNative(refreshRateHz: Float) {
+        if (frameBatch == null) return
+        batchCount = 0
+        if (nativeHandle == 0L) {
+            nativeHandle = NativeAnalytics.framesCreate(refreshRateHz, HISTORY_WINDOW_MS)
+        } else {
+            NativeAnalytics.framesReset(nativeHandle)
+            NativeAnalytics.framesSetRefreshRate(nativeHandle, refreshRateHz)
+        }
+    }
+    
+    private fun flushBatch() {
+        val batch = frameBatch
+        if (nativeHandle != 0L && batch != null && batchCount > 0) {
+            NativeAnalytics.framesAdd(nativeHandle, batch, batchCount)
+        }
+        batchCount = 0
+    }
+    
+    // Kotlin fallback: count the frame and its missed vsyncs
+    private fun recordFrame(frameTimeNanos: Long) {
+        frameCount++
+        totalFrameCount++
+        
+        if (lastFrameTime > 0) {
+            val frameTimeMs = (frameTimeNanos - lastFrameTime) / 1_000_000f
+            if (frameTimeMs < FRAME_GAP_MS) {
+                // A frame spanning n vsync periods missed n - 1 of them
+                val missed = (frameTimeMs / refreshPeriodMs).roundToInt() - 1
+                if (missed > 0) {
+                    jankFrameCount++
+                    missedVsyncCount += missed
+                    Timber.tag(TAG).v("Jank detected: frame took %.2fms (%d vsyncs missed)", frameTimeMs, missed)
+                }
+            }
+        }
+        lastFrameTime = frameTimeNanos
+    }
+    
+    private fun addToHistory(fps: Int) {
+        _currentFps.value = fps
+        fpsHistory.addLast(fps)
+        if (fpsHistory.size > MAX_HISTORY_SIZE) {
+            fpsHistory.removeFirst()
+        }
+    }
+    
+    private fun publishStats() {
+        val currentFps = frameCount
+        addToHistory(currentFps)
         
-        val avg = fpsHistory.average().toFloat()
-        val min = fpsHistory.minOrNull() ?: 0
-        val max = fpsHistory.maxOrNull() ?: 0
-        val dropsBelow30 = fpsHistory.count { it < fpsThreshold }
         val jankPercent = if (totalFrameCount > 0) {
             (jankFrameCount.toFloat() / totalFrameCount * 100)
         } else 0f
         
         _fpsStats.value = FpsStats(
             current = currentFps,
-            average = avg,
-            min = min,
-            max = max,
-            frameDrops = dropsBelow30,
+            average = fpsHistory.average().toFloat(),
+            min = fpsHistory.minOrNull() ?: 0,
+            max = fpsHistory.maxOrNull() ?: 0,
+            frameDrops = fpsHistory.count { it < fpsThreshold },
             jankPercent = jankPercent,
-            status = FpsStatus.fromFps(currentFps, fpsThreshold)
+            status = FpsStatus.fromFps(currentFps, fpsThreshold),
+            missedVsyncs = missedVsyncCount
+        )
+    }
+    
+    private fun publishNativeStats() {
+        flushBatch()
+        val buf = statsBuffer
+        if (!NativeAnalytics.framesGetStatsInto(nativeHandle, buf)) return
+        
+        val values = NativeAnalytics.FRAME_OUT_VALUES
+        val currentFps = buf.getFloat(values).roundToInt()
+        addToHistory(currentFps)
+        
+        val frames = buf.getInt(NativeAnalytics.FRAME_OUT_FRAMES)
+        val jankFrames = buf.getInt(NativeAnalytics.FRAME_OUT_JANK_FRAMES)
+        
+        _fpsStats.value = FpsStats(
+            current = currentFps,
+            average = buf.getFloat(values + 4),
+            min = fpsHistory.minOrNull() ?: 0,
+            max = fpsHistory.maxOrNull() ?: 0,
+            frameDrops = fpsHistory.count { it < fpsThreshold },
+            jankPercent = if (frames > 0) jankFrames.toFloat() / frames * 100 else 0f,
+            status = FpsStatus.fromFps(currentFps, fpsThreshold),
+            low1PercentFps = buf.getFloat(values + 8),
+            p50FrameMs = buf.getFloat(values + 12),
+            p90FrameMs = buf.getFloat(values + 16),
+            p99FrameMs = buf.getFloat(values + 20),
+            missedVsyncs = buf.getInt(NativeAnalytics.FRAME_OUT_MISSED_VSYNCS)
         )
     }
     
     fun getStatus(): FpsStatus = FpsStatus.fromFps(_currentFps.value, fpsThreshold)
     
     fun reset() {
-        fpsHistory.clear()
-        jankFrameCount = 0
-        totalFrameCount = 0
-        _fpsStats.value = FpsStats.EMPTY
-        _currentFps.value = 0
+        mainHandler.post {
+            fpsHistory.clear()
+            jankFrameCount = 0
+            missedVsyncCount = 0
+            totalFrameCount = 0
+            batchCount = 0
+            if (nativeHandle != 0L) NativeAnalytics.framesReset(nativeHandle)
+            _fpsStats.value = FpsStats.EMPTY
+            _currentFps.value = 0
+        }
     }
     
     companion object {
         private const val TAG = "FPS_MONITOR"
         private const val ONE_SECOND_NS = 1_000_000_000L
         private const val MAX_HISTORY_SIZE = 60 // 1 minute of data
+        private const val HISTORY_WINDOW_MS = 60_000L
+        private const val BATCH_CAPACITY = 256 // > 1 s of frames at 240 Hz
+        private const val FRAME_GAP_MS = 1000f // Longer gaps are pauses, not jank
     }
 }
 
@@ -154,7 +254,13 @@ data class FpsStats(
     val max: Int,
     val frameDrops: Int,
     val jankPercent: Float,
-    val status: FpsStatus
+    val status: FpsStatus,
+    // Frame-time distribution over the last minute (native engine only)
+    val low1PercentFps: Float = 0f,
+    val p50FrameMs: Float = 0f,
+    val p90FrameMs: Float = 0f,
+    val p99FrameMs: Float = 0f,
+    val missedVsyncs: Int = 0
 ) {
     companion object {
         val EMPTY = FpsStats(0, 0f, 0, 0, 0, 0f, FpsStatus.UNKNOWN)
@@ -0,0 +1,130 @@
+package com.sysmetrics.app.domain.analytics
+
+import com.sysmetrics.app.native_bridge.NativePublisher
+import timber.log.Timber
+import kotlin.math.abs
+
+/**
+ * Change-driven publishing stage for a fixed vector of metrics.
+ *
+ * Each tick the caller submits every metric; only the ones that moved past
+ * their dead-band since they were last published (or have been silent for
+ * maxSilenceMs) are reported. Consumers skip formatting, view updates and
+ * buffer pushes for everything else.
+ *
+ * Uses native C++ backend when available, Kotlin fallback otherwise.
+ */
+class SamplePublisher(
+    private val metricCount: Int,
+    private val maxSilenceMs: Long
+) {
+    // Native handle (0 = use Kotlin fallback)
+    private var nativeHandle: Long = 0L
+    private val packed = FloatArray(metricCount)
+
+    /**
+     * Latest published value of every metric, indexed by metric.
+     */
+    val published = FloatArray(metricCount)
+
+    // Kotlin fallback
+    private val deadbandAbs = FloatArray(metricCount)
+    private val deadbandRel = FloatArray(metricCount)
+    private val lastTime = LongArray(metricCount)
+    private var primed = false
+    private var suppressedTicks = 0L
+    private var submittedTicks = 0L
+
+    init {
+        require(metricCount in 1..MAX_METRICS) { "metricCount must be 1..$MAX_METRICS" }
+        if (NativePublisher.isAvailable()) {
+            nativeHandle = runCatching { NativePublisher.create(metricCount, maxSilenceMs) }.getOrDefault(0L)
+            if (nativeHandle != 0L) {
+                Timber.d("Using native publisher for $metricCount metrics")
+            }
+        }
+    }
+
+    fun setDeadband(index: Int, absolute: Float, relative: Float = 0f) {
+        deadbandAbs[index] = absolute
+        deadbandRel[index] = relative
+        if (nativeHandle != 0L) {
+            NativePublisher.setDeadband(nativeHandle, index, absolute, relative)
+        }
+    }
+
+    /**
+     * Submit one sample vector.
+     * @return Bitmask of published metrics; their values are in [published]
+     */
+    fun submit(values: FloatArray, timestampMs: Long = System.currentTimeMillis()): Int {
+        if (nativeHandle != 0L) {
+            val mask = NativePublisher.submit(nativeHandle, values, timestampMs, packed)
+            if (mask >= 0) {
+                var next = 0
+                for (i in 0 until metricCount) {
+                    if (mask and (1L shl i) != 0L) published[i] = packed[next++]
+                }
+                return mask.toInt()
+            }
+        }
+        return submitFallback(values, timestampMs)
+    }
+
+    private fun submitFallback(values: FloatArray, timestampMs: Long): Int {
+        var mask = 0
+        for (i in 0 until metricCount) {
+            val value = values[i]
+            val last = published[i]
+            val silent = timestampMs - lastTime[i]
+            val changed = when {
+                !primed -> true
+                value.isNaN() || last.isNaN() -> value.isNaN() != last.isNaN()
+                else -> abs(value - last) > maxOf(deadbandAbs[i], deadbandRel[i] * abs(last))
+            }
+            if (changed || silent < 0 || (maxSilenceMs > 0 && silent >= maxSilenceMs)) {
+                mask = mask or (1 shl i)
+                published[i] = value
+                lastTime[i] = timestampMs
+            }
+        }
+        primed = true
+        submittedTicks++
+        if (mask == 0) suppressedTicks++
+        return mask
+    }
+
+    /**
+     * Publish every metric on the next submit.
+     */
+    fun force() {
+        primed = false
+        if (nativeHandle != 0L) {
+            NativePublisher.force(nativeHandle)
+        }
+    }
+
+    /**
+     * Fraction of ticks where nothing was published.
+     */
+    fun getSuppressionRatio(): Float {
+        if (nativeHandle != 0L) {
+            val stats = NativePublisher.getStats(nativeHandle)
+            if (stats != null && stats[0] > 0) return stats[2].toFloat() / stats[0]
+        }
+        return if (submittedTicks > 0) suppressedTicks.toFloat() / submittedTicks else 0f
+    }
+
+    fun destroy() {
+        if (nativeHandle != 0L) {
+            NativePublisher.destroy(nativeHandle)
+            nativeHandle = 0L
+        }
+    }
+
+    companion object {
+        const val MAX_METRICS = 32
+
+        fun isChanged(mask: Int, index: Int): Boolean = mask and (1 shl index) != 0
+    }
+}
@@ -1,9 +1,10 @@
 package com.sysmetrics.app.domain.analytics
 
+import com.sysmetrics.app.data.model.advanced.AnomalyScores
 import com.sysmetrics.app.data.model.advanced.MetricType
 import com.sysmetrics.app.data.model.advanced.TimeWindowStats
 import com.sysmetrics.app.native_bridge.NativeAnalytics
-import com.sysmetrics.app.native_bridge.NativeTimeWindowStats
+import com.sysmetrics.app.native_bridge.NativeMetrics
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
@@ -32,6 +33,9 @@ class TimeWindowAverageCalculator(
     private var nativeHandle: Long = 0L
     private val useNative: Boolean
     
+    // Reused by every native stats read (guarded by lock)
+    private val statsBuffer by lazy { NativeAnalytics.newStatsBuffer() }
+    
     // Kotlin fallback
     private val dataPoints = LinkedList<DataPoint>()
     private val lock = Any()
@@ -76,22 +80,34 @@ class TimeWindowAverageCalculator(
     }
     
     private fun updateStatsFromNative(current: Float, timestamp: Long) {
-        val nativeStats = NativeTimeWindowStats.fromArray(
-            NativeAnalytics.twcGetStats(nativeHandle)
-        )
-        
-        _stats.value = TimeWindowStats(
-            metricType = metricType,
-            current = current,
-            avg30s = nativeStats.avg30s,
-            avg1m = nativeStats.avg1m,
-            avg5m = nativeStats.avg5m,
-            min = nativeStats.min,
-            max = nativeStats.max,
-            p95 = nativeStats.p95,
-            p99 = nativeStats.p99,
-            timestamp = timestamp
-        )
+        synchronized(lock) {
+            val buf = statsBuffer
+            if (!NativeAnalytics.twcGetStatsInto(nativeHandle, buf)) {
+                _stats.value = TimeWindowStats.empty(metricType)
+                return
+            }
+            
+            // Offsets per STATS_OUT_VALUES: current, avg30s, avg1m, avg5m, min, max, p50, p95, p99
+            val base = NativeAnalytics.STATS_OUT_VALUES
+            _stats.value = TimeWindowStats(
+                metricType = metricType,
+                current = current,
+                avg30s = buf.getFloat(base + 4),
+                avg1m = buf.getFloat(base + 8),
+                avg5m = buf.getFloat(base + 12),
+                min = buf.getFloat(base + 16),
+                max = buf.getFloat(base + 20),
+                p95 = buf.getFloat(base + 28),
+                p99 = buf.getFloat(base + 32),
+                timestamp = timestamp,
+                anomaly = AnomalyScores(
+                    ewma = buf.getFloat(NativeAnalytics.STATS_OUT_SCORES),
+                    robust = buf.getFloat(NativeAnalytics.STATS_OUT_SCORES + 4),
+                    cusum = buf.getFloat(NativeAnalytics.STATS_OUT_SCORES + 8),
+                    flags = buf.getInt(NativeAnalytics.STATS_OUT_FLAGS)
+                )
+            )
+        }
     }
     
     private fun updateStats(current: Float, now: Long) {
@@ -203,6 +219,17 @@ class MetricsAverageManager {
     fun addDataPoint(metricType: MetricType, value: Float) {
         getCalculator(metricType).addDataPoint(value)
     }
+
+    /**
+     * Push one diskstats sample (totals) into the disk averages.
+     * Baseline samples without rates are skipped.
+     */
+    fun addDiskSample(disk: NativeMetrics.DiskIoData) {
+        if (!disk.total.isValid) return
+        addDataPoint(MetricType.DISK_READ, disk.total.readMbPerSec)
+        addDataPoint(MetricType.DISK_WRITE, disk.total.writeMbPerSec)
+        addDataPoint(MetricType.DISK_UTILIZATION, disk.total.utilizationPercent)
+    }
     
     fun getStats(metricType: MetricType): TimeWindowStats {
         return getCalculator(metricType).stats.value
@@ -1,5 +1,9 @@
 package com.sysmetrics.app.native_bridge
 
+import android.graphics.Bitmap
+import dalvik.annotation.optimization.FastNative
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import timber.log.Timber
 
 /**
@@ -20,6 +24,52 @@ object NativeAnalytics {
     
     private const val TAG = "NATIVE_ANALYTICS"
     
+    // Direct-buffer layouts of twcGetStatsInto / peakGetDataInto
+    // (STATS_OUT_* / PEAK_OUT_* in native_analytics.h), native byte order
+    const val STATS_OUT_VALUES = 0      // 9 floats: current, avg30s, avg1m, avg5m, min, max, p50, p95, p99
+    const val STATS_OUT_TIMESTAMP = 40  // Long
+    const val STATS_OUT_COUNT = 48      // Long
+    const val STATS_OUT_SCORES = 56     // 3 floats: ewma, robust, cusum
+    const val STATS_OUT_FLAGS = 68      // Int, ANOMALY_FLAG_*
+    const val STATS_OUT_SIZE = 72
+    
+    const val PEAK_OUT_VALUE = 0        // Float
+    const val PEAK_OUT_AVG = 4          // Float
+    const val PEAK_OUT_TIMESTAMP = 8    // Long
+    const val PEAK_OUT_COUNT = 16       // Long
+    const val PEAK_OUT_SIZE = 24
+    
+    // Anomaly detectors (ANOMALY_FLAG_* in native_anomaly.h)
+    const val ANOMALY_FLAG_EWMA = 0x1
+    const val ANOMALY_FLAG_ROBUST = 0x2
+    const val ANOMALY_FLAG_CUSUM = 0x4
+    
+    // Threshold rules (RULE_* in native_rules.h)
+    const val RULE_SOURCE_VALUE = 0
+    const val RULE_SOURCE_AVERAGE = 1
+    const val RULE_SOURCE_PERCENTILE = 2
+    const val RULE_ABOVE = 0
+    const val RULE_BELOW = 1
+    const val RULE_MAX = 64
+    const val RULE_QUEUE_CAPACITY = 256
+    
+    // Row layout of ruleDrainInto, RULE_OUT_FIELDS longs per transition
+    const val RULE_OUT_ID = 0
+    const val RULE_OUT_ACTIVE = 1
+    const val RULE_OUT_VALUE = 2        // Float.fromBits
+    const val RULE_OUT_TIMESTAMP = 3
+    const val RULE_OUT_FIELDS = 4
+    
+    // Frame timing (native_frames.h); framesGetStatsInto layout, native byte order
+    const val FRAME_OUT_TOTAL_FRAMES = 0    // Long
+    const val FRAME_OUT_TOTAL_JANK = 8      // Long
+    const val FRAME_OUT_FRAMES = 16         // Int, frames in the window
+    const val FRAME_OUT_JANK_FRAMES = 20    // Int
+    const val FRAME_OUT_MISSED_VSYNCS = 24  // Int
+    const val FRAME_OUT_VALUES = 28         // 8 floats: fpsCurrent, fpsAverage, fpsLow1Pct, p50, p90, p99, max (ms), refreshHz
+    const val FRAME_OUT_SIZE = 64
+    const val FRAME_RING_CAPACITY = 8192
+    
     @Volatile
     private var isLoaded = false
     
@@ -42,6 +92,30 @@ object NativeAnalytics {
     
     fun isAvailable(): Boolean = isLoaded
     
+    /**
+     * Direct buffer for twcGetStatsInto; allocate once per owner and reuse.
+     */
+    fun newStatsBuffer(): ByteBuffer =
+        ByteBuffer.allocateDirect(STATS_OUT_SIZE).order(ByteOrder.nativeOrder())
+    
+    /**
+     * Direct buffer for peakGetDataInto; allocate once per owner and reuse.
+     */
+    fun newPeakBuffer(): ByteBuffer =
+        ByteBuffer.allocateDirect(PEAK_OUT_SIZE).order(ByteOrder.nativeOrder())
+    
+    /**
+     * Direct buffer for framesGetStatsInto; allocate once per owner and reuse.
+     */
+    fun newFrameStatsBuffer(): ByteBuffer =
+        ByteBuffer.allocateDirect(FRAME_OUT_SIZE).order(ByteOrder.nativeOrder())
+    
+    /**
+     * Direct buffer of capacity vsync timestamps (Long ns) for framesAdd.
+     */
+    fun newFrameBatchBuffer(capacity: Int): ByteBuffer =
+        ByteBuffer.allocateDirect(capacity * 8).order(ByteOrder.nativeOrder())
+    
     // ========================================================================
     // Time Window Calculator
     // ========================================================================
@@ -73,12 +147,86 @@ object NativeAnalytics {
     @JvmStatic
     external fun twcGetStats(handle: Long): FloatArray?
     
+    /**
+     * Write all statistics into a buffer from [newStatsBuffer] (no allocation).
+     * @return false if the handle is unknown or the buffer is not direct/too small
+     */
+    @JvmStatic
+    @FastNative
+    external fun twcGetStatsInto(handle: Long, out: ByteBuffer): Boolean
+    
     /**
      * Clear all data from TimeWindowCalculator.
      */
     @JvmStatic
     external fun twcClear(handle: Long)
     
+    /**
+     * Replace the anomaly detector parameters and restart detection.
+     * Defaults: alpha 0.02, 3 sigma, robust z 3.5, CUSUM slack 1 / threshold 5.
+     * @return false if the handle is unknown or a value is out of range
+     */
+    @JvmStatic
+    external fun twcSetAnomalyParams(
+        handle: Long,
+        ewmaAlpha: Float,
+        ewmaThreshold: Float,
+        robustThreshold: Float,
+        cusumSlack: Float,
+        cusumThreshold: Float
+    ): Boolean
+    
+    // ========================================================================
+    // Threshold Rules
+    // ========================================================================
+    
+    /**
+     * Attach a threshold rule to a TimeWindowCalculator. It is evaluated on
+     * every [twcAddPoint] and removed with the calculator.
+     * @param source RULE_SOURCE_*; percentile and windowMs apply to the windowed sources
+     * @param direction RULE_ABOVE (exit <= enter) or RULE_BELOW (exit >= enter)
+     * @return Rule id, or -1 if the rule is invalid or the table is full
+     */
+    @JvmStatic
+    external fun ruleAdd(
+        handle: Long,
+        source: Int,
+        percentile: Int,
+        windowMs: Long,
+        direction: Int,
+        enter: Float,
+        exit: Float,
+        enterHoldMs: Long,
+        exitHoldMs: Long
+    ): Int
+    
+    /**
+     * Remove a rule. Transitions already queued are still drained.
+     */
+    @JvmStatic
+    external fun ruleRemove(ruleId: Int): Boolean
+    
+    /**
+     * @return 1 if the rule is active, 0 if inactive, -1 if unknown
+     */
+    @JvmStatic
+    @FastNative
+    external fun ruleState(ruleId: Int): Int
+    
+    /**
+     * Move queued transitions into out, oldest first, RULE_OUT_FIELDS longs each.
+     * @return Number of transitions written (at most out.size / RULE_OUT_FIELDS)
+     */
+    @JvmStatic
+    @FastNative
+    external fun ruleDrainInto(out: LongArray): Int
+    
+    /**
+     * Transitions lost because nobody drained the queue in time.
+     */
+    @JvmStatic
+    external fun ruleDroppedCount(): Long
+    
     // ========================================================================
     // Chart Buffer
     // ========================================================================
@@ -110,6 +258,14 @@ object NativeAnalytics {
     @JvmStatic
     external fun chartGetNormalized(handle: Long, maxCount: Int): FloatArray?
     
+    /**
+     * Write normalized values into out (no allocation).
+     * @return Number of values written (at most out.size)
+     */
+    @JvmStatic
+    @FastNative
+    external fun chartGetNormalizedInto(handle: Long, out: FloatArray): Int
+    
     /**
      * Get min/max range of values in buffer.
      * @return FloatArray [min, max]
@@ -117,12 +273,110 @@ object NativeAnalytics {
     @JvmStatic
     external fun chartGetRange(handle: Long): FloatArray?
     
+    /**
+     * Write [min, max] into out[0..1] (no allocation).
+     */
+    @JvmStatic
+    @FastNative
+    external fun chartGetRangeInto(handle: Long, out: FloatArray): Boolean
+    
     /**
      * Clear all data from ChartBuffer.
      */
     @JvmStatic
     external fun chartClear(handle: Long)
-    
+
+    // ========================================================================
+    // Sparkline
+    // ========================================================================
+
+    /**
+     * Create a sparkline renderer for width x height ARGB_8888 bitmaps.
+     * Colors are ARGB ints; slots is the number of points across (>= 2).
+     * @return Handle, or 0 on invalid sizes or style
+     */
+    @JvmStatic
+    external fun sparkCreate(
+        width: Int, height: Int, slots: Int,
+        background: Int, line: Int, fillTop: Int, fillBottom: Int,
+        lineWidth: Float, padding: Float
+    ): Long
+
+    @JvmStatic
+    external fun sparkDestroy(handle: Long)
+
+    /**
+     * Render a ChartBuffer's normalized series into bitmap (same size as the
+     * renderer). Only columns that changed since the last render into the
+     * same bitmap are repainted.
+     * @return Columns repainted (0 if unchanged), or -1 on error
+     */
+    @JvmStatic
+    external fun sparkRenderChart(handle: Long, chartHandle: Long, bitmap: Bitmap): Int
+
+    /**
+     * Render the first count normalized values (0-1, oldest first).
+     * @return As [sparkRenderChart]
+     */
+    @JvmStatic
+    external fun sparkRenderValues(handle: Long, values: FloatArray, count: Int, bitmap: Bitmap): Int
+
+    /**
+     * Repaint everything on the next render, e.g. after the bitmap was
+     * drawn over or erased.
+     */
+    @JvmStatic
+    external fun sparkInvalidate(handle: Long)
+
+    /**
+     * Replace the colors (ARGB ints) without reallocating the renderer; the
+     * next render repaints everything.
+     * @return false on an unknown handle
+     */
+    @JvmStatic
+    external fun sparkSetColors(handle: Long, background: Int, line: Int, fillTop: Int, fillBottom: Int): Boolean
+
+    // ========================================================================
+    // Frame Timing
+    // ========================================================================
+
+    /**
+     * Create a frame-time engine for a display refresh rate.
+     * @param windowMs Statistics window, <= 0 for one minute
+     * @return Handle, or 0 if refreshHz is out of range
+     */
+    @JvmStatic
+    external fun framesCreate(refreshHz: Float, windowMs: Long): Long
+
+    @JvmStatic
+    external fun framesDestroy(handle: Long)
+
+    /**
+     * Ingest the first count vsync timestamps (Long ns) of a buffer from
+     * [newFrameBatchBuffer]. Pauses of a second or more start a new run.
+     * @return Frame durations recorded, or -1 on an unknown handle
+     */
+    @JvmStatic
+    @FastNative
+    external fun framesAdd(handle: Long, batch: ByteBuffer, count: Int): Int
+
+    /**
+     * Change the refresh rate jank is measured against; restarts the window.
+     */
+    @JvmStatic
+    external fun framesSetRefreshRate(handle: Long, refreshHz: Float): Boolean
+
+    /**
+     * Write frame statistics into a buffer from [newFrameStatsBuffer]
+     * (FRAME_OUT_* layout, no allocation).
+     */
+    @JvmStatic
+    @FastNative
+    external fun framesGetStatsInto(handle: Long, out: ByteBuffer): Boolean
+
+    @JvmStatic
+    external fun framesReset(handle: Long)
+
     // ========================================================================
     // Peak Tracker
     // ========================================================================
@@ -154,6 +408,14 @@ object NativeAnalytics {
     @JvmStatic
     external fun peakGetData(handle: Long): FloatArray?
     
+    /**
+     * Write peak data into a buffer from [newPeakBuffer] (no allocation).
+     * Unlike [peakGetData], the timestamp keeps full Long precision.
+     */
+    @JvmStatic
+    @FastNative
+    external fun peakGetDataInto(handle: Long, out: ByteBuffer): Boolean
+    
     /**
      * Reset PeakTracker.
      */
@@ -192,6 +454,21 @@ data class NativeTimeWindowStats(
                 p99 = arr[8]
             )
         }
+        
+        fun fromBuffer(buf: ByteBuffer): NativeTimeWindowStats {
+            val base = NativeAnalytics.STATS_OUT_VALUES
+            return NativeTimeWindowStats(
+                current = buf.getFloat(base),
+                avg30s = buf.getFloat(base + 4),
+                avg1m = buf.getFloat(base + 8),
+                avg5m = buf.getFloat(base + 12),
+                min = buf.getFloat(base + 16),
+                max = buf.getFloat(base + 20),
+                p50 = buf.getFloat(base + 24),
+                p95 = buf.getFloat(base + 28),
+                p99 = buf.getFloat(base + 32)
+            )
+        }
     }
 }
 
@@ -216,5 +493,12 @@ data class NativePeakData(
                 sampleCount = arr[3].toInt()
             )
         }
+        
+        fun fromBuffer(buf: ByteBuffer): NativePeakData = NativePeakData(
+            peakValue = buf.getFloat(NativeAnalytics.PEAK_OUT_VALUE),
+            peakTimestamp = buf.getLong(NativeAnalytics.PEAK_OUT_TIMESTAMP),
+            avgValue = buf.getFloat(NativeAnalytics.PEAK_OUT_AVG),
+            sampleCount = buf.getLong(NativeAnalytics.PEAK_OUT_COUNT).toInt()
+        )
     }
 }
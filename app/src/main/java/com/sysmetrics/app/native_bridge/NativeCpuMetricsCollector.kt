@@ -1,6 +1,7 @@
 package com.sysmetrics.app.native_bridge
 
 import com.sysmetrics.app.domain.collector.ICpuMetricsCollector
+import dalvik.annotation.optimization.FastNative
 import timber.log.Timber
 
 /**
@@ -68,6 +69,6 @@ class NativeCpuMetricsCollector : ICpuMetricsCollector {
     // Native method declarations
     private external fun getCpuUsageNative(): Float
     private external fun resetCpuBaselineNative()
-    private external fun getCpuCoreCountNative(): Int
+    @FastNative private external fun getCpuCoreCountNative(): Int
     private external fun getProcessCpuStats(pid: Int): LongArray?
 }
@@ -0,0 +1,45 @@
+package com.sysmetrics.app.native_bridge
+
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
+
+/**
+ * Registration statistics and call-overhead probes for the native library.
+ *
+ * JNI_OnLoad registers every bridge method with RegisterNatives and fails the
+ * load if a Kotlin external has no native implementation, so once any bridge
+ * class has loaded the library these methods are bound as well. They are
+ * only meaningful after that (see [NativeMetrics.isNativeAvailable]).
+ *
+ * [echo], [fastEcho] and [criticalEcho] do the same work under the regular,
+ * @FastNative and @CriticalNative calling conventions; benchmarks use them to
+ * measure the per-call JNI overhead of each.
+ */
+object NativeJni {
+
+    /**
+     * Time JNI_OnLoad spent caching classes and registering methods.
+     */
+    @JvmStatic
+    external fun registrationTimeNs(): Long
+
+    /**
+     * Number of methods registered across all bridge classes.
+     */
+    @JvmStatic
+    external fun registeredMethodCount(): Int
+
+    @JvmStatic
+    external fun echo(value: Int): Int
+
+    @JvmStatic
+    @FastNative
+    external fun fastEcho(value: Int): Int
+
+    /**
+     * Also used by JNI_OnLoad to confirm @CriticalNative is in effect.
+     */
+    @JvmStatic
+    @CriticalNative
+    external fun criticalEcho(value: Int): Int
+}
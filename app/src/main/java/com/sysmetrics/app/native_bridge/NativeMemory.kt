@@ -0,0 +1,98 @@
+package com.sysmetrics.app.native_bridge
+
+import timber.log.Timber
+
+/**
+ * JNI Bridge for system memory counters (/proc/meminfo, /proc/vmstat, zram).
+ *
+ * Callers register the fields they need once (constants below, matching
+ * MemField in native_memory.h) and read them into a reusable DoubleArray.
+ * meminfo and zram fields are kB; vmstat fields are events per second
+ * since the previous read of the same handle (0 on the first read).
+ */
+object NativeMemory {
+
+    private const val TAG = "NATIVE_MEMORY"
+
+    // /proc/meminfo (kB)
+    const val TOTAL = 0
+    const val FREE = 1
+    const val AVAILABLE = 2
+    const val BUFFERS = 3
+    const val CACHED = 4
+    const val SWAP_CACHED = 5
+    const val ACTIVE = 6
+    const val INACTIVE = 7
+    const val SWAP_TOTAL = 8
+    const val SWAP_FREE = 9
+    const val DIRTY = 10
+    const val WRITEBACK = 11
+    const val ANON_PAGES = 12
+    const val MAPPED = 13
+    const val SHMEM = 14
+    const val SLAB = 15
+    const val SRECLAIMABLE = 16
+    const val SUNRECLAIM = 17
+    const val KERNEL_STACK = 18
+    const val PAGE_TABLES = 19
+    const val CMA_TOTAL = 20
+    const val CMA_FREE = 21
+
+    // /sys/block/zram0/mm_stat (kB)
+    const val ZRAM_ORIG_DATA = 22
+    const val ZRAM_COMPR_DATA = 23
+    const val ZRAM_USED = 24
+
+    // /proc/vmstat (per second)
+    const val VM_PGPGIN = 25
+    const val VM_PGPGOUT = 26
+    const val VM_PSWPIN = 27
+    const val VM_PSWPOUT = 28
+    const val VM_PGFAULT = 29
+    const val VM_PGMAJFAULT = 30
+    const val VM_ALLOCSTALL = 31
+    const val VM_PGSTEAL_KSWAPD = 32
+    const val VM_PGSTEAL_DIRECT = 33
+    const val VM_PGSCAN_KSWAPD = 34
+    const val VM_PGSCAN_DIRECT = 35
+    const val VM_WORKINGSET_REFAULT = 36
+    const val VM_OOM_KILL = 37
+
+    @Volatile
+    private var isLoaded = false
+
+    init {
+        loadLibrary()
+    }
+
+    private fun loadLibrary() {
+        if (isLoaded) return
+
+        try {
+            System.loadLibrary("sysmetrics_native")
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            Timber.tag(TAG).e(e, "Failed to load native memory library")
+            isLoaded = false
+        }
+    }
+
+    fun isAvailable(): Boolean = isLoaded
+
+    /**
+     * Register a field set.
+     * @return Handle, or 0 if a field is unknown or repeated
+     */
+    @JvmStatic
+    external fun register(fields: IntArray): Long
+
+    @JvmStatic
+    external fun unregister(handle: Long)
+
+    /**
+     * Read the registered fields into out, in registration order.
+     * @return Number of values written, or -1 on error
+     */
+    @JvmStatic
+    external fun read(handle: Long, out: DoubleArray): Int
+}
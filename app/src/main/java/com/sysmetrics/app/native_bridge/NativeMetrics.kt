@@ -1,5 +1,6 @@
 package com.sysmetrics.app.native_bridge
 
+import dalvik.annotation.optimization.FastNative
 import timber.log.Timber
 
 /**
@@ -13,6 +14,10 @@ object NativeMetrics {
 
     private var isLoaded = false
 
+    // Output arrays reused by the *Into getters instead of a new array per call
+    private val memoryOut = FloatArray(4)
+    private val processCpuOut = LongArray(3)
+
     init {
         try {
             System.loadLibrary("sysmetrics_native")
@@ -60,16 +65,17 @@ object NativeMetrics {
         if (!isLoaded) return null
 
         return runCatching {
-            val stats = getMemoryStats()
-            if (stats != null && stats.size >= 4) {
-                MemoryData(
-                    totalMb = stats[0],
-                    usedMb = stats[1],
-                    availableMb = stats[2],
-                    usagePercent = stats[3]
-                )
-            } else {
-                null
+            synchronized(memoryOut) {
+                if (getMemoryStatsInto(memoryOut)) {
+                    MemoryData(
+                        totalMb = memoryOut[0],
+                        usedMb = memoryOut[1],
+                        availableMb = memoryOut[2],
+                        usagePercent = memoryOut[3]
+                    )
+                } else {
+                    null
+                }
             }
         }.getOrNull()
     }
@@ -94,19 +100,113 @@ object NativeMetrics {
         if (!isLoaded) return null
 
         return runCatching {
-            val stats = getProcessCpuStats(pid)
-            if (stats != null && stats.size >= 3) {
-                ProcessCpuData(
-                    utime = stats[0],
-                    stime = stats[1],
-                    totalTime = stats[2]
-                )
-            } else {
-                null
+            synchronized(processCpuOut) {
+                if (getProcessCpuStatsInto(pid, processCpuOut)) {
+                    ProcessCpuData(
+                        utime = processCpuOut[0],
+                        stime = processCpuOut[1],
+                        totalTime = processCpuOut[2]
+                    )
+                } else {
+                    null
+                }
             }
         }.getOrNull()
     }
 
+    /**
+     * Read memory of many processes in one native call.
+     * RSS comes from /proc/<pid>/statm on every call; PSS/USS/swap from
+     * smaps_rollup, refreshed per process at most every detail interval.
+     * @return Entries keyed by pid; unreadable processes are omitted
+     */
+    fun getProcessMemoryNative(pids: IntArray): Map<Int, ProcessMemoryData> {
+        if (!isLoaded || pids.isEmpty()) return emptyMap()
+
+        return runCatching {
+            val packed = getProcessMemoryBatch(pids) ?: return@runCatching emptyMap()
+            val result = HashMap<Int, ProcessMemoryData>(pids.size)
+            var base = 0
+            while (base + PROCESS_MEMORY_FIELDS <= packed.size) {
+                if (packed[base + 1] == 0L) {
+                    val pid = packed[base].toInt()
+                    result[pid] = ProcessMemoryData(
+                        pid = pid,
+                        rssKb = packed[base + 2],
+                        sharedKb = packed[base + 3],
+                        pssKb = packed[base + 4],
+                        ussKb = packed[base + 5],
+                        swapKb = packed[base + 6],
+                        swapPssKb = packed[base + 7],
+                        detailTimestampMs = packed[base + 8]
+                    )
+                }
+                base += PROCESS_MEMORY_FIELDS
+            }
+            result
+        }.getOrDefault(emptyMap())
+    }
+
+    /**
+     * Best RAM estimate (PSS, else RSS) of each pid into ramKbOut, row for
+     * row, without building per-process objects. Unreadable pids get -1.
+     * @return false if the native batch read is unavailable
+     */
+    fun getProcessRamKbInto(pids: IntArray, ramKbOut: LongArray): Boolean {
+        if (!isLoaded || pids.isEmpty() || ramKbOut.size < pids.size) return false
+
+        return runCatching {
+            val packed = getProcessMemoryBatch(pids) ?: return@runCatching false
+            for (row in pids.indices) {
+                val base = row * PROCESS_MEMORY_FIELDS
+                ramKbOut[row] = when {
+                    base + PROCESS_MEMORY_FIELDS > packed.size || packed[base + 1] != 0L -> -1L
+                    packed[base + 4] >= 0 -> packed[base + 4]
+                    else -> packed[base + 2]
+                }
+            }
+            true
+        }.getOrDefault(false)
+    }
+
+    /**
+     * Rank a packed process table natively: row i is (cpuPercent[i], ramKb[i])
+     * for the first count rows. A bounded heap keeps the best topN rows, so
+     * only their indices come back (best first, ties in table order).
+     * A row qualifies when its CPU is above minCpuPercent or its RAM above
+     * minRamMb; the combined key is cpu * cpuWeight + ramMb / ramMbDivisor.
+     * @param sortKey RANK_BY_CPU, RANK_BY_RAM or RANK_BY_COMBINED
+     * @return Number of indices written to out, or -1 if unavailable
+     */
+    fun rankProcessesNative(
+        cpuPercent: FloatArray,
+        ramKb: LongArray,
+        count: Int,
+        sortKey: Int,
+        topN: Int,
+        minCpuPercent: Float,
+        minRamMb: Long,
+        cpuWeight: Float,
+        ramMbDivisor: Float,
+        out: IntArray
+    ): Int {
+        if (!isLoaded) return -1
+        return runCatching {
+            rankProcesses(cpuPercent, ramKb, count, sortKey, topN, minCpuPercent, minRamMb,
+                cpuWeight, ramMbDivisor, out)
+        }.getOrDefault(-1)
+    }
+
+    /**
+     * How often PSS/USS/swap are re-read per process (smaps_rollup is
+     * expensive for the kernel). Default 5000 ms.
+     */
+    fun setProcessMemoryDetailIntervalNative(intervalMs: Long) {
+        if (isLoaded) {
+            runCatching { setProcessMemoryDetailInterval(intervalMs) }
+        }
+    }
+
     /**
      * Get CPU core count using native code.
      * @return number of CPU cores, or -1 if unavailable
@@ -164,18 +264,159 @@ object NativeMetrics {
         }
     }
 
+    /**
+     * Sample block-device I/O from /proc/diskstats.
+     * Rates are deltas against the previous call, so the first call after
+     * startup (or after a device appears) reports isValid = false.
+     * @return Totals plus one entry per whole physical device, or null
+     */
+    fun getDiskIoNative(): DiskIoData? {
+        if (!isLoaded) return null
+
+        return runCatching {
+            val packed = getDiskStats() ?: return@runCatching null
+            if (packed.size < DISK_RATE_FIELDS) return@runCatching null
+            val names = getDiskNames() ?: emptyArray()
+
+            val devices = ArrayList<DiskDeviceRate>(names.size)
+            var base = DISK_RATE_FIELDS
+            var index = 0
+            while (base + DISK_RATE_FIELDS <= packed.size && index < names.size) {
+                devices.add(DiskDeviceRate.fromPacked(names[index], packed, base))
+                base += DISK_RATE_FIELDS
+                index++
+            }
+            DiskIoData(total = DiskDeviceRate.fromPacked("total", packed, 0), devices = devices)
+        }.getOrNull()
+    }
+
+    /**
+     * Drop the per-device diskstats baselines.
+     */
+    fun resetDiskBaselineNative() {
+        if (isLoaded) {
+            runCatching { resetDiskBaseline() }
+        }
+    }
+
+    /**
+     * Sample every cpufreq policy (CPU cluster). avgKhz is weighted by
+     * time_in_state residency since the previous call, so it reflects the
+     * whole interval rather than the instant of the read.
+     * @return One entry per policy, empty without cpufreq, or null on error
+     */
+    fun getCpuFrequenciesNative(): List<CpuFreqPolicyData>? {
+        if (!isLoaded) return null
+
+        return runCatching {
+            val packed = getCpuFrequencies() ?: return@runCatching null
+            if (packed.isEmpty()) return@runCatching null
+
+            val count = packed[0]
+            val policies = ArrayList<CpuFreqPolicyData>(count)
+            var base = 1
+            while (policies.size < count && base + CPUFREQ_FIELDS <= packed.size) {
+                policies.add(CpuFreqPolicyData.fromPacked(packed, base))
+                base += CPUFREQ_FIELDS
+            }
+            policies
+        }.getOrNull()
+    }
+
+    /**
+     * Sample GPU load, clock and temperature. The vendor is probed once and
+     * its sysfs nodes stay open; Adreno load is the gpubusy delta since the
+     * previous call.
+     * @return GpuData, or null if no supported GPU node exists
+     */
+    fun getGpuSampleNative(): GpuData? {
+        if (!isLoaded) return null
+
+        return runCatching {
+            val packed = getGpuSample() ?: return@runCatching null
+            if (packed.size < GPU_FIELDS) return@runCatching null
+            GpuData.fromPacked(packed)
+        }.getOrNull()
+    }
+
+    /**
+     * Redirect native proc/sys reads to a recorded or fake tree.
+     * @param root Directory standing in for "/", or "" for the live system
+     * @return true if the root was applied
+     */
+    fun setProcRootNative(root: String): Boolean {
+        return if (isLoaded) {
+            runCatching { setProcRoot(root) }.getOrDefault(false)
+        } else {
+            false
+        }
+    }
+
+    /**
+     * Snapshot the proc/sys files the native collectors read into
+     * `<dir>/<index>/` so a field issue can be replayed on a Linux host.
+     * @return Number of files recorded, or -1 on error
+     */
+    fun recordSnapshotNative(dir: String, index: Int): Int {
+        return if (isLoaded) {
+            runCatching { recordSnapshot(dir, index) }.getOrDefault(-1)
+        } else {
+            -1
+        }
+    }
+
     // Native method declarations
     private external fun getCpuUsage(): Float
     private external fun resetCpuBaseline()
     private external fun getMemoryStats(): FloatArray?
+    private external fun getMemoryStatsInto(out: FloatArray): Boolean
     private external fun getTemperature(): Float
-    private external fun isAvailable(): Boolean
-    private external fun getCpuCoreCount(): Int
+    @FastNative private external fun isAvailable(): Boolean
+    @FastNative private external fun getCpuCoreCount(): Int
     private external fun getProcessCpuStats(pid: Int): LongArray?
+    private external fun getProcessCpuStatsInto(pid: Int, out: LongArray): Boolean
     private external fun formatTimeString(hour: Int, minute: Int, use24h: Boolean): String
     private external fun formatCpuString(cpuPercent: Float): String
     private external fun formatRamString(usedMb: Long, totalMb: Long): String
     private external fun formatSelfStatsString(cpuPercent: Float, ramMb: Long): String
+    private external fun setProcRoot(root: String): Boolean
+    private external fun recordSnapshot(dir: String, index: Int): Int
+    private external fun getProcessMemoryBatch(pids: IntArray): LongArray?
+    private external fun setProcessMemoryDetailInterval(intervalMs: Long)
+    private external fun rankProcesses(
+        cpuPercent: FloatArray, ramKb: LongArray, count: Int, sortKey: Int, topN: Int,
+        minCpuPercent: Float, minRamMb: Long, cpuWeight: Float, ramMbDivisor: Float, out: IntArray
+    ): Int
+    private external fun getDiskStats(): DoubleArray?
+    private external fun getDiskNames(): Array<String>?
+    private external fun resetDiskBaseline()
+    private external fun getCpuFrequencies(): IntArray?
+    private external fun getGpuSample(): FloatArray?
+
+    // Longs per pid in getProcessMemoryBatch(), see PROCMEM_FIELDS
+    private const val PROCESS_MEMORY_FIELDS = 9
+
+    // Sort keys and limits for rankProcessesNative(), see native_process_rank.h
+    const val RANK_BY_CPU = 0
+    const val RANK_BY_RAM = 1
+    const val RANK_BY_COMBINED = 2
+    const val RANK_TOP_MAX = 32
+    const val RANK_MAX_PROCESSES = 1024
+
+    // Doubles per entry in getDiskStats(), see DISK_RATE_FIELDS
+    private const val DISK_RATE_FIELDS = 7
+
+    // Ints per policy in getCpuFrequencies(), see CPUFREQ_FIELDS
+    private const val CPUFREQ_FIELDS = 8
+
+    // Floats in getGpuSample(), see GPU_FIELDS
+    private const val GPU_FIELDS = 5
+
+    // GpuVendorNative in native_gpu.h
+    const val GPU_VENDOR_NONE = 0
+    const val GPU_VENDOR_ADRENO = 1
+    const val GPU_VENDOR_MALI = 2
+    const val GPU_VENDOR_GENERIC = 3
 
     /**
      * Data class for memory statistics.
@@ -187,6 +428,120 @@ object NativeMetrics {
         val usagePercent: Float
     )
 
+    /**
+     * Memory of one process. Detail fields (PSS/USS/swap) are -1 until
+     * smaps_rollup has been read for the process.
+     */
+    data class ProcessMemoryData(
+        val pid: Int,
+        val rssKb: Long,
+        val sharedKb: Long,
+        val pssKb: Long,
+        val ussKb: Long,
+        val swapKb: Long,
+        val swapPssKb: Long,
+        val detailTimestampMs: Long
+    ) {
+        /** PSS when known, RSS until the first smaps_rollup read. */
+        val bestEstimateKb: Long
+            get() = if (pssKb >= 0) pssKb else rssKb
+    }
+
+    /**
+     * Block-device I/O of one sample: totals over all whole devices plus
+     * each device. total.utilization is the busiest device's.
+     */
+    data class DiskIoData(
+        val total: DiskDeviceRate,
+        val devices: List<DiskDeviceRate>
+    )
+
+    /**
+     * I/O rates of one block device between two samples.
+     */
+    data class DiskDeviceRate(
+        val name: String,
+        val readBytesPerSec: Long,
+        val writeBytesPerSec: Long,
+        val readIops: Float,
+        val writeIops: Float,
+        val utilizationPercent: Float,
+        val inFlight: Int,
+        val isValid: Boolean
+    ) {
+        val readMbPerSec: Float get() = readBytesPerSec / (1024f * 1024f)
+        val writeMbPerSec: Float get() = writeBytesPerSec / (1024f * 1024f)
+
+        companion object {
+            internal fun fromPacked(name: String, packed: DoubleArray, base: Int) = DiskDeviceRate(
+                name = name,
+                readBytesPerSec = packed[base].toLong(),
+                writeBytesPerSec = packed[base + 1].toLong(),
+                readIops = packed[base + 2].toFloat(),
+                writeIops = packed[base + 3].toFloat(),
+                utilizationPercent = packed[base + 4].toFloat(),
+                inFlight = packed[base + 5].toInt(),
+                isValid = packed[base + 6] != 0.0
+            )
+        }
+    }
+
+    /**
+     * One cpufreq policy: the CPUs in cpuMask share a clock.
+     */
+    data class CpuFreqPolicyData(
+        val firstCpu: Int,
+        val cpuMask: Int,
+        val curKhz: Int,
+        val avgKhz: Int,
+        val scalingMaxKhz: Int,
+        val cpuinfoMaxKhz: Int,
+        val isOnline: Boolean,
+        val hasResidency: Boolean
+    ) {
+        val cpuCount: Int get() = Integer.bitCount(cpuMask)
+
+        /** Current cap relative to the hardware maximum; below 1 when throttled. */
+        val throttleRatio: Float
+            get() = if (cpuinfoMaxKhz > 0) scalingMaxKhz.toFloat() / cpuinfoMaxKhz else 1f
+
+        val isThrottled: Boolean get() = throttleRatio < 1f
+
+        companion object {
+            internal fun fromPacked(packed: IntArray, base: Int) = CpuFreqPolicyData(
+                firstCpu = packed[base],
+                cpuMask = packed[base + 1],
+                curKhz = packed[base + 2],
+                avgKhz = packed[base + 3],
+                scalingMaxKhz = packed[base + 4],
+                cpuinfoMaxKhz = packed[base + 5],
+                isOnline = packed[base + 6] != 0,
+                hasResidency = packed[base + 7] != 0
+            )
+        }
+    }
+
+    /**
+     * One GPU sample; vendor is one of the GPU_VENDOR_* constants.
+     */
+    data class GpuData(
+        val vendor: Int,
+        val usagePercent: Float,
+        val frequencyMhz: Int,
+        val temperatureCelsius: Float,
+        val hasUsage: Boolean
+    ) {
+        companion object {
+            internal fun fromPacked(packed: FloatArray) = GpuData(
+                vendor = packed[0].toInt(),
+                usagePercent = packed[1],
+                frequencyMhz = packed[2].toInt(),
+                temperatureCelsius = packed[3],
+                hasUsage = packed[4] != 0f
+            )
+        }
+    }
+
     /**
      * Data class for process CPU statistics.
      */
@@ -29,6 +29,7 @@ class NativeNetworkMetrics {
     companion object {
         private const val TAG = "NATIVE_NET_METRICS"
         private const val BYTES_TO_MBPS = 8f / (1024f * 1024f)
+        private const val UID_TRAFFIC_FIELDS = 7 // Matches native_uid_traffic.h
 
         @Volatile
         private var isLibraryLoaded = false
@@ -82,6 +83,10 @@ class NativeNetworkMetrics {
     @Volatile
     private var sessionStartTxBytes: Long = 0L
 
+    // Reused by getNetworkStats: [rx, tx, timestamp] and [rxBps, txBps, rxMbps, txMbps]
+    private val snapshotOut = LongArray(3)
+    private val speedOut = FloatArray(4)
+
     /**
      * Checks if native library is loaded and available.
      */
@@ -98,6 +103,7 @@ class NativeNetworkMetrics {
      *
      * @return [NetworkTrafficStats] with current speeds and totals
      */
+    @Synchronized
     fun getNetworkStats(): NetworkTrafficStats {
         if (!isLibraryLoaded) {
             Timber.tag(TAG).w("Native library not loaded")
@@ -105,8 +111,8 @@ class NativeNetworkMetrics {
         }
 
         return try {
-            val snapshot = nativeGetNetworkSnapshot() ?: return NetworkTrafficStats.EMPTY
-            if (snapshot.size < 3) return NetworkTrafficStats.EMPTY
+            val snapshot = snapshotOut
+            if (!nativeGetNetworkSnapshotInto(snapshot)) return NetworkTrafficStats.EMPTY
 
             val currRxBytes = snapshot[0]
             val currTxBytes = snapshot[1]
@@ -123,9 +129,11 @@ class NativeNetworkMetrics {
             }
 
             // Calculate speed using native function
-            val speedResult = nativeCalculateSpeed(
+            val speedResult = speedOut
+            val hasSpeed = nativeCalculateSpeedInto(
                 prevRxBytes, prevTxBytes, prevTimestamp,
-                currRxBytes, currTxBytes, currTimestamp
+                currRxBytes, currTxBytes, currTimestamp,
+                speedResult
             )
 
             // Update previous values
@@ -133,7 +141,7 @@ class NativeNetworkMetrics {
             prevTxBytes = currTxBytes
             prevTimestamp = currTimestamp
 
-            if (speedResult == null || speedResult.size < 4) {
+            if (!hasSpeed) {
                 return createStats(0L, 0L, currRxBytes, currTxBytes, currTimestamp)
             }
 
@@ -234,6 +242,63 @@ class NativeNetworkMetrics {
         } else 0
     }
 
+    /**
+     * Per-UID traffic rates from /proc/net/xt_qtaguid/stats.
+     */
+    data class UidTrafficRate(
+        val uid: Int,
+        val rxBytesPerSec: Long,
+        val txBytesPerSec: Long,
+        val totalRxBytes: Long,
+        val totalTxBytes: Long,
+        val sessionRxBytes: Long,
+        val sessionTxBytes: Long
+    )
+
+    /**
+     * Samples per-UID traffic natively and returns the topN busiest UIDs.
+     * The first call only records a baseline and returns an empty list.
+     *
+     * @return UIDs sorted by rx + tx rate, or null if xt_qtaguid is unavailable
+     */
+    fun sampleUidTraffic(topN: Int): List<UidTrafficRate>? {
+        if (!isLibraryLoaded || topN <= 0) return null
+
+        return try {
+            val out = LongArray(topN * UID_TRAFFIC_FIELDS)
+            val count = nativeSampleUidTraffic(out, topN)
+            if (count < 0) return null
+
+            List(count) { i ->
+                val base = i * UID_TRAFFIC_FIELDS
+                UidTrafficRate(
+                    uid = out[base].toInt(),
+                    rxBytesPerSec = out[base + 1],
+                    txBytesPerSec = out[base + 2],
+                    totalRxBytes = out[base + 3],
+                    totalTxBytes = out[base + 4],
+                    sessionRxBytes = out[base + 5],
+                    sessionTxBytes = out[base + 6]
+                )
+            }
+        } catch (e: Exception) {
+            Timber.tag(TAG).e(e, "Error sampling per-UID traffic")
+            null
+        }
+    }
+
+    /**
+     * Forgets the per-UID baseline and session counters.
+     */
+    fun resetUidTraffic() {
+        if (!isLibraryLoaded) return
+        try {
+            nativeResetUidTraffic()
+        } catch (e: Exception) {
+            Timber.tag(TAG).e(e, "Error resetting per-UID traffic")
+        }
+    }
+
     /**
      * Resets baseline and peak values.
      */
@@ -330,7 +395,15 @@ class NativeNetworkMetrics {
         prevRx: Long, prevTx: Long, prevTime: Long,
         currRx: Long, currTx: Long, currTime: Long
     ): FloatArray?
+    private external fun nativeGetNetworkSnapshotInto(out: LongArray): Boolean
+    private external fun nativeCalculateSpeedInto(
+        prevRx: Long, prevTx: Long, prevTime: Long,
+        currRx: Long, currTx: Long, currTime: Long,
+        out: FloatArray
+    ): Boolean
     private external fun nativeFormatSpeed(bytesPerSec: Long, prefix: String): String?
     private external fun nativeIsAvailable(): Boolean
     private external fun nativeGetInterfaceCount(): Int
+    private external fun nativeSampleUidTraffic(out: LongArray, topN: Int): Int
+    private external fun nativeResetUidTraffic()
 }
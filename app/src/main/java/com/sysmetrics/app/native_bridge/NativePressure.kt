@@ -0,0 +1,133 @@
+package com.sysmetrics.app.native_bridge
+
+import timber.log.Timber
+
+/**
+ * JNI Bridge for Linux pressure stall information (/proc/pressure).
+ *
+ * read() parses the some/full stall averages of one resource. Triggers are
+ * registered with the kernel ("some 150000 1000000" = 150ms stalled within
+ * any 1s window) and waitForTrigger() blocks in poll() until one fires, so
+ * a watcher thread costs nothing while the system is healthy.
+ *
+ * PSI needs CONFIG_PSI (Android 10+ kernels). Unprivileged triggers are
+ * refused on some kernels or by SELinux; callers must treat -1 as
+ * "not supported" and keep their periodic checks.
+ */
+object NativePressure {
+
+    private const val TAG = "NATIVE_PSI"
+
+    const val CPU = 0
+    const val MEMORY = 1
+    const val IO = 2
+
+    @Volatile
+    private var isLoaded = false
+
+    init {
+        loadLibrary()
+    }
+
+    private fun loadLibrary() {
+        if (isLoaded) return
+
+        try {
+            System.loadLibrary("sysmetrics_native")
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            Timber.tag(TAG).e(e, "Failed to load native pressure library")
+            isLoaded = false
+        }
+    }
+
+    fun isAvailable(): Boolean = isLoaded
+
+    /**
+     * Current stall averages of one resource.
+     * @return DoubleArray [someAvg10, someAvg60, someAvg300, someTotalUs,
+     *         fullAvg10, fullAvg60, fullAvg300, fullTotalUs, hasFull]
+     *         or null when PSI is unavailable
+     */
+    @JvmStatic
+    external fun read(resource: Int): DoubleArray?
+
+    /**
+     * Register a kernel trigger.
+     * @param full Track "full" (all tasks stalled) instead of "some"
+     * @param stallUs Stall time that fires the trigger
+     * @param windowUs Tracking window, 500ms..10s
+     * @return Trigger id (0..7), or -1 if the kernel refused it
+     */
+    @JvmStatic
+    external fun addTrigger(resource: Int, full: Boolean, stallUs: Long, windowUs: Long): Int
+
+    @JvmStatic
+    external fun removeTrigger(triggerId: Int)
+
+    @JvmStatic
+    external fun clearTriggers()
+
+    /**
+     * Block until a trigger fires, wake() is called or the timeout expires.
+     * @return Bitmask of fired trigger ids, 0 on timeout/wake, -1 on error
+     */
+    @JvmStatic
+    external fun waitForTrigger(timeoutMs: Int): Int
+
+    /**
+     * Interrupt a thread blocked in waitForTrigger().
+     */
+    @JvmStatic
+    external fun wake()
+
+    /**
+     * Decoded stall averages, or null when PSI is unavailable.
+     */
+    fun getStats(resource: Int): PressureStats? {
+        if (!isLoaded) return null
+
+        return runCatching {
+            PressureStats.fromArray(read(resource))
+        }.getOrElse { e ->
+            Timber.tag(TAG).w(e, "Failed to read pressure stats")
+            null
+        }
+    }
+}
+
+/**
+ * Stall percentages over 10s/60s/300s windows plus cumulative stall time.
+ * full* values are zero for the cpu resource on kernels without "full".
+ */
+data class PressureStats(
+    val someAvg10: Float,
+    val someAvg60: Float,
+    val someAvg300: Float,
+    val someTotalUs: Long,
+    val fullAvg10: Float,
+    val fullAvg60: Float,
+    val fullAvg300: Float,
+    val fullTotalUs: Long,
+    val hasFull: Boolean
+) {
+    companion object {
+        private const val FIELDS = 9
+
+        fun fromArray(arr: DoubleArray?): PressureStats? {
+            if (arr == null || arr.size < FIELDS) return null
+
+            return PressureStats(
+                someAvg10 = arr[0].toFloat(),
+                someAvg60 = arr[1].toFloat(),
+                someAvg300 = arr[2].toFloat(),
+                someTotalUs = arr[3].toLong(),
+                fullAvg10 = arr[4].toFloat(),
+                fullAvg60 = arr[5].toFloat(),
+                fullAvg300 = arr[6].toFloat(),
+                fullTotalUs = arr[7].toLong(),
+                hasFull = arr[8] != 0.0
+            )
+        }
+    }
+}
@@ -0,0 +1,215 @@
+package com.sysmetrics.app.native_bridge
+
+import dalvik.annotation.optimization.CriticalNative
+import timber.log.Timber
+
+/**
+ * JNI Bridge for native self-instrumentation.
+ *
+ * Every native entry point (procfs readers, analytics buffers) is timed with
+ * CLOCK_MONOTONIC into a lock-free log-bucketed histogram plus call/error
+ * counters. Timing is off by default; when off a probe costs one relaxed
+ * atomic load, so it is safe to leave compiled into release builds.
+ *
+ * Tracing additionally records every native call as a span in a per-thread
+ * ring; flushTrace() writes them as Chrome trace-event JSON that opens in
+ * Perfetto (ui.perfetto.dev) or chrome://tracing.
+ */
+object NativeProfiler {
+
+    private const val TAG = "NATIVE_PROFILER"
+
+    @Volatile
+    private var isLoaded = false
+
+    init {
+        loadLibrary()
+    }
+
+    private fun loadLibrary() {
+        if (isLoaded) return
+
+        try {
+            System.loadLibrary("sysmetrics_native")
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            Timber.tag(TAG).e(e, "Failed to load native profiler library")
+            isLoaded = false
+        }
+    }
+
+    fun isAvailable(): Boolean = isLoaded
+
+    /**
+     * Turn native timing on or off at runtime.
+     */
+    @JvmStatic
+    external fun setEnabled(enabled: Boolean)
+
+    @JvmStatic
+    @CriticalNative
+    external fun isEnabled(): Boolean
+
+    /**
+     * Zero all native histograms and counters.
+     */
+    @JvmStatic
+    external fun reset()
+
+    /**
+     * Packed statistics for every probe.
+     * @return LongArray [version, probeCount, fieldsPerProbe,
+     *         (calls, errors, totalNs, maxNs, p50Ns, p90Ns, p99Ns) * probeCount]
+     */
+    @JvmStatic
+    external fun dump(): LongArray?
+
+    /**
+     * Native function name of each probe, in dump() order.
+     */
+    @JvmStatic
+    external fun probeNames(): Array<String>?
+
+    /**
+     * Start or stop recording native trace spans.
+     */
+    @JvmStatic
+    external fun setTracingEnabled(enabled: Boolean)
+
+    @JvmStatic
+    @CriticalNative
+    external fun isTracingEnabled(): Boolean
+
+    /**
+     * Write spans recorded since the last flush to a Chrome trace-event
+     * JSON file and drop them from the rings.
+     * @return Number of spans written, or -1 on I/O error
+     */
+    @JvmStatic
+    external fun flushTrace(path: String): Int
+
+    /**
+     * Sample every thread of this process into out, THREAD_FIELDS longs each:
+     * [tid, cpuCentiPercent, cpuTimeMs, voluntarySwitches, involuntarySwitches, isValid],
+     * most expensive first.
+     * @return Thread names in the same order (one per thread written), or null
+     */
+    @JvmStatic
+    external fun sampleThreads(out: LongArray): Array<String>?
+
+    private const val THREAD_FIELDS = 6
+    private const val MAX_THREADS = 256
+
+    // Reused between samples; guarded by the object lock in getThreadStats()
+    private val threadBuffer = LongArray(MAX_THREADS * THREAD_FIELDS)
+
+    /**
+     * CPU and context switches of each of our threads since the previous
+     * call, most expensive first. The first call only sets baselines
+     * (isValid = false).
+     */
+    @Synchronized
+    fun getThreadStats(): List<ThreadCpuStats> {
+        if (!isLoaded) return emptyList()
+
+        return runCatching {
+            val names = sampleThreads(threadBuffer) ?: return@runCatching emptyList()
+            List(names.size) { index ->
+                ThreadCpuStats.fromPacked(names[index], threadBuffer, index * THREAD_FIELDS)
+            }
+        }.getOrElse { e ->
+            Timber.tag(TAG).w(e, "Failed to sample native thread stats")
+            emptyList()
+        }
+    }
+
+    /**
+     * Decoded per-function statistics, keyed by native function name.
+     * Probes that have not been called are omitted.
+     */
+    fun getStats(): Map<String, NativeProbeStats> {
+        if (!isLoaded) return emptyMap()
+
+        return runCatching {
+            NativeProbeStats.fromDump(dump(), probeNames())
+        }.getOrElse { e ->
+            Timber.tag(TAG).w(e, "Failed to read native probe stats")
+            emptyMap()
+        }
+    }
+}
+
+/**
+ * Cost of one thread of this process between two samples.
+ * cpuPercent is relative to one core.
+ */
+data class ThreadCpuStats(
+    val tid: Int,
+    val name: String,
+    val cpuPercent: Float,
+    val cpuTimeMs: Long,
+    val voluntarySwitches: Long,
+    val involuntarySwitches: Long,
+    val isValid: Boolean
+) {
+    companion object {
+        internal fun fromPacked(name: String, packed: LongArray, base: Int) = ThreadCpuStats(
+            tid = packed[base].toInt(),
+            name = name,
+            cpuPercent = packed[base + 1] / 100f,
+            cpuTimeMs = packed[base + 2],
+            voluntarySwitches = packed[base + 3],
+            involuntarySwitches = packed[base + 4],
+            isValid = packed[base + 5] != 0L
+        )
+    }
+}
+
+/**
+ * Latency statistics of one native entry point (nanoseconds).
+ */
+data class NativeProbeStats(
+    val calls: Long,
+    val errors: Long,
+    val totalNs: Long,
+    val maxNs: Long,
+    val p50Ns: Long,
+    val p90Ns: Long,
+    val p99Ns: Long
+) {
+    val avgNs: Long get() = if (calls > 0) totalNs / calls else 0L
+
+    companion object {
+        // Layout of NativeProfiler.dump(): [version, probeCount, fieldsPerProbe, fields...]
+        private const val DUMP_VERSION = 1L
+        private const val HEADER = 3
+
+        fun fromDump(arr: LongArray?, names: Array<String>?): Map<String, NativeProbeStats> {
+            if (arr == null || names == null || arr.size < HEADER || arr[0] != DUMP_VERSION) {
+                return emptyMap()
+            }
+
+            val probeCount = arr[1].toInt()
+            val fields = arr[2].toInt()
+            if (fields < 7 || arr.size < HEADER + probeCount * fields) return emptyMap()
+
+            val result = LinkedHashMap<String, NativeProbeStats>()
+            for (probe in 0 until minOf(probeCount, names.size)) {
+                val base = HEADER + probe * fields
+                val calls = arr[base]
+                if (calls == 0L) continue
+
+                result[names[probe]] = NativeProbeStats(
+                    calls = calls,
+                    errors = arr[base + 1],
+                    totalNs = arr[base + 2],
+                    maxNs = arr[base + 3],
+                    p50Ns = arr[base + 4],
+                    p90Ns = arr[base + 5],
+                    p99Ns = arr[base + 6]
+                )
+            }
+            return result
+        }
+    }
+}
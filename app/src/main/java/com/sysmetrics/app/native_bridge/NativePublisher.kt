@@ -0,0 +1,76 @@
+package com.sysmetrics.app.native_bridge
+
+import timber.log.Timber
+
+/**
+ * JNI Bridge for change-driven sample publishing.
+ *
+ * A publisher holds the last published value of every metric in a fixed
+ * sample vector. submit() returns a bitmask of the metrics that moved past
+ * their dead-band (or stayed silent for longer than maxSilenceMs) and packs
+ * just those values into changedOut, so idle ticks cost one JNI call and
+ * no UI or analytics work.
+ */
+object NativePublisher {
+
+    private const val TAG = "NATIVE_PUBLISH"
+
+    @Volatile
+    private var isLoaded = false
+
+    init {
+        loadLibrary()
+    }
+
+    private fun loadLibrary() {
+        if (isLoaded) return
+
+        try {
+            System.loadLibrary("sysmetrics_native")
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            Timber.tag(TAG).e(e, "Failed to load native publisher library")
+            isLoaded = false
+        }
+    }
+
+    fun isAvailable(): Boolean = isLoaded
+
+    /**
+     * @param metricCount Metrics per sample (1..32)
+     * @param maxSilenceMs Republish unchanged metrics after this long; <= 0 disables
+     * @return Handle, or 0 on failure
+     */
+    @JvmStatic
+    external fun create(metricCount: Int, maxSilenceMs: Long): Long
+
+    @JvmStatic
+    external fun destroy(handle: Long)
+
+    /**
+     * Publish a metric when |value - lastPublished| > max(absolute, relative * |lastPublished|).
+     */
+    @JvmStatic
+    external fun setDeadband(handle: Long, index: Int, absolute: Float, relative: Float): Boolean
+
+    /**
+     * @param values One value per metric; NaN marks a missing reading
+     * @param changedOut Receives the published values packed in metric order
+     * @return Change mask (bit i = metric i), or -1 on error
+     */
+    @JvmStatic
+    external fun submit(handle: Long, values: FloatArray, timestampMs: Long, changedOut: FloatArray): Long
+
+    /**
+     * Publish every metric on the next submit.
+     */
+    @JvmStatic
+    external fun force(handle: Long)
+
+    /**
+     * @return LongArray [submitted, publishedTicks, suppressedTicks,
+     *         publishedValues, suppressedValues, heartbeatValues]
+     */
+    @JvmStatic
+    external fun getStats(handle: Long): LongArray?
+}
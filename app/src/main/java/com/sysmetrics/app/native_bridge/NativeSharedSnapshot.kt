@@ -0,0 +1,160 @@
+package com.sysmetrics.app.native_bridge
+
+import timber.log.Timber
+
+/**
+ * JNI Bridge for the shared-memory metrics snapshot.
+ *
+ * The overlay service creates the region and publishes every tick; other
+ * components (widget, activities) read the latest snapshot instead of
+ * collecting on their own. Reads are seqlock-protected copies out of a
+ * memfd mapping, so they never block the publisher. The fd from create()
+ * can be passed to another process (ParcelFileDescriptor) and attached
+ * there.
+ *
+ * While a session recording is running, every published snapshot is also
+ * appended to a compact binary log (native_session.h) that the host tool
+ * sysmetrics_replay feeds back into the analytics engine.
+ */
+object NativeSharedSnapshot {
+
+    private const val TAG = "NATIVE_SHARED_SNAPSHOT"
+
+    // SnapshotMetric in native_shared_snapshot.h; NaN = not collected
+    const val CPU_PERCENT = 0
+    const val RAM_USED_MB = 1
+    const val RAM_TOTAL_MB = 2
+    const val RAM_PERCENT = 3
+    const val NET_RX_BPS = 4
+    const val NET_TX_BPS = 5
+    const val SELF_CPU_PERCENT = 6
+    const val SELF_RAM_MB = 7
+    const val TEMPERATURE_C = 8
+    const val GPU_PERCENT = 9
+    const val METRIC_COUNT = 10
+
+    @Volatile
+    private var isLoaded = false
+
+    @Volatile
+    private var localHandle = 0L
+
+    init {
+        loadLibrary()
+    }
+
+    private fun loadLibrary() {
+        if (isLoaded) return
+
+        try {
+            System.loadLibrary("sysmetrics_native")
+            isLoaded = true
+        } catch (e: UnsatisfiedLinkError) {
+            Timber.tag(TAG).e(e, "Failed to load native snapshot library")
+            isLoaded = false
+        }
+    }
+
+    fun isAvailable(): Boolean = isLoaded
+
+    /**
+     * Latest snapshot published in this process.
+     */
+    data class Snapshot(
+        val timestampMs: Long,
+        val publishCount: Long,
+        private val values: DoubleArray
+    ) {
+        operator fun get(metric: Int): Double = values[metric]
+
+        fun has(metric: Int): Boolean = !values[metric].isNaN()
+
+        fun ageMs(nowMs: Long = System.currentTimeMillis()): Long = nowMs - timestampMs
+    }
+
+    /**
+     * Read the latest snapshot published in this process.
+     * @return Snapshot, or null if nothing was published yet
+     */
+    fun readLatest(): Snapshot? {
+        if (!isLoaded) return null
+
+        return runCatching {
+            val handle = localHandle.takeIf { it != 0L } ?: attachLocal() ?: return@runCatching null
+            val out = DoubleArray(METRIC_COUNT + 1)
+            val count = read(handle, out)
+            if (count <= 0) return@runCatching null
+            Snapshot(out[0].toLong(), count, out.copyOfRange(1, METRIC_COUNT + 1))
+        }.getOrNull()
+    }
+
+    // Readers never create the region: until the publisher has, there is nothing to read
+    @Synchronized
+    private fun attachLocal(): Long? {
+        if (localHandle != 0L) return localHandle
+        val fd = regionFd()
+        if (fd < 0) return null
+        localHandle = attach(fd).takeIf { it != 0L } ?: return null
+        return localHandle
+    }
+
+    /**
+     * Create the region (idempotent).
+     * @return File descriptor of the region, or -1 on failure
+     */
+    @JvmStatic
+    external fun create(): Int
+
+    /**
+     * The region created in this process, without creating one.
+     * @return File descriptor of the region, or -1 if none exists
+     */
+    @JvmStatic
+    external fun regionFd(): Int
+
+    /**
+     * @param values METRIC_COUNT values in metric order
+     */
+    @JvmStatic
+    external fun publish(timestampMs: Long, values: DoubleArray): Boolean
+
+    @JvmStatic
+    external fun destroy()
+
+    /**
+     * Map a region read-only (e.g. an fd received from another process).
+     * @return Handle, or 0 if fd is not a snapshot region
+     */
+    @JvmStatic
+    external fun attach(fd: Int): Long
+
+    @JvmStatic
+    external fun detach(handle: Long)
+
+    /**
+     * @param out Receives [timestampMs, values...] (METRIC_COUNT + 1 doubles)
+     * @return Publish count, 0 before the first publish, or -1 on error
+     */
+    @JvmStatic
+    external fun read(handle: Long, out: DoubleArray): Long
+
+    /**
+     * Record every published snapshot to path (truncated), finishing any
+     * recording in progress.
+     */
+    @JvmStatic
+    external fun startRecording(path: String): Boolean
+
+    /**
+     * Flush and close the session log.
+     * @return Samples recorded, or -1 if not recording
+     */
+    @JvmStatic
+    external fun stopRecording(): Long
+
+    /**
+     * @return Samples recorded so far, or -1 if not recording
+     */
+    @JvmStatic
+    external fun recordedSamples(): Long
+}
@@ -6,6 +6,7 @@ import android.app.NotificationManager
 import android.app.Service
 import android.content.Context
 import android.content.Intent
+import android.content.SharedPreferences
 import android.graphics.PixelFormat
 import android.os.Build
 import android.os.Handler
@@ -24,17 +25,26 @@ import androidx.lifecycle.LifecycleService
 import androidx.lifecycle.lifecycleScope
 import com.sysmetrics.app.core.SysMetricsApplication
 import com.sysmetrics.app.core.common.Constants
+import com.sysmetrics.app.data.source.GpuDataSource
 import com.sysmetrics.app.data.source.PreferencesDataSource
 import com.sysmetrics.app.data.source.SystemDataSource
 import com.sysmetrics.app.data.source.network.NetworkStatsDataSource
 import com.sysmetrics.app.domain.collector.IMetricsCollector
+import com.sysmetrics.app.domain.analytics.SamplePublisher
 import com.sysmetrics.app.domain.collector.IProcessStatsCollector
 import com.sysmetrics.app.domain.formatter.IStringFormatter
+import com.sysmetrics.app.native_bridge.NativeSharedSnapshot
 import com.sysmetrics.app.utils.AdaptivePerformanceMonitor
 import com.sysmetrics.app.utils.DeviceUtils
 import com.sysmetrics.app.utils.DraggableOverlayTouchListener
+import com.sysmetrics.app.utils.MemoryMonitor
+import com.sysmetrics.app.utils.PerformanceMonitor
+import com.sysmetrics.app.utils.PressureStallMonitor
+import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
 import timber.log.Timber
+import java.io.File
 import java.text.SimpleDateFormat
 import java.util.Date
 import java.util.Locale
@@ -65,6 +75,15 @@ class MinimalistOverlayService : LifecycleService() {
         private const val TAG_UPDATE = "OVERLAY_UPDATE"
         private const val TAG_DISPLAY = "OVERLAY_DISPLAY"
         private const val TAG_SETTINGS = "OVERLAY_SETTINGS"
+
+        // Sample vector layout for the change-driven publisher
+        private const val METRIC_CPU = 0
+        private const val METRIC_RAM_USED_MB = 1
+        private const val METRIC_NET_RX = 2
+        private const val METRIC_NET_TX = 3
+        private const val METRIC_SELF_CPU = 4
+        private const val METRIC_SELF_RAM_MB = 5
+        private const val METRIC_COUNT = 6
     }
 
     private lateinit var systemDataSource: SystemDataSource
@@ -73,6 +92,7 @@ class MinimalistOverlayService : LifecycleService() {
     private lateinit var processStatsCollector: IProcessStatsCollector
     private lateinit var adaptiveMonitor: AdaptivePerformanceMonitor
     private lateinit var batteryAwareMonitor: com.sysmetrics.app.utils.BatteryAwareMonitor
+    private lateinit var memoryMonitor: MemoryMonitor
     private lateinit var preferencesDataSource: PreferencesDataSource
     private lateinit var stringFormatter: IStringFormatter
 
@@ -83,6 +103,16 @@ class MinimalistOverlayService : LifecycleService() {
     // Adaptive performance monitoring
     private var currentUpdateInterval = Constants.OverlayService.UPDATE_INTERVAL_MS
     private var adaptiveCheckCounter = 0
+    private var pressureMonitor: PressureStallMonitor? = null
+    private val publisher = createPublisher()
+    private val sample = FloatArray(METRIC_COUNT)
+    private val sharedSnapshot = DoubleArray(NativeSharedSnapshot.METRIC_COUNT) { Double.NaN }
+    private var isSharedSnapshotReady = false
+    private var isRecordingSession = false
+    private val sessionPrefListener = SharedPreferences.OnSharedPreferenceChangeListener { prefs, key ->
+        if (key == Constants.SessionRecording.PREF_KEY) applySessionRecording(prefs)
+    }
+    private var lastTimeDisplay = ""
 
     private val handler = Handler(Looper.getMainLooper())
     private val updateRunnable = object : Runnable {
@@ -108,6 +138,7 @@ class MinimalistOverlayService : LifecycleService() {
     
     // Network data source
     private lateinit var networkStatsDataSource: NetworkStatsDataSource
+    private lateinit var gpuDataSource: GpuDataSource
 
     private var currentConfig: com.sysmetrics.app.data.model.OverlayConfig = com.sysmetrics.app.data.model.OverlayConfig.DEFAULT
     private var isBaselineInitialized = false
@@ -131,11 +162,22 @@ class MinimalistOverlayService : LifecycleService() {
         systemDataSource = SystemDataSource(com.sysmetrics.app.core.di.DefaultDispatcherProvider())
         preferencesDataSource = PreferencesDataSource(this)
         batteryAwareMonitor = com.sysmetrics.app.utils.BatteryAwareMonitor(this)
+        memoryMonitor = MemoryMonitor(this)
         networkStatsDataSource = NetworkStatsDataSource(com.sysmetrics.app.core.di.DefaultDispatcherProvider())
+        gpuDataSource = GpuDataSource(com.sysmetrics.app.core.di.DefaultDispatcherProvider())
         
         // Setup exception handler for TV-specific crashes
         setupExceptionHandler()
 
+        // Other components read our samples from shared memory instead of re-collecting
+        isSharedSnapshotReady = NativeSharedSnapshot.isAvailable() &&
+            runCatching { NativeSharedSnapshot.create() >= 0 }.getOrDefault(false)
+
+        // Session log (Settings > Record session log), independent of the shared region
+        val prefs = PreferenceManager.getDefaultSharedPreferences(this)
+        prefs.registerOnSharedPreferenceChangeListener(sessionPrefListener)
+        applySessionRecording(prefs)
+
         windowManager = getSystemService(WINDOW_SERVICE) as WindowManager
         Timber.tag(TAG_SERVICE).d("📦 Dependencies initialized from AppContainer")
         
@@ -226,12 +268,35 @@ class MinimalistOverlayService : LifecycleService() {
                 
                 // Start regular updates on main thread
                 handler.post(updateRunnable)
+                startPressureMonitor()
             } catch (e: Exception) {
                 Timber.tag(TAG_SERVICE).e(e, "Failed to initialize baseline")
             }
         }
     }
 
+    /**
+     * Arm kernel PSI triggers so a memory/CPU stall is sampled the moment the
+     * kernel reports it. With triggers armed the periodic rate can stay low.
+     */
+    private fun startPressureMonitor() {
+        if (!deviceUtils.shouldUseAdaptivePerformance()) return
+
+        val monitor = PressureStallMonitor {
+            handler.post {
+                // A stall reported after onDestroy() must not restart the loop
+                if (pressureMonitor == null) return@post
+                // Sample now and restart the periodic schedule from here
+                handler.removeCallbacks(updateRunnable)
+                handler.post(updateRunnable)
+            }
+        }
+        if (monitor.start()) {
+            pressureMonitor = monitor
+            adaptiveMonitor.setStallTriggersArmed(true)
+        }
+    }
+
     override fun onStartCommand(intent: Intent?, flags: Int, startId: Int): Int {
         super.onStartCommand(intent, flags, startId)
         return START_STICKY
@@ -240,6 +305,17 @@ class MinimalistOverlayService : LifecycleService() {
     override fun onDestroy() {
         super.onDestroy()
         handler.removeCallbacks(updateRunnable)
+        pressureMonitor?.stop()
+        pressureMonitor = null
+        adaptiveMonitor.setStallTriggersArmed(false)
+        memoryMonitor.release()
+        Timber.tag(TAG_SERVICE).i("📉 Suppressed %.0f%% of overlay updates", publisher.getSuppressionRatio() * 100f)
+        publisher.destroy()
+        // A session recording ends with the samples that feed it
+        PreferenceManager.getDefaultSharedPreferences(this)
+            .unregisterOnSharedPreferenceChangeListener(sessionPrefListener)
+        PerformanceMonitor.stopSessionRecording()
+        isRecordingSession = false
         
         try {
             windowManager.removeView(overlayView)
@@ -265,6 +341,24 @@ class MinimalistOverlayService : LifecycleService() {
         Timber.tag(TAG_SETTINGS).i("⚙️ Settings loaded: opacity=%d", opacity)
     }
     
+    /**
+     * Start or stop the session log to match the setting. Starting truncates
+     * files/session.smsr.
+     */
+    private fun applySessionRecording(prefs: SharedPreferences) {
+        val enabled = prefs.getBoolean(Constants.SessionRecording.PREF_KEY, false)
+        if (enabled == isRecordingSession) return
+
+        if (enabled) {
+            val path = File(filesDir, Constants.SessionRecording.FILE_NAME).path
+            isRecordingSession = PerformanceMonitor.startSessionRecording(path)
+            Timber.tag(TAG_SETTINGS).i("📼 Session recording to %s: %b", path, isRecordingSession)
+        } else {
+            PerformanceMonitor.stopSessionRecording()
+            isRecordingSession = false
+        }
+    }
+    
     /**
      * Load config and apply visibility settings
      */
@@ -523,8 +617,22 @@ class MinimalistOverlayService : LifecycleService() {
                     networkStats.ingressBytesPerSec / 1024f / 1024f,
                     networkStats.egressBytesPerSec / 1024f / 1024f)
 
-                // Update UI on main thread
-                updateUI(cpuPercent, usedMb, totalMb, ramPercent, networkStats)
+                // Self stats are part of the published sample
+                val selfStats = processStatsCollector.getSelfStats()
+
+                sample[METRIC_CPU] = cpuPercent
+                sample[METRIC_RAM_USED_MB] = usedMb.toFloat()
+                sample[METRIC_NET_RX] = networkStats.ingressBytesPerSec.toFloat()
+                sample[METRIC_NET_TX] = networkStats.egressBytesPerSec.toFloat()
+                sample[METRIC_SELF_CPU] = selfStats.cpuPercent
+                sample[METRIC_SELF_RAM_MB] = selfStats.ramMb.toFloat()
+                val changed = publisher.submit(sample)
+                publishSharedSnapshot(cpuPercent, usedMb, totalMb, ramPercent, networkStats,
+                    selfStats.cpuPercent, selfStats.ramMb)
+
+                // Update UI on main thread (only views whose metrics changed)
+                updateUI(changed, cpuPercent, usedMb, totalMb, ramPercent, networkStats,
+                    selfStats.cpuPercent, selfStats.ramMb)
                 
                 val duration = System.currentTimeMillis() - startTime
                 Timber.tag(TAG_UPDATE).v("✅ Update cycle completed in %dms", duration)
@@ -541,8 +649,57 @@ class MinimalistOverlayService : LifecycleService() {
         }
     }
     
-    private suspend fun updateUI(cpuPercent: Float, usedMb: Long, totalMb: Long, ramPercent: Float, 
-                                  networkStats: com.sysmetrics.app.data.model.network.NetworkTrafficStats) {
+    /**
+     * Publish this tick to the shared-memory snapshot read by the widget and
+     * activities. Publishing also appends to the session log, which works
+     * without a shared region. GPU and temperature are only read when
+     * something consumes them.
+     */
+    private suspend fun publishSharedSnapshot(cpuPercent: Float, usedMb: Long, totalMb: Long, ramPercent: Float,
+                                              networkStats: com.sysmetrics.app.data.model.network.NetworkTrafficStats,
+                                              selfCpuPercent: Float, selfRamMb: Long) {
+        if (!isSharedSnapshotReady && !isRecordingSession) return
+
+        val gpuInfo = gpuDataSource.readGpuInfo()
+        val temperature = systemDataSource.readTemperature()
+
+        sharedSnapshot[NativeSharedSnapshot.CPU_PERCENT] = cpuPercent.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.RAM_USED_MB] = usedMb.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.RAM_TOTAL_MB] = totalMb.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.RAM_PERCENT] = ramPercent.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.NET_RX_BPS] = networkStats.ingressBytesPerSec.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.NET_TX_BPS] = networkStats.egressBytesPerSec.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.SELF_CPU_PERCENT] = selfCpuPercent.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.SELF_RAM_MB] = selfRamMb.toDouble()
+        sharedSnapshot[NativeSharedSnapshot.TEMPERATURE_C] =
+            if (temperature.cpuTempCelsius > 0f) temperature.cpuTempCelsius.toDouble() else Double.NaN
+        sharedSnapshot[NativeSharedSnapshot.GPU_PERCENT] =
+            if (gpuInfo.isAvailable) gpuInfo.usagePercent.toDouble() else Double.NaN
+        runCatching { NativeSharedSnapshot.publish(System.currentTimeMillis(), sharedSnapshot) }
+    }
+
+    private fun updateUI(changed: Int, cpuPercent: Float, usedMb: Long, totalMb: Long, ramPercent: Float,
+                         networkStats: com.sysmetrics.app.data.model.network.NetworkTrafficStats,
+                         selfCpuPercent: Float, selfRamMb: Long) {
+        if (SamplePublisher.isChanged(changed, METRIC_CPU)) updateCpuView(cpuPercent)
+        if (SamplePublisher.isChanged(changed, METRIC_RAM_USED_MB)) updateRamView(usedMb, totalMb, ramPercent)
+        if (SamplePublisher.isChanged(changed, METRIC_NET_RX) || SamplePublisher.isChanged(changed, METRIC_NET_TX)) {
+            updateNetworkView(networkStats)
+        }
+        if (SamplePublisher.isChanged(changed, METRIC_SELF_CPU) || SamplePublisher.isChanged(changed, METRIC_SELF_RAM_MB)) {
+            updateSelfStatsView(selfCpuPercent, selfRamMb)
+        }
+
+        // Time display only changes once a minute
+        val currentTime = timeFormat24h.format(Date())
+        if (currentTime != lastTimeDisplay) {
+            lastTimeDisplay = currentTime
+            timeText.text = currentTime
+            Timber.tag(TAG_DISPLAY).v("🕒 TIME on SCREEN: '%s'", currentTime)
+        }
+    }
+
+    private fun updateCpuView(cpuPercent: Float) {
         // Update CPU with color indicator - use optimized string formatting
         val cpuDisplay = stringFormatter.formatCpu(cpuPercent)
         cpuText.text = cpuDisplay
@@ -554,35 +711,45 @@ class MinimalistOverlayService : LifecycleService() {
             else -> "RED"
         }
         Timber.tag(TAG_DISPLAY).d("📺 CPU on SCREEN: '%s' color=%s", cpuDisplay, cpuColor)
+    }
 
+    private fun updateRamView(usedMb: Long, totalMb: Long, ramPercent: Float) {
         // Update RAM with color indicator - use optimized string formatting
         val ramDisplay = stringFormatter.formatRam(usedMb, totalMb)
         ramText.text = ramDisplay
         ramText.setTextColor(getColorForValue(ramPercent))
 
         Timber.tag(TAG_DISPLAY).d("📺 RAM on SCREEN: '%s' (%.1f%%)", ramDisplay, ramPercent)
-        
+    }
+
+    private fun updateNetworkView(networkStats: com.sysmetrics.app.data.model.network.NetworkTrafficStats) {
         // Update Network traffic
         val networkDisplay = formatNetworkSpeed(networkStats.ingressBytesPerSec, networkStats.egressBytesPerSec)
         networkText.text = networkDisplay
         Timber.tag(TAG_DISPLAY).d("📺 NET on SCREEN: '%s'", networkDisplay)
+    }
 
+    private fun updateSelfStatsView(selfCpuPercent: Float, selfRamMb: Long) {
         // SysMetrics self stats with color (compact format) - use optimized string formatting
-        val selfStats = processStatsCollector.getSelfStats()
-        val selfDisplay = stringFormatter.formatSelfStats(selfStats.cpuPercent, selfStats.ramMb)
+        val selfDisplay = stringFormatter.formatSelfStats(selfCpuPercent, selfRamMb)
         selfStatsText.text = selfDisplay
-        selfStatsText.setTextColor(getColorForValue(selfStats.cpuPercent))
+        selfStatsText.setTextColor(getColorForValue(selfCpuPercent))
 
         Timber.tag(TAG_DISPLAY).d("📺 SELF on SCREEN: '%s'", selfDisplay)
+    }
 
-        // Update time display - always show time
-        val calendar = java.util.Calendar.getInstance()
-        val hour = calendar.get(java.util.Calendar.HOUR_OF_DAY)
-        val minute = calendar.get(java.util.Calendar.MINUTE)
-
-        val currentTime = timeFormat24h.format(Date())
-        timeText.text = currentTime
-        Timber.tag(TAG_DISPLAY).v("🕒 TIME on SCREEN: '%s'", currentTime)
+    /**
+     * Publisher for the overlay's sample vector; idle ticks publish nothing.
+     */
+    private fun createPublisher(): SamplePublisher {
+        return SamplePublisher(METRIC_COUNT, Constants.Publishing.MAX_SILENCE_MS).apply {
+            setDeadband(METRIC_CPU, Constants.Publishing.CPU_DEADBAND_PERCENT)
+            setDeadband(METRIC_RAM_USED_MB, Constants.Publishing.RAM_DEADBAND_MB)
+            setDeadband(METRIC_NET_RX, Constants.Publishing.NET_DEADBAND_BYTES, Constants.Publishing.NET_DEADBAND_RELATIVE)
+            setDeadband(METRIC_NET_TX, Constants.Publishing.NET_DEADBAND_BYTES, Constants.Publishing.NET_DEADBAND_RELATIVE)
+            setDeadband(METRIC_SELF_CPU, Constants.Publishing.CPU_DEADBAND_PERCENT)
+            setDeadband(METRIC_SELF_RAM_MB, Constants.Publishing.RAM_DEADBAND_MB)
+        }
     }
 
     /**
@@ -638,11 +805,15 @@ class MinimalistOverlayService : LifecycleService() {
                 ramUsagePercent = ramPercent
             )
             
+            // Kernel reclaim activity (major faults, refaults, direct reclaim stalls)
+            val kernelMemory = withContext(Dispatchers.IO) { memoryMonitor.getKernelMemoryInfo() }
+            
             // Calculate optimal interval based on system load
             var optimalInterval = adaptiveMonitor.calculateOptimalInterval(
                 metrics = metrics,
                 isTvDevice = deviceUtils.isTvDevice(),
-                preferredInterval = Constants.OverlayService.UPDATE_INTERVAL_MS
+                preferredInterval = Constants.OverlayService.UPDATE_INTERVAL_MS,
+                memoryReclaiming = kernelMemory?.isUnderPressure == true
             )
             
             // Battery-aware optimization: Adjust interval based on battery level
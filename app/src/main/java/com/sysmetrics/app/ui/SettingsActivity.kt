@@ -8,8 +8,10 @@ import androidx.lifecycle.Lifecycle
 import androidx.lifecycle.ViewModelProvider
 import androidx.lifecycle.lifecycleScope
 import androidx.lifecycle.repeatOnLifecycle
+import androidx.preference.PreferenceManager
 import com.sysmetrics.app.R
 import com.sysmetrics.app.core.SysMetricsApplication
+import com.sysmetrics.app.core.common.Constants
 import com.sysmetrics.app.data.model.OverlayPosition
 import com.sysmetrics.app.data.repository.MetricsHistoryRepository
 import com.sysmetrics.app.databinding.ActivitySettingsBinding
@@ -98,6 +100,13 @@ class SettingsActivity : AppCompatActivity() {
                 exportMetrics(ExportMetricsUseCase.ExportFormat.JSON)
             }
             
+            // Session log toggle; the overlay service starts/stops recording on change
+            val prefs = PreferenceManager.getDefaultSharedPreferences(this@SettingsActivity)
+            switchRecordSession.isChecked = prefs.getBoolean(Constants.SessionRecording.PREF_KEY, false)
+            switchRecordSession.setOnCheckedChangeListener { _, isChecked ->
+                prefs.edit().putBoolean(Constants.SessionRecording.PREF_KEY, isChecked).apply()
+            }
+            
             // Background collection toggle
             switchBackgroundCollection.setOnCheckedChangeListener { _, isChecked ->
                 isBackgroundCollectionEnabled = isChecked
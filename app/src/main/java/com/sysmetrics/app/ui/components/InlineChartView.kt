@@ -11,7 +11,9 @@ import com.sysmetrics.app.data.model.advanced.Severity
 
 /**
  * Custom view for rendering inline sparkline charts.
- * Memory-efficient with smooth Bézier curve rendering.
+ * Drawn by the native rasteriser into a cached bitmap when available
+ * (straight segments, only changed columns repainted); otherwise smooth
+ * Bézier paths.
  */
 class InlineChartView @JvmOverloads constructor(
     context: Context,
@@ -50,6 +52,14 @@ class InlineChartView @JvmOverloads constructor(
     private val colorHigh = Color.parseColor("#F44336")     // Red
     
     private var gradientShader: Shader? = null
+    private var gradientBaseColor = colorLow
+    
+    // Native bitmap renderer, rebuilt when its size, slots or geometry change
+    // and recolored in place when severity changes. A key whose creation
+    // failed stays on the Path fallback.
+    private var sparkline: SparklineBitmap? = null
+    private var sparklineKey: Any? = null
+    private var sparkValues = FloatArray(0)
     
     fun setData(data: ChartData) {
         chartData = data
@@ -72,6 +82,7 @@ class InlineChartView @JvmOverloads constructor(
                 Severity.MEDIUM -> colorMedium
                 Severity.HIGH -> colorHigh
             }
+            gradientBaseColor = baseColor
             
             gradientShader = LinearGradient(
                 0f, 0f, 0f, height.toFloat(),
@@ -93,6 +104,13 @@ class InlineChartView @JvmOverloads constructor(
         updateGradient()
     }
     
+    override fun onDetachedFromWindow() {
+        super.onDetachedFromWindow()
+        sparkline?.destroy()
+        sparkline = null
+        sparklineKey = null
+    }
+    
     override fun onDraw(canvas: Canvas) {
         super.onDraw(canvas)
         
@@ -124,9 +142,6 @@ class InlineChartView @JvmOverloads constructor(
         val points = chartData.points
         if (points.size < 2) return
         
-        linePath.reset()
-        fillPath.reset()
-        
         val padding = 4f * resources.displayMetrics.density
         val chartWidth = width - 2 * padding
         val chartHeight = height - 2 * padding
@@ -135,6 +150,19 @@ class InlineChartView @JvmOverloads constructor(
         val maxVal = chartData.maxValue
         val range = (maxVal - minVal).coerceAtLeast(1f)
         
+        // Line color based on latest severity
+        val latestSeverity = points.lastOrNull()?.severity ?: Severity.LOW
+        val lineColor = when (latestSeverity) {
+            Severity.LOW -> colorLow
+            Severity.MEDIUM -> colorMedium
+            Severity.HIGH -> colorHigh
+        }
+        
+        if (drawNativeChart(canvas, points, padding, minVal, range, lineColor)) return
+        
+        linePath.reset()
+        fillPath.reset()
+        
         // Calculate points
         val pointCoords = points.mapIndexed { index, point ->
             val x = padding + (index.toFloat() / (points.size - 1)) * chartWidth
@@ -168,14 +196,50 @@ class InlineChartView @JvmOverloads constructor(
             fillPaint.shader = gradientShader
             canvas.drawPath(fillPath, fillPaint)
             
-            // Draw line with color based on latest severity
-            val latestSeverity = points.lastOrNull()?.severity ?: Severity.LOW
-            linePaint.color = when (latestSeverity) {
-                Severity.LOW -> colorLow
-                Severity.MEDIUM -> colorMedium
-                Severity.HIGH -> colorHigh
-            }
+            // Draw line
+            linePaint.color = lineColor
             canvas.drawPath(linePath, linePaint)
         }
     }
+    
+    /**
+     * Points sit at fixed slots (maxHistorySize across), so a growing series
+     * extends to the right and a full one scrolls.
+     * @return false to fall back to Path rendering
+     */
+    private fun drawNativeChart(
+        canvas: Canvas,
+        points: List<ChartDataPoint>,
+        padding: Float,
+        minVal: Float,
+        range: Float,
+        lineColor: Int
+    ): Boolean {
+        val slots = maxOf(chartData.maxHistorySize, points.size)
+        val style = SparklineBitmap.Style(
+            background = Color.TRANSPARENT,
+            line = lineColor,
+            fillTop = Color.argb(80, Color.red(gradientBaseColor), Color.green(gradientBaseColor), Color.blue(gradientBaseColor)),
+            fillBottom = Color.argb(10, Color.red(gradientBaseColor), Color.green(gradientBaseColor), Color.blue(gradientBaseColor)),
+            lineWidthPx = linePaint.strokeWidth,
+            paddingPx = padding
+        )
+        val key = listOf(width, height, slots, style.lineWidthPx, style.paddingPx)
+        if (key != sparklineKey) {
+            sparkline?.destroy()
+            sparkline = SparklineBitmap.create(width, height, slots, style)
+            sparklineKey = key
+        }
+        val spark = sparkline ?: return false
+        if (!spark.setColors(style)) return false
+        
+        if (sparkValues.size < slots) sparkValues = FloatArray(slots)
+        points.forEachIndexed { index, point ->
+            sparkValues[index] = (point.value - minVal) / range
+        }
+        if (!spark.render(sparkValues, points.size)) return false
+        
+        canvas.drawBitmap(spark.bitmap, 0f, 0f, null)
+        return true
+    }
 }
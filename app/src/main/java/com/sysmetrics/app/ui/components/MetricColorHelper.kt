@@ -21,6 +21,41 @@ object MetricColorHelper {
     val COLOR_RED = Color.parseColor("#F44336")      // 🔴 Critical
     val COLOR_GRAY = Color.parseColor("#9E9E9E")     // ⚪ N/A
     
+    // Level steps (green→yellow, yellow→orange, orange→red); every
+    // color, emoji and health score below is cut at these points
+    val CPU_STEPS = floatArrayOf(20f, 40f, 70f)
+    val RAM_STEPS = floatArrayOf(50f, 70f, 85f)
+    val GPU_STEPS = floatArrayOf(30f, 50f, 75f)
+    val TEMPERATURE_STEPS = floatArrayOf(45f, 60f, 75f)
+    
+    /**
+     * Get level of a value against its steps.
+     * 
+     * @return 0 (healthy) to 3 (critical)
+     */
+    fun getLevel(value: Float, steps: FloatArray): Int = steps.count { value >= it }
+    
+    /**
+     * Get color for a level from [getLevel].
+     * 
+     * @param level 0 (healthy) to 3 (critical)
+     * @return Color int
+     */
+    fun getLevelColor(level: Int): Int = when (level) {
+        0 -> COLOR_GREEN
+        1 -> COLOR_YELLOW
+        2 -> COLOR_ORANGE
+        3 -> COLOR_RED
+        else -> COLOR_GRAY
+    }
+    
+    private fun getLevelEmoji(level: Int): String = when (level) {
+        0 -> "🟢"
+        1 -> "🟡"
+        2 -> "🟠"
+        else -> "🔴"
+    }
+    
     /**
      * Get color for CPU usage percentage.
      * 
@@ -29,10 +64,7 @@ object MetricColorHelper {
      */
     fun getCpuColor(usage: Float): Int = when {
         usage < 0f -> COLOR_GRAY
-        usage < 20f -> COLOR_GREEN        // 🟢 0-20%
-        usage < 40f -> COLOR_YELLOW       // 🟡 20-40%
-        usage < 70f -> COLOR_ORANGE       // 🟠 40-70%
-        else -> COLOR_RED                 // 🔴 70-100%
+        else -> getLevelColor(getLevel(usage, CPU_STEPS))
     }
     
     /**
@@ -43,10 +75,7 @@ object MetricColorHelper {
      */
     fun getRamColor(usagePercent: Float): Int = when {
         usagePercent < 0f -> COLOR_GRAY
-        usagePercent < 50f -> COLOR_GREEN        // 🟢 0-50%
-        usagePercent < 70f -> COLOR_YELLOW       // 🟡 50-70%
-        usagePercent < 85f -> COLOR_ORANGE       // 🟠 70-85%
-        else -> COLOR_RED                        // 🔴 85-100%
+        else -> getLevelColor(getLevel(usagePercent, RAM_STEPS))
     }
     
     /**
@@ -57,10 +86,7 @@ object MetricColorHelper {
      */
     fun getGpuColor(usage: Float): Int = when {
         usage < 0f -> COLOR_GRAY
-        usage < 30f -> COLOR_GREEN        // 🟢 0-30%
-        usage < 50f -> COLOR_YELLOW       // 🟡 30-50%
-        usage < 75f -> COLOR_ORANGE       // 🟠 50-75%
-        else -> COLOR_RED                 // 🔴 75-100%
+        else -> getLevelColor(getLevel(usage, GPU_STEPS))
     }
     
     /**
@@ -71,10 +97,7 @@ object MetricColorHelper {
      */
     fun getTemperatureColor(celsius: Float): Int = when {
         celsius <= 0f -> COLOR_GRAY
-        celsius < 45f -> COLOR_GREEN        // 🟢 0-45°C Cool
-        celsius < 60f -> COLOR_YELLOW       // 🟡 45-60°C Warm
-        celsius < 75f -> COLOR_ORANGE       // 🟠 60-75°C Hot
-        else -> COLOR_RED                   // 🔴 75+°C Critical
+        else -> getLevelColor(getLevel(celsius, TEMPERATURE_STEPS))
     }
     
     /**
@@ -124,32 +147,19 @@ object MetricColorHelper {
     /**
      * Get emoji indicator for CPU usage.
      */
-    fun getCpuEmoji(usage: Float): String = when {
-        usage < 20f -> "🟢"
-        usage < 40f -> "🟡"
-        usage < 70f -> "🟠"
-        else -> "🔴"
-    }
+    fun getCpuEmoji(usage: Float): String = getLevelEmoji(getLevel(usage, CPU_STEPS))
     
     /**
      * Get emoji indicator for RAM usage.
      */
-    fun getRamEmoji(usagePercent: Float): String = when {
-        usagePercent < 50f -> "🟢"
-        usagePercent < 70f -> "🟡"
-        usagePercent < 85f -> "🟠"
-        else -> "🔴"
-    }
+    fun getRamEmoji(usagePercent: Float): String = getLevelEmoji(getLevel(usagePercent, RAM_STEPS))
     
     /**
      * Get emoji indicator for temperature.
      */
     fun getTemperatureEmoji(celsius: Float): String = when {
         celsius <= 0f -> "❄️"
-        celsius < 45f -> "🟢"
-        celsius < 60f -> "🟡"
-        celsius < 75f -> "🟠"
-        else -> "🔴"
+        else -> getLevelEmoji(getLevel(celsius, TEMPERATURE_STEPS))
     }
     
     /**
@@ -160,28 +170,9 @@ object MetricColorHelper {
         ramUsagePercent: Float,
         temperature: Float
     ): String {
-        val cpuScore = when {
-            cpuUsage < 20f -> 0
-            cpuUsage < 40f -> 1
-            cpuUsage < 70f -> 2
-            else -> 3
-        }
-        
-        val ramScore = when {
-            ramUsagePercent < 50f -> 0
-            ramUsagePercent < 70f -> 1
-            ramUsagePercent < 85f -> 2
-            else -> 3
-        }
-        
-        val tempScore = if (temperature > 0f) {
-            when {
-                temperature < 45f -> 0
-                temperature < 60f -> 1
-                temperature < 75f -> 2
-                else -> 3
-            }
-        } else 0
+        val cpuScore = getLevel(cpuUsage, CPU_STEPS)
+        val ramScore = getLevel(ramUsagePercent, RAM_STEPS)
+        val tempScore = if (temperature > 0f) getLevel(temperature, TEMPERATURE_STEPS) else 0
         
         val totalScore = cpuScore + ramScore + tempScore
         
@@ -0,0 +1,88 @@
+package com.sysmetrics.app.ui.components
+
+import android.graphics.Bitmap
+import com.sysmetrics.app.domain.analytics.ChartDataBuffer
+import com.sysmetrics.app.native_bridge.NativeAnalytics
+
+/**
+ * Sparkline rendered natively into an ARGB_8888 bitmap: anti-aliased line
+ * over a vertical gradient fill, point i at slot i of [slots].
+ *
+ * The renderer remembers what it drew, so each render only repaints the
+ * columns whose points changed (a scroll by one sample is a row shift plus
+ * a few columns). Draw [bitmap] directly or hand it to a RemoteViews.
+ * Not thread-safe; call [destroy] when done.
+ */
+class SparklineBitmap private constructor(
+    private var handle: Long,
+    val bitmap: Bitmap,
+    val slots: Int
+) {
+    /**
+     * Render a chart buffer's normalized series (its newest [slots] points).
+     * @return false if the buffer has no native backing or rendering failed
+     */
+    fun render(buffer: ChartDataBuffer): Boolean {
+        val chart = buffer.nativeChartHandle
+        if (handle == 0L || chart == 0L) return false
+        return NativeAnalytics.sparkRenderChart(handle, chart, bitmap) >= 0
+    }
+
+    /**
+     * Render the first [count] normalized values (0-1, oldest first).
+     */
+    fun render(values: FloatArray, count: Int = values.size): Boolean {
+        if (handle == 0L) return false
+        return NativeAnalytics.sparkRenderValues(handle, values, count, bitmap) >= 0
+    }
+
+    /**
+     * Repaint everything on the next render, e.g. after erasing the bitmap.
+     */
+    fun invalidate() {
+        if (handle != 0L) NativeAnalytics.sparkInvalidate(handle)
+    }
+
+    /**
+     * Recolor in place (size, slots, line width and padding are kept); the
+     * next render repaints the whole bitmap.
+     */
+    fun setColors(style: Style): Boolean {
+        if (handle == 0L) return false
+        return NativeAnalytics.sparkSetColors(handle, style.background, style.line, style.fillTop, style.fillBottom)
+    }
+
+    fun destroy() {
+        if (handle != 0L) {
+            NativeAnalytics.sparkDestroy(handle)
+            handle = 0L
+        }
+        bitmap.recycle()
+    }
+
+    data class Style(
+        val background: Int,
+        val line: Int,
+        val fillTop: Int,
+        val fillBottom: Int,
+        val lineWidthPx: Float,
+        val paddingPx: Float
+    )
+
+    companion object {
+        /**
+         * @return null when the native library is unavailable or the size
+         * or style is out of range (max 1024 x 256 pixels, 2..512 slots)
+         */
+        fun create(width: Int, height: Int, slots: Int, style: Style): SparklineBitmap? {
+            if (!NativeAnalytics.isAvailable() || width <= 0 || height <= 0) return null
+            val handle = NativeAnalytics.sparkCreate(
+                width, height, slots,
+                style.background, style.line, style.fillTop, style.fillBottom,
+                style.lineWidthPx, style.paddingPx
+            )
+            if (handle == 0L) return null
+            return SparklineBitmap(handle, Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888), slots)
+        }
+    }
+}
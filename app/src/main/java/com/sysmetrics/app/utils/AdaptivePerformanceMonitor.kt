@@ -27,6 +27,8 @@ class AdaptivePerformanceMonitor {
     
     private var currentInterval: Long = Constants.AdaptiveIntervals.NORMAL
     private var lastCheckTime: Long = 0L
+    @Volatile
+    private var stallTriggersArmed = false
     
     /**
      * Calculate optimal update interval based on system metrics.
@@ -34,12 +36,14 @@ class AdaptivePerformanceMonitor {
      * @param metrics Current system metrics
      * @param isTvDevice Whether device is Android TV
      * @param preferredInterval User's preferred interval
+     * @param memoryReclaiming Kernel is reclaiming under pressure (MemoryMonitor.KernelMemoryInfo)
      * @return Optimal update interval in milliseconds
      */
     fun calculateOptimalInterval(
         metrics: SystemMetrics,
         isTvDevice: Boolean,
-        preferredInterval: Long = Constants.AdaptiveIntervals.NORMAL
+        preferredInterval: Long = Constants.AdaptiveIntervals.NORMAL,
+        memoryReclaiming: Boolean = false
     ): Long {
         val now = System.currentTimeMillis()
         
@@ -50,8 +54,10 @@ class AdaptivePerformanceMonitor {
         
         lastCheckTime = now
         
-        // Determine load level
-        val loadLevel = determineLoadLevel(metrics)
+        // Determine load level; reclaim pressure counts as HIGH even when free RAM looks fine
+        val loadLevel = determineLoadLevel(metrics).let {
+            if (memoryReclaiming && it < LoadLevel.HIGH) LoadLevel.HIGH else it
+        }
         
         val newInterval = when {
             // Critical load - slow down significantly
@@ -78,6 +84,10 @@ class AdaptivePerformanceMonitor {
             
             // Default
             else -> preferredInterval.coerceIn(Constants.AdaptiveIntervals.FAST, Constants.AdaptiveIntervals.SLOW)
+        }.let {
+            // Stalls are sampled as the kernel reports them, so the periodic
+            // base rate no longer has to be fast enough to catch them
+            if (stallTriggersArmed) maxOf(it, Constants.AdaptiveIntervals.NORMAL) else it
         }
         
         if (newInterval != currentInterval) {
@@ -123,6 +133,14 @@ class AdaptivePerformanceMonitor {
         }
     }
     
+    /**
+     * Set while kernel PSI triggers are armed: the caller samples as soon as
+     * a stall is reported, so intervals never go below NORMAL.
+     */
+    fun setStallTriggersArmed(armed: Boolean) {
+        stallTriggersArmed = armed
+    }
+    
     /**
      * Reset the monitor state.
      */
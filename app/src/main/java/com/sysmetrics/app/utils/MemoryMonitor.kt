@@ -3,6 +3,7 @@ package com.sysmetrics.app.utils
 import android.app.ActivityManager
 import android.content.Context
 import android.os.Debug
+import com.sysmetrics.app.native_bridge.NativeMemory
 import timber.log.Timber
 
 /**
@@ -17,7 +18,28 @@ class MemoryMonitor(private val context: Context) {
     companion object {
         private const val TAG = "MEMORY_MONITOR"
         private const val MB = 1024 * 1024L
+
+        // Kernel counters read through NativeMemory, in KernelMemoryInfo order
+        private val KERNEL_FIELDS = intArrayOf(
+            NativeMemory.SWAP_TOTAL,
+            NativeMemory.SWAP_FREE,
+            NativeMemory.CACHED,
+            NativeMemory.SHMEM,
+            NativeMemory.SLAB,
+            NativeMemory.ZRAM_USED,
+            NativeMemory.VM_PGMAJFAULT,
+            NativeMemory.VM_PSWPOUT,
+            NativeMemory.VM_ALLOCSTALL,
+            NativeMemory.VM_WORKINGSET_REFAULT
+        )
+
+        // Reclaim activity that means real pressure rather than cache growth
+        private const val PRESSURE_MAJFAULT_PER_SEC = 100.0
+        private const val PRESSURE_REFAULT_PER_SEC = 500.0
     }
+
+    private var kernelHandle = 0L
+    private val kernelValues = DoubleArray(KERNEL_FIELDS.size)
     
     /**
      * Get current memory info.
@@ -65,8 +87,67 @@ class MemoryMonitor(private val context: Context) {
         if (info.isLowMemory) {
             Timber.tag(TAG).e("🔴 System is running low on memory!")
         }
+
+        getKernelMemoryInfo()?.let { kernel ->
+            Timber.tag(TAG).d(
+                "Kernel: cached=%dMB shmem=%dMB slab=%dMB zram=%dMB swap=%dMB, " +
+                    "majflt=%.0f/s swpout=%.0f/s stalls=%.1f/s refault=%.0f/s",
+                kernel.cachedKb / 1024, kernel.shmemKb / 1024, kernel.slabKb / 1024,
+                kernel.zramUsedKb / 1024, kernel.swapUsedKb / 1024,
+                kernel.majorFaultsPerSec, kernel.swapOutPerSec,
+                kernel.allocStallsPerSec, kernel.refaultsPerSec
+            )
+            if (kernel.isUnderPressure) {
+                Timber.tag(TAG).w("⚠️ Kernel is reclaiming under pressure")
+            }
+        }
     }
     
+    /**
+     * Kernel-side memory breakdown and reclaim rates since the previous
+     * call, or null without the native library.
+     */
+    @Synchronized
+    fun getKernelMemoryInfo(): KernelMemoryInfo? {
+        if (!NativeMemory.isAvailable()) return null
+
+        return runCatching {
+            if (kernelHandle == 0L) {
+                kernelHandle = NativeMemory.register(KERNEL_FIELDS)
+                if (kernelHandle == 0L) return@runCatching null
+            }
+            if (NativeMemory.read(kernelHandle, kernelValues) != KERNEL_FIELDS.size) {
+                return@runCatching null
+            }
+
+            KernelMemoryInfo(
+                swapUsedKb = (kernelValues[0] - kernelValues[1]).toLong(),
+                cachedKb = kernelValues[2].toLong(),
+                shmemKb = kernelValues[3].toLong(),
+                slabKb = kernelValues[4].toLong(),
+                zramUsedKb = kernelValues[5].toLong(),
+                majorFaultsPerSec = kernelValues[6],
+                swapOutPerSec = kernelValues[7],
+                allocStallsPerSec = kernelValues[8],
+                refaultsPerSec = kernelValues[9]
+            )
+        }.getOrElse { e ->
+            Timber.tag(TAG).w(e, "Failed to read kernel memory counters")
+            null
+        }
+    }
+
+    /**
+     * Release the native field registration.
+     */
+    @Synchronized
+    fun release() {
+        if (kernelHandle != 0L) {
+            runCatching { NativeMemory.unregister(kernelHandle) }
+            kernelHandle = 0L
+        }
+    }
+
     /**
      * Check if memory usage is critical.
      */
@@ -85,6 +166,28 @@ class MemoryMonitor(private val context: Context) {
         System.gc()
     }
     
+    /**
+     * Kernel memory breakdown. Rates are per second over the interval since
+     * the previous read; a growing page cache alone is not pressure, direct
+     * reclaim stalls, major faults and refaults are.
+     */
+    data class KernelMemoryInfo(
+        val swapUsedKb: Long,
+        val cachedKb: Long,
+        val shmemKb: Long,
+        val slabKb: Long,
+        val zramUsedKb: Long,
+        val majorFaultsPerSec: Double,
+        val swapOutPerSec: Double,
+        val allocStallsPerSec: Double,
+        val refaultsPerSec: Double
+    ) {
+        val isUnderPressure: Boolean
+            get() = allocStallsPerSec > 0.0 ||
+                majorFaultsPerSec > PRESSURE_MAJFAULT_PER_SEC ||
+                refaultsPerSec > PRESSURE_REFAULT_PER_SEC
+    }
+
     /**
      * Memory information data class.
      */
@@ -1,6 +1,10 @@
 package com.sysmetrics.app.utils
 
 import android.os.SystemClock
+import com.sysmetrics.app.native_bridge.NativeProbeStats
+import com.sysmetrics.app.native_bridge.NativeProfiler
+import com.sysmetrics.app.native_bridge.NativeSharedSnapshot
+import com.sysmetrics.app.native_bridge.ThreadCpuStats
 import timber.log.Timber
 
 /**
@@ -11,6 +15,8 @@ object PerformanceMonitor {
     
     @PublishedApi
     internal const val TAG = "PERFORMANCE"
+
+    private const val TOP_THREADS_LOGGED = 5
     
     @PublishedApi
     internal val measurements = mutableMapOf<String, MutableList<Long>>()
@@ -83,6 +89,69 @@ object PerformanceMonitor {
                 Timber.tag(TAG).i("  $label: avg=${stats.avg.toInt()}ms, min=${stats.min}ms, max=${stats.max}ms (n=${stats.count})")
             }
         }
+
+        val nativeStats = getNativeStats()
+        if (nativeStats.isNotEmpty()) {
+            Timber.tag(TAG).i("📊 Native Statistics:")
+            nativeStats.forEach { (name, stats) ->
+                Timber.tag(TAG).i(
+                    "  $name: p50=${stats.p50Ns / 1000}μs, p99=${stats.p99Ns / 1000}μs, " +
+                        "max=${stats.maxNs / 1000}μs (n=${stats.calls}, errors=${stats.errors})"
+                )
+            }
+        }
+
+        val threadStats = getThreadStats().filter { it.isValid }.take(TOP_THREADS_LOGGED)
+        if (threadStats.isNotEmpty()) {
+            Timber.tag(TAG).i("📊 Thread Statistics:")
+            threadStats.forEach { thread ->
+                Timber.tag(TAG).i(
+                    "  ${thread.name} (${thread.tid}): cpu=%.1f%%, cs=%d/%d",
+                    thread.cpuPercent, thread.voluntarySwitches, thread.involuntarySwitches
+                )
+            }
+        }
+    }
+
+    /**
+     * Enable or disable timing of native entry points.
+     */
+    fun setNativeProfilingEnabled(enabled: Boolean) {
+        if (NativeProfiler.isAvailable()) {
+            NativeProfiler.setEnabled(enabled)
+        }
+    }
+
+    /**
+     * Per-function native latency (p50/p90/p99 in nanoseconds), keyed by
+     * native function name. Empty while native profiling is disabled.
+     */
+    fun getNativeStats(): Map<String, NativeProbeStats> = NativeProfiler.getStats()
+
+    /**
+     * Per-thread CPU% and context switches of this process since the
+     * previous call, most expensive first.
+     */
+    fun getThreadStats(): List<ThreadCpuStats> = NativeProfiler.getThreadStats()
+
+    /**
+     * Record every sample the overlay publishes to a binary session log for
+     * offline replay (sysmetrics_replay). Stopped with the overlay service.
+     * @return false if the native library is missing or path is not writable
+     */
+    fun startSessionRecording(path: String): Boolean {
+        if (!NativeSharedSnapshot.isAvailable()) return false
+        return runCatching { NativeSharedSnapshot.startRecording(path) }.getOrDefault(false)
+    }
+
+    /**
+     * @return Samples written to the session log, or -1 if not recording
+     */
+    fun stopSessionRecording(): Long {
+        if (!NativeSharedSnapshot.isAvailable()) return -1
+        val samples = runCatching { NativeSharedSnapshot.stopRecording() }.getOrDefault(-1L)
+        if (samples >= 0) Timber.tag(TAG).i("📼 Session log closed: $samples samples")
+        return samples
     }
     
     /**
@@ -90,6 +159,9 @@ object PerformanceMonitor {
      */
     fun clear() {
         measurements.clear()
+        if (NativeProfiler.isAvailable()) {
+            NativeProfiler.reset()
+        }
     }
     
     /**
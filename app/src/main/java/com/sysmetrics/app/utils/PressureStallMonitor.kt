@@ -0,0 +1,99 @@
+package com.sysmetrics.app.utils
+
+import com.sysmetrics.app.core.common.Constants
+import com.sysmetrics.app.native_bridge.NativePressure
+import timber.log.Timber
+
+/**
+ * Watches kernel PSI triggers on a dedicated thread and reports stalls.
+ *
+ * The thread sleeps in poll() until memory or CPU stall time crosses the
+ * configured threshold, so the overlay does not have to sample /proc/pressure
+ * to notice a stall. If no trigger can be registered (no CONFIG_PSI, or the
+ * kernel/SELinux refuses unprivileged triggers) start() returns false and
+ * callers keep relying on their periodic checks.
+ */
+class PressureStallMonitor(
+    private val onStall: (firedMask: Int) -> Unit
+) {
+
+    companion object {
+        private const val TAG = "PSI_MONITOR"
+    }
+
+    @Volatile
+    private var running = false
+    private var watcher: Thread? = null
+
+    /**
+     * Register triggers and start the watcher thread.
+     * @return true if at least one trigger is armed
+     */
+    fun start(): Boolean {
+        if (running) return true
+        if (!NativePressure.isAvailable()) return false
+        // A watcher left over from a timed-out stop() clears the triggers on its way out
+        watcher?.join()
+        watcher = null
+
+        val armed = listOf(
+            NativePressure.addTrigger(
+                NativePressure.MEMORY, false,
+                Constants.PressureTriggers.MEMORY_STALL_US, Constants.PressureTriggers.WINDOW_US
+            ),
+            NativePressure.addTrigger(
+                NativePressure.CPU, false,
+                Constants.PressureTriggers.CPU_STALL_US, Constants.PressureTriggers.WINDOW_US
+            )
+        ).count { it >= 0 }
+
+        if (armed == 0) {
+            Timber.tag(TAG).i("PSI triggers unavailable - falling back to periodic checks")
+            return false
+        }
+
+        running = true
+        watcher = Thread(::watchLoop, "psi-watcher").apply {
+            isDaemon = true
+            start()
+        }
+        Timber.tag(TAG).i("PSI watcher started with %d trigger(s)", armed)
+        return true
+    }
+
+    fun isRunning(): Boolean = running
+
+    /**
+     * Stop the watcher thread. The watcher releases the kernel triggers
+     * itself once it is out of poll(), so a join that times out never
+     * closes descriptors still being polled.
+     */
+    fun stop() {
+        if (!running) return
+
+        running = false
+        NativePressure.wake()
+        watcher?.join(Constants.PressureTriggers.STOP_TIMEOUT_MS)
+        if (watcher?.isAlive == false) watcher = null
+    }
+
+    private fun watchLoop() {
+        try {
+            while (running) {
+                val fired = NativePressure.waitForTrigger(Constants.PressureTriggers.POLL_TIMEOUT_MS)
+                when {
+                    fired < 0 -> {
+                        Timber.tag(TAG).w("PSI wait failed - stopping watcher")
+                        running = false
+                    }
+                    fired > 0 && running -> {
+                        Timber.tag(TAG).d("PSI trigger fired (mask=0x%x)", fired)
+                        onStall(fired)
+                    }
+                }
+            }
+        } finally {
+            NativePressure.clearTriggers()
+        }
+    }
+}
@@ -8,6 +8,7 @@ import com.sysmetrics.app.core.common.Constants
 import com.sysmetrics.app.core.di.DispatcherProvider
 import com.sysmetrics.app.domain.collector.ICpuMetricsCollector
 import com.sysmetrics.app.domain.collector.IProcessStatsCollector
+import com.sysmetrics.app.native_bridge.NativeMetrics
 import java.io.File
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.withContext
@@ -70,7 +71,8 @@ class ProcessStatsCollector(
             kotlinx.coroutines.delay(100)
         }
         
-        val stats = getStatsForPid(pid, "com.sysmetrics.app")
+        val nativeMemory = NativeMetrics.getProcessMemoryNative(intArrayOf(pid))
+        val stats = getStatsForPid(pid, "com.sysmetrics.app", nativeMemory[pid])
         
         if (stats != null) {
             Timber.tag(TAG_CPU).d("✅ Self stats: CPU=%.2f%%, RAM=%dMB", stats.cpuPercent, stats.ramMb)
@@ -105,41 +107,17 @@ class ProcessStatsCollector(
             val runningApps = activityManager.runningAppProcesses ?: emptyList()
             Timber.tag(TAG_TOP).v("📱 Found %d running processes", runningApps.size)
             
-            val appStatsList = mutableListOf<AppStats>()
-
-            for (appProcess in runningApps) {
+            val candidates = runningApps.filter { appProcess ->
                 val packageName = appProcess.processName.split(":")[0]
-                
-                // Skip current app (SysMetrics)
-                if (packageName == context.packageName) {
-                    continue
-                }
-
-                // Check if it's a user-installed app
-                if (!isUserApp(packageName)) {
-                    continue
-                }
-
-                // Get stats for this process
-                val stats = getStatsForPid(appProcess.pid, appProcess.processName)
-                
-                // Only include apps with measurable resource usage
-                if (stats != null && (stats.cpuPercent > Constants.ProcessMonitoring.MIN_CPU_THRESHOLD || 
-                    stats.ramMb > Constants.ProcessMonitoring.MIN_RAM_THRESHOLD_MB)) {
-                    appStatsList.add(stats)
-                }
+                // Skip current app (SysMetrics) and system apps
+                packageName != context.packageName && isUserApp(packageName)
             }
 
-            Timber.tag(TAG_TOP).d("📊 Collected %d user apps with measurable usage", appStatsList.size)
-            
-            // Sort by specified criteria
-            val sorted = when (sortBy.lowercase()) {
-                "cpu" -> appStatsList.sortedByDescending { it.cpuPercent }
-                "ram" -> appStatsList.sortedByDescending { it.ramMb }
-                else -> appStatsList.sortedByDescending { it.combinedScore }
-            }
+            Timber.tag(TAG_TOP).d("📊 Ranking %d user app candidates", candidates.size)
 
-            val result = sorted.take(count)
+            // Native bounded-heap ranking; labels are resolved for the winners only
+            val result = rankTopAppsNative(candidates, count, sortBy)
+                ?: rankTopAppsKotlin(candidates, count, sortBy)
             
             // Log top apps
             result.forEachIndexed { index, app ->
@@ -155,6 +133,98 @@ class ProcessStatsCollector(
         }
     }
     
+    /**
+     * Rank candidates over a packed table (pid order): CPU and RAM go into
+     * primitive arrays and the native ranker returns the winning rows, so
+     * no AppStats or label lookups are made for the others.
+     * @return Ranked apps, or null when native ranking is unavailable
+     */
+    private fun rankTopAppsNative(
+        candidates: List<ActivityManager.RunningAppProcessInfo>,
+        count: Int,
+        sortBy: String
+    ): List<AppStats>? {
+        val size = candidates.size
+        if (count > NativeMetrics.RANK_TOP_MAX || size > NativeMetrics.RANK_MAX_PROCESSES) return null
+        if (size == 0) return emptyList()
+
+        // One native batch read instead of a Binder call per pid
+        val pids = IntArray(size) { candidates[it].pid }
+        val ramKb = LongArray(size)
+        if (!NativeMetrics.getProcessRamKbInto(pids, ramKb)) ramKb.fill(-1L)
+        val cpuPercent = FloatArray(size)
+        for (row in 0 until size) {
+            if (ramKb[row] < 0) ramKb[row] = runCatching { readPssKb(pids[row]) }.getOrDefault(0L)
+            cpuPercent[row] = calculateCpuUsageForPid(pids[row])
+        }
+
+        val winners = IntArray(count)
+        val ranked = NativeMetrics.rankProcessesNative(
+            cpuPercent, ramKb, size, rankKey(sortBy), count,
+            Constants.ProcessMonitoring.MIN_CPU_THRESHOLD,
+            Constants.ProcessMonitoring.MIN_RAM_THRESHOLD_MB,
+            Constants.ProcessMonitoring.CPU_SCORE_WEIGHT,
+            Constants.ProcessMonitoring.RAM_SCORE_WEIGHT_DIVISOR,
+            winners
+        )
+        if (ranked < 0) return null
+
+        return List(ranked) { i ->
+            val row = winners[i]
+            val processName = candidates[row].processName
+            AppStats(
+                packageName = processName,
+                appName = resolveAppName(processName),
+                cpuPercent = cpuPercent[row],
+                ramMb = ramKb[row].coerceAtLeast(0L) / 1024
+            )
+        }
+    }
+
+    /**
+     * Fallback without the native library: full stats for every candidate,
+     * then sort and take.
+     */
+    private fun rankTopAppsKotlin(
+        candidates: List<ActivityManager.RunningAppProcessInfo>,
+        count: Int,
+        sortBy: String
+    ): List<AppStats> {
+        val nativeMemory = NativeMetrics.getProcessMemoryNative(
+            IntArray(candidates.size) { candidates[it].pid }
+        )
+
+        val appStatsList = mutableListOf<AppStats>()
+
+        for (appProcess in candidates) {
+            // Get stats for this process
+            val stats = getStatsForPid(appProcess.pid, appProcess.processName, nativeMemory[appProcess.pid])
+            
+            // Only include apps with measurable resource usage
+            if (stats != null && (stats.cpuPercent > Constants.ProcessMonitoring.MIN_CPU_THRESHOLD || 
+                stats.ramMb > Constants.ProcessMonitoring.MIN_RAM_THRESHOLD_MB)) {
+                appStatsList.add(stats)
+            }
+        }
+
+        Timber.tag(TAG_TOP).d("📊 Collected %d user apps with measurable usage", appStatsList.size)
+        
+        // Sort by specified criteria
+        val sorted = when (rankKey(sortBy)) {
+            NativeMetrics.RANK_BY_CPU -> appStatsList.sortedByDescending { it.cpuPercent }
+            NativeMetrics.RANK_BY_RAM -> appStatsList.sortedByDescending { it.ramMb }
+            else -> appStatsList.sortedByDescending { it.combinedScore }
+        }
+
+        return sorted.take(count)
+    }
+
+    private fun rankKey(sortBy: String): Int = when (sortBy.lowercase()) {
+        "cpu" -> NativeMetrics.RANK_BY_CPU
+        "ram" -> NativeMetrics.RANK_BY_RAM
+        else -> NativeMetrics.RANK_BY_COMBINED
+    }
+
     /**
      * Get top apps by CPU usage specifically
      */
@@ -190,39 +260,32 @@ class ProcessStatsCollector(
 
     /**
      * Get stats for specific PID
+     * @param nativeMemory Result of the native batch read, or null when
+     *        /proc/<pid> is not readable (falls back to ActivityManager)
      */
-    private fun getStatsForPid(pid: Int, processName: String): AppStats? {
+    private fun getStatsForPid(
+        pid: Int,
+        processName: String,
+        nativeMemory: NativeMetrics.ProcessMemoryData? = null
+    ): AppStats? {
         try {
             // Get RAM usage
-            val memoryInfo = android.app.ActivityManager.MemoryInfo()
-            activityManager.getMemoryInfo(memoryInfo)
-            
-            val pids = intArrayOf(pid)
-            val processMemInfo = activityManager.getProcessMemoryInfo(pids)
-            val ramKb = if (processMemInfo.isNotEmpty()) {
-                processMemInfo[0].totalPss.toLong()
-            } else 0L
+            val ramKb = if (nativeMemory != null) {
+                Timber.tag(TAG_RAM).v("🚀 Native memory for PID %d: pss=%dKB rss=%dKB",
+                    pid, nativeMemory.pssKb, nativeMemory.rssKb)
+                nativeMemory.bestEstimateKb
+            } else {
+                readPssKb(pid)
+            }
             
             val ramMb = ramKb / 1024
 
             // Get CPU usage
             val cpuPercent = calculateCpuUsageForPid(pid)
 
-            // Get app name (human-readable)
-            val appName = try {
-                val appInfo = packageManager.getApplicationInfo(processName, 0)
-                val label = packageManager.getApplicationLabel(appInfo).toString()
-                Timber.tag(TAG_NAME).v("📱 %s → %s", processName, label)
-                label
-            } catch (e: Exception) {
-                val fallback = processName.split(":")[0]
-                Timber.tag(TAG_NAME).v("⚠️ Failed to get label for %s, using: %s", processName, fallback)
-                fallback
-            }
-
             return AppStats(
                 packageName = processName,
-                appName = appName,
+                appName = resolveAppName(processName),
                 cpuPercent = cpuPercent,
                 ramMb = ramMb
             )
@@ -233,6 +296,34 @@ class ProcessStatsCollector(
         }
     }
 
+    /**
+     * PSS through ActivityManager, for processes whose /proc entry is not
+     * readable by the native batch read.
+     */
+    private fun readPssKb(pid: Int): Long {
+        val processMemInfo = activityManager.getProcessMemoryInfo(intArrayOf(pid))
+        return if (processMemInfo.isNotEmpty()) {
+            processMemInfo[0].totalPss.toLong()
+        } else 0L
+    }
+
+    /**
+     * Human-readable app name, falling back to the package part of the
+     * process name.
+     */
+    private fun resolveAppName(processName: String): String {
+        return try {
+            val appInfo = packageManager.getApplicationInfo(processName, 0)
+            val label = packageManager.getApplicationLabel(appInfo).toString()
+            Timber.tag(TAG_NAME).v("📱 %s → %s", processName, label)
+            label
+        } catch (e: Exception) {
+            val fallback = processName.split(":")[0]
+            Timber.tag(TAG_NAME).v("⚠️ Failed to get label for %s, using: %s", processName, fallback)
+            fallback
+        }
+    }
+
     /**
      * Calculate CPU usage for specific PID (optimized)
      * Uses delta measurement with proper timing for accuracy under load
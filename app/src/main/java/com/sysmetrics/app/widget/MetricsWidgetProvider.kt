@@ -6,25 +6,43 @@ import android.appwidget.AppWidgetProvider
 import android.content.ComponentName
 import android.content.Context
 import android.content.Intent
+import android.graphics.Bitmap
+import android.graphics.Color
+import android.view.View
 import android.widget.RemoteViews
 import com.sysmetrics.app.R
+import com.sysmetrics.app.data.model.advanced.MetricType
+import com.sysmetrics.app.domain.analytics.ChartDataBuffer
+import com.sysmetrics.app.native_bridge.NativeSharedSnapshot
 import com.sysmetrics.app.ui.MainActivityOverlay
+import com.sysmetrics.app.ui.components.SparklineBitmap
 import timber.log.Timber
 import java.io.File
 
 /**
  * Widget provider for displaying system metrics on the home screen.
- * Shows CPU and RAM usage with color indicators.
+ * Shows CPU and RAM usage with color indicators, plus a CPU history
+ * sparkline when the native renderer is available.
  */
 class MetricsWidgetProvider : AppWidgetProvider() {
 
     companion object {
         private const val TAG = "MetricsWidget"
         const val ACTION_REFRESH = "com.sysmetrics.app.widget.ACTION_REFRESH"
+
+        // Overlay snapshots older than this are ignored and the widget collects itself
+        private const val SNAPSHOT_MAX_AGE_MS = 10_000L
         
         // Cache for CPU delta calculation
         private var lastCpuTotal = 0L
         private var lastCpuIdle = 0L
+
+        // CPU history for the sparkline, kept while the process lives
+        private const val CHART_POINTS = 60
+        private const val CHART_WIDTH_DP = 180
+        private const val CHART_HEIGHT_DP = 32
+        private val cpuHistory by lazy { ChartDataBuffer(MetricType.CPU, CHART_POINTS) }
+        private var cpuSparkline: SparklineBitmap? = null
         
         /**
          * Update all widgets.
@@ -69,14 +87,22 @@ class MetricsWidgetProvider : AppWidgetProvider() {
         appWidgetId: Int
     ) {
         try {
-            val cpuUsage = getCpuUsage()
-            val ramUsage = getRamUsage(context)
+            // Reuse the overlay's latest sample when it is running
+            val snapshot = NativeSharedSnapshot.readLatest()?.takeIf { it.ageMs() in 0..SNAPSHOT_MAX_AGE_MS }
+            val cpuUsage = snapshot?.takeIf { it.has(NativeSharedSnapshot.CPU_PERCENT) }
+                ?.get(NativeSharedSnapshot.CPU_PERCENT)?.toFloat() ?: getCpuUsage()
+            val ramUsage = snapshot?.takeIf { it.has(NativeSharedSnapshot.RAM_PERCENT) }
+                ?.get(NativeSharedSnapshot.RAM_PERCENT)?.toFloat() ?: getRamUsage(context)
             
             val views = RemoteViews(context.packageName, R.layout.widget_metrics).apply {
                 // CPU
                 setTextViewText(R.id.tvWidgetCpuValue, String.format("%.0f%%", cpuUsage))
                 setInt(R.id.tvWidgetCpuValue, "setTextColor", getColorForValue(context, cpuUsage))
                 setProgressBar(R.id.pbWidgetCpu, 100, cpuUsage.toInt(), false)
+                renderCpuSparkline(context, cpuUsage)?.let { bitmap ->
+                    setImageViewBitmap(R.id.ivWidgetCpuChart, bitmap)
+                    setViewVisibility(R.id.ivWidgetCpuChart, View.VISIBLE)
+                }
                 
                 // RAM
                 setTextViewText(R.id.tvWidgetRamValue, String.format("%.0f%%", ramUsage))
@@ -110,6 +136,30 @@ class MetricsWidgetProvider : AppWidgetProvider() {
         }
     }
 
+    /**
+     * Append the sample and render the history natively; null without the
+     * native renderer (the chart view then stays gone).
+     */
+    private fun renderCpuSparkline(context: Context, cpuUsage: Float): Bitmap? {
+        cpuHistory.add(cpuUsage)
+        val sparkline = cpuSparkline ?: run {
+            val density = context.resources.displayMetrics.density
+            val color = context.getColor(R.color.metric_success)
+            val style = SparklineBitmap.Style(
+                background = Color.TRANSPARENT,
+                line = color,
+                fillTop = Color.argb(96, Color.red(color), Color.green(color), Color.blue(color)),
+                fillBottom = Color.argb(8, Color.red(color), Color.green(color), Color.blue(color)),
+                lineWidthPx = 1.5f * density,
+                paddingPx = 2f * density
+            )
+            SparklineBitmap.create(
+                (CHART_WIDTH_DP * density).toInt(), (CHART_HEIGHT_DP * density).toInt(), CHART_POINTS, style
+            )?.also { cpuSparkline = it }
+        } ?: return null
+        return if (sparkline.render(cpuHistory)) sparkline.bitmap else null
+    }
+
     private fun getCpuUsage(): Float {
         return try {
             val statFile = File("/proc/stat")
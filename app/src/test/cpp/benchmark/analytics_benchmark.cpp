@@ -0,0 +1,414 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "native_analytics.h"
+#include "native_anomaly.h"
+#include "native_frames.h"
+#include "native_instrument.h"
+#include "native_process_rank.h"
+#include "native_publish.h"
+#include "native_rules.h"
+#include "native_session.h"
+#include "native_shared_snapshot.h"
+#include "native_sparkline.h"
+
+/**
+ * Analytics engine benchmarks. Buffers are filled with a deterministic
+ * pseudo-random series at 2 samples/sec, the rate the overlay produces.
+ */
+namespace {
+
+constexpr int64_t SAMPLE_INTERVAL_MS = 500;
+
+float next_value(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 100.0f;
+}
+
+void fill_buffer(CircularBuffer* buffer, int32_t count) {
+    uint32_t seed = 42;
+    for (int32_t i = 0; i < count; i++) {
+        native_buffer_push(buffer, next_value(seed), i * SAMPLE_INTERVAL_MS);
+    }
+}
+
+}  // namespace
+
+static void BM_BufferPush(benchmark::State& state) {
+    CircularBuffer buffer;
+    native_buffer_init(&buffer, MAX_BUFFER_SIZE);
+    uint32_t seed = 7;
+    int64_t ts = 0;
+    for (auto _ : state) {
+        native_buffer_push(&buffer, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    benchmark::DoNotOptimize(buffer.count);
+    native_buffer_free(&buffer);
+}
+BENCHMARK(BM_BufferPush);
+
+static void BM_BufferPushTrim(benchmark::State& state) {
+    CircularBuffer buffer;
+    native_buffer_init(&buffer, MAX_BUFFER_SIZE);
+    uint32_t seed = 7;
+    int64_t ts = 0;
+    for (auto _ : state) {
+        native_buffer_trim(&buffer, ts - WINDOW_1M);
+        native_buffer_push(&buffer, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    benchmark::DoNotOptimize(buffer.count);
+    native_buffer_free(&buffer);
+}
+BENCHMARK(BM_BufferPushTrim);
+
+static void BM_CalcAverage(benchmark::State& state) {
+    CircularBuffer buffer;
+    native_buffer_init(&buffer, static_cast<int32_t>(state.range(0)));
+    fill_buffer(&buffer, buffer.capacity);
+    int64_t now = buffer.newest_timestamp;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_calc_average(&buffer, WINDOW_5M, now));
+    }
+    native_buffer_free(&buffer);
+}
+BENCHMARK(BM_CalcAverage)->Arg(64)->Arg(MAX_BUFFER_SIZE);
+
+static void BM_CalcPercentile(benchmark::State& state) {
+    CircularBuffer buffer;
+    native_buffer_init(&buffer, static_cast<int32_t>(state.range(0)));
+    fill_buffer(&buffer, buffer.capacity);
+    int64_t now = buffer.newest_timestamp;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_calc_percentile(&buffer, 95, WINDOW_5M, now));
+    }
+    native_buffer_free(&buffer);
+}
+BENCHMARK(BM_CalcPercentile)->Arg(64)->Arg(MAX_BUFFER_SIZE);
+
+static void BM_CalcAllStats(benchmark::State& state) {
+    CircularBuffer buffer;
+    native_buffer_init(&buffer, static_cast<int32_t>(state.range(0)));
+    fill_buffer(&buffer, buffer.capacity);
+    int64_t now = buffer.newest_timestamp;
+    StatsResult result;
+    for (auto _ : state) {
+        native_calc_all_stats(&buffer, &result, now);
+        benchmark::DoNotOptimize(result);
+    }
+    native_buffer_free(&buffer);
+}
+BENCHMARK(BM_CalcAllStats)->Arg(64)->Arg(MAX_BUFFER_SIZE);
+
+// Per-point cost of the three detectors native_twc_add_point runs
+static void BM_AnomalyUpdate(benchmark::State& state) {
+    AnomalyDetector detector;
+    AnomalyParams params;
+    native_anomaly_default_params(&params);
+    native_anomaly_init(&detector, &params);
+    uint32_t seed = 3;
+    AnomalyResult result;
+    for (auto _ : state) {
+        native_anomaly_update(&detector, next_value(seed), &result);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_AnomalyUpdate);
+
+// Overlay sparkline (240x64, 120 slots, 2 px pitch) over uniform noise, the
+// worst case where every column crosses a steep segment: a full repaint versus
+// the scroll-by-one repaint each new sample triggers
+static void BM_SparkRender(benchmark::State& state) {
+    const bool scroll = state.range(0) != 0;
+    SparkStyle style = { 0xFF101418u, 0xFF4CAF50u, 0x804CAF50u, 0x004CAF50u, 2.0f, 1.0f };
+    SparkState spark;
+    native_spark_init(&spark, 240, 64, 120, &style);
+    static uint32_t pixels[240 * 64];
+    float values[1024];
+    uint32_t seed = 3;
+    for (float& v : values) v = next_value(seed) / 100.0f;
+
+    int start = 0;
+    for (auto _ : state) {
+        if (!scroll) native_spark_invalidate(&spark);
+        benchmark::DoNotOptimize(native_spark_render(&spark, values + start, 120, pixels, 240));
+        if (scroll) start = (start + 1) % (1024 - 120);
+    }
+}
+BENCHMARK(BM_SparkRender)->Arg(0)->Arg(1);
+
+// One second of 60 Hz vsyncs per call, as FpsMonitor flushes them
+static void BM_FramesAdd(benchmark::State& state) {
+    int64_t handle = native_frames_create(60.0f, 0);
+    int64_t batch[60];
+    int64_t ts = 0;
+    uint32_t seed = 3;
+    for (auto _ : state) {
+        for (int64_t& t : batch) {
+            ts += 16666667 + static_cast<int64_t>(next_value(seed) * 20000);
+            t = ts;
+        }
+        benchmark::DoNotOptimize(native_frames_add(handle, batch, 60));
+    }
+    state.SetItemsProcessed(state.iterations() * 60);
+    native_frames_destroy(handle);
+}
+BENCHMARK(BM_FramesAdd);
+
+// Statistics over a full one-minute window (3600 frames)
+static void BM_FramesGetStats(benchmark::State& state) {
+    int64_t handle = native_frames_create(60.0f, 0);
+    std::vector<int64_t> ts(3601);
+    uint32_t seed = 3;
+    int64_t t = 0;
+    for (int64_t& v : ts) {
+        t += 16666667 + static_cast<int64_t>(next_value(seed) * 20000);
+        v = t;
+    }
+    native_frames_add(handle, ts.data(), static_cast<int32_t>(ts.size()));
+    FrameStats stats;
+    for (auto _ : state) {
+        native_frames_get_stats(handle, &stats);
+        benchmark::DoNotOptimize(stats);
+    }
+    native_frames_destroy(handle);
+}
+BENCHMARK(BM_FramesGetStats);
+
+static void BM_TwcAddPoint(benchmark::State& state) {
+    int64_t handle = native_twc_create(WINDOW_5M);
+    uint32_t seed = 3;
+    int64_t ts = 0;
+    for (auto _ : state) {
+        native_twc_add_point(handle, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    native_twc_destroy(handle);
+}
+BENCHMARK(BM_TwcAddPoint);
+
+// Three colour-level rules on the value plus one p95-over-a-minute rule:
+// the cost on top of BM_TwcAddPoint is what the rule engine adds per point.
+static void BM_TwcAddPointWithRules(benchmark::State& state) {
+    int64_t handle = native_twc_create(WINDOW_5M);
+    const float steps[] = { 20.0f, 40.0f, 70.0f };
+    for (float step : steps) {
+        RuleSpec spec = { RULE_SOURCE_VALUE, 0, 0, RULE_ABOVE, step, step - 5.0f, 2000, 2000 };
+        native_rule_add(handle, &spec);
+    }
+    RuleSpec p95 = { RULE_SOURCE_PERCENTILE, 95, WINDOW_1M, RULE_ABOVE, 90.0f, 80.0f, 0, 0 };
+    native_rule_add(handle, &p95);
+
+    uint32_t seed = 3;
+    int64_t ts = 0;
+    RuleTransition drained[RULE_QUEUE_CAPACITY];
+    for (auto _ : state) {
+        native_twc_add_point(handle, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+        native_rule_drain(drained, RULE_QUEUE_CAPACITY);
+    }
+    native_twc_destroy(handle);
+    native_rules_clear_all();
+}
+BENCHMARK(BM_TwcAddPointWithRules);
+
+static void BM_TwcGetStats(benchmark::State& state) {
+    int64_t handle = native_twc_create(WINDOW_5M);
+    uint32_t seed = 3;
+    for (int64_t i = 0; i < WINDOW_5M / SAMPLE_INTERVAL_MS; i++) {
+        native_twc_add_point(handle, next_value(seed), i * SAMPLE_INTERVAL_MS);
+    }
+    StatsResult result;
+    for (auto _ : state) {
+        native_twc_get_stats(handle, &result);
+        benchmark::DoNotOptimize(result);
+    }
+    native_twc_destroy(handle);
+}
+BENCHMARK(BM_TwcGetStats);
+
+// Reads while another thread adds as fast as it can: the reader copies the
+// published result and should stay close to BM_TwcGetStats.
+static void BM_TwcGetStatsWhileAdding(benchmark::State& state) {
+    int64_t handle = native_twc_create(WINDOW_5M);
+    uint32_t seed = 3;
+    for (int64_t i = 0; i < WINDOW_5M / SAMPLE_INTERVAL_MS; i++) {
+        native_twc_add_point(handle, next_value(seed), i * SAMPLE_INTERVAL_MS);
+    }
+    std::atomic<bool> stop(false);
+    std::thread sampler([&]() {
+        uint32_t writer_seed = 7;
+        int64_t ts = WINDOW_5M;
+        while (!stop.load(std::memory_order_relaxed)) {
+            native_twc_add_point(handle, next_value(writer_seed), ts);
+            ts += SAMPLE_INTERVAL_MS;
+        }
+    });
+    StatsResult result;
+    for (auto _ : state) {
+        native_twc_get_stats(handle, &result);
+        benchmark::DoNotOptimize(result);
+    }
+    stop.store(true);
+    sampler.join();
+    native_twc_destroy(handle);
+}
+BENCHMARK(BM_TwcGetStatsWhileAdding)->UseRealTime();
+
+static void BM_ChartAddPoint(benchmark::State& state) {
+    int64_t handle = native_chart_create(static_cast<int32_t>(state.range(0)));
+    uint32_t seed = 5;
+    int64_t ts = 0;
+    for (auto _ : state) {
+        native_chart_add_point(handle, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    native_chart_destroy(handle);
+}
+BENCHMARK(BM_ChartAddPoint)->Arg(60)->Arg(MAX_BUFFER_SIZE);
+
+static void BM_PeakAddValue(benchmark::State& state) {
+    int64_t handle = native_peak_create(WINDOW_1M);
+    uint32_t seed = 11;
+    int64_t ts = 0;
+    for (auto _ : state) {
+        native_peak_add_value(handle, next_value(seed), ts);
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    native_peak_destroy(handle);
+}
+BENCHMARK(BM_PeakAddValue);
+
+// Overlay-sized sample vector (7 metrics), mostly idle: values jitter inside
+// their dead-bands so nearly every tick is suppressed
+static void BM_PublishSubmit(benchmark::State& state) {
+    constexpr int32_t METRICS = 7;
+    int64_t handle = native_pub_create(METRICS, 5000);
+    for (int32_t i = 0; i < METRICS; i++) {
+        native_pub_set_deadband(handle, i, 1.0f, 0.05f);
+    }
+
+    uint32_t seed = 13;
+    int64_t ts = 0;
+    float values[METRICS];
+    float changed[METRICS];
+    uint32_t mask = 0;
+    for (auto _ : state) {
+        for (int32_t i = 0; i < METRICS; i++) {
+            values[i] = 50.0f + next_value(seed) * 0.01f;
+        }
+        benchmark::DoNotOptimize(native_pub_submit(handle, values, METRICS, ts, &mask, changed));
+        ts += SAMPLE_INTERVAL_MS;
+    }
+    native_pub_destroy(handle);
+}
+BENCHMARK(BM_PublishSubmit);
+
+// Seqlock publish into the shared region, then a reader's copy out of it
+static void BM_SharedSnapshotPublishRead(benchmark::State& state) {
+    int fd = native_snapshot_create();
+    int64_t handle = native_snapshot_attach(fd);
+    if (handle == 0) {
+        state.SkipWithError("memfd unavailable");
+        return;
+    }
+
+    MetricsSnapshot in = {};
+    MetricsSnapshot out;
+    for (auto _ : state) {
+        in.timestamp_ms += SAMPLE_INTERVAL_MS;
+        native_snapshot_publish(&in);
+        benchmark::DoNotOptimize(native_snapshot_read(handle, &out));
+    }
+    native_snapshot_detach(handle);
+    native_snapshot_destroy();
+}
+BENCHMARK(BM_SharedSnapshotPublishRead);
+
+// Half an hour of overlay ticks (3600 samples, 8 metrics) as a session log
+static std::vector<uint8_t> record_session_log() {
+    std::string path = "/tmp/sysmetrics_bench_" + std::to_string(getpid()) + ".smsr";
+    if (native_session_start(path.c_str()) != 0) return {};
+
+    MetricsSnapshot snapshot = {};
+    for (double& value : snapshot.values) value = NAN;
+    uint32_t seed = 3;
+    int64_t mono_ns = static_cast<int64_t>(native_instr_now_ns());
+    for (int i = 0; i < 3600; i++) {
+        for (int m = 0; m <= SNAPSHOT_SELF_RAM_MB; m++) snapshot.values[m] = next_value(seed);
+        mono_ns += SAMPLE_INTERVAL_MS * 1000000;
+        native_session_record(&snapshot, mono_ns);
+    }
+    native_session_stop();
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> log((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    unlink(path.c_str());
+    return log;
+}
+
+static void BM_SessionDecode(benchmark::State& state) {
+    std::vector<uint8_t> log = record_session_log();
+    SessionReader reader;
+    SessionSample sample;
+    int64_t samples = 0;
+    for (auto _ : state) {
+        native_session_reader_open(&reader, log.data(), log.size());
+        while (native_session_reader_next(&reader, &sample) == 1) samples++;
+        benchmark::DoNotOptimize(sample);
+    }
+    state.SetItemsProcessed(samples);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(log.size()));
+}
+BENCHMARK(BM_SessionDecode);
+
+// Replay into fresh calculators, chart buffers and peak trackers per metric;
+// items are samples (8 values, 24 engine updates each)
+static void BM_SessionReplay(benchmark::State& state) {
+    std::vector<uint8_t> log = record_session_log();
+    ReplayStats stats;
+    int64_t samples = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        ReplayTargets targets;
+        native_replay_targets_create(&targets, 60, WINDOW_1M);
+        state.ResumeTiming();
+
+        native_session_replay(log.data(), log.size(), &targets, &stats);
+        samples += stats.samples;
+
+        state.PauseTiming();
+        native_replay_targets_destroy(&targets);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(samples);
+}
+BENCHMARK(BM_SessionReplay);
+
+// Top 5 by combined score over a table of state.range(0) processes
+static void BM_RankTopProcesses(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    float cpu[RANK_MAX_PROCESSES];
+    int64_t ram_kb[RANK_MAX_PROCESSES];
+    uint32_t seed = 42;
+    for (int i = 0; i < count; i++) {
+        cpu[i] = next_value(seed) * 0.2f;
+        ram_kb[i] = static_cast<int64_t>(next_value(seed) * 4096.0f);
+    }
+
+    RankParams params = { RANK_BY_COMBINED, 0.01f, 10, 10.0f, 100.0f };
+    int32_t out[RANK_TOP_MAX];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_rank_top_n(cpu, ram_kb, count, &params, 5, out));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RankTopProcesses)->Arg(64)->Arg(256)->Arg(RANK_MAX_PROCESSES);
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cinttypes>
+#include "native_format.h"
+#include "native_metrics.h"
+
+/**
+ * Format kernel vs. the snprintf code it replaced.
+ * Inputs sweep every unit of the ladder so branch prediction
+ * does not flatter either side.
+ */
+namespace {
+
+const uint64_t SPEED_INPUTS[] = {
+    512ULL, 1536ULL, 734003ULL, 1048575ULL, 5452595ULL, 987654321ULL, 3221225472ULL, 17ULL
+};
+constexpr size_t SPEED_INPUT_COUNT = sizeof(SPEED_INPUTS) / sizeof(SPEED_INPUTS[0]);
+
+int snprintf_speed(char* buffer, int size, const char* pfx, uint64_t bps) {
+    if (bps < 1024) {
+        return snprintf(buffer, size, "%s%" PRIu64 " B/s", pfx, bps);
+    } else if (bps < 1024 * 1024) {
+        return snprintf(buffer, size, "%s%.1f KB/s", pfx, bps / 1024.0f);
+    } else if (bps < 1024ULL * 1024 * 1024) {
+        return snprintf(buffer, size, "%s%.2f MB/s", pfx, bps / (1024.0f * 1024.0f));
+    }
+    return snprintf(buffer, size, "%s%.2f GB/s", pfx, bps / (1024.0f * 1024.0f * 1024.0f));
+}
+
+}  // namespace
+
+static void BM_FormatSpeed_Kernel(benchmark::State& state) {
+    char buffer[64];
+    size_t i = 0;
+    for (auto _ : state) {
+        int len = native_fmt_speed(buffer, sizeof(buffer), "", SPEED_INPUTS[i++ % SPEED_INPUT_COUNT]);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FormatSpeed_Kernel);
+
+static void BM_FormatSpeed_Snprintf(benchmark::State& state) {
+    char buffer[64];
+    size_t i = 0;
+    for (auto _ : state) {
+        int len = snprintf_speed(buffer, sizeof(buffer), "", SPEED_INPUTS[i++ % SPEED_INPUT_COUNT]);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FormatSpeed_Snprintf);
+
+static void BM_FormatPercent_Kernel(benchmark::State& state) {
+    char buffer[32];
+    float value = 0.0f;
+    for (auto _ : state) {
+        int len = native_fmt_percent(buffer, sizeof(buffer), value);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+        value = value < 100.0f ? value + 0.37f : 0.0f;
+    }
+}
+BENCHMARK(BM_FormatPercent_Kernel);
+
+static void BM_FormatPercent_Snprintf(benchmark::State& state) {
+    char buffer[32];
+    float value = 0.0f;
+    for (auto _ : state) {
+        int len = snprintf(buffer, sizeof(buffer), "%.1f%%", value);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+        value = value < 100.0f ? value + 0.37f : 0.0f;
+    }
+}
+BENCHMARK(BM_FormatPercent_Snprintf);
+
+static void BM_FormatCpuString(benchmark::State& state) {
+    char buffer[32];
+    float value = 0.05f;
+    for (auto _ : state) {
+        int len = format_cpu_string(buffer, sizeof(buffer), value);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+        value = value < 100.0f ? value * 1.7f : 0.05f;
+    }
+}
+BENCHMARK(BM_FormatCpuString);
+
+static void BM_FormatTimeString(benchmark::State& state) {
+    char buffer[16];
+    int minute = 0;
+    for (auto _ : state) {
+        int len = format_time_string(buffer, sizeof(buffer), minute / 60, minute % 60, false);
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+        minute = (minute + 1) % (24 * 60);
+    }
+}
+BENCHMARK(BM_FormatTimeString);
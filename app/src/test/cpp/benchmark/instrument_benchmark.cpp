@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "native_instrument.h"
+
+/**
+ * Probe overhead: an empty instrumented scope with timing off (one relaxed
+ * load) and on (two clock reads plus the histogram update or ring append).
+ */
+
+static void BM_ProbeScopeDisabled(benchmark::State& state) {
+    native_instr_set_enabled(false);
+    for (auto _ : state) {
+        NativeProbeScope probe(PROBE_TWC_ADD_POINT);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ProbeScopeDisabled);
+
+static void BM_ProbeScopeEnabled(benchmark::State& state) {
+    if (state.thread_index() == 0) native_instr_set_enabled(true);
+    for (auto _ : state) {
+        NativeProbeScope probe(PROBE_TWC_ADD_POINT);
+        benchmark::ClobberMemory();
+    }
+    if (state.thread_index() == 0) {
+        native_instr_set_enabled(false);
+        native_instr_reset();
+    }
+}
+BENCHMARK(BM_ProbeScopeEnabled)->ThreadRange(1, 4);
+
+static void BM_TraceScopeEnabled(benchmark::State& state) {
+    if (state.thread_index() == 0) native_trace_set_enabled(true);
+    for (auto _ : state) {
+        NativeTraceScope trace("bench", TRACE_CAT_JNI);
+        benchmark::ClobberMemory();
+    }
+    if (state.thread_index() == 0) {
+        native_trace_set_enabled(false);
+        native_trace_clear();
+    }
+}
+BENCHMARK(BM_TraceScopeEnabled)->ThreadRange(1, 4);
+
+static void BM_InstrumentDump(benchmark::State& state) {
+    int64_t values[INSTR_DUMP_HEADER + PROBE_COUNT * INSTR_DUMP_FIELDS];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_instr_dump(values, native_instr_dump_size()));
+    }
+}
+BENCHMARK(BM_InstrumentDump);
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+#include "native_metrics.h"
+#include "native_network_stats.h"
+#include "native_disk_stats.h"
+#include "native_cpufreq.h"
+#include "native_threads.h"
+#include "native_memory.h"
+#include "native_process_memory.h"
+#include <unistd.h>
+
+/**
+ * Collector benchmarks: full open/read/parse/close cycles against the
+ * host's live procfs, i.e. what one overlay tick costs per metric.
+ */
+
+static void BM_ReadCpuStats(benchmark::State& state) {
+    CpuStats stats;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(read_cpu_stats(&stats));
+    }
+}
+BENCHMARK(BM_ReadCpuStats);
+
+static void BM_CalculateCpuUsage(benchmark::State& state) {
+    CpuStats prev = { 10132153, 290696, 3084719, 46828483, 16683, 0, 25195, 0 };
+    CpuStats curr = prev;
+    for (auto _ : state) {
+        curr.user += 7;
+        curr.idle += 93;
+        benchmark::DoNotOptimize(calculate_cpu_usage(&prev, &curr));
+    }
+}
+BENCHMARK(BM_CalculateCpuUsage);
+
+static void BM_ReadMemoryStats(benchmark::State& state) {
+    MemoryStats stats;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(read_memory_stats(&stats));
+    }
+}
+BENCHMARK(BM_ReadMemoryStats);
+
+// Every meminfo, zram and vmstat field through one registered handle
+static void BM_MemReadAllFields(benchmark::State& state) {
+    int32_t fields[MEM_FIELD_COUNT];
+    for (int i = 0; i < MEM_FIELD_COUNT; i++) fields[i] = i;
+    int64_t handle = native_mem_register(fields, MEM_FIELD_COUNT);
+
+    double values[MEM_FIELD_COUNT];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_mem_read(handle, values, MEM_FIELD_COUNT));
+    }
+    native_mem_unregister(handle);
+}
+BENCHMARK(BM_MemReadAllFields);
+
+static void BM_ReadProcessCpuStats(benchmark::State& state) {
+    ProcessCpuStats stats;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(read_process_cpu_stats(1, &stats));
+    }
+}
+BENCHMARK(BM_ReadProcessCpuStats);
+
+static void BM_ReadProcNetDev(benchmark::State& state) {
+    InterfaceStatsNative interfaces[MAX_INTERFACES];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_read_proc_net_dev(interfaces, MAX_INTERFACES));
+    }
+}
+BENCHMARK(BM_ReadProcNetDev);
+
+static void BM_GetTotalBytes(benchmark::State& state) {
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_get_total_bytes(&rx_bytes, &tx_bytes));
+    }
+}
+BENCHMARK(BM_GetTotalBytes);
+
+static void BM_DiskSample(benchmark::State& state) {
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    DiskRateNative total;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_disk_sample(rates, DISK_MAX_DEVICES, &total));
+    }
+}
+BENCHMARK(BM_DiskSample);
+
+// Descriptors stay open: pread of cur/max/time_in_state per policy
+static void BM_CpuFreqSample(benchmark::State& state) {
+    CpuFreqPolicy policies[CPUFREQ_MAX_POLICIES];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES));
+    }
+    native_cpufreq_close();
+}
+BENCHMARK(BM_CpuFreqSample);
+
+// Our own threads: task/ scan plus stat + status per thread
+static void BM_ThreadsSample(benchmark::State& state) {
+    ThreadStatsNative threads[THREADS_MAX];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_threads_sample(0, threads, THREADS_MAX));
+    }
+    native_threads_reset();
+}
+BENCHMARK(BM_ThreadsSample);
+
+// Steady state: statm + stat per tick, smaps_rollup only every 5 s
+static void BM_ProcessMemoryCached(benchmark::State& state) {
+    native_procmem_set_detail_interval(PROCMEM_DEFAULT_DETAIL_INTERVAL_MS);
+    ProcessMemoryStats stats;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_procmem_read(getpid(), &stats));
+    }
+}
+BENCHMARK(BM_ProcessMemoryCached);
+
+// Worst case: smaps_rollup walked on every read
+static void BM_ProcessMemoryDetail(benchmark::State& state) {
+    native_procmem_set_detail_interval(0);
+    ProcessMemoryStats stats;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(native_procmem_read(getpid(), &stats));
+    }
+    native_procmem_set_detail_interval(PROCMEM_DEFAULT_DETAIL_INTERVAL_MS);
+}
+BENCHMARK(BM_ProcessMemoryDetail);
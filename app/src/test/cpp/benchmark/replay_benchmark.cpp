@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "native_paths.h"
+#include "native_metrics.h"
+#include "native_network_stats.h"
+#include "native_gpu.h"
+#include "native_uid_traffic.h"
+
+/**
+ * Collector throughput against recorded snapshots (fixtures/tv_box).
+ * Each iteration steps the replay and runs the parse + rate maths the
+ * overlay does per tick, so items/s is samples per second.
+ */
+namespace {
+
+const std::string FIXTURE = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+class ReplayScope {
+public:
+    explicit ReplayScope(benchmark::State& state) {
+        if (native_replay_open(FIXTURE.c_str()) <= 0) {
+            state.SkipWithError("fixture not found");
+        }
+    }
+    ~ReplayScope() { native_replay_close(); }
+};
+
+// Step the replay, rewinding after the last snapshot.
+// @return true after a rewind, when rate baselines must be retaken
+bool step_replay() {
+    if (native_replay_step() >= 0) return false;
+    native_replay_rewind();
+    return true;
+}
+
+}  // namespace
+
+static void BM_ReplayCpuUsage(benchmark::State& state) {
+    ReplayScope replay(state);
+    CpuStats prev;
+    CpuStats curr;
+    read_cpu_stats(&prev);
+    for (auto _ : state) {
+        if (step_replay()) {
+            read_cpu_stats(&prev);
+            continue;
+        }
+        read_cpu_stats(&curr);
+        benchmark::DoNotOptimize(calculate_cpu_usage(&prev, &curr));
+        prev = curr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayCpuUsage);
+
+static void BM_ReplayMemoryStats(benchmark::State& state) {
+    ReplayScope replay(state);
+    MemoryStats stats;
+    for (auto _ : state) {
+        step_replay();
+        benchmark::DoNotOptimize(read_memory_stats(&stats));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayMemoryStats);
+
+static void BM_ReplayNetworkSpeed(benchmark::State& state) {
+    ReplayScope replay(state);
+    InterfaceStatsNative interfaces[MAX_INTERFACES];
+    NetworkStatsNative prev;
+    NetworkStatsNative curr;
+    NetworkSpeedNative speed;
+
+    int count = native_read_proc_net_dev(interfaces, MAX_INTERFACES);
+    native_aggregate_network_stats(interfaces, count, &prev);
+    for (auto _ : state) {
+        bool rewound = step_replay();
+        count = native_read_proc_net_dev(interfaces, MAX_INTERFACES);
+        if (rewound) {
+            native_aggregate_network_stats(interfaces, count, &prev);
+            continue;
+        }
+        native_aggregate_network_stats(interfaces, count, &curr);
+        native_calculate_network_speed(&prev, &curr, &speed);
+        benchmark::DoNotOptimize(speed);
+        prev = curr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayNetworkSpeed);
+
+static void BM_ReplayTemperature(benchmark::State& state) {
+    ReplayScope replay(state);
+    for (auto _ : state) {
+        step_replay();
+        benchmark::DoNotOptimize(read_temperature(0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayTemperature);
+
+static void BM_ReplayUidTraffic(benchmark::State& state) {
+    ReplayScope replay(state);
+    int64_t rows[UID_TOP_MAX * UID_TRAFFIC_FIELDS];
+    native_uid_traffic_reset();
+    native_uid_traffic_sample(rows, 5);
+    for (auto _ : state) {
+        if (step_replay()) native_uid_traffic_reset();
+        benchmark::DoNotOptimize(native_uid_traffic_sample(rows, 5));
+    }
+    native_uid_traffic_reset();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayUidTraffic);
+
+static void BM_ReplayGpu(benchmark::State& state) {
+    ReplayScope replay(state);
+    GpuSample sample;
+    for (auto _ : state) {
+        step_replay();
+        benchmark::DoNotOptimize(native_gpu_sample(&sample));
+    }
+    native_gpu_close();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayGpu);
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "native_analytics.h"
+
+/**
+ * Unit tests for the native analytics engine (circular buffer,
+ * statistics and handle-based calculators).
+ */
+
+class CircularBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(0, native_buffer_init(&buffer, 8));
+    }
+
+    void TearDown() override {
+        native_buffer_free(&buffer);
+    }
+
+    CircularBuffer buffer;
+};
+
+TEST_F(CircularBufferTest, PushOverwritesOldestWhenFull) {
+    for (int i = 0; i < 10; i++) {
+        native_buffer_push(&buffer, static_cast<float>(i), 1000 + i);
+    }
+
+    DataPoint points[8];
+    ASSERT_EQ(8, native_buffer_get_all(&buffer, points, 8));
+    EXPECT_FLOAT_EQ(2.0f, points[0].value);
+    EXPECT_FLOAT_EQ(9.0f, points[7].value);
+    EXPECT_EQ(1002, buffer.oldest_timestamp);
+    EXPECT_EQ(1009, buffer.newest_timestamp);
+}
+
+TEST_F(CircularBufferTest, TrimDropsPointsBeforeCutoff) {
+    for (int i = 0; i < 5; i++) {
+        native_buffer_push(&buffer, static_cast<float>(i), 1000 * i);
+    }
+
+    native_buffer_trim(&buffer, 2500);
+
+    EXPECT_EQ(2, buffer.count);
+    EXPECT_EQ(3000, buffer.oldest_timestamp);
+}
+
+TEST_F(CircularBufferTest, WindowedStatistics) {
+    // Values 10..80, one per second; the last 3 seconds hold 60, 70, 80
+    for (int i = 1; i <= 8; i++) {
+        native_buffer_push(&buffer, 10.0f * i, 1000 * i);
+    }
+
+    EXPECT_FLOAT_EQ(70.0f, native_calc_average(&buffer, 2000, 8000));
+    EXPECT_FLOAT_EQ(60.0f, native_calc_min(&buffer, 2000, 8000));
+    EXPECT_FLOAT_EQ(80.0f, native_calc_max(&buffer, 2000, 8000));
+    EXPECT_FLOAT_EQ(40.0f, native_calc_percentile(&buffer, 50, 10000, 8000));
+    EXPECT_FLOAT_EQ(80.0f, native_calc_percentile(&buffer, 100, 10000, 8000));
+}
+
+TEST(NativeAnalyticsTest, TimeWindowCalculatorReportsAllWindows) {
+    int64_t handle = native_twc_create(WINDOW_5M);
+    ASSERT_NE(0, handle);
+
+    // One sample per second for two minutes: value == seconds elapsed
+    for (int i = 0; i < 120; i++) {
+        native_twc_add_point(handle, static_cast<float>(i), 1000LL * i);
+    }
+
+    StatsResult stats;
+    native_twc_get_stats(handle, &stats);
+
+    EXPECT_FLOAT_EQ(119.0f, stats.current);
+    EXPECT_FLOAT_EQ(0.0f, stats.min);
+    EXPECT_FLOAT_EQ(119.0f, stats.max);
+    EXPECT_NEAR(104.0f, stats.avg_30s, 0.01f);   // 89..119
+    EXPECT_NEAR(89.0f, stats.avg_1m, 0.01f);     // 59..119
+    EXPECT_NEAR(59.5f, stats.avg_5m, 0.01f);     // 0..119
+    EXPECT_EQ(120, stats.count);
+
+    native_twc_destroy(handle);
+
+    native_twc_get_stats(handle, &stats);
+    EXPECT_EQ(0, stats.count);
+}
+
+TEST(NativeAnalyticsTest, PublishedStatsMatchFullRecompute) {
+    // 1-minute calculator (capacity 130) fed at irregular intervals, so
+    // points leave by trim and by overwrite; one sample steps back in time
+    int64_t handle = native_twc_create(WINDOW_1M);
+    ASSERT_NE(0, handle);
+    CircularBuffer reference;
+    ASSERT_EQ(0, native_buffer_init(&reference, WINDOW_1M / 500 + 10));
+
+    uint32_t seed = 7;
+    int64_t timestamp = 0;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        timestamp += (i == 700) ? -3000 : 100 + (seed >> 16) % 900;
+        float value = static_cast<float>((seed >> 8) % 1000) / 10.0f;
+
+        native_twc_add_point(handle, value, timestamp);
+        native_buffer_trim(&reference, timestamp - WINDOW_1M);
+        native_buffer_push(&reference, value, timestamp);
+
+        StatsResult stats;
+        StatsResult expected;
+        native_twc_get_stats(handle, &stats);
+        native_calc_all_stats(&reference, &expected, reference.newest_timestamp);
+        ASSERT_EQ(expected.count, stats.count) << "sample " << i;
+        ASSERT_EQ(expected.timestamp, stats.timestamp) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.current, stats.current) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.avg_30s, stats.avg_30s) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.avg_1m, stats.avg_1m) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.avg_5m, stats.avg_5m) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.min, stats.min) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.max, stats.max) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.p50, stats.p50) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.p95, stats.p95) << "sample " << i;
+        ASSERT_FLOAT_EQ(expected.p99, stats.p99) << "sample " << i;
+    }
+
+    native_buffer_free(&reference);
+    native_twc_destroy(handle);
+}
+
+TEST(NativeAnalyticsTest, ChartBufferNormalizesAgainstRange) {
+    int64_t handle = native_chart_create(4);
+    ASSERT_NE(0, handle);
+
+    native_chart_add_point(handle, 10.0f, 1);
+    native_chart_add_point(handle, 30.0f, 2);
+    native_chart_add_point(handle, 20.0f, 3);
+
+    float values[4];
+    ASSERT_EQ(3, native_chart_get_normalized(handle, values, 4));
+    EXPECT_FLOAT_EQ(0.0f, values[0]);
+    EXPECT_FLOAT_EQ(1.0f, values[1]);
+    EXPECT_FLOAT_EQ(0.5f, values[2]);
+
+    float min_value;
+    float max_value;
+    native_chart_get_range(handle, &min_value, &max_value);
+    EXPECT_FLOAT_EQ(10.0f, min_value);
+    EXPECT_FLOAT_EQ(30.0f, max_value);
+
+    native_chart_destroy(handle);
+}
+
+TEST(NativeAnalyticsTest, PeakTrackerKeepsPeakInsideWindow) {
+    int64_t handle = native_peak_create(5000);
+    ASSERT_NE(0, handle);
+
+    native_peak_add_value(handle, 90.0f, 1000);
+    native_peak_add_value(handle, 40.0f, 2000);
+    native_peak_add_value(handle, 50.0f, 7000);  // 90 @1000 falls out
+
+    PeakData peak;
+    native_peak_get_data(handle, &peak);
+    EXPECT_FLOAT_EQ(50.0f, peak.peak_value);
+    EXPECT_EQ(7000, peak.peak_timestamp);
+    EXPECT_EQ(2, peak.sample_count);
+
+    native_peak_destroy(handle);
+}
+
+TEST(NativeAnalyticsTest, IntoGettersWriteTypedLayouts) {
+    const int64_t base_ts = 1700000000123LL;  // not representable as a float
+    int64_t twc = native_twc_create(WINDOW_5M);
+    int64_t peak = native_peak_create(WINDOW_1M);
+    ASSERT_NE(0, twc);
+    ASSERT_NE(0, peak);
+    for (int i = 0; i < 4; i++) {
+        native_twc_add_point(twc, 10.0f * (i + 1), base_ts + 1000LL * i);
+        native_peak_add_value(peak, i == 2 ? 99.0f : 1.0f, base_ts + 1000LL * i);
+    }
+
+    alignas(8) uint8_t stats_out[STATS_OUT_SIZE];
+    ASSERT_EQ(STATS_OUT_SIZE, native_twc_get_stats_into(twc, stats_out, sizeof(stats_out)));
+    float values[9];
+    int64_t timestamp;
+    int64_t count;
+    memcpy(values, stats_out + STATS_OUT_VALUES, sizeof(values));
+    memcpy(&timestamp, stats_out + STATS_OUT_TIMESTAMP, sizeof(timestamp));
+    memcpy(&count, stats_out + STATS_OUT_COUNT, sizeof(count));
+    EXPECT_FLOAT_EQ(40.0f, values[0]);  // current
+    EXPECT_FLOAT_EQ(25.0f, values[1]);  // avg_30s
+    EXPECT_FLOAT_EQ(10.0f, values[4]);  // min
+    EXPECT_EQ(base_ts + 3000, timestamp);
+    EXPECT_EQ(4, count);
+
+    alignas(8) uint8_t peak_out[PEAK_OUT_SIZE];
+    ASSERT_EQ(PEAK_OUT_SIZE, native_peak_get_data_into(peak, peak_out, sizeof(peak_out)));
+    float peak_value;
+    memcpy(&peak_value, peak_out + PEAK_OUT_VALUE, sizeof(peak_value));
+    memcpy(&timestamp, peak_out + PEAK_OUT_TIMESTAMP, sizeof(timestamp));
+    memcpy(&count, peak_out + PEAK_OUT_COUNT, sizeof(count));
+    EXPECT_FLOAT_EQ(99.0f, peak_value);
+    EXPECT_EQ(base_ts + 2000, timestamp);
+    EXPECT_EQ(4, count);
+
+    EXPECT_EQ(-1, native_twc_get_stats_into(twc, stats_out, STATS_OUT_SIZE - 1));
+    EXPECT_EQ(-1, native_peak_get_data_into(peak, nullptr, PEAK_OUT_SIZE));
+
+    native_twc_destroy(twc);
+    native_peak_destroy(peak);
+
+    memset(stats_out, 0xff, sizeof(stats_out));
+    EXPECT_EQ(-1, native_twc_get_stats_into(twc, stats_out, sizeof(stats_out)));
+    memcpy(&count, stats_out + STATS_OUT_COUNT, sizeof(count));
+    EXPECT_EQ(0, count);
+}
+
+TEST(NativeAnalyticsTest, ReadersSeePublishedResultsWhileSamplerAdds) {
+    int64_t twc = native_twc_create(WINDOW_5M);
+    int64_t chart = native_chart_create(60);
+    ASSERT_NE(0, twc);
+    ASSERT_NE(0, chart);
+
+    // Values only grow, so every consistent snapshot has current == max and
+    // a chart series that ends at 1.0; a torn copy breaks one of them.
+    std::atomic<bool> done(false);
+    std::thread sampler([&]() {
+        for (int i = 1; i <= 20000; i++) {
+            native_twc_add_point(twc, static_cast<float>(i), 500LL * i);
+            native_chart_add_point(chart, static_cast<float>(i), 500LL * i);
+        }
+        done.store(true);
+    });
+
+    std::atomic<int> inconsistent(0);
+    std::vector<std::vector<int64_t>> latencies(2);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&, r]() {
+            float last_current = 0;
+            StatsResult stats;
+            float series[60];
+            while (!done.load()) {
+                auto start = std::chrono::steady_clock::now();
+                native_twc_get_stats(twc, &stats);
+                int32_t count = native_chart_get_normalized(chart, series, 60);
+                latencies[r].push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+
+                if (stats.current != stats.max || stats.current < last_current) inconsistent++;
+                if (count > 1 && series[count - 1] != 1.0f) inconsistent++;
+                last_current = stats.current;
+            }
+        });
+    }
+
+    sampler.join();
+    for (std::thread& reader : readers) reader.join();
+
+    std::vector<int64_t> all;
+    for (const std::vector<int64_t>& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    ASSERT_FALSE(all.empty());
+    std::sort(all.begin(), all.end());
+    int64_t p99_us = all[all.size() * 99 / 100];
+
+    EXPECT_EQ(0, inconsistent.load());
+    EXPECT_LT(p99_us, 1000);  // a copy, never a recompute behind the sampler
+
+    StatsResult stats;
+    native_twc_get_stats(twc, &stats);
+    EXPECT_FLOAT_EQ(20000.0f, stats.current);
+
+    native_twc_destroy(twc);
+    native_chart_destroy(chart);
+}
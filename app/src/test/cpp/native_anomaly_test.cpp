@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "native_analytics.h"
+#include "native_anomaly.h"
+
+/**
+ * Tests for the online anomaly detectors, standalone and as published
+ * through the TimeWindowCalculator stats.
+ */
+class NativeAnomalyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        AnomalyParams params;
+        native_anomaly_default_params(&params);
+        ASSERT_EQ(0, native_anomaly_init(&detector, &params));
+    }
+
+    // CPU idling around 5% with a little noise
+    AnomalyResult feed_idle(int points) {
+        std::normal_distribution<float> noise(5.0f, 0.5f);
+        AnomalyResult result = {};
+        for (int i = 0; i < points; i++) native_anomaly_update(&detector, noise(rng), &result);
+        return result;
+    }
+
+    AnomalyDetector detector;
+    std::mt19937 rng{7};
+};
+
+TEST_F(NativeAnomalyTest, QuietSeriesIsNotFlagged) {
+    std::normal_distribution<float> noise(5.0f, 0.5f);
+    int robust = 0, cusum = 0;
+    for (int i = 0; i < 600; i++) {
+        AnomalyResult result;
+        native_anomaly_update(&detector, noise(rng), &result);
+        if (result.flags & ANOMALY_FLAG_ROBUST) robust++;
+        if (result.flags & ANOMALY_FLAG_CUSUM) cusum++;
+    }
+    // A 31-point MAD is itself noisy: allow the odd robust hit, no drift alarm
+    EXPECT_LE(robust, 12);
+    EXPECT_EQ(0, cusum);
+}
+
+TEST_F(NativeAnomalyTest, SingleSpikeFlagsZScoresButNotCusum) {
+    feed_idle(200);
+
+    AnomalyResult spike;
+    native_anomaly_update(&detector, 60.0f, &spike);
+    EXPECT_TRUE(spike.flags & ANOMALY_FLAG_EWMA);
+    EXPECT_TRUE(spike.flags & ANOMALY_FLAG_ROBUST);
+    EXPECT_FALSE(spike.flags & ANOMALY_FLAG_CUSUM);
+    EXPECT_GT(spike.robust_score, 10.0f);
+
+    AnomalyResult after = feed_idle(1);
+    EXPECT_FALSE(after.flags & ANOMALY_FLAG_ROBUST);
+}
+
+TEST_F(NativeAnomalyTest, SustainedShiftTripsCusum) {
+    feed_idle(200);
+
+    // The box stops idling: 5% -> 35%
+    std::normal_distribution<float> busy(35.0f, 0.5f);
+    int first_cusum = -1;
+    for (int i = 0; i < 10 && first_cusum < 0; i++) {
+        AnomalyResult result;
+        native_anomaly_update(&detector, busy(rng), &result);
+        if (result.flags & ANOMALY_FLAG_CUSUM) first_cusum = i;
+    }
+    EXPECT_GE(first_cusum, 1);  // never on the first point alone
+    EXPECT_LE(first_cusum, 3);
+}
+
+TEST_F(NativeAnomalyTest, RobustScoreMatchesBruteForce) {
+    std::uniform_real_distribution<float> values(0.0f, 100.0f);
+    std::vector<float> history;
+    for (int i = 0; i < 300; i++) {
+        float x = std::round(values(rng));  // duplicates exercise the sorted window
+        AnomalyResult result;
+        native_anomaly_update(&detector, x, &result);
+
+        if (i >= ANOMALY_WARMUP) {
+            size_t n = std::min<size_t>(history.size(), ANOMALY_MEDIAN_WINDOW);
+            std::vector<float> window(history.end() - n, history.end());
+            std::sort(window.begin(), window.end());
+            float median = n % 2 ? window[n / 2] : (window[n / 2 - 1] + window[n / 2]) * 0.5f;
+            std::vector<float> dev;
+            for (float v : window) dev.push_back(std::fabs(v - median));
+            std::sort(dev.begin(), dev.end());
+            float mad = n % 2 ? dev[n / 2] : (dev[n / 2 - 1] + dev[n / 2]) * 0.5f;
+            float scale = std::max(1.4826f * mad, std::max(ANOMALY_SCALE_MIN, ANOMALY_SCALE_FLOOR * median));
+            float expected = std::min(std::fabs(x - median) / scale, ANOMALY_SCORE_MAX);
+            ASSERT_NEAR(expected, result.robust_score, 1e-4f) << "point " << i;
+        }
+        history.push_back(x);
+    }
+}
+
+TEST_F(NativeAnomalyTest, WarmupInvalidInputAndParams) {
+    AnomalyResult result;
+    for (int i = 0; i < ANOMALY_WARMUP; i++) {
+        native_anomaly_update(&detector, i == 5 ? 1000.0f : 1.0f, &result);
+        EXPECT_EQ(0, result.flags);
+        EXPECT_EQ(0.0f, result.ewma_score);
+    }
+
+    int64_t count = detector.count;
+    native_anomaly_update(&detector, NAN, &result);
+    EXPECT_EQ(count, detector.count);
+    EXPECT_EQ(0, result.flags);
+
+    AnomalyParams params;
+    native_anomaly_default_params(&params);
+    params.ewma_alpha = 0.0f;
+    EXPECT_EQ(-1, native_anomaly_init(&detector, &params));
+    EXPECT_EQ(count, detector.count);
+    params.ewma_alpha = 0.1f;
+    params.cusum_threshold = 0.0f;
+    EXPECT_EQ(-1, native_anomaly_init(&detector, &params));
+    EXPECT_EQ(-1, native_anomaly_init(&detector, nullptr));
+}
+
+TEST(NativeAnomalyStatsTest, ScoresArePublishedWithStats) {
+    int64_t twc = native_twc_create(WINDOW_5M);
+    ASSERT_NE(0, twc);
+    for (int i = 0; i < 100; i++) {
+        native_twc_add_point(twc, 5.0f + 0.5f * (i % 3), 1000LL * i);
+    }
+    native_twc_add_point(twc, 80.0f, 100000);
+
+    StatsResult stats;
+    native_twc_get_stats(twc, &stats);
+    EXPECT_TRUE(stats.anomaly_flags & ANOMALY_FLAG_EWMA);
+    EXPECT_TRUE(stats.anomaly_flags & ANOMALY_FLAG_ROBUST);
+
+    alignas(8) uint8_t out[STATS_OUT_SIZE];
+    ASSERT_EQ(STATS_OUT_SIZE, native_twc_get_stats_into(twc, out, sizeof(out)));
+    float scores[3];
+    int32_t flags;
+    memcpy(scores, out + STATS_OUT_SCORES, sizeof(scores));
+    memcpy(&flags, out + STATS_OUT_FLAGS, sizeof(flags));
+    EXPECT_FLOAT_EQ(stats.ewma_score, scores[0]);
+    EXPECT_FLOAT_EQ(stats.robust_score, scores[1]);
+    EXPECT_FLOAT_EQ(stats.cusum_score, scores[2]);
+    EXPECT_EQ(stats.anomaly_flags, flags);
+
+    // Clear restarts detection; new params restart it too
+    native_twc_clear(twc);
+    native_twc_get_stats(twc, &stats);
+    EXPECT_EQ(0, stats.anomaly_flags);
+    EXPECT_EQ(0.0f, stats.ewma_score);
+
+    AnomalyParams params;
+    native_anomaly_default_params(&params);
+    params.ewma_threshold = 100.0f;
+    EXPECT_EQ(0, native_twc_set_anomaly_params(twc, &params));
+    params.robust_threshold = -1.0f;
+    EXPECT_EQ(-1, native_twc_set_anomaly_params(twc, &params));
+    EXPECT_EQ(-1, native_twc_set_anomaly_params(twc + 1000, &params));
+
+    native_twc_destroy(twc);
+}
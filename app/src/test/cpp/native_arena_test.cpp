@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "native_analytics.h"
+#include "native_arena.h"
+
+/**
+ * Tests for the slab allocator and per-thread scratch, and the steady-state
+ * check: once trackers exist and their buffers are full, adding points and
+ * reading results allocates nothing. operator new is replaced in this test
+ * binary so that check also catches containers; counting is only armed on
+ * the thread running the workload.
+ */
+namespace {
+
+thread_local bool g_count_allocations = false;
+thread_local int g_allocations = 0;
+
+void* counted_alloc(size_t size) {
+    if (g_count_allocations) g_allocations++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* counted_aligned_alloc(size_t size, std::align_val_t align) {
+    if (g_count_allocations) g_allocations++;
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, static_cast<size_t>(align), size ? size : 1) != 0) throw std::bad_alloc();
+    return ptr;
+}
+
+struct AllocationCounter {
+    AllocationCounter() : arena_before(native_arena_heap_allocations()) {
+        g_allocations = 0;
+        g_count_allocations = true;
+    }
+    ~AllocationCounter() { g_count_allocations = false; }
+
+    int heap_allocations() const {
+        return g_allocations + static_cast<int>(native_arena_heap_allocations() - arena_before);
+    }
+
+    uint64_t arena_before;
+};
+
+}  // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+
+TEST(NativeArenaTest, BlocksAreAlignedAndReused) {
+    int32_t in_use = native_slab_blocks_in_use();
+
+    void* first = native_slab_alloc(100);
+    void* second = native_slab_alloc(5000);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % NATIVE_SLAB_ALIGN);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % NATIVE_SLAB_ALIGN);
+    EXPECT_EQ(in_use + 2, native_slab_blocks_in_use());
+
+    uint64_t heap = native_arena_heap_allocations();
+    native_slab_free(first, 100);
+    EXPECT_EQ(first, native_slab_alloc(200));  // same class, last freed first
+    EXPECT_EQ(heap, native_arena_heap_allocations());
+
+    native_slab_free(first, 200);
+    native_slab_free(second, 5000);
+    EXPECT_EQ(in_use, native_slab_blocks_in_use());
+}
+
+TEST(NativeArenaTest, RejectsSizesOutsideTheClasses) {
+    EXPECT_EQ(nullptr, native_slab_alloc(0));
+    EXPECT_EQ(nullptr, native_slab_alloc(NATIVE_SLAB_MAX_SIZE + 1));
+    EXPECT_NE(nullptr, native_scratch_floats(NATIVE_SCRATCH_FLOATS));
+    EXPECT_EQ(nullptr, native_scratch_floats(NATIVE_SCRATCH_FLOATS + 1));
+}
+
+TEST(NativeArenaTest, ScratchIsPerThread) {
+    float* mine = native_scratch_floats(16);
+    float* theirs = nullptr;
+    std::thread other([&theirs]() { theirs = native_scratch_floats(16); });
+    other.join();
+    EXPECT_NE(mine, theirs);
+}
+
+TEST(NativeArenaTest, TrackerChurnReusesSlabBlocks) {
+    // First cycle may grow the classes; later ones must not
+    native_twc_destroy(native_twc_create(WINDOW_5M));
+    native_chart_destroy(native_chart_create(60));
+    native_peak_destroy(native_peak_create(WINDOW_1M));
+
+    uint64_t heap = native_arena_heap_allocations();
+    for (int i = 0; i < 50; i++) {
+        native_twc_destroy(native_twc_create(WINDOW_5M));
+        native_chart_destroy(native_chart_create(60));
+        native_peak_destroy(native_peak_create(WINDOW_1M));
+    }
+    EXPECT_EQ(heap, native_arena_heap_allocations());
+}
+
+TEST(NativeArenaTest, SteadyStateAnalyticsDoNotAllocate) {
+    int64_t twc = native_twc_create(WINDOW_5M);
+    int64_t chart = native_chart_create(60);
+    int64_t peak = native_peak_create(WINDOW_1M);
+    ASSERT_NE(0, twc);
+    ASSERT_NE(0, chart);
+    ASSERT_NE(0, peak);
+    CircularBuffer buffer;
+    ASSERT_EQ(0, native_buffer_init(&buffer, MAX_BUFFER_SIZE));
+
+    // Past the point where every buffer is full and trimming
+    int64_t ts = 0;
+    for (int i = 0; i < 1000; i++, ts += 500) {
+        native_twc_add_point(twc, static_cast<float>(i % 97), ts);
+        native_chart_add_point(chart, static_cast<float>(i % 89), ts);
+        native_peak_add_value(peak, static_cast<float>(i % 83), ts);
+        native_buffer_push(&buffer, static_cast<float>(i % 79), ts);
+    }
+
+    StatsResult stats;
+    PeakData peak_data;
+    float series[60];
+    float min_value, max_value;
+    int32_t count = 0;
+    float p95 = 0;
+    int allocations;
+    {
+        AllocationCounter counter;
+        for (int i = 0; i < 1000; i++, ts += 500) {
+            native_twc_add_point(twc, static_cast<float>(i % 97), ts);
+            native_chart_add_point(chart, static_cast<float>(i % 89), ts);
+            native_peak_add_value(peak, static_cast<float>(i % 83), ts);
+            native_buffer_push(&buffer, static_cast<float>(i % 79), ts);
+
+            native_twc_get_stats(twc, &stats);
+            count = native_chart_get_normalized(chart, series, 60);
+            native_chart_get_range(chart, &min_value, &max_value);
+            native_peak_get_data(peak, &peak_data);
+            p95 = native_calc_percentile(&buffer, 95, WINDOW_1M, ts);
+        }
+        allocations = counter.heap_allocations();
+    }
+
+    EXPECT_EQ(0, allocations);
+    EXPECT_EQ(60, count);
+    EXPECT_GT(stats.p95, 0.0f);
+    EXPECT_GT(p95, 0.0f);
+
+    native_buffer_free(&buffer);
+    native_twc_destroy(twc);
+    native_chart_destroy(chart);
+    native_peak_destroy(peak);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "native_cpufreq.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the cpufreq sampler. fixtures/tv_box has a little cluster
+ * (cpu0-1, 1.8 GHz) and a big one (cpu2-3, 2.4 GHz) whose scaling_max_freq
+ * drops to 1.4 GHz in the last snapshot (thermal cap).
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+}  // namespace
+
+class NativeCpuFreqTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_cpufreq_close();
+    }
+
+    void TearDown() override {
+        native_cpufreq_close();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+};
+
+TEST_F(NativeCpuFreqTest, ParsesTimeInState) {
+    uint32_t freqs[CPUFREQ_MAX_STATES];
+    uint64_t times[CPUFREQ_MAX_STATES];
+    const char* text = "600000 10000\n1000000 5000\ngarbage\n1800000 2000\n";
+
+    ASSERT_EQ(3, native_cpufreq_parse_time_in_state(text, freqs, times, CPUFREQ_MAX_STATES));
+    EXPECT_EQ(600000u, freqs[0]);
+    EXPECT_EQ(10000u, times[0]);
+    EXPECT_EQ(1800000u, freqs[2]);
+    EXPECT_EQ(2000u, times[2]);
+
+    EXPECT_EQ(1, native_cpufreq_parse_time_in_state(text, freqs, times, 1));
+    EXPECT_EQ(0, native_cpufreq_parse_time_in_state("", freqs, times, CPUFREQ_MAX_STATES));
+}
+
+TEST_F(NativeCpuFreqTest, GroupsCpusIntoPolicies) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    CpuFreqPolicy policies[CPUFREQ_MAX_POLICIES];
+    ASSERT_EQ(2, native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES));
+
+    EXPECT_EQ(0, policies[0].first_cpu);
+    EXPECT_EQ(0x3u, policies[0].cpu_mask);
+    EXPECT_EQ(1200000u, policies[0].cur_khz);
+    EXPECT_EQ(1800000u, policies[0].cpuinfo_max_khz);
+    EXPECT_EQ(1, policies[0].online);
+
+    EXPECT_EQ(2, policies[1].first_cpu);
+    EXPECT_EQ(0xCu, policies[1].cpu_mask);
+    EXPECT_EQ(2400000u, policies[1].cpuinfo_max_khz);
+
+    // No previous time_in_state yet: the average is the instantaneous value
+    EXPECT_EQ(0, policies[0].has_residency);
+    EXPECT_EQ(policies[0].cur_khz, policies[0].avg_khz);
+}
+
+TEST_F(NativeCpuFreqTest, AveragesResidencyAcrossReplaySteps) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    CpuFreqPolicy policies[CPUFREQ_MAX_POLICIES];
+    native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES);
+
+    // Second 1: little cluster 50/50 at 1.0 and 1.8 GHz; descriptors are
+    // reopened on the new root but the residency baseline is kept
+    native_replay_step();
+    ASSERT_EQ(2, native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES));
+    ASSERT_EQ(1, policies[0].has_residency);
+    EXPECT_EQ(1800000u, policies[0].cur_khz);
+    EXPECT_EQ(1400000u, policies[0].avg_khz);
+    EXPECT_EQ(2300000u, policies[1].avg_khz);
+
+    // Second 2: big cluster capped to 1.4 GHz
+    native_replay_step();
+    ASSERT_EQ(2, native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES));
+    EXPECT_EQ(600000u, policies[0].avg_khz);
+    EXPECT_EQ(1000000u, policies[0].cur_khz);
+    EXPECT_EQ(1400000u, policies[1].scaling_max_khz);
+    EXPECT_EQ(2400000u, policies[1].cpuinfo_max_khz);
+    EXPECT_EQ(1400000u, policies[1].avg_khz);
+}
+
+TEST_F(NativeCpuFreqTest, MissingCpufreqReportsNoPolicies) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+
+    CpuFreqPolicy policies[CPUFREQ_MAX_POLICIES];
+    EXPECT_EQ(0, native_cpufreq_sample(policies, CPUFREQ_MAX_POLICIES));
+    EXPECT_EQ(-1, native_cpufreq_sample(nullptr, CPUFREQ_MAX_POLICIES));
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "native_disk_stats.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the /proc/diskstats collector. fixtures/tv_box has eMMC reads
+ * in the first second and an OTA-style write burst in the second, next to
+ * loop/zram/dm layers and partitions that must not be counted.
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+const DiskRateNative* find_device(const DiskRateNative* rates, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(rates[i].name, name) == 0) return &rates[i];
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+class NativeDiskStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_disk_reset();
+    }
+
+    void TearDown() override {
+        native_disk_reset();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+};
+
+TEST_F(NativeDiskStatsTest, KeepsOnlyWholePhysicalDevices) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    DiskStatsNative stats[DISK_MAX_DEVICES];
+    ASSERT_EQ(3, native_read_diskstats(stats, DISK_MAX_DEVICES));
+
+    // Partitions, loop/zram/dm layers and the idle rpmb area are dropped
+    EXPECT_STREQ("mmcblk0", stats[0].name);
+    EXPECT_STREQ("mmcblk0boot0", stats[1].name);
+    EXPECT_STREQ("sda", stats[2].name);
+
+    EXPECT_EQ(179u, stats[0].major);
+    EXPECT_EQ(20000u, stats[0].reads_completed);
+    EXPECT_EQ(4000000u, stats[0].sectors_read);
+    EXPECT_EQ(800000u, stats[0].sectors_written);
+    EXPECT_EQ(40000u, stats[0].io_time_ms);
+}
+
+TEST_F(NativeDiskStatsTest, PartitionNamingFollowsKernelRules) {
+    const char* text =
+        " 259 0 nvme0n1 10 0 80 1 0 0 0 0 0 1 1\n"
+        " 259 1 nvme0n1p1 10 0 80 1 0 0 0 0 0 1 1\n"
+        "   9 1 md1 5 0 40 1 0 0 0 0 0 1 1\n"
+        "   9 10 md10 5 0 40 1 0 0 0 0 0 1 1\n"
+        "   8 0 sda 5 0 40 1 0 0 0 0 0 1 1\n"
+        "   8 15 sda15 5 0 40 1 0 0 0 0 0 1 1\n"
+        "   8 16 sdb 5 0 40 1 0 0 0 0 0 1 1\n"
+        "   8 17 truncated 5 0\n";
+
+    DiskStatsNative stats[DISK_MAX_DEVICES];
+    ASSERT_EQ(5, native_parse_diskstats(text, stats, DISK_MAX_DEVICES));
+    EXPECT_STREQ("nvme0n1", stats[0].name);
+    EXPECT_STREQ("md1", stats[1].name);
+    EXPECT_STREQ("md10", stats[2].name);  // "<digit-disk>0" is not a partition
+    EXPECT_STREQ("sda", stats[3].name);
+    EXPECT_STREQ("sdb", stats[4].name);
+
+    // max_count caps the output
+    EXPECT_EQ(2, native_parse_diskstats(text, stats, 2));
+}
+
+TEST_F(NativeDiskStatsTest, FirstSampleOnlyEstablishesBaseline) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    DiskRateNative total;
+    ASSERT_EQ(3, native_disk_sample(rates, DISK_MAX_DEVICES, &total));
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(0, rates[i].is_valid);
+    }
+    EXPECT_EQ(0, total.is_valid);
+}
+
+TEST_F(NativeDiskStatsTest, ComputesThroughputIopsAndUtilization) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    DiskRateNative total;
+    native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+
+    // Second 1: 40960 sectors read, 2048 written, 250 ms busy on the eMMC
+    native_replay_step();
+    int count = native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+    ASSERT_EQ(3, count);
+
+    const DiskRateNative* emmc = find_device(rates, count, "mmcblk0");
+    ASSERT_NE(nullptr, emmc);
+    ASSERT_EQ(1, emmc->is_valid);
+    EXPECT_EQ(40960u * 512u, emmc->read_bytes_per_sec);
+    EXPECT_EQ(2048u * 512u, emmc->write_bytes_per_sec);
+    EXPECT_FLOAT_EQ(200.0f, emmc->read_iops);
+    EXPECT_FLOAT_EQ(50.0f, emmc->write_iops);
+    EXPECT_FLOAT_EQ(25.0f, emmc->utilization);
+
+    const DiskRateNative* sda = find_device(rates, count, "sda");
+    ASSERT_NE(nullptr, sda);
+    EXPECT_EQ(80u * 512u, sda->read_bytes_per_sec);
+    EXPECT_FLOAT_EQ(0.5f, sda->utilization);
+
+    EXPECT_EQ(1, total.is_valid);
+    EXPECT_EQ((40960u + 80u) * 512u, total.read_bytes_per_sec);
+    EXPECT_FLOAT_EQ(210.0f, total.read_iops);
+    EXPECT_FLOAT_EQ(25.0f, total.utilization);  // busiest device, not the sum
+}
+
+TEST_F(NativeDiskStatsTest, WriteBurstSaturatesAndNewDeviceStartsFresh) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    DiskRateNative total;
+    native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+    native_replay_step();
+    native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+
+    native_replay_step();
+    int count = native_disk_sample(rates, DISK_MAX_DEVICES, &total);
+    ASSERT_EQ(4, count);
+
+    const DiskRateNative* emmc = find_device(rates, count, "mmcblk0");
+    ASSERT_NE(nullptr, emmc);
+    EXPECT_EQ(0u, emmc->read_bytes_per_sec);
+    EXPECT_EQ(102400u * 512u, emmc->write_bytes_per_sec);
+    EXPECT_FLOAT_EQ(1000.0f, emmc->write_iops);
+    EXPECT_FLOAT_EQ(100.0f, emmc->utilization);
+    EXPECT_EQ(3u, emmc->in_flight);
+
+    // USB stick plugged in between samples: no rate until the next one
+    const DiskRateNative* usb = find_device(rates, count, "sdb");
+    ASSERT_NE(nullptr, usb);
+    EXPECT_EQ(0, usb->is_valid);
+}
+
+TEST_F(NativeDiskStatsTest, MissingFileIsAnError) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+
+    DiskRateNative rates[DISK_MAX_DEVICES];
+    EXPECT_EQ(-1, native_disk_sample(rates, DISK_MAX_DEVICES, nullptr));
+}
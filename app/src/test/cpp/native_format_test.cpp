@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include "native_format.h"
+#include "native_analytics.h"
+#include "native_metrics.h"
+#include "native_network_stats.h"
+
+/**
+ * Golden-output tests for the shared native format kernel.
+ * Every expected string here is what the overlay/UI shows to the user,
+ * so a change in this file is a user-visible formatting change.
+ */
+namespace {
+
+std::string speed(uint64_t bps, const char* prefix = nullptr) {
+    char buffer[64];
+    native_fmt_speed(buffer, sizeof(buffer), prefix, bps);
+    return buffer;
+}
+
+std::string bytes(uint64_t value) {
+    char buffer[64];
+    native_fmt_bytes(buffer, sizeof(buffer), value);
+    return buffer;
+}
+
+std::string percent(float value) {
+    char buffer[32];
+    native_fmt_percent(buffer, sizeof(buffer), value);
+    return buffer;
+}
+
+std::string fixed(double value, int decimals) {
+    char buffer[64];
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, sizeof(buffer));
+    native_fmt_put_fixed(&writer, value, decimals);
+    native_fmt_finish(&writer);
+    return buffer;
+}
+
+std::string integer(uint64_t value, int min_digits) {
+    char buffer[32];
+    FormatWriter writer;
+    native_fmt_init(&writer, buffer, sizeof(buffer));
+    native_fmt_put_u64(&writer, value, min_digits);
+    native_fmt_finish(&writer);
+    return buffer;
+}
+
+constexpr uint64_t KB = 1024ULL;
+constexpr uint64_t MB = KB * 1024ULL;
+constexpr uint64_t GB = MB * 1024ULL;
+
+}  // namespace
+
+TEST(NativeFormatTest, SpeedUnitBoundaries) {
+    EXPECT_EQ("0 B/s", speed(0));
+    EXPECT_EQ("1023 B/s", speed(KB - 1));
+    EXPECT_EQ("1.0 KB/s", speed(KB));
+    EXPECT_EQ("1.5 KB/s", speed(KB + KB / 2));
+    EXPECT_EQ("1023.9 KB/s", speed(1023 * KB + 972));
+    EXPECT_EQ("1.00 MB/s", speed(MB - 1));
+    EXPECT_EQ("1.00 MB/s", speed(MB));
+    EXPECT_EQ("2.25 MB/s", speed(2 * MB + MB / 4));
+    EXPECT_EQ("1023.99 MB/s", speed(GB - 6 * MB / 1000 - 1));
+    EXPECT_EQ("1.00 GB/s", speed(GB - 1));
+    EXPECT_EQ("1.00 GB/s", speed(GB));
+    EXPECT_EQ("4096.00 GB/s", speed(4096 * GB));
+    EXPECT_EQ("17179869184.00 GB/s", speed(UINT64_MAX));
+}
+
+TEST(NativeFormatTest, SpeedPrefixIsCopiedVerbatim) {
+    EXPECT_EQ("\xE2\x86\x93" "1.5 KB/s", speed(KB + KB / 2, "\xE2\x86\x93"));
+    EXPECT_EQ("0 B/s", speed(0, ""));
+}
+
+TEST(NativeFormatTest, BytesUnitBoundaries) {
+    EXPECT_EQ("0 B", bytes(0));
+    EXPECT_EQ("1023 B", bytes(KB - 1));
+    EXPECT_EQ("1.0 KB", bytes(KB));
+    EXPECT_EQ("1.0 MB", bytes(MB - 1));
+    EXPECT_EQ("1.3 MB", bytes(MB + MB / 4));
+    EXPECT_EQ("1023.9 MB", bytes(1023 * MB + 900 * KB));
+    EXPECT_EQ("1.00 GB", bytes(GB - 1));
+    EXPECT_EQ("2.50 GB", bytes(2 * GB + GB / 2));
+}
+
+TEST(NativeFormatTest, PercentRounding) {
+    EXPECT_EQ("0.0%", percent(0.0f));
+    EXPECT_EQ("42.5%", percent(42.46f));
+    EXPECT_EQ("99.9%", percent(99.94f));
+    EXPECT_EQ("100.0%", percent(99.96f));
+    EXPECT_EQ("100.0%", percent(100.0f));
+    EXPECT_EQ("0.0%", percent(-0.04f));
+    EXPECT_EQ("-1.5%", percent(-1.5f));
+    EXPECT_EQ("0.0%", percent(NAN));
+}
+
+TEST(NativeFormatTest, FixedPointDecimals) {
+    EXPECT_EQ("55", fixed(55.4, 0));
+    EXPECT_EQ("56", fixed(55.5, 0));
+    EXPECT_EQ("5.5", fixed(5.5, 1));
+    EXPECT_EQ("0.12", fixed(0.123, 2));
+    EXPECT_EQ("0.05", fixed(0.05, 2));
+    EXPECT_EQ("1.000000", fixed(0.9999999, 6));
+    EXPECT_EQ("3.141590", fixed(3.14159, 9));  // Clamped to 6 places
+}
+
+TEST(NativeFormatTest, IntegerPadding) {
+    EXPECT_EQ("0", integer(0, 1));
+    EXPECT_EQ("07", integer(7, 2));
+    EXPECT_EQ("42", integer(42, 2));
+    EXPECT_EQ("100", integer(100, 2));
+    EXPECT_EQ("18446744073709551615", integer(UINT64_MAX, 1));
+}
+
+TEST(NativeFormatTest, TruncationFollowsSnprintfContract) {
+    char buffer[4];
+    int len = native_fmt_speed(buffer, sizeof(buffer), nullptr, KB + KB / 2);
+
+    EXPECT_EQ(8, len);
+    EXPECT_EQ(std::string("1.5"), buffer);
+}
+
+TEST(NativeFormatTest, InvalidBufferIsRejected) {
+    char buffer[8];
+    EXPECT_EQ(-1, native_fmt_speed(nullptr, 8, nullptr, 1));
+    EXPECT_EQ(-1, native_fmt_bytes(buffer, 0, 1));
+    EXPECT_EQ(-1, native_fmt_percent(buffer, -1, 1.0f));
+}
+
+TEST(NativeFormatTest, EntryPointsShareOneStyle) {
+    char network[64];
+    char analytics[64];
+
+    native_format_speed_string(1536, network, sizeof(network), nullptr);
+    native_format_speed(analytics, sizeof(analytics), 1536);
+    EXPECT_EQ(std::string(network), analytics);
+
+    native_format_bytes_string(3 * MB, network, sizeof(network));
+    native_format_memory(analytics, sizeof(analytics), 3 * MB);
+    EXPECT_EQ("3.0 MB", std::string(network));
+    EXPECT_EQ(std::string(network), analytics);
+
+    native_format_memory(analytics, sizeof(analytics), -42);
+    EXPECT_EQ("0 B", std::string(analytics));
+
+    native_format_percent(analytics, sizeof(analytics), 12.34f);
+    EXPECT_EQ("12.3%", std::string(analytics));
+}
+
+TEST(NativeFormatTest, OverlayStrings) {
+    char buffer[32];
+
+    format_time_string(buffer, sizeof(buffer), 9, 5, true);
+    EXPECT_EQ("09:05", std::string(buffer));
+    format_time_string(buffer, sizeof(buffer), 0, 0, false);
+    EXPECT_EQ("12:00 AM", std::string(buffer));
+    format_time_string(buffer, sizeof(buffer), 13, 7, false);
+    EXPECT_EQ("1:07 PM", std::string(buffer));
+
+    format_cpu_string(buffer, sizeof(buffer), 55.4f);
+    EXPECT_EQ("CPU: 55%", std::string(buffer));
+    format_cpu_string(buffer, sizeof(buffer), 5.5f);
+    EXPECT_EQ("CPU: 5.5%", std::string(buffer));
+    format_cpu_string(buffer, sizeof(buffer), 0.123f);
+    EXPECT_EQ("CPU: 0.12%", std::string(buffer));
+    format_cpu_string(buffer, sizeof(buffer), 0.04f);
+    EXPECT_EQ("CPU: 0.0%", std::string(buffer));
+
+    format_ram_string(buffer, sizeof(buffer), 1536, 4096);
+    EXPECT_EQ("RAM: 1536/4096 MB", std::string(buffer));
+
+    format_self_stats_string(buffer, sizeof(buffer), 2.25f, 48);
+    EXPECT_EQ("Self: 2.3% / 48M", std::string(buffer));
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "native_frames.h"
+
+/**
+ * Tests for the frame-time engine: jank in missed vsyncs, histogram
+ * percentiles and 1% low against exact values, the window and batching.
+ */
+namespace {
+
+constexpr int64_t NS_PER_MS = 1000000;
+
+// Vsync timestamps starting at start_ns with the given frame durations
+std::vector<int64_t> timestamps(const std::vector<double>& durations_ms, int64_t start_ns = 1000 * NS_PER_MS) {
+    std::vector<int64_t> out = { start_ns };
+    double t = static_cast<double>(start_ns);
+    for (double ms : durations_ms) {
+        t += ms * NS_PER_MS;
+        out.push_back(static_cast<int64_t>(t));
+    }
+    return out;
+}
+
+FrameStats stats_of(int64_t handle) {
+    FrameStats stats;
+    EXPECT_EQ(0, native_frames_get_stats(handle, &stats));
+    return stats;
+}
+
+}  // namespace
+
+TEST(NativeFramesTest, Steady60HzHasNoJank) {
+    int64_t frames = native_frames_create(60.0f, 0);
+    ASSERT_NE(0, frames);
+
+    // 10 s of vsyncs with +/-1 ms jitter
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> jitter(-1.0, 1.0);
+    std::vector<double> durations;
+    for (int i = 0; i < 600; i++) durations.push_back(1000.0 / 60 + jitter(rng));
+    std::vector<int64_t> ts = timestamps(durations);
+    EXPECT_EQ(600, native_frames_add(frames, ts.data(), static_cast<int32_t>(ts.size())));
+
+    FrameStats stats = stats_of(frames);
+    EXPECT_EQ(600, stats.frames);
+    EXPECT_EQ(600, stats.total_frames);
+    EXPECT_EQ(0, stats.jank_frames);
+    EXPECT_EQ(0, stats.missed_vsyncs);
+    EXPECT_NEAR(60.0f, stats.fps_average, 0.5f);
+    EXPECT_NEAR(60.0f, stats.fps_current, 1.0f);
+    EXPECT_NEAR(16.67f, stats.p50_ms, 0.5f);
+    EXPECT_LT(stats.max_ms, 17.7f);
+    EXPECT_GT(stats.fps_low_1pct, 56.0f);
+    EXPECT_FLOAT_EQ(60.0f, stats.refresh_hz);
+
+    native_frames_destroy(frames);
+}
+
+TEST(NativeFramesTest, JankIsCountedInMissedVsyncsForTheRefreshRate) {
+    // One frame of each: on time, one vsync missed, two missed, three missed
+    std::vector<int64_t> ts = timestamps({ 16.7, 33.3, 50.1, 66.4 });
+
+    int64_t at60 = native_frames_create(60.0f, 0);
+    native_frames_add(at60, ts.data(), static_cast<int32_t>(ts.size()));
+    FrameStats stats = stats_of(at60);
+    EXPECT_EQ(4, stats.frames);
+    EXPECT_EQ(3, stats.jank_frames);
+    EXPECT_EQ(6, stats.missed_vsyncs);
+    EXPECT_EQ(3, stats.total_jank);
+
+    // The same frames on a 120 Hz panel each missed one more period per 8.3 ms
+    int64_t at120 = native_frames_create(120.0f, 0);
+    native_frames_add(at120, ts.data(), static_cast<int32_t>(ts.size()));
+    stats = stats_of(at120);
+    EXPECT_EQ(4, stats.jank_frames);
+    EXPECT_EQ(1 + 3 + 5 + 7, stats.missed_vsyncs);
+
+    // A 30 Hz panel: 33.3 ms is on time
+    int64_t at30 = native_frames_create(30.0f, 0);
+    native_frames_add(at30, ts.data(), static_cast<int32_t>(ts.size()));
+    stats = stats_of(at30);
+    EXPECT_EQ(2, stats.jank_frames);
+    EXPECT_EQ(1 + 1, stats.missed_vsyncs);
+
+    // Switching the rate restarts the window, keeping the totals
+    EXPECT_EQ(0, native_frames_set_refresh_rate(at30, 60.0f));
+    stats = stats_of(at30);
+    EXPECT_EQ(0, stats.frames);
+    EXPECT_EQ(4, stats.total_frames);
+    EXPECT_EQ(2, stats.total_jank);
+
+    native_frames_destroy(at60);
+    native_frames_destroy(at120);
+    native_frames_destroy(at30);
+}
+
+TEST(NativeFramesTest, PercentilesAndOnePercentLowMatchExactValues) {
+    int64_t frames = native_frames_create(60.0f, 0);
+    std::mt19937 rng(11);
+    std::lognormal_distribution<double> frame_ms(2.9, 0.35);  // median ~18 ms with a long tail
+    std::vector<double> durations;
+    for (int i = 0; i < 3000; i++) durations.push_back(std::min(frame_ms(rng), 900.0));
+    std::vector<int64_t> ts = timestamps(durations);
+    native_frames_add(frames, ts.data(), static_cast<int32_t>(ts.size()));
+
+    // The engine sees whole microseconds
+    std::vector<double> sorted;
+    for (size_t i = 1; i < ts.size(); i++) sorted.push_back(((ts[i] - ts[i - 1]) / 1000) / 1000.0);
+    std::sort(sorted.begin(), sorted.end());
+    auto rank = [&](int p) { return sorted[(sorted.size() * p + 99) / 100 - 1]; };
+
+    FrameStats stats = stats_of(frames);
+    EXPECT_NEAR(rank(50), stats.p50_ms, rank(50) * 0.02);
+    EXPECT_NEAR(rank(90), stats.p90_ms, rank(90) * 0.02);
+    EXPECT_NEAR(rank(99), stats.p99_ms, rank(99) * 0.02);
+    EXPECT_NEAR(sorted.back(), stats.max_ms, 0.001);
+
+    double slowest = 0.0;
+    for (size_t i = sorted.size() - 30; i < sorted.size(); i++) slowest += sorted[i];
+    double low = 30 * 1000.0 / slowest;
+    EXPECT_NEAR(low, stats.fps_low_1pct, low * 0.02);
+
+    native_frames_destroy(frames);
+}
+
+TEST(NativeFramesTest, WindowEvictsOldFramesAndGapsStartNewRuns) {
+    int64_t frames = native_frames_create(60.0f, 1000);
+    std::vector<double> steady(120, 1000.0 / 60);
+    std::vector<int64_t> ts = timestamps(steady);
+    native_frames_add(frames, ts.data(), static_cast<int32_t>(ts.size()));
+
+    FrameStats stats = stats_of(frames);
+    EXPECT_EQ(60, stats.frames);
+    EXPECT_EQ(120, stats.total_frames);
+
+    // Two slow frames, then paused for 5 s: the pause is not a frame
+    int64_t last = ts.back();
+    int64_t more[] = { last + 50 * NS_PER_MS, last + 100 * NS_PER_MS, last + 5100 * NS_PER_MS,
+                       last + 5117 * NS_PER_MS };
+    EXPECT_EQ(3, native_frames_add(frames, more, 4));
+    stats = stats_of(frames);
+    EXPECT_EQ(123, stats.total_frames);
+    EXPECT_EQ(2, stats.jank_frames);
+    EXPECT_EQ(4, stats.missed_vsyncs);
+    EXPECT_LT(stats.max_ms, 60.0f);
+
+    // Old jank leaves the window with its frames
+    std::vector<int64_t> later = timestamps(steady, more[3]);
+    native_frames_add(frames, later.data() + 1, static_cast<int32_t>(later.size() - 1));
+    stats = stats_of(frames);
+    EXPECT_EQ(0, stats.jank_frames);
+    EXPECT_EQ(2, stats.total_jank);
+
+    native_frames_destroy(frames);
+}
+
+TEST(NativeFramesTest, BatchesStatsLayoutAndInvalidInput) {
+    std::vector<double> mixed;
+    for (int i = 0; i < 500; i++) mixed.push_back(i % 50 == 0 ? 35.0 : 16.6);
+    std::vector<int64_t> ts = timestamps(mixed);
+
+    // Split into uneven batches with a duplicate and a step back in between
+    int64_t batched = native_frames_create(60.0f, 0);
+    int64_t single = native_frames_create(60.0f, 0);
+    native_frames_add(single, ts.data(), static_cast<int32_t>(ts.size()));
+    size_t pos = 0;
+    for (size_t size : { 1, 7, 100, 250 }) {
+        native_frames_add(batched, ts.data() + pos, static_cast<int32_t>(size));
+        pos += size;
+    }
+    int64_t stale[] = { ts[pos - 1], ts[pos - 2] };
+    EXPECT_EQ(0, native_frames_add(batched, stale, 2));
+    native_frames_add(batched, ts.data() + pos, static_cast<int32_t>(ts.size() - pos));
+
+    FrameStats a = stats_of(batched);
+    FrameStats b = stats_of(single);
+    EXPECT_EQ(0, memcmp(&a, &b, sizeof(FrameStats)));
+    EXPECT_EQ(10, a.jank_frames);
+
+    alignas(8) uint8_t out[FRAME_OUT_SIZE];
+    ASSERT_EQ(FRAME_OUT_SIZE, native_frames_get_stats_into(batched, out, sizeof(out)));
+    int64_t totals[2];
+    int32_t counts[3];
+    float values[8];
+    memcpy(totals, out + FRAME_OUT_TOTALS, sizeof(totals));
+    memcpy(counts, out + FRAME_OUT_COUNTS, sizeof(counts));
+    memcpy(values, out + FRAME_OUT_VALUES, sizeof(values));
+    EXPECT_EQ(a.total_frames, totals[0]);
+    EXPECT_EQ(a.total_jank, totals[1]);
+    EXPECT_EQ(a.missed_vsyncs, counts[2]);
+    EXPECT_FLOAT_EQ(a.fps_low_1pct, values[2]);
+    EXPECT_FLOAT_EQ(a.refresh_hz, values[7]);
+    EXPECT_EQ(-1, native_frames_get_stats_into(batched, out, FRAME_OUT_SIZE - 1));
+
+    native_frames_reset(batched);
+    a = stats_of(batched);
+    EXPECT_EQ(0, a.total_frames);
+    EXPECT_EQ(0, native_frames_add(batched, ts.data(), 1));  // first timestamp only starts a run
+
+    EXPECT_EQ(0, native_frames_create(0.0f, 0));
+    EXPECT_EQ(0, native_frames_create(FRAME_REFRESH_MAX_HZ + 1.0f, 0));
+    EXPECT_EQ(-1, native_frames_set_refresh_rate(batched, -60.0f));
+    native_frames_destroy(batched);
+    native_frames_destroy(single);
+
+    FrameStats gone;
+    EXPECT_EQ(-1, native_frames_add(batched, ts.data(), 2));
+    EXPECT_EQ(-1, native_frames_get_stats(batched, &gone));
+    EXPECT_EQ(0, gone.total_frames);
+    EXPECT_EQ(-1, native_frames_get_stats_into(batched, out, sizeof(out)));
+}
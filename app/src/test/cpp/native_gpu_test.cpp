@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include "native_gpu.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the GPU sampler. fixtures/tv_box is a Mali box whose load
+ * and clock climb over the 3 snapshots, with a "gpu-thermal" zone next to
+ * the CPU one. Adreno's gpubusy pair is checked against a scratch root.
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+void write_file(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::trunc);
+    out << text;
+}
+
+}  // namespace
+
+class NativeGpuTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_gpu_close();
+    }
+
+    void TearDown() override {
+        native_gpu_close();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+        if (!scratch_.empty()) {
+            std::string cleanup = "rm -rf '" + scratch_ + "'";
+            ASSERT_EQ(0, system(cleanup.c_str()));
+        }
+    }
+
+    // kgsl-3d0 under a temporary root
+    void make_adreno_root() {
+        char dir_template[] = "/tmp/sysmetrics_gpu_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        scratch_ = dir_template;
+        kgsl_ = scratch_ + SYS_KGSL_GPU;
+        ASSERT_EQ(0, system(("mkdir -p '" + kgsl_ + "'").c_str()));
+        write_file(kgsl_ + "/gpubusy", "   1000    4000\n");
+        write_file(kgsl_ + "/gpuclk", "585000000\n");
+        write_file(kgsl_ + "/temp", "45000\n");
+        ASSERT_EQ(0, native_paths_set_root(scratch_.c_str()));
+    }
+
+    std::string scratch_;
+    std::string kgsl_;
+};
+
+TEST_F(NativeGpuTest, ParsesBusyPair) {
+    uint64_t busy, total;
+    ASSERT_EQ(0, native_gpu_parse_busy("  250  1000\n", &busy, &total));
+    EXPECT_EQ(250u, busy);
+    EXPECT_EQ(1000u, total);
+
+    EXPECT_EQ(-1, native_gpu_parse_busy("250\n", &busy, &total));
+    EXPECT_EQ(-1, native_gpu_parse_busy("", &busy, &total));
+}
+
+TEST_F(NativeGpuTest, ReadsMaliFromFixture) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    GpuSample sample;
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_EQ(GPU_VENDOR_MALI, sample.vendor);
+    EXPECT_EQ(1, sample.has_usage);
+    EXPECT_FLOAT_EQ(35.0f, sample.usage_percent);
+    EXPECT_EQ(400, sample.freq_mhz);
+    EXPECT_FLOAT_EQ(48.0f, sample.temp_celsius);  // thermal_zone2, not the CPU zone
+}
+
+TEST_F(NativeGpuTest, RedetectsAcrossReplaySteps) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    GpuSample sample;
+    native_gpu_sample(&sample);
+    native_replay_step();
+    native_replay_step();
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_FLOAT_EQ(88.0f, sample.usage_percent);
+    EXPECT_EQ(800, sample.freq_mhz);
+    EXPECT_FLOAT_EQ(57.25f, sample.temp_celsius);
+}
+
+TEST_F(NativeGpuTest, AdrenoBusyIsADelta) {
+    make_adreno_root();
+
+    GpuSample sample;
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_EQ(GPU_VENDOR_ADRENO, native_gpu_vendor());
+    EXPECT_FLOAT_EQ(25.0f, sample.usage_percent);  // no baseline: the pair itself
+    EXPECT_EQ(585, sample.freq_mhz);
+    EXPECT_FLOAT_EQ(45.0f, sample.temp_celsius);
+
+    // Descriptors stay open; sysfs-style rewrites are seen on the next pread
+    write_file(kgsl_ + "/gpubusy", "3000 8000\n");
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_FLOAT_EQ(50.0f, sample.usage_percent);
+
+    // Window-style kernels: total went backwards, use the pair as is
+    write_file(kgsl_ + "/gpubusy", "100 1000\n");
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_FLOAT_EQ(10.0f, sample.usage_percent);
+}
+
+TEST_F(NativeGpuTest, VendorIsDetectedOnce) {
+    make_adreno_root();
+
+    GpuSample sample;
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    ASSERT_EQ(0, system(("mkdir -p '" + scratch_ + SYS_MALI_GPU + "'").c_str()));
+    write_file(scratch_ + SYS_MALI_GPU "/utilization", "99\n");
+
+    ASSERT_EQ(0, native_gpu_sample(&sample));
+    EXPECT_EQ(GPU_VENDOR_ADRENO, sample.vendor);
+}
+
+TEST_F(NativeGpuTest, MissingGpuIsAnError) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+
+    GpuSample sample;
+    EXPECT_EQ(-1, native_gpu_sample(&sample));
+    EXPECT_EQ(GPU_VENDOR_NONE, sample.vendor);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "native_instrument.h"
+#include "native_metrics.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the native latency probes: histogram accuracy, the runtime
+ * switch, error accounting and the packed dump consumed over JNI.
+ */
+namespace {
+
+const std::string FIXTURE = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box/000000";
+
+// Record a call that appears to have taken roughly elapsed_ns
+void record_elapsed(NativeProbeId probe, uint64_t elapsed_ns, bool failed = false) {
+    native_instr_record(probe, native_instr_now_ns() - elapsed_ns, failed);
+}
+
+}  // namespace
+
+class NativeInstrumentTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_instr_reset();
+    }
+
+    void TearDown() override {
+        native_instr_set_enabled(false);
+        native_instr_reset();
+        native_paths_set_root(nullptr);
+    }
+};
+
+TEST_F(NativeInstrumentTest, PercentilesStayWithinBucketError) {
+    // 90 fast calls around 10 us, 10 slow ones around 1 ms
+    for (int i = 0; i < 90; i++) record_elapsed(PROBE_TWC_ADD_POINT, 10000);
+    for (int i = 0; i < 10; i++) record_elapsed(PROBE_TWC_ADD_POINT, 1000000);
+
+    ProbeStats stats;
+    ASSERT_EQ(0, native_instr_get_stats(PROBE_TWC_ADD_POINT, &stats));
+    EXPECT_EQ(100u, stats.calls);
+    EXPECT_EQ(0u, stats.errors);
+
+    EXPECT_NEAR(10000.0, static_cast<double>(stats.p50_ns), 10000.0 * 0.07);
+    EXPECT_NEAR(10000.0, static_cast<double>(stats.p90_ns), 10000.0 * 0.07);
+    EXPECT_NEAR(1000000.0, static_cast<double>(stats.p99_ns), 1000000.0 * 0.07);
+    EXPECT_GE(stats.max_ns, 1000000u);
+    EXPECT_LE(stats.p99_ns, stats.max_ns);
+    EXPECT_GE(stats.total_ns, 90u * 10000u + 10u * 1000000u);
+}
+
+TEST_F(NativeInstrumentTest, ProbesRecordNothingWhileDisabled) {
+    native_paths_set_root(FIXTURE.c_str());
+    CpuStats cpu;
+
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    ProbeStats stats;
+    native_instr_get_stats(PROBE_READ_CPU_STATS, &stats);
+    EXPECT_EQ(0u, stats.calls);
+
+    native_instr_set_enabled(true);
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    native_instr_get_stats(PROBE_READ_CPU_STATS, &stats);
+    EXPECT_EQ(2u, stats.calls);
+    EXPECT_GT(stats.max_ns, 0u);
+}
+
+TEST_F(NativeInstrumentTest, FailedCallsCountAsErrors) {
+    native_instr_set_enabled(true);
+    native_paths_set_root("/nonexistent-root");
+
+    CpuStats cpu;
+    EXPECT_EQ(-1, read_cpu_stats(&cpu));
+    EXPECT_LT(read_temperature(0), 0.0f);
+
+    ProbeStats stats;
+    native_instr_get_stats(PROBE_READ_CPU_STATS, &stats);
+    EXPECT_EQ(1u, stats.calls);
+    EXPECT_EQ(1u, stats.errors);
+
+    native_instr_get_stats(PROBE_READ_TEMPERATURE, &stats);
+    EXPECT_EQ(1u, stats.errors);
+}
+
+TEST_F(NativeInstrumentTest, DumpHasHeaderAndFixedStride) {
+    record_elapsed(PROBE_PEAK_GET_DATA, 5000, true);
+
+    std::vector<int64_t> dump(native_instr_dump_size());
+    ASSERT_EQ(-1, native_instr_dump(dump.data(), static_cast<int>(dump.size()) - 1));
+    ASSERT_EQ(static_cast<int>(dump.size()),
+              native_instr_dump(dump.data(), static_cast<int>(dump.size())));
+
+    EXPECT_EQ(INSTR_DUMP_VERSION, dump[0]);
+    EXPECT_EQ(PROBE_COUNT, dump[1]);
+    EXPECT_EQ(INSTR_DUMP_FIELDS, dump[2]);
+
+    const int64_t* peak = &dump[INSTR_DUMP_HEADER + PROBE_PEAK_GET_DATA * INSTR_DUMP_FIELDS];
+    EXPECT_EQ(1, peak[0]);  // calls
+    EXPECT_EQ(1, peak[1]);  // errors
+    EXPECT_GT(peak[4], 0);  // p50
+
+    EXPECT_STREQ("native_peak_get_data", native_instr_probe_name(PROBE_PEAK_GET_DATA));
+    EXPECT_EQ(nullptr, native_instr_probe_name(PROBE_COUNT));
+}
+
+TEST_F(NativeInstrumentTest, ResetClearsEveryProbe) {
+    record_elapsed(PROBE_CHART_ADD_POINT, 2000);
+    native_instr_reset();
+
+    ProbeStats stats;
+    native_instr_get_stats(PROBE_CHART_ADD_POINT, &stats);
+    EXPECT_EQ(0u, stats.calls);
+    EXPECT_EQ(0u, stats.max_ns);
+    EXPECT_EQ(0u, stats.p99_ns);
+}
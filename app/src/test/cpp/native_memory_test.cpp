@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "native_memory.h"
+#include "native_metrics.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the meminfo/vmstat/zram reader. fixtures/tv_box uses the
+ * per-zone allocstall counters of older kernels; second 1 has a burst of
+ * major faults and swap-out, second 2 an OOM kill.
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+}  // namespace
+
+class NativeMemoryTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (int64_t handle : handles_) native_mem_unregister(handle);
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+
+    int64_t register_fields(std::initializer_list<int32_t> fields) {
+        std::vector<int32_t> list(fields);
+        int64_t handle = native_mem_register(list.data(), static_cast<int32_t>(list.size()));
+        if (handle != 0) handles_.push_back(handle);
+        return handle;
+    }
+
+    std::vector<int64_t> handles_;
+};
+
+TEST_F(NativeMemoryTest, LookupMatchesKnownKeysOnly) {
+    EXPECT_EQ(MEM_TOTAL, native_mem_lookup("MemTotal", 8));
+    EXPECT_EQ(MEM_CMA_FREE, native_mem_lookup("CmaFree", 7));
+    EXPECT_EQ(MEM_VM_PGMAJFAULT, native_mem_lookup("pgmajfault", 10));
+    EXPECT_EQ(MEM_VM_ALLOCSTALL, native_mem_lookup("allocstall_movable", 18));
+
+    EXPECT_EQ(-1, native_mem_lookup("MemTotals", 9));
+    EXPECT_EQ(-1, native_mem_lookup("MemTota", 7));
+    EXPECT_EQ(-1, native_mem_lookup("nr_mapped", 9));
+    EXPECT_EQ(-1, native_mem_lookup("", 0));
+}
+
+TEST_F(NativeMemoryTest, ParseFillsOnlyRequestedFields) {
+    const char* text =
+        "MemTotal:        2015732 kB\n"
+        "MemFree:          812000 kB\n"
+        "Shmem:             12000 kB\n"
+        "Unknown:             999 kB\n";
+
+    uint64_t values[MEM_FIELD_COUNT] = {};
+    EXPECT_EQ(2, native_mem_parse(text, (1ull << MEM_TOTAL) | (1ull << MEM_SHMEM), values));
+    EXPECT_EQ(2015732u, values[MEM_TOTAL]);
+    EXPECT_EQ(12000u, values[MEM_SHMEM]);
+    EXPECT_EQ(0u, values[MEM_FREE]);
+}
+
+TEST_F(NativeMemoryTest, ReadsMeminfoAndZramInRegistrationOrder) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    int64_t handle = register_fields({ MEM_SWAP_FREE, MEM_TOTAL, MEM_SLAB, MEM_CMA_TOTAL,
+                                       MEM_ZRAM_ORIG_DATA, MEM_ZRAM_USED });
+    ASSERT_NE(0, handle);
+
+    double values[MEM_FIELD_COUNT];
+    ASSERT_EQ(6, native_mem_read(handle, values, MEM_FIELD_COUNT));
+    EXPECT_DOUBLE_EQ(498000.0, values[0]);
+    EXPECT_DOUBLE_EQ(2015732.0, values[1]);
+    EXPECT_DOUBLE_EQ(64000.0, values[2]);
+    EXPECT_DOUBLE_EQ(65536.0, values[3]);
+    EXPECT_DOUBLE_EQ(102400.0, values[4]);
+    EXPECT_DOUBLE_EQ(32768.0, values[5]);
+}
+
+TEST_F(NativeMemoryTest, VmstatCountersBecomeRates) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    int64_t handle = register_fields({ MEM_VM_PGMAJFAULT, MEM_VM_PSWPOUT, MEM_VM_ALLOCSTALL,
+                                       MEM_VM_WORKINGSET_REFAULT, MEM_VM_OOM_KILL });
+    double values[MEM_FIELD_COUNT];
+    ASSERT_EQ(5, native_mem_read(handle, values, MEM_FIELD_COUNT));
+    for (int i = 0; i < 5; i++) EXPECT_DOUBLE_EQ(0.0, values[i]);
+
+    native_replay_step();
+    ASSERT_EQ(5, native_mem_read(handle, values, MEM_FIELD_COUNT));
+    EXPECT_DOUBLE_EQ(150.0, values[0]);
+    EXPECT_DOUBLE_EQ(80.0, values[1]);
+    EXPECT_DOUBLE_EQ(4.0, values[2]);    // allocstall_normal + allocstall_movable
+    EXPECT_DOUBLE_EQ(300.0, values[3]);  // refault anon + file
+    EXPECT_DOUBLE_EQ(0.0, values[4]);
+
+    native_replay_step();
+    ASSERT_EQ(5, native_mem_read(handle, values, MEM_FIELD_COUNT));
+    EXPECT_DOUBLE_EQ(20.0, values[0]);
+    EXPECT_DOUBLE_EQ(0.0, values[1]);
+    EXPECT_DOUBLE_EQ(1.0, values[4]);
+}
+
+TEST_F(NativeMemoryTest, HandlesKeepIndependentBaselines) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    int64_t early = register_fields({ MEM_VM_PGFAULT });
+    double value;
+    native_mem_read(early, &value, 1);
+    native_replay_step();
+    native_mem_read(early, &value, 1);
+    EXPECT_DOUBLE_EQ(12000.0, value);
+
+    int64_t late = register_fields({ MEM_VM_PGFAULT });
+    native_mem_read(late, &value, 1);
+    EXPECT_DOUBLE_EQ(0.0, value);
+
+    native_replay_step();
+    native_mem_read(late, &value, 1);
+    EXPECT_DOUBLE_EQ(8000.0, value);
+}
+
+TEST_F(NativeMemoryTest, RejectsInvalidFieldSets) {
+    EXPECT_EQ(0, register_fields({ MEM_TOTAL, MEM_TOTAL }));
+    EXPECT_EQ(0, register_fields({ MEM_FIELD_COUNT }));
+    EXPECT_EQ(0, register_fields({ -1 }));
+
+    double values[2];
+    int64_t handle = register_fields({ MEM_TOTAL, MEM_FREE });
+    EXPECT_EQ(-1, native_mem_read(handle, values, 1));
+    EXPECT_EQ(-1, native_mem_read(12345678, values, 2));
+}
+
+TEST_F(NativeMemoryTest, MissingZramReadsAsZero) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+
+    int64_t zram = register_fields({ MEM_ZRAM_USED });
+    double value = -1.0;
+    ASSERT_EQ(1, native_mem_read(zram, &value, 1));
+    EXPECT_DOUBLE_EQ(0.0, value);
+
+    int64_t meminfo = register_fields({ MEM_TOTAL });
+    EXPECT_EQ(-1, native_mem_read(meminfo, &value, 1));
+}
+
+TEST_F(NativeMemoryTest, LegacyMemoryStatsUseTheSameParser) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    MemoryStats stats;
+    ASSERT_EQ(0, read_memory_stats(&stats));
+    EXPECT_EQ(2015732, stats.total_kb);
+    EXPECT_EQ(812000, stats.free_kb);
+    EXPECT_EQ(1203456, stats.available_kb);
+    EXPECT_EQ(40120, stats.buffers_kb);
+    EXPECT_EQ(512300, stats.cached_kb);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "native_paths.h"
+#include "native_metrics.h"
+#include "native_network_stats.h"
+
+/**
+ * Tests for rooted proc/sys path resolution and record/replay, driven by
+ * the recorded fixture in fixtures/tv_box (3 snapshots, 1 s apart).
+ */
+namespace {
+
+const std::string FIXTURE = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+}  // namespace
+
+class NativePathsTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+};
+
+TEST_F(NativePathsTest, LiveRootResolvesToAbsolutePaths) {
+    char path[NATIVE_PATH_MAX];
+
+    ASSERT_GT(native_path(path, sizeof(path), PROC_STAT), 0);
+    EXPECT_STREQ("/proc/stat", path);
+
+    native_path_pid(path, sizeof(path), 1234, "stat");
+    EXPECT_STREQ("/proc/1234/stat", path);
+
+    native_path_task(path, sizeof(path), 1234, 1240, "status");
+    EXPECT_STREQ("/proc/1234/task/1240/status", path);
+
+    native_path_thermal(path, sizeof(path), 3, "temp");
+    EXPECT_STREQ("/sys/class/thermal/thermal_zone3/temp", path);
+}
+
+TEST_F(NativePathsTest, RootPrefixIsPrependedWithoutTrailingSlash) {
+    ASSERT_EQ(0, native_paths_set_root("/tmp/fake/"));
+    EXPECT_STREQ("/tmp/fake", native_paths_get_root());
+
+    char path[NATIVE_PATH_MAX];
+    native_path(path, sizeof(path), PROC_NET_DEV);
+    EXPECT_STREQ("/tmp/fake/proc/net/dev", path);
+
+    ASSERT_EQ(0, native_paths_set_root("/"));
+    native_path(path, sizeof(path), PROC_NET_DEV);
+    EXPECT_STREQ("/proc/net/dev", path);
+}
+
+TEST_F(NativePathsTest, ConcurrentRootChangesNeverTearResolvedPaths) {
+    // Same length, so a torn copy would still be NUL-terminated
+    const std::string a = "/tmp/" + std::string(240, 'a');
+    const std::string b = "/tmp/" + std::string(240, 'b');
+    std::atomic<bool> done(false);
+    ASSERT_EQ(0, native_paths_set_root(a.c_str()));
+
+    std::thread writer([&] {
+        for (int i = 0; i < 200000; i++) native_paths_set_root((i & 1 ? a : b).c_str());
+        done.store(true);
+    });
+
+    int torn = 0;
+    char path[NATIVE_PATH_MAX];
+    while (!done.load()) {
+        native_path(path, sizeof(path), PROC_STAT);
+        std::string resolved(path);
+        if (resolved != a + PROC_STAT && resolved != b + PROC_STAT) torn++;
+    }
+    writer.join();
+    EXPECT_EQ(0, torn);
+}
+
+TEST_F(NativePathsTest, OversizedPathsAreRejected) {
+    std::string long_root(NATIVE_PATH_MAX, 'x');
+    EXPECT_EQ(-1, native_paths_set_root(long_root.c_str()));
+
+    char small[8];
+    EXPECT_EQ(-1, native_path(small, sizeof(small), PROC_MEMINFO));
+}
+
+TEST_F(NativePathsTest, CollectorsReadThroughRoot) {
+    ASSERT_EQ(0, native_paths_set_root((FIXTURE + "/000000").c_str()));
+
+    CpuStats cpu;
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    EXPECT_EQ(10000, cpu.user);
+    EXPECT_EQ(80000, cpu.idle);
+
+    MemoryStats mem;
+    ASSERT_EQ(0, read_memory_stats(&mem));
+    EXPECT_EQ(2015732, mem.total_kb);
+    EXPECT_EQ(1203456, mem.available_kb);
+
+    EXPECT_FLOAT_EQ(52.3f, read_temperature(0));
+    EXPECT_FLOAT_EQ(-1.0f, read_temperature(1));
+
+    InterfaceStatsNative interfaces[MAX_INTERFACES];
+    ASSERT_EQ(3, native_read_proc_net_dev(interfaces, MAX_INTERFACES));
+    EXPECT_STREQ("eth0", interfaces[1].interface_name);
+    EXPECT_EQ(500000000u, interfaces[1].rx_bytes);
+}
+
+TEST_F(NativePathsTest, ReplayReproducesRecordedRates) {
+    ASSERT_EQ(3, native_replay_open(FIXTURE.c_str()));
+    EXPECT_EQ(1700000000000LL, native_clock_now_ms());
+
+    CpuStats cpu_prev;
+    CpuStats cpu_curr;
+    InterfaceStatsNative interfaces[MAX_INTERFACES];
+    NetworkStatsNative net_prev;
+    NetworkStatsNative net_curr;
+
+    ASSERT_EQ(0, read_cpu_stats(&cpu_prev));
+    int count = native_read_proc_net_dev(interfaces, MAX_INTERFACES);
+    native_aggregate_network_stats(interfaces, count, &net_prev);
+
+    ASSERT_EQ(1, native_replay_step());
+    ASSERT_EQ(0, read_cpu_stats(&cpu_curr));
+    count = native_read_proc_net_dev(interfaces, MAX_INTERFACES);
+    native_aggregate_network_stats(interfaces, count, &net_curr);
+
+    // user +30, system +10, idle +60
+    EXPECT_FLOAT_EQ(40.0f, calculate_cpu_usage(&cpu_prev, &cpu_curr));
+
+    NetworkSpeedNative speed;
+    ASSERT_EQ(0, native_calculate_network_speed(&net_prev, &net_curr, &speed));
+    EXPECT_EQ(1048576u, speed.ingress_bytes_per_sec);
+    EXPECT_EQ(102400u, speed.egress_bytes_per_sec);
+}
+
+TEST_F(NativePathsTest, ReplayHoldsTheLastSnapshotUntilRewound) {
+    ASSERT_EQ(3, native_replay_open(FIXTURE.c_str()));
+    ASSERT_EQ(1, native_replay_step());
+    ASSERT_EQ(2, native_replay_step());
+
+    // Past the end the last snapshot stays: counters never run backwards
+    CpuStats before;
+    CpuStats after;
+    ASSERT_EQ(0, read_cpu_stats(&before));
+    int64_t last = native_clock_now_ms();
+    EXPECT_EQ(-1, native_replay_step());
+    EXPECT_EQ(last, native_clock_now_ms());
+    ASSERT_EQ(0, read_cpu_stats(&after));
+    EXPECT_EQ(before.user, after.user);
+    EXPECT_EQ(before.idle, after.idle);
+
+    // A rewind starts the recording over with the clock still moving forward
+    for (int round = 0; round < 2; round++) {
+        ASSERT_EQ(0, native_replay_rewind());
+        EXPECT_EQ(last + 1000, native_clock_now_ms());
+        last = native_clock_now_ms();
+        while (native_replay_step() >= 0) {
+            int64_t now = native_clock_now_ms();
+            EXPECT_EQ(last + 1000, now);
+            last = now;
+        }
+    }
+
+    native_replay_close();
+    EXPECT_EQ(0, native_replay_is_active());
+    EXPECT_STREQ("", native_paths_get_root());
+}
+
+TEST_F(NativePathsTest, RecordedSnapshotReplaysIdentically) {
+    char dir_template[] = "/tmp/sysmetrics_record_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir_template));
+    std::string recording(dir_template);
+
+    ASSERT_EQ(0, native_paths_set_root((FIXTURE + "/000002").c_str()));
+    // stat, meminfo, net/dev, thermal_zone0/2 temp + type, pressure cpu/memory/io, diskstats,
+    // vmstat, zram0 mm_stat, xt_qtaguid, mali utilization + clock, cpufreq of cpu0..3
+    // (related_cpus everywhere, the rest on policy CPUs only)
+    EXPECT_EQ(28, native_record_snapshot(recording.c_str(), 0));
+    native_paths_set_root(nullptr);
+
+    ASSERT_EQ(1, native_replay_open(recording.c_str()));
+    CpuStats cpu;
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    EXPECT_EQ(10080, cpu.user);
+    EXPECT_FLOAT_EQ(55.8f, read_temperature(0));
+    native_replay_close();
+
+    std::string cleanup = "rm -rf '" + recording + "'";
+    ASSERT_EQ(0, system(cleanup.c_str()));
+}
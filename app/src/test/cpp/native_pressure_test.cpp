@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "native_pressure.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the PSI reader and trigger plumbing. fixtures/tv_box carries
+ * /proc/pressure with memory pressure building up over the 3 snapshots.
+ * Trigger registration is checked against a scratch root (regular files
+ * never raise POLLPRI, which also exercises timeout and wake-up).
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int open_fd_count() {
+    int count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir) return -1;
+    while (readdir(dir)) count++;
+    closedir(dir);
+    return count;
+}
+
+}  // namespace
+
+class NativePressureTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        native_psi_trigger_clear();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+        if (!scratch_.empty()) {
+            std::string cleanup = "rm -rf '" + scratch_ + "'";
+            ASSERT_EQ(0, system(cleanup.c_str()));
+        }
+    }
+
+    // Empty pressure files under a temporary root
+    void make_scratch_root() {
+        char dir_template[] = "/tmp/sysmetrics_psi_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        scratch_ = dir_template;
+        ASSERT_EQ(0, system(("mkdir -p '" + scratch_ + "/proc/pressure'").c_str()));
+        for (const char* name : { "cpu", "memory", "io" }) {
+            std::ofstream(scratch_ + "/proc/pressure/" + name).close();
+        }
+        ASSERT_EQ(0, native_paths_set_root(scratch_.c_str()));
+    }
+
+    std::string scratch_;
+};
+
+TEST_F(NativePressureTest, ParsesSomeAndFullLines) {
+    PsiStats stats;
+    ASSERT_EQ(0, native_psi_parse(
+        "some avg10=12.37 avg60=3.15 avg300=1.05 total=9775345\n"
+        "full avg10=6.02 avg60=1.44 avg300=0.46 total=2655120\n", &stats));
+
+    EXPECT_FLOAT_EQ(12.37f, stats.some.avg10);
+    EXPECT_FLOAT_EQ(3.15f, stats.some.avg60);
+    EXPECT_FLOAT_EQ(1.05f, stats.some.avg300);
+    EXPECT_EQ(9775345u, stats.some.total_us);
+    EXPECT_EQ(1, stats.has_full);
+    EXPECT_FLOAT_EQ(6.02f, stats.full.avg10);
+    EXPECT_EQ(2655120u, stats.full.total_us);
+}
+
+TEST_F(NativePressureTest, CpuWithoutFullLineOnOlderKernels) {
+    PsiStats stats;
+    ASSERT_EQ(0, native_psi_parse("some avg10=0.00 avg60=0.00 avg300=0.00 total=42\n", &stats));
+    EXPECT_EQ(0, stats.has_full);
+    EXPECT_EQ(42u, stats.some.total_us);
+
+    EXPECT_EQ(-1, native_psi_parse("garbage\n", &stats));
+    EXPECT_EQ(-1, native_psi_parse("some avg10=1.0 total=5\n", &stats));
+}
+
+TEST_F(NativePressureTest, ReplayShowsMemoryPressureRising) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    PsiStats first, last;
+    ASSERT_EQ(0, native_psi_read(PSI_MEMORY, &first));
+    native_replay_step();
+    native_replay_step();
+    ASSERT_EQ(0, native_psi_read(PSI_MEMORY, &last));
+
+    EXPECT_FLOAT_EQ(0.0f, first.some.avg10);
+    EXPECT_FLOAT_EQ(12.37f, last.some.avg10);
+    // 655 ms of additional stall over the 2 s between snapshots
+    EXPECT_EQ(655000u, last.some.total_us - first.some.total_us);
+
+    PsiStats io;
+    ASSERT_EQ(0, native_psi_read(PSI_IO, &io));
+    EXPECT_EQ(1, io.has_full);
+}
+
+TEST_F(NativePressureTest, MissingPsiIsReported) {
+    native_paths_set_root("/nonexistent-root");
+    PsiStats stats;
+    EXPECT_EQ(-1, native_psi_read(PSI_CPU, &stats));
+    EXPECT_EQ(-1, native_psi_trigger_add(PSI_CPU, 0, 100000, 1000000));
+    EXPECT_EQ(-1, native_psi_wait(0));
+}
+
+TEST_F(NativePressureTest, TriggerWritesKernelSyntax) {
+    make_scratch_root();
+
+    int id = native_psi_trigger_add(PSI_MEMORY, 0, 150000, 1000000);
+    ASSERT_GE(id, 0);
+    int full_id = native_psi_trigger_add(PSI_IO, 1, 500000, 2000000);
+    ASSERT_GE(full_id, 0);
+    EXPECT_NE(id, full_id);
+
+    // Includes the terminating NUL the kernel expects
+    EXPECT_EQ(std::string("some 150000 1000000", 20), read_file(scratch_ + "/proc/pressure/memory"));
+    EXPECT_EQ(std::string("full 500000 2000000", 20), read_file(scratch_ + "/proc/pressure/io"));
+
+    // Windows outside the kernel's 500 ms..10 s range are refused up front
+    EXPECT_EQ(-1, native_psi_trigger_add(PSI_CPU, 0, 1000, 100000));
+    EXPECT_EQ(-1, native_psi_trigger_add(PSI_CPU, 0, 2000000, 1000000));
+}
+
+TEST_F(NativePressureTest, WaitTimesOutAndWakes) {
+    make_scratch_root();
+    ASSERT_GE(native_psi_trigger_add(PSI_CPU, 0, 100000, 1000000), 0);
+
+    EXPECT_EQ(0, native_psi_wait(20));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread waker([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        native_psi_wake();
+    });
+    EXPECT_EQ(0, native_psi_wait(5000));
+    waker.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+}
+
+TEST_F(NativePressureTest, RemovingTriggersDuringAWaitDefersTheClose) {
+    make_scratch_root();
+    ASSERT_GE(native_psi_trigger_add(PSI_CPU, 0, 100000, 1000000), 0);
+    native_psi_wait(0);   // Creates the wake pipe up front
+    int before = open_fd_count();
+    ASSERT_GE(native_psi_trigger_add(PSI_MEMORY, 0, 100000, 1000000), 0);
+    EXPECT_EQ(before + 1, open_fd_count());
+
+    // The clear wakes the wait; its descriptors close only once it returned
+    auto start = std::chrono::steady_clock::now();
+    // (-1 if the clear got in before the wait started polling)
+    std::thread waiter([] { EXPECT_LE(native_psi_wait(5000), 0); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    native_psi_trigger_clear();
+    waiter.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_EQ(before - 1, open_fd_count());
+    EXPECT_EQ(-1, native_psi_wait(0));
+}
+
+TEST_F(NativePressureTest, LiveTriggerOnHostKernel) {
+    if (access("/proc/pressure/cpu", W_OK) != 0) {
+        GTEST_SKIP() << "PSI triggers not available to this user";
+    }
+
+    int id = native_psi_trigger_add(PSI_CPU, 0, 500000, 2000000);
+    if (id < 0) {
+        GTEST_SKIP() << "Kernel refused the PSI trigger";
+    }
+    EXPECT_GE(native_psi_wait(10), 0);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "native_process_memory.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the per-process memory reader against fixtures/tv_box:
+ * pid 1234 has smaps_rollup in every snapshot and is recycled (new
+ * starttime) in snapshot 2; pid 1300 only has a full smaps (old kernel).
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+const std::string FIXTURE = RECORDING + "/000000";
+
+int64_t pages_kb(int64_t pages) {
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+}  // namespace
+
+class NativeProcessMemoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_procmem_clear_cache();
+        native_procmem_set_detail_interval(PROCMEM_DEFAULT_DETAIL_INTERVAL_MS);
+    }
+
+    void TearDown() override {
+        native_replay_close();
+        native_paths_set_root(nullptr);
+        native_procmem_clear_cache();
+    }
+};
+
+TEST_F(NativeProcessMemoryTest, ReadsStatmAndSmapsRollup) {
+    native_paths_set_root(FIXTURE.c_str());
+
+    ProcessMemoryStats stats;
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    EXPECT_EQ(1234, stats.pid);
+    EXPECT_EQ(81234u, stats.start_time);
+    EXPECT_EQ(pages_kb(48000), stats.rss_kb);
+    EXPECT_EQ(pages_kb(21000), stats.shared_kb);
+    EXPECT_EQ(122880, stats.pss_kb);
+    EXPECT_EQ(24576 + 102400, stats.uss_kb);
+    EXPECT_EQ(16384, stats.swap_kb);
+    EXPECT_EQ(12288, stats.swap_pss_kb);
+    EXPECT_GT(stats.detail_timestamp_ms, 0);
+}
+
+TEST_F(NativeProcessMemoryTest, FallsBackToSmapsWithoutRollup) {
+    native_paths_set_root(FIXTURE.c_str());
+
+    ProcessMemoryStats stats;
+    ASSERT_EQ(0, native_procmem_read(1300, &stats));
+    EXPECT_EQ(412u, stats.start_time);
+    EXPECT_EQ(32 + 5000, stats.pss_kb);
+    EXPECT_EQ(32 + 5000, stats.uss_kb);
+    EXPECT_EQ(512, stats.swap_kb);
+    EXPECT_EQ(256, stats.swap_pss_kb);
+}
+
+TEST_F(NativeProcessMemoryTest, DetailFollowsCadenceAndPidReuse) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+    native_procmem_set_detail_interval(5000);
+
+    ProcessMemoryStats stats;
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    EXPECT_EQ(122880, stats.pss_kb);
+
+    // 1 s later: RSS is fresh, PSS still cached
+    native_replay_step();
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    EXPECT_EQ(pages_kb(49024), stats.rss_kb);
+    EXPECT_EQ(122880, stats.pss_kb);
+
+    // Same pid, new starttime: nothing is inherited from the old process
+    native_replay_step();
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    EXPECT_EQ(99999u, stats.start_time);
+    EXPECT_EQ(pages_kb(12000), stats.rss_kb);
+    EXPECT_EQ(30720, stats.pss_kb);
+}
+
+TEST_F(NativeProcessMemoryTest, ZeroIntervalReadsDetailEveryTime) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+    native_procmem_set_detail_interval(0);
+
+    ProcessMemoryStats stats;
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    native_replay_step();
+    ASSERT_EQ(0, native_procmem_read(1234, &stats));
+    EXPECT_EQ(126976, stats.pss_kb);
+}
+
+TEST_F(NativeProcessMemoryTest, BatchKeepsOneRowPerRequestedPid) {
+    native_paths_set_root(FIXTURE.c_str());
+
+    const int32_t pids[] = { 1234, 4242, 1300 };
+    std::vector<int64_t> out(3 * PROCMEM_FIELDS);
+    EXPECT_EQ(-1, native_procmem_read_batch(pids, 3, out.data(), static_cast<int>(out.size()) - 1));
+    ASSERT_EQ(3, native_procmem_read_batch(pids, 3, out.data(), static_cast<int>(out.size())));
+
+    EXPECT_EQ(1234, out[0]);
+    EXPECT_EQ(0, out[1]);
+    EXPECT_EQ(122880, out[4]);
+
+    const int64_t* gone = &out[PROCMEM_FIELDS];
+    EXPECT_EQ(4242, gone[0]);
+    EXPECT_EQ(-1, gone[1]);
+    EXPECT_EQ(-1, gone[2]);
+
+    EXPECT_EQ(1300, out[2 * PROCMEM_FIELDS]);
+    EXPECT_EQ(5032, out[2 * PROCMEM_FIELDS + 5]);
+
+    EXPECT_EQ(2, native_procmem_cache_size());
+    native_procmem_clear_cache();
+    EXPECT_EQ(0, native_procmem_cache_size());
+}
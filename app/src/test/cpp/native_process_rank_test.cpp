@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "native_process_rank.h"
+
+/**
+ * Tests for the bounded-heap top-N ranker. The reference is what
+ * ProcessStatsCollector used to do in Kotlin: filter on the thresholds,
+ * stable sort descending on the key, take N.
+ */
+namespace {
+
+RankParams params_for(int32_t key) {
+    // Constants.ProcessMonitoring
+    return RankParams{ key, 0.01f, 10, 10.0f, 100.0f };
+}
+
+std::vector<int32_t> reference_rank(const std::vector<float>& cpu, const std::vector<int64_t>& ram_kb,
+                                    const RankParams& params, int top_n) {
+    std::vector<int32_t> rows;
+    std::vector<double> keys(cpu.size());
+    for (size_t i = 0; i < cpu.size(); i++) {
+        int64_t ram_mb = ram_kb[i] > 0 ? ram_kb[i] / 1024 : 0;
+        if (!(cpu[i] > params.min_cpu_percent) && ram_mb <= params.min_ram_mb) continue;
+        if (params.key == RANK_BY_CPU) {
+            keys[i] = cpu[i];
+        } else if (params.key == RANK_BY_RAM) {
+            keys[i] = static_cast<double>(ram_mb);
+        } else {
+            keys[i] = cpu[i] * params.cpu_weight + static_cast<float>(ram_mb) / params.ram_mb_divisor;
+        }
+        rows.push_back(static_cast<int32_t>(i));
+    }
+    std::stable_sort(rows.begin(), rows.end(), [&keys](int32_t a, int32_t b) { return keys[a] > keys[b]; });
+    if (static_cast<int>(rows.size()) > top_n) rows.resize(top_n);
+    return rows;
+}
+
+}  // namespace
+
+TEST(NativeProcessRankTest, MatchesStableSortForEveryKey) {
+    std::mt19937 rng(42);
+    // Coarse values so ties (and RAM ties within the same megabyte) are common
+    std::uniform_int_distribution<int> cpu_dist(0, 40);
+    std::uniform_int_distribution<int64_t> ram_dist(0, 300 * 1024);
+
+    for (int round = 0; round < 50; round++) {
+        int count = 1 + round * 7;
+        std::vector<float> cpu(count);
+        std::vector<int64_t> ram_kb(count);
+        for (int i = 0; i < count; i++) {
+            cpu[i] = cpu_dist(rng) * 0.25f;
+            ram_kb[i] = ram_dist(rng);
+        }
+
+        for (int32_t key : { RANK_BY_CPU, RANK_BY_RAM, RANK_BY_COMBINED }) {
+            RankParams params = params_for(key);
+            for (int top_n : { 1, 5, RANK_TOP_MAX }) {
+                int32_t out[RANK_TOP_MAX];
+                int written = native_rank_top_n(cpu.data(), ram_kb.data(), count, &params, top_n, out);
+                std::vector<int32_t> expected = reference_rank(cpu, ram_kb, params, top_n);
+                ASSERT_EQ(static_cast<int>(expected.size()), written) << "key " << key << " n " << count;
+                EXPECT_EQ(expected, std::vector<int32_t>(out, out + written)) << "key " << key << " n " << count;
+            }
+        }
+    }
+}
+
+TEST(NativeProcessRankTest, ThresholdsDropIdleProcesses) {
+    const float cpu[] = { 0.0f, 0.01f, 0.02f, 0.0f, 0.0f };
+    // 10 MB exactly is not above the threshold; negative (unknown) counts as 0
+    const int64_t ram_kb[] = { 10 * 1024, 1023, 0, 10 * 1024 + 1024, -1 };
+    RankParams params = params_for(RANK_BY_COMBINED);
+
+    int32_t out[RANK_TOP_MAX];
+    ASSERT_EQ(2, native_rank_top_n(cpu, ram_kb, 5, &params, RANK_TOP_MAX, out));
+    EXPECT_EQ(2, out[0]);  // 0.2 beats 0.11
+    EXPECT_EQ(3, out[1]);
+}
+
+TEST(NativeProcessRankTest, TopNIsClamped) {
+    std::vector<float> cpu(RANK_TOP_MAX * 2);
+    std::vector<int64_t> ram_kb(cpu.size(), 0);
+    for (size_t i = 0; i < cpu.size(); i++) cpu[i] = static_cast<float>(i + 1);
+    RankParams params = params_for(RANK_BY_CPU);
+
+    int32_t out[RANK_TOP_MAX];
+    ASSERT_EQ(RANK_TOP_MAX, native_rank_top_n(cpu.data(), ram_kb.data(), static_cast<int>(cpu.size()),
+                                              &params, RANK_TOP_MAX + 10, out));
+    EXPECT_EQ(static_cast<int32_t>(cpu.size()) - 1, out[0]);
+    EXPECT_EQ(RANK_TOP_MAX, out[RANK_TOP_MAX - 1]);
+    EXPECT_EQ(0, native_rank_top_n(cpu.data(), ram_kb.data(), static_cast<int>(cpu.size()), &params, 0, out));
+}
+
+TEST(NativeProcessRankTest, RejectsInvalidArguments) {
+    const float cpu[] = { 1.0f };
+    const int64_t ram_kb[] = { 1024 };
+    int32_t out[RANK_TOP_MAX];
+    RankParams params = params_for(RANK_BY_CPU);
+
+    EXPECT_EQ(-1, native_rank_top_n(nullptr, ram_kb, 1, &params, 1, out));
+    EXPECT_EQ(-1, native_rank_top_n(cpu, ram_kb, RANK_MAX_PROCESSES + 1, &params, 1, out));
+    EXPECT_EQ(-1, native_rank_top_n(cpu, ram_kb, 1, &params, -1, out));
+
+    params.key = 7;
+    EXPECT_EQ(-1, native_rank_top_n(cpu, ram_kb, 1, &params, 1, out));
+
+    params = params_for(RANK_BY_COMBINED);
+    params.ram_mb_divisor = 0.0f;
+    EXPECT_EQ(-1, native_rank_top_n(cpu, ram_kb, 1, &params, 1, out));
+
+    params = params_for(RANK_BY_RAM);
+    EXPECT_EQ(0, native_rank_top_n(cpu, ram_kb, 0, &params, 1, out));
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "native_publish.h"
+
+/**
+ * Tests for change-driven publishing: dead-bands, max silence heartbeats,
+ * packed output order and the suppression counters.
+ */
+class NativePublishTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        handle_ = native_pub_create(3, 5000);
+        ASSERT_NE(0, handle_);
+    }
+
+    void TearDown() override {
+        native_pub_destroy(handle_);
+    }
+
+    int submit(float a, float b, float c, int64_t ts) {
+        const float values[3] = { a, b, c };
+        return native_pub_submit(handle_, values, 3, ts, &mask_, changed_);
+    }
+
+    int64_t handle_ = 0;
+    uint32_t mask_ = 0;
+    float changed_[3] = {};
+};
+
+TEST_F(NativePublishTest, FirstSubmitPublishesEverything) {
+    ASSERT_EQ(3, submit(10.0f, 20.0f, 30.0f, 0));
+    EXPECT_EQ(0x7u, mask_);
+    EXPECT_FLOAT_EQ(10.0f, changed_[0]);
+    EXPECT_FLOAT_EQ(20.0f, changed_[1]);
+    EXPECT_FLOAT_EQ(30.0f, changed_[2]);
+}
+
+TEST_F(NativePublishTest, UnchangedValuesAreSuppressed) {
+    submit(10.0f, 20.0f, 30.0f, 0);
+
+    EXPECT_EQ(0, submit(10.0f, 20.0f, 30.0f, 500));
+    EXPECT_EQ(0u, mask_);
+
+    PublishStats stats;
+    ASSERT_EQ(0, native_pub_get_stats(handle_, &stats));
+    EXPECT_EQ(2u, stats.submitted);
+    EXPECT_EQ(1u, stats.published_ticks);
+    EXPECT_EQ(1u, stats.suppressed_ticks);
+    EXPECT_EQ(3u, stats.published_values);
+    EXPECT_EQ(3u, stats.suppressed_values);
+}
+
+TEST_F(NativePublishTest, ChangedValuesArePackedInMetricOrder) {
+    submit(10.0f, 20.0f, 30.0f, 0);
+
+    ASSERT_EQ(2, submit(11.0f, 20.0f, 29.0f, 500));
+    EXPECT_EQ(0x5u, mask_);
+    EXPECT_FLOAT_EQ(11.0f, changed_[0]);
+    EXPECT_FLOAT_EQ(29.0f, changed_[1]);
+}
+
+TEST_F(NativePublishTest, AbsoluteDeadbandMeasuresFromLastPublished) {
+    ASSERT_EQ(0, native_pub_set_deadband(handle_, 0, 1.0f, 0.0f));
+    submit(50.0f, 0.0f, 0.0f, 0);
+
+    // Creeping by 0.6 per tick: suppressed once, then the drift from the
+    // last published value (not the last sample) crosses the band
+    EXPECT_EQ(0, submit(50.6f, 0.0f, 0.0f, 500));
+    EXPECT_EQ(1, submit(51.2f, 0.0f, 0.0f, 1000));
+    EXPECT_EQ(0x1u, mask_);
+    EXPECT_FLOAT_EQ(51.2f, changed_[0]);
+}
+
+TEST_F(NativePublishTest, RelativeDeadbandScalesWithMagnitude) {
+    ASSERT_EQ(0, native_pub_set_deadband(handle_, 1, 0.0f, 0.05f));
+    submit(0.0f, 1000000.0f, 0.0f, 0);
+
+    EXPECT_EQ(0, submit(0.0f, 1040000.0f, 0.0f, 500));
+    EXPECT_EQ(1, submit(0.0f, 1060000.0f, 0.0f, 1000));
+    EXPECT_EQ(0x2u, mask_);
+}
+
+TEST_F(NativePublishTest, MaxSilenceRepublishesStaleMetrics) {
+    ASSERT_EQ(0, native_pub_set_deadband(handle_, 2, 5.0f, 0.0f));
+    submit(1.0f, 1.0f, 1.0f, 0);
+    submit(2.0f, 2.0f, 1.0f, 2500);  // metric 2 stays quiet
+
+    // Metric 2 last published at 0 -> due at 5000; 0 and 1 only at 7500
+    ASSERT_EQ(1, submit(2.0f, 2.0f, 2.0f, 5000));
+    EXPECT_EQ(0x4u, mask_);
+    EXPECT_FLOAT_EQ(2.0f, changed_[0]);
+
+    PublishStats stats;
+    ASSERT_EQ(0, native_pub_get_stats(handle_, &stats));
+    EXPECT_EQ(1u, stats.heartbeat_values);
+}
+
+TEST_F(NativePublishTest, MissingReadingsTransitionAsChanges) {
+    ASSERT_EQ(0, native_pub_set_deadband(handle_, 0, 100.0f, 0.0f));
+    submit(40.0f, 0.0f, 0.0f, 0);
+
+    EXPECT_EQ(1, submit(NAN, 0.0f, 0.0f, 500));
+    EXPECT_EQ(0x1u, mask_);
+    EXPECT_EQ(0, submit(NAN, 0.0f, 0.0f, 1000));
+    EXPECT_EQ(1, submit(40.0f, 0.0f, 0.0f, 1500));
+}
+
+TEST_F(NativePublishTest, ForceAndClockRewindRepublish) {
+    submit(1.0f, 2.0f, 3.0f, 10000);
+
+    native_pub_force(handle_);
+    EXPECT_EQ(3, submit(1.0f, 2.0f, 3.0f, 10500));
+
+    EXPECT_EQ(3, submit(1.0f, 2.0f, 3.0f, 0));
+}
+
+TEST_F(NativePublishTest, RejectsBadArguments) {
+    const float values[4] = {};
+    uint32_t mask = 0;
+    EXPECT_EQ(-1, native_pub_submit(handle_, values, 4, 0, &mask, nullptr));
+    EXPECT_EQ(-1, native_pub_submit(handle_ + 1000, values, 3, 0, &mask, nullptr));
+    EXPECT_EQ(-1, native_pub_set_deadband(handle_, 3, 1.0f, 0.0f));
+    EXPECT_EQ(-1, native_pub_set_deadband(handle_, 0, -1.0f, 0.0f));
+    EXPECT_EQ(0, native_pub_create(0, 1000));
+    EXPECT_EQ(0, native_pub_create(PUBLISH_MAX_METRICS + 1, 1000));
+}
+
+TEST_F(NativePublishTest, FullWidthMaskUsesEveryBit) {
+    int64_t wide = native_pub_create(PUBLISH_MAX_METRICS, 0);
+    ASSERT_NE(0, wide);
+
+    float values[PUBLISH_MAX_METRICS] = {};
+    uint32_t mask = 0;
+    EXPECT_EQ(PUBLISH_MAX_METRICS, native_pub_submit(wide, values, PUBLISH_MAX_METRICS, 0, &mask, nullptr));
+    EXPECT_EQ(0xffffffffu, mask);
+
+    // max_silence_ms 0 disables heartbeats entirely
+    EXPECT_EQ(0, native_pub_submit(wide, values, PUBLISH_MAX_METRICS, 1000000, &mask, nullptr));
+    native_pub_destroy(wide);
+}
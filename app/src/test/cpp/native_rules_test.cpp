@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "native_analytics.h"
+#include "native_rules.h"
+
+/**
+ * Tests for threshold rules evaluated inside native_twc_add_point:
+ * hysteresis, hold times, windowed sources and the transition queue.
+ */
+class NativeRulesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_rules_clear_all();
+        handle = native_twc_create(WINDOW_5M);
+        ASSERT_NE(0, handle);
+    }
+
+    void TearDown() override {
+        native_twc_destroy(handle);
+        native_rules_clear_all();
+    }
+
+    static RuleSpec above(float enter, float exit, int64_t enter_hold_ms = 0, int64_t exit_hold_ms = 0) {
+        return RuleSpec{ RULE_SOURCE_VALUE, 0, 0, RULE_ABOVE, enter, exit, enter_hold_ms, exit_hold_ms };
+    }
+
+    std::vector<RuleTransition> drain() {
+        RuleTransition out[RULE_QUEUE_CAPACITY];
+        int count = native_rule_drain(out, RULE_QUEUE_CAPACITY);
+        return std::vector<RuleTransition>(out, out + count);
+    }
+
+    int64_t handle = 0;
+};
+
+TEST_F(NativeRulesTest, HysteresisSuppressesFlapping) {
+    RuleSpec spec = above(80.0f, 70.0f);
+    int32_t id = native_rule_add(handle, &spec);
+    ASSERT_GT(id, 0);
+
+    // Oscillating between the exit and enter thresholds flips only once
+    const float values[] = { 50, 81, 75, 79, 72, 85, 71, 69, 75, 79 };
+    int64_t ts = 1000;
+    for (float v : values) native_twc_add_point(handle, v, ts += 1000);
+
+    std::vector<RuleTransition> transitions = drain();
+    ASSERT_EQ(2u, transitions.size());
+    EXPECT_EQ(id, transitions[0].rule_id);
+    EXPECT_EQ(1, transitions[0].active);
+    EXPECT_FLOAT_EQ(81.0f, transitions[0].value);
+    EXPECT_EQ(3000, transitions[0].timestamp);
+    EXPECT_EQ(0, transitions[1].active);
+    EXPECT_FLOAT_EQ(69.0f, transitions[1].value);
+    EXPECT_EQ(0, native_rule_state(id));
+}
+
+TEST_F(NativeRulesTest, HoldTimeDebouncesSpikes) {
+    RuleSpec spec = above(80.0f, 80.0f, 3000, 2000);
+    int32_t id = native_rule_add(handle, &spec);
+    ASSERT_GT(id, 0);
+
+    // A 2 s spike is not enough; the streak restarts when it breaks
+    native_twc_add_point(handle, 90, 1000);
+    native_twc_add_point(handle, 90, 3000);
+    native_twc_add_point(handle, 10, 4000);
+    EXPECT_TRUE(drain().empty());
+
+    native_twc_add_point(handle, 90, 5000);
+    native_twc_add_point(handle, 90, 7000);
+    EXPECT_EQ(0, native_rule_state(id));
+    native_twc_add_point(handle, 90, 8000);
+    EXPECT_EQ(1, native_rule_state(id));
+
+    native_twc_add_point(handle, 10, 9000);
+    native_twc_add_point(handle, 10, 11000);
+
+    std::vector<RuleTransition> transitions = drain();
+    ASSERT_EQ(2u, transitions.size());
+    EXPECT_EQ(8000, transitions[0].timestamp);
+    EXPECT_EQ(11000, transitions[1].timestamp);
+    EXPECT_EQ(0, transitions[1].active);
+}
+
+TEST_F(NativeRulesTest, PercentileAndBelowSources) {
+    RuleSpec p95 = { RULE_SOURCE_PERCENTILE, 95, WINDOW_30S, RULE_ABOVE, 90.0f, 80.0f, 0, 0 };
+    RuleSpec low_avg = { RULE_SOURCE_AVERAGE, 0, 10000, RULE_BELOW, 20.0f, 30.0f, 0, 0 };
+    int32_t p95_id = native_rule_add(handle, &p95);
+    int32_t avg_id = native_rule_add(handle, &low_avg);
+    ASSERT_GT(p95_id, 0);
+    ASSERT_GT(avg_id, 0);
+
+    // 19 quiet samples and one spike: p95 of 20 samples is the 19th smallest
+    int64_t ts = 0;
+    for (int i = 0; i < 19; i++) native_twc_add_point(handle, 10.0f, ts += 1000);
+    EXPECT_EQ(0, native_rule_state(p95_id));
+    EXPECT_EQ(1, native_rule_state(avg_id));
+    native_twc_add_point(handle, 100.0f, ts += 1000);
+    EXPECT_EQ(0, native_rule_state(p95_id));
+
+    // A second spike lifts the p95 over the threshold
+    native_twc_add_point(handle, 100.0f, ts += 1000);
+    EXPECT_EQ(1, native_rule_state(p95_id));
+    EXPECT_EQ(1, native_rule_state(avg_id));  // 10 s mean is about 26, inside the band
+}
+
+TEST_F(NativeRulesTest, RulesFollowTheirHandle) {
+    int64_t other = native_twc_create(WINDOW_1M);
+    ASSERT_NE(0, other);
+    RuleSpec spec = above(50.0f, 50.0f);
+    int32_t id = native_rule_add(other, &spec);
+
+    native_twc_add_point(handle, 90.0f, 1000);
+    EXPECT_EQ(0, native_rule_state(id));
+    native_twc_add_point(other, 90.0f, 1000);
+    EXPECT_EQ(1, native_rule_state(id));
+
+    // Clear records the exit; destroy removes the rule
+    native_twc_clear(other);
+    EXPECT_EQ(0, native_rule_state(id));
+    std::vector<RuleTransition> transitions = drain();
+    ASSERT_EQ(2u, transitions.size());
+    EXPECT_EQ(0, transitions[1].active);
+
+    native_twc_destroy(other);
+    EXPECT_EQ(-1, native_rule_state(id));
+    EXPECT_EQ(-1, native_rule_remove(id));
+}
+
+TEST_F(NativeRulesTest, QueueDropsOldestWhenFull) {
+    RuleSpec spec = above(50.0f, 50.0f);
+    ASSERT_GT(native_rule_add(handle, &spec), 0);
+
+    const int flips = RULE_QUEUE_CAPACITY + 10;
+    for (int i = 0; i < flips; i++) {
+        native_twc_add_point(handle, i % 2 == 0 ? 90.0f : 10.0f, 1000 + i);
+    }
+
+    EXPECT_EQ(10, native_rule_dropped());
+    std::vector<RuleTransition> transitions = drain();
+    ASSERT_EQ(static_cast<size_t>(RULE_QUEUE_CAPACITY), transitions.size());
+    EXPECT_EQ(1010, transitions.front().timestamp);
+    EXPECT_EQ(1000 + flips - 1, transitions.back().timestamp);
+    EXPECT_TRUE(drain().empty());
+}
+
+TEST_F(NativeRulesTest, RejectsInvalidSpecs) {
+    RuleSpec spec = above(70.0f, 80.0f);  // exit above enter
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+
+    spec = above(80.0f, 70.0f, -1, 0);
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+
+    spec = { RULE_SOURCE_PERCENTILE, 0, WINDOW_1M, RULE_ABOVE, 80.0f, 70.0f, 0, 0 };
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+
+    spec = { RULE_SOURCE_AVERAGE, 0, 0, RULE_ABOVE, 80.0f, 70.0f, 0, 0 };
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+
+    spec = { RULE_SOURCE_VALUE, 0, 0, RULE_BELOW, 20.0f, 10.0f, 0, 0 };
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+    EXPECT_EQ(-1, native_rule_add(handle, nullptr));
+    EXPECT_EQ(-1, native_rule_add(0, &spec));
+
+    spec = above(80.0f, 70.0f);
+    for (int i = 0; i < RULE_MAX; i++) ASSERT_GT(native_rule_add(handle, &spec), 0);
+    EXPECT_EQ(-1, native_rule_add(handle, &spec));
+}
+
+TEST_F(NativeRulesTest, RejectsUnknownAndDestroyedCalculators) {
+    RuleSpec spec = above(80.0f, 70.0f);
+    EXPECT_EQ(-1, native_rule_add(handle + 1000, &spec));
+
+    int64_t other = native_twc_create(WINDOW_5M);
+    ASSERT_NE(0, other);
+    native_twc_destroy(other);
+    EXPECT_EQ(-1, native_rule_add(other, &spec));
+
+    // Nothing was stored for the rejected handles
+    for (int i = 0; i < RULE_MAX; i++) ASSERT_GT(native_rule_add(handle, &spec), 0);
+}
@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "native_session.h"
+#include "native_analytics.h"
+#include "native_instrument.h"
+#include "native_rules.h"
+#include "native_shared_snapshot.h"
+
+/**
+ * Tests for the session recorder: delta-coded round trip, log size,
+ * truncated tails, the publish hook and replay into analytics.
+ */
+namespace {
+
+constexpr int64_t NS_PER_MS = 1000000;
+
+std::vector<uint8_t> read_bytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+MetricsSnapshot snapshot_of(double cpu, double ram_mb) {
+    MetricsSnapshot snapshot;
+    snapshot.timestamp_ms = 0;
+    for (double& value : snapshot.values) value = NAN;
+    snapshot.values[SNAPSHOT_CPU_PERCENT] = cpu;
+    snapshot.values[SNAPSHOT_RAM_USED_MB] = ram_mb;
+    snapshot.values[SNAPSHOT_RAM_TOTAL_MB] = 2048.0;
+    return snapshot;
+}
+
+std::vector<SessionSample> read_all(const std::vector<uint8_t>& log, int* end_result) {
+    std::vector<SessionSample> samples;
+    SessionReader reader;
+    if (native_session_reader_open(&reader, log.data(), log.size()) != 0) {
+        *end_result = -2;
+        return samples;
+    }
+    SessionSample sample;
+    while ((*end_result = native_session_reader_next(&reader, &sample)) == 1) samples.push_back(sample);
+    return samples;
+}
+
+}  // namespace
+
+class NativeSessionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = "/tmp/sysmetrics_session_" + std::to_string(getpid()) + ".smsr";
+    }
+
+    void TearDown() override {
+        native_session_stop();
+        unlink(path_.c_str());
+    }
+
+    // Record a CPU walk with a RAM step every 10th sample, 1 s apart
+    std::vector<MetricsSnapshot> record(int count, uint32_t seed) {
+        std::vector<MetricsSnapshot> snapshots;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> cpu(5.0, 95.0);
+        EXPECT_EQ(0, native_session_start(path_.c_str()));
+        start_ns_ = static_cast<int64_t>(native_instr_now_ns());
+        for (int i = 0; i < count; i++) {
+            MetricsSnapshot snapshot = snapshot_of(cpu(rng), 900.0 + (i / 10) * 3.5);
+            snapshots.push_back(snapshot);
+            EXPECT_EQ(0, native_session_record(&snapshot, start_ns_ + (i + 1) * 1000 * NS_PER_MS));
+        }
+        EXPECT_EQ(count, native_session_stop());
+        return snapshots;
+    }
+
+    std::string path_;
+    int64_t start_ns_ = 0;   // Monotonic time of record()'s samples, 1 s before the first
+};
+
+TEST_F(NativeSessionTest, RoundTripKeepsValuesGapsAndMonotonicTime) {
+    std::vector<MetricsSnapshot> recorded = record(500, 3);
+    std::vector<uint8_t> log = read_bytes(path_);
+
+    int end = 0;
+    std::vector<SessionSample> samples = read_all(log, &end);
+    EXPECT_EQ(0, end);
+    ASSERT_EQ(recorded.size(), samples.size());
+
+    int64_t start_mono, start_wall;
+    memcpy(&start_mono, log.data() + SESSION_HDR_START_MONO, sizeof(start_mono));
+    memcpy(&start_wall, log.data() + SESSION_HDR_START_WALL, sizeof(start_wall));
+    for (size_t i = 0; i < samples.size(); i++) {
+        for (int m = 0; m < SNAPSHOT_METRIC_COUNT; m++) {
+            double value = recorded[i].values[m];
+            if (std::isnan(value)) {
+                EXPECT_TRUE(std::isnan(samples[i].values[m]));
+            } else {
+                EXPECT_EQ(static_cast<float>(value), samples[i].values[m]);
+            }
+        }
+        // Times are kept to the microsecond, relative to the header anchor
+        int64_t mono_ns = start_ns_ + static_cast<int64_t>(i + 1) * 1000 * NS_PER_MS;
+        EXPECT_LE(samples[i].mono_ns, mono_ns);
+        EXPECT_GT(samples[i].mono_ns, mono_ns - 1000);
+        EXPECT_EQ(start_wall + (samples[i].mono_ns - start_mono) / NS_PER_MS, samples[i].timestamp_ms);
+    }
+}
+
+TEST_F(NativeSessionTest, UnchangedMetricsCostNothing) {
+    record(1000, 7);
+    std::vector<uint8_t> log = read_bytes(path_);
+
+    // First record: up to 3 bytes of time, a mask byte, three values. Then 3 + 1
+    // bytes per tick, the CPU value, and the RAM value on every 10th tick.
+    size_t expected_max = SESSION_HEADER_SIZE + (3 + 1 + 3 * 4) + 999 * (3 + 1 + 4) + 99 * 4;
+    EXPECT_LE(log.size(), expected_max);
+    EXPECT_GE(log.size(), expected_max - 8);
+
+    // Versus the 88-byte MetricsSnapshot published each tick
+    EXPECT_LT(log.size() * 10, 1000 * sizeof(MetricsSnapshot));
+}
+
+TEST_F(NativeSessionTest, TruncatedTailAndBadHeadersAreDetected) {
+    record(50, 11);
+    std::vector<uint8_t> log = read_bytes(path_);
+
+    int end = 0;
+    size_t complete = read_all(log, &end).size();
+    ASSERT_EQ(50u, complete);
+
+    // Every cut inside the last record yields the 49 before it
+    for (size_t cut = 1; cut < 8; cut++) {
+        std::vector<uint8_t> partial(log.begin(), log.end() - static_cast<long>(cut));
+        EXPECT_EQ(49u, read_all(partial, &end).size()) << "cut " << cut;
+        EXPECT_EQ(-1, end);
+
+        ReplayTargets targets = {};
+        ReplayStats stats;
+        EXPECT_EQ(0, native_session_replay(partial.data(), partial.size(), &targets, &stats));
+        EXPECT_EQ(49, stats.samples);
+        EXPECT_EQ(1, stats.truncated);
+    }
+
+    // A mask naming metrics past the end is corrupt, not a sample
+    std::vector<uint8_t> corrupt(log.begin(), log.begin() + SESSION_HEADER_SIZE);
+    corrupt.insert(corrupt.end(), { 0x01, 0xff, 0x7f });
+    EXPECT_TRUE(read_all(corrupt, &end).empty());
+    EXPECT_EQ(-1, end);
+
+    std::vector<uint8_t> header_only(log.begin(), log.begin() + SESSION_HEADER_SIZE);
+    EXPECT_TRUE(read_all(header_only, &end).empty());
+    EXPECT_EQ(0, end);
+
+    std::vector<uint8_t> wrong_magic = log;
+    wrong_magic[0] ^= 0xff;
+    read_all(wrong_magic, &end);
+    EXPECT_EQ(-2, end);
+    std::vector<uint8_t> short_header(log.begin(), log.begin() + SESSION_HEADER_SIZE - 1);
+    read_all(short_header, &end);
+    EXPECT_EQ(-2, end);
+
+    ReplayTargets targets = {};
+    ReplayStats stats;
+    EXPECT_EQ(-1, native_session_replay_file("/nonexistent/session.smsr", &targets, &stats));
+}
+
+TEST_F(NativeSessionTest, PublishRecordsOnlyWhileRecording) {
+    MetricsSnapshot snapshot = snapshot_of(42.0, 1000.0);
+    EXPECT_EQ(-1, native_session_recorded());
+    EXPECT_EQ(-1, native_session_record(&snapshot, 1));
+    EXPECT_EQ(-1, native_session_stop());
+
+    native_snapshot_publish(&snapshot);
+    ASSERT_EQ(0, native_session_start(path_.c_str()));
+    EXPECT_EQ(0, native_session_recorded());
+    // No shared region exists here: the publish fails but is still recorded
+    EXPECT_EQ(-1, native_snapshot_publish(&snapshot));
+    snapshot.values[SNAPSHOT_CPU_PERCENT] = 43.0;
+    native_snapshot_publish(&snapshot);
+    EXPECT_EQ(2, native_session_recorded());
+    EXPECT_EQ(2, native_session_stop());
+    native_snapshot_publish(&snapshot);
+
+    int end = 0;
+    std::vector<SessionSample> samples = read_all(read_bytes(path_), &end);
+    ASSERT_EQ(2u, samples.size());
+    EXPECT_EQ(42.0f, samples[0].values[SNAPSHOT_CPU_PERCENT]);
+    EXPECT_EQ(43.0f, samples[1].values[SNAPSHOT_CPU_PERCENT]);
+    EXPECT_LE(samples[0].mono_ns, samples[1].mono_ns);
+
+    EXPECT_EQ(-1, native_session_start("/nonexistent/dir/session.smsr"));
+    EXPECT_EQ(-1, native_session_recorded());
+}
+
+TEST_F(NativeSessionTest, ReplayMatchesFeedingTheEnginesDirectly) {
+    record(400, 19);
+    std::vector<uint8_t> log = read_bytes(path_);
+    int end = 0;
+    std::vector<SessionSample> samples = read_all(log, &end);
+
+    ReplayTargets replayed;
+    ReplayTargets direct;
+    ASSERT_EQ(0, native_replay_targets_create(&replayed, 60, 30000));
+    ASSERT_EQ(0, native_replay_targets_create(&direct, 60, 30000));
+
+    // Alert rules attached before replay re-run offline
+    RuleTransition drained[RULE_QUEUE_CAPACITY];
+    native_rule_drain(drained, RULE_QUEUE_CAPACITY);
+    RuleSpec spec = {};
+    spec.source = RULE_SOURCE_AVERAGE;
+    spec.window_ms = 10000;
+    spec.direction = RULE_ABOVE;
+    spec.enter = 60.0f;
+    spec.exit = 50.0f;
+    int32_t rule = native_rule_add(replayed.twc[SNAPSHOT_CPU_PERCENT], &spec);
+    ASSERT_GT(rule, 0);
+
+    ReplayStats stats;
+    ASSERT_EQ(0, native_session_replay_file(path_.c_str(), &replayed, &stats));
+    EXPECT_EQ(400, stats.samples);
+    EXPECT_EQ(400 * 3, stats.values);
+    EXPECT_EQ(0, stats.truncated);
+    EXPECT_EQ(399 * 1000, stats.span_ms);
+    EXPECT_GT(stats.elapsed_ns, 0);
+
+    for (const SessionSample& sample : samples) {
+        for (int m = 0; m < SNAPSHOT_METRIC_COUNT; m++) {
+            if (std::isnan(sample.values[m])) continue;
+            native_twc_add_point(direct.twc[m], sample.values[m], sample.timestamp_ms);
+            native_chart_add_point(direct.chart[m], sample.values[m], sample.timestamp_ms);
+            native_peak_add_value(direct.peak[m], sample.values[m], sample.timestamp_ms);
+        }
+    }
+
+    for (int m = 0; m < SNAPSHOT_METRIC_COUNT; m++) {
+        alignas(8) uint8_t a[STATS_OUT_SIZE];
+        alignas(8) uint8_t b[STATS_OUT_SIZE];
+        native_twc_get_stats_into(replayed.twc[m], a, sizeof(a));
+        native_twc_get_stats_into(direct.twc[m], b, sizeof(b));
+        EXPECT_EQ(0, memcmp(a, b, sizeof(a))) << "metric " << m;
+
+        alignas(8) uint8_t pa[PEAK_OUT_SIZE];
+        alignas(8) uint8_t pb[PEAK_OUT_SIZE];
+        native_peak_get_data_into(replayed.peak[m], pa, sizeof(pa));
+        native_peak_get_data_into(direct.peak[m], pb, sizeof(pb));
+        EXPECT_EQ(0, memcmp(pa, pb, sizeof(pa))) << "metric " << m;
+
+        float ca[60], cb[60];
+        int32_t count = native_chart_get_normalized(replayed.chart[m], ca, 60);
+        ASSERT_EQ(count, native_chart_get_normalized(direct.chart[m], cb, 60));
+        EXPECT_EQ(0, memcmp(ca, cb, sizeof(float) * static_cast<size_t>(count)));
+    }
+
+    StatsResult cpu;
+    native_twc_get_stats(replayed.twc[SNAPSHOT_CPU_PERCENT], &cpu);
+    EXPECT_GT(cpu.count, 250);   // 5 min of 1 s samples
+
+    // The random CPU walk around 50% crosses the 10 s mean band repeatedly
+    int transitions = native_rule_drain(drained, RULE_QUEUE_CAPACITY);
+    EXPECT_GT(transitions, 0);
+    for (int i = 0; i < transitions; i++) EXPECT_EQ(rule, drained[i].rule_id);
+
+    native_replay_targets_destroy(&replayed);
+    native_replay_targets_destroy(&direct);
+    EXPECT_EQ(0, replayed.twc[0]);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "native_shared_snapshot.h"
+
+/**
+ * Tests for the shared-memory snapshot: round trips through an attached
+ * mapping, a forked reader, foreign fds, and a writer hammering the region
+ * while readers check every copy for tearing.
+ */
+namespace {
+
+MetricsSnapshot make_snapshot(int64_t tag) {
+    MetricsSnapshot snapshot;
+    snapshot.timestamp_ms = tag;
+    for (double& value : snapshot.values) value = static_cast<double>(tag);
+    return snapshot;
+}
+
+}  // namespace
+
+class NativeSharedSnapshotTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        if (handle_ != 0) native_snapshot_detach(handle_);
+        native_snapshot_destroy();
+    }
+
+    int64_t handle_ = 0;
+};
+
+TEST_F(NativeSharedSnapshotTest, CreateIsIdempotent) {
+    int fd = native_snapshot_create();
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(fd, native_snapshot_create());
+}
+
+TEST_F(NativeSharedSnapshotTest, LookingUpTheRegionNeverCreatesIt) {
+    EXPECT_EQ(-1, native_snapshot_fd());
+    EXPECT_EQ(-1, native_snapshot_fd());
+
+    int fd = native_snapshot_create();
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(fd, native_snapshot_fd());
+
+    native_snapshot_destroy();
+    EXPECT_EQ(-1, native_snapshot_fd());
+}
+
+TEST_F(NativeSharedSnapshotTest, PublishedSnapshotRoundTrips) {
+    int fd = native_snapshot_create();
+    ASSERT_GE(fd, 0);
+    handle_ = native_snapshot_attach(fd);
+    ASSERT_NE(0, handle_);
+
+    MetricsSnapshot out;
+    EXPECT_EQ(0, native_snapshot_read(handle_, &out));
+
+    MetricsSnapshot in = make_snapshot(1700000000000);
+    in.values[SNAPSHOT_CPU_PERCENT] = 42.5;
+    in.values[SNAPSHOT_GPU_PERCENT] = NAN;
+    ASSERT_EQ(0, native_snapshot_publish(&in));
+    ASSERT_EQ(0, native_snapshot_publish(&in));
+
+    EXPECT_EQ(2, native_snapshot_read(handle_, &out));
+    EXPECT_EQ(1700000000000, out.timestamp_ms);
+    EXPECT_DOUBLE_EQ(42.5, out.values[SNAPSHOT_CPU_PERCENT]);
+    EXPECT_TRUE(std::isnan(out.values[SNAPSHOT_GPU_PERCENT]));
+}
+
+TEST_F(NativeSharedSnapshotTest, ForkedProcessReadsTheSameRegion) {
+    int fd = native_snapshot_create();
+    ASSERT_GE(fd, 0);
+    MetricsSnapshot in = make_snapshot(77);
+    ASSERT_EQ(0, native_snapshot_publish(&in));
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        int64_t handle = native_snapshot_attach(fd);
+        MetricsSnapshot out;
+        bool ok = handle != 0 && native_snapshot_read(handle, &out) == 1 &&
+                  out.timestamp_ms == 77 && out.values[SNAPSHOT_RAM_USED_MB] == 77.0;
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+}
+
+TEST_F(NativeSharedSnapshotTest, RejectsForeignDescriptors) {
+    EXPECT_EQ(0, native_snapshot_attach(-1));
+
+    FILE* file = tmpfile();
+    ASSERT_NE(nullptr, file);
+    std::vector<char> zeros(4096, 0);
+    ASSERT_EQ(zeros.size(), fwrite(zeros.data(), 1, zeros.size(), file));
+    fflush(file);
+    EXPECT_EQ(0, native_snapshot_attach(fileno(file)));
+    fclose(file);
+
+    MetricsSnapshot out;
+    EXPECT_EQ(-1, native_snapshot_read(12345, &out));
+    EXPECT_EQ(-1, native_snapshot_publish(nullptr));
+}
+
+TEST_F(NativeSharedSnapshotTest, ConcurrentReadersNeverSeeTornSnapshots) {
+    int fd = native_snapshot_create();
+    ASSERT_GE(fd, 0);
+    MetricsSnapshot first = make_snapshot(1);
+    ASSERT_EQ(0, native_snapshot_publish(&first));
+
+    std::atomic<bool> done(false);
+    std::thread writer([&done]() {
+        for (int64_t tag = 2; tag <= 200000; tag++) {
+            MetricsSnapshot snapshot = make_snapshot(tag);
+            native_snapshot_publish(&snapshot);
+        }
+        done.store(true);
+    });
+
+    std::atomic<int> torn(0);
+    std::atomic<int> regressions(0);
+    std::atomic<int> successes(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([fd, &done, &torn, &regressions, &successes]() {
+            int64_t handle = native_snapshot_attach(fd);
+            int64_t last_count = 0;
+            MetricsSnapshot out;
+            while (!done.load()) {
+                int64_t count = native_snapshot_read(handle, &out);
+                if (count <= 0) continue;  // writer kept the sequence odd for every retry
+                successes++;
+                if (count < last_count) regressions++;
+                last_count = count;
+                for (double value : out.values) {
+                    if (value != static_cast<double>(out.timestamp_ms)) {
+                        torn++;
+                        break;
+                    }
+                }
+            }
+            native_snapshot_detach(handle);
+        });
+    }
+
+    writer.join();
+    for (std::thread& reader : readers) reader.join();
+
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(0, regressions.load());
+    EXPECT_GT(successes.load(), 0);
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "native_analytics.h"
+#include "native_sparkline.h"
+
+/**
+ * Tests for the sparkline rasteriser: golden images, dirty-column renders
+ * against full renders, and the ChartBuffer path.
+ *
+ * Goldens are PAM (P7, RGB_ALPHA) files of the raw premultiplied pixels.
+ * Regenerate after an intended rendering change with
+ * SYSMETRICS_UPDATE_GOLDEN=1 and review the images before committing.
+ */
+namespace {
+
+const std::string GOLDEN_DIR = std::string(SYSMETRICS_FIXTURE_DIR) + "/sparkline";
+
+// Overlay CPU colors: dark background, green line, fading green fill
+SparkStyle overlay_style() {
+    return { 0xFF101418u, 0xFF4CAF50u, 0x804CAF50u, 0x004CAF50u, 2.0f, 2.0f };
+}
+
+std::vector<float> cpu_trace(int count, int phase = 0) {
+    std::vector<float> values(count);
+    for (int i = 0; i < count; i++) {
+        int t = i + phase;
+        values[i] = 0.45f + 0.3f * std::sin(t * 0.21f) + 0.15f * std::sin(t * 1.3f);
+    }
+    return values;
+}
+
+struct Canvas {
+    Canvas(int width, int height, int stride = 0)
+        : width(width), height(height), stride(stride ? stride : width),
+          pixels(static_cast<size_t>(this->stride) * height, 0xDEADBEEFu) {}
+
+    // Row-major pixels without the stride padding
+    std::vector<uint32_t> image() const {
+        std::vector<uint32_t> out;
+        for (int r = 0; r < height; r++) {
+            out.insert(out.end(), pixels.begin() + r * stride, pixels.begin() + r * stride + width);
+        }
+        return out;
+    }
+
+    int width;
+    int height;
+    int stride;
+    std::vector<uint32_t> pixels;
+};
+
+std::vector<uint32_t> render_full(int width, int height, int slots, const SparkStyle& style,
+                                  const std::vector<float>& values) {
+    SparkState spark;
+    EXPECT_EQ(0, native_spark_init(&spark, width, height, slots, &style));
+    Canvas canvas(width, height);
+    native_spark_render(&spark, values.data(), static_cast<int32_t>(values.size()),
+                        canvas.pixels.data(), canvas.stride);
+    return canvas.image();
+}
+
+bool write_pam(const std::string& path, const std::vector<uint32_t>& image, int width, int height) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", width, height);
+    for (uint32_t px : image) {
+        uint8_t bytes[4] = { static_cast<uint8_t>(px), static_cast<uint8_t>(px >> 8),
+                             static_cast<uint8_t>(px >> 16), static_cast<uint8_t>(px >> 24) };
+        fwrite(bytes, 1, 4, f);
+    }
+    fclose(f);
+    return true;
+}
+
+bool read_pam(const std::string& path, std::vector<uint32_t>* image, int* width, int* height) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int depth = 0, maxval = 0;
+    char tupltype[32];
+    bool ok = fscanf(f, "P7 WIDTH %d HEIGHT %d DEPTH %d MAXVAL %d TUPLTYPE %31s ENDHDR",
+                     width, height, &depth, &maxval, tupltype) == 5 && fgetc(f) == '\n' &&
+              depth == 4 && maxval == 255;
+    if (ok) {
+        std::vector<uint8_t> bytes(static_cast<size_t>(*width) * *height * 4);
+        ok = fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        image->resize(bytes.size() / 4);
+        for (size_t i = 0; ok && i < image->size(); i++) {
+            (*image)[i] = bytes[i * 4] | (bytes[i * 4 + 1] << 8) | (bytes[i * 4 + 2] << 16) |
+                          (static_cast<uint32_t>(bytes[i * 4 + 3]) << 24);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+// Compare with the golden, allowing +/-1 per channel for float rounding
+void expect_golden(const std::string& name, const std::vector<uint32_t>& image, int width, int height) {
+    std::string path = GOLDEN_DIR + "/" + name + ".pam";
+    const char* update = getenv("SYSMETRICS_UPDATE_GOLDEN");
+    if (update && strcmp(update, "1") == 0) {
+        ASSERT_TRUE(write_pam(path, image, width, height)) << path;
+        return;
+    }
+
+    std::vector<uint32_t> golden;
+    int golden_width = 0, golden_height = 0;
+    ASSERT_TRUE(read_pam(path, &golden, &golden_width, &golden_height)) << path;
+    ASSERT_EQ(width, golden_width);
+    ASSERT_EQ(height, golden_height);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < image.size(); i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            int got = (image[i] >> shift) & 0xff;
+            int want = (golden[i] >> shift) & 0xff;
+            if (std::abs(got - want) > 1 && mismatches++ < 5) {
+                ADD_FAILURE() << name << " pixel (" << i % width << ", " << i / width
+                              << ") channel " << shift / 8 << ": " << got << " != " << want;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches) << name;
+}
+
+}  // namespace
+
+TEST(NativeSparklineTest, MatchesGoldenImages) {
+    SparkStyle style = overlay_style();
+    expect_golden("overlay_growing", render_full(120, 40, 60, style, cpu_trace(35)), 120, 40);
+    expect_golden("overlay_full", render_full(120, 40, 60, style, cpu_trace(60)), 120, 40);
+
+    // Widget: wide, thin line, opaque fill, clipped extremes
+    SparkStyle widget = { 0x00000000u, 0xFFFFC107u, 0xFFFF9800u, 0x40FF9800u, 1.5f, 1.0f };
+    std::vector<float> values = cpu_trace(100);
+    values[20] = 1.5f;
+    values[70] = -0.5f;
+    values[71] = NAN;
+    expect_golden("widget_clipped", render_full(300, 48, 100, widget, values), 300, 48);
+
+    expect_golden("single_point", render_full(64, 24, 30, style, { 0.5f }), 64, 24);
+}
+
+TEST(NativeSparklineTest, FlatLineGeometry) {
+    SparkStyle style = { 0xFF000000u, 0xFFFFFFFFu, 0xFF0000FFu, 0xFF0000FFu, 2.0f, 0.0f };
+    std::vector<uint32_t> image = render_full(50, 21, 11, style, std::vector<float>(11, 0.5f));
+
+    // Line centred on y = 10.5: rows 9..11 carry the line, above is background,
+    // below is the opaque blue fill (bytes R G B A)
+    for (int c = 0; c < 50; c++) {
+        EXPECT_EQ(0xFF000000u, image[5 * 50 + c]) << c;
+        EXPECT_EQ(0xFFFFFFFFu, image[10 * 50 + c]) << c;
+        EXPECT_EQ(0xFFFF0000u, image[15 * 50 + c]) << c;
+    }
+}
+
+TEST(NativeSparklineTest, DirtyRendersMatchFullRendersWhileGrowing) {
+    SparkStyle style = overlay_style();
+    SparkState spark;
+    ASSERT_EQ(0, native_spark_init(&spark, 130, 40, 50, &style));
+    Canvas canvas(130, 40, 136);
+
+    std::vector<float> trace = cpu_trace(50);
+    for (int n = 0; n <= 50; n++) {
+        int repainted = native_spark_render(&spark, trace.data(), n, canvas.pixels.data(), canvas.stride);
+        ASSERT_GE(repainted, 0);
+        if (n > 2) {
+            EXPECT_LT(repainted, 20) << "point " << n;
+        }
+        std::vector<float> prefix(trace.begin(), trace.begin() + n);
+        ASSERT_EQ(render_full(130, 40, 50, style, prefix), canvas.image()) << "point " << n;
+    }
+
+    // Same series again: nothing to do
+    EXPECT_EQ(0, native_spark_render(&spark, trace.data(), 50, canvas.pixels.data(), canvas.stride));
+
+    // Editing one old point repaints around it only
+    trace[10] = 0.95f;
+    int repainted = native_spark_render(&spark, trace.data(), 50, canvas.pixels.data(), canvas.stride);
+    EXPECT_GT(repainted, 0);
+    EXPECT_LT(repainted, 20);
+    EXPECT_EQ(render_full(130, 40, 50, style, trace), canvas.image());
+}
+
+TEST(NativeSparklineTest, RecoloringRepaintsTheSameSeries) {
+    SparkStyle style = overlay_style();
+    SparkState spark;
+    ASSERT_EQ(0, native_spark_init(&spark, 130, 40, 50, &style));
+    Canvas canvas(130, 40);
+    std::vector<float> trace = cpu_trace(50);
+    ASSERT_GT(native_spark_render(&spark, trace.data(), 50, canvas.pixels.data(), canvas.stride), 0);
+
+    // Same colors: nothing to repaint
+    ASSERT_EQ(0, native_spark_set_colors(&spark, style.background, style.line, style.fill_top, style.fill_bottom));
+    EXPECT_EQ(0, native_spark_render(&spark, trace.data(), 50, canvas.pixels.data(), canvas.stride));
+
+    // Severity turned red: every column again, as if created red
+    SparkStyle red = { style.background, 0xFFF44336u, 0x80F44336u, 0x00F44336u, style.line_width, style.padding };
+    ASSERT_EQ(0, native_spark_set_colors(&spark, red.background, red.line, red.fill_top, red.fill_bottom));
+    EXPECT_EQ(130, native_spark_render(&spark, trace.data(), 50, canvas.pixels.data(), canvas.stride));
+    EXPECT_EQ(render_full(130, 40, 50, red, trace), canvas.image());
+
+    EXPECT_EQ(-1, native_spark_set_colors(nullptr, 0, 0, 0, 0));
+}
+
+TEST(NativeSparklineTest, DirtyRendersMatchFullRendersWhileScrolling) {
+    // 59 slot gaps of 2 px plus 2 px padding each side: whole-pixel pitch
+    SparkStyle style = overlay_style();
+    SparkState spark;
+    ASSERT_EQ(0, native_spark_init(&spark, 122, 40, 60, &style));
+    Canvas canvas(122, 40);
+
+    std::vector<float> trace = cpu_trace(200);
+    native_spark_render(&spark, trace.data(), 60, canvas.pixels.data(), canvas.stride);
+    for (int start = 1; start + 60 <= 200; start += (start % 3) + 1) {
+        int repainted = native_spark_render(&spark, trace.data() + start, 60,
+                                            canvas.pixels.data(), canvas.stride);
+        EXPECT_LT(repainted, 40) << "start " << start;
+        std::vector<float> window(trace.begin() + start, trace.begin() + start + 60);
+        ASSERT_EQ(render_full(122, 40, 60, style, window), canvas.image()) << "start " << start;
+    }
+
+    // Fractional pitch cannot shift pixels: still correct, just more work
+    ASSERT_EQ(0, native_spark_init(&spark, 125, 40, 60, &style));
+    native_spark_render(&spark, trace.data(), 60, canvas.pixels.data(), canvas.stride);
+    Canvas wide(125, 40);
+    native_spark_render(&spark, trace.data(), 60, wide.pixels.data(), wide.stride);
+    native_spark_render(&spark, trace.data() + 1, 60, wide.pixels.data(), wide.stride);
+    std::vector<float> window(trace.begin() + 1, trace.begin() + 61);
+    EXPECT_EQ(render_full(125, 40, 60, style, window), wide.image());
+}
+
+TEST(NativeSparklineTest, RendersChartBufferHandle) {
+    int64_t chart = native_chart_create(40);
+    ASSERT_NE(0, chart);
+    for (int i = 0; i < 40; i++) native_chart_add_point(chart, 20.0f + (i % 7) * 5.0f, 1000LL * i);
+
+    std::vector<float> normalized(40);
+    ASSERT_EQ(40, native_chart_get_normalized(chart, normalized.data(), 40));
+
+    SparkStyle style = overlay_style();
+    SparkState spark;
+    ASSERT_EQ(0, native_spark_init(&spark, 80, 30, 40, &style));
+    Canvas canvas(80, 30);
+    EXPECT_EQ(80, native_spark_render_chart(&spark, chart, canvas.pixels.data(), canvas.stride));
+    EXPECT_EQ(render_full(80, 30, 40, style, normalized), canvas.image());
+    EXPECT_EQ(0, native_spark_render_chart(&spark, chart, canvas.pixels.data(), canvas.stride));
+
+    // Fewer slots than points: the newest ones
+    ASSERT_EQ(0, native_spark_init(&spark, 80, 30, 10, &style));
+    native_spark_render_chart(&spark, chart, canvas.pixels.data(), canvas.stride);
+    std::vector<float> newest(normalized.end() - 10, normalized.end());
+    EXPECT_EQ(render_full(80, 30, 10, style, newest), canvas.image());
+
+    native_chart_destroy(chart);
+    native_spark_render_chart(&spark, chart, canvas.pixels.data(), canvas.stride);
+    EXPECT_EQ(render_full(80, 30, 10, style, {}), canvas.image());
+}
+
+TEST(NativeSparklineTest, RejectsInvalidArguments) {
+    SparkStyle style = overlay_style();
+    SparkState spark;
+    EXPECT_EQ(-1, native_spark_init(&spark, 0, 40, 10, &style));
+    EXPECT_EQ(-1, native_spark_init(&spark, SPARK_MAX_WIDTH + 1, 40, 10, &style));
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, SPARK_MAX_HEIGHT + 1, 10, &style));
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, 40, 1, &style));
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, 40, SPARK_MAX_SLOTS + 1, &style));
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, 40, 10, nullptr));
+    style.padding = 20.0f;
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, 40, 10, &style));
+    style.padding = 2.0f;
+    style.line_width = 0.0f;
+    EXPECT_EQ(-1, native_spark_init(&spark, 100, 40, 10, &style));
+
+    style = overlay_style();
+    ASSERT_EQ(0, native_spark_init(&spark, 100, 40, 10, &style));
+    Canvas canvas(100, 40);
+    std::vector<float> values(11, 0.5f);
+    EXPECT_EQ(-1, native_spark_render(&spark, values.data(), 11, canvas.pixels.data(), canvas.stride));
+    EXPECT_EQ(-1, native_spark_render(&spark, values.data(), 5, nullptr, canvas.stride));
+    EXPECT_EQ(-1, native_spark_render(&spark, values.data(), 5, canvas.pixels.data(), 99));
+    EXPECT_EQ(-1, native_spark_render(&spark, nullptr, 5, canvas.pixels.data(), canvas.stride));
+    EXPECT_EQ(-1, native_spark_render(nullptr, values.data(), 5, canvas.pixels.data(), canvas.stride));
+    EXPECT_EQ(100, native_spark_render(&spark, nullptr, 0, canvas.pixels.data(), canvas.stride));
+}
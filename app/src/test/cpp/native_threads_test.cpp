@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "native_threads.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the per-thread profiler. fixtures/tv_box has pid 2000 with a
+ * busy RenderThread; psi-watcher starts in snapshot 1, and in snapshot 2
+ * RenderThread exits while tid 2020 is reused by a new thread.
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+const int APP_PID = 2000;
+
+const ThreadStatsNative* find_thread(const ThreadStatsNative* threads, int count, int tid) {
+    for (int i = 0; i < count; i++) {
+        if (threads[i].tid == tid) return &threads[i];
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+class NativeThreadsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_threads_reset();
+    }
+
+    void TearDown() override {
+        native_threads_reset();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+};
+
+TEST_F(NativeThreadsTest, FirstSampleReportsNamesAndTotalsOnly) {
+    ASSERT_EQ(0, native_paths_set_root((RECORDING + "/000000").c_str()));
+
+    ThreadStatsNative threads[THREADS_MAX];
+    ASSERT_EQ(4, native_threads_sample(APP_PID, threads, THREADS_MAX));
+
+    const ThreadStatsNative* jit = find_thread(threads, 4, 2031);
+    ASSERT_NE(nullptr, jit);
+    EXPECT_STREQ("Jit thread pool", jit->name);  // comm with spaces
+    EXPECT_EQ(500u, jit->cpu_time_ms);
+    EXPECT_EQ(0, jit->is_valid);
+
+    // Without an interval, cost falls back to total CPU time
+    EXPECT_EQ(2000, threads[0].tid);
+    EXPECT_EQ(7000u, threads[0].cpu_time_ms);
+    EXPECT_EQ(4, native_threads_tracked_count());
+}
+
+TEST_F(NativeThreadsTest, RanksThreadsByIntervalCost) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    ThreadStatsNative threads[THREADS_MAX];
+    native_threads_sample(APP_PID, threads, THREADS_MAX);
+    native_replay_step();
+    ASSERT_EQ(5, native_threads_sample(APP_PID, threads, THREADS_MAX));
+
+    EXPECT_STREQ("RenderThread", threads[0].name);
+    EXPECT_FLOAT_EQ(30.0f, threads[0].cpu_percent);
+    EXPECT_EQ(120u, threads[0].voluntary_switches);
+    EXPECT_EQ(30u, threads[0].involuntary_switches);
+    EXPECT_EQ(1, threads[0].is_valid);
+
+    EXPECT_EQ(2000, threads[1].tid);
+    EXPECT_FLOAT_EQ(15.0f, threads[1].cpu_percent);
+    EXPECT_STREQ("DefaultDispatch", threads[2].name);
+    EXPECT_FLOAT_EQ(5.0f, threads[2].cpu_percent);
+
+    // Idle threads: Jit pool (more total CPU) ahead of the new psi-watcher
+    EXPECT_EQ(2031, threads[3].tid);
+    EXPECT_FLOAT_EQ(0.0f, threads[3].cpu_percent);
+    EXPECT_EQ(2040, threads[4].tid);
+    EXPECT_EQ(0, threads[4].is_valid);
+}
+
+TEST_F(NativeThreadsTest, ExitedThreadsDropAndReusedTidsStartFresh) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    ThreadStatsNative threads[THREADS_MAX];
+    native_threads_sample(APP_PID, threads, THREADS_MAX);
+    native_replay_step();
+    native_threads_sample(APP_PID, threads, THREADS_MAX);
+    EXPECT_EQ(5, native_threads_tracked_count());
+
+    native_replay_step();
+    int count = native_threads_sample(APP_PID, threads, THREADS_MAX);
+    ASSERT_EQ(4, count);
+    EXPECT_EQ(nullptr, find_thread(threads, count, 2011));
+    EXPECT_EQ(4, native_threads_tracked_count());
+
+    const ThreadStatsNative* reused = find_thread(threads, count, 2020);
+    ASSERT_NE(nullptr, reused);
+    EXPECT_STREQ("OkHttp Dispatch", reused->name);
+    EXPECT_EQ(0, reused->is_valid);
+
+    const ThreadStatsNative* watcher = find_thread(threads, count, 2040);
+    ASSERT_NE(nullptr, watcher);
+    EXPECT_EQ(1, watcher->is_valid);
+    EXPECT_EQ(1u, watcher->voluntary_switches);
+}
+
+TEST_F(NativeThreadsTest, MaxCountKeepsTheMostExpensive) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    ThreadStatsNative threads[2];
+    native_threads_sample(APP_PID, threads, 2);
+    native_replay_step();
+    ASSERT_EQ(2, native_threads_sample(APP_PID, threads, 2));
+    EXPECT_EQ(2011, threads[0].tid);
+    EXPECT_EQ(2000, threads[1].tid);
+
+    // Threads beyond max_count are still tracked
+    EXPECT_EQ(5, native_threads_tracked_count());
+}
+
+TEST_F(NativeThreadsTest, SamplesOwnProcessLive) {
+    ThreadStatsNative threads[THREADS_MAX];
+    int count = native_threads_sample(0, threads, THREADS_MAX);
+    ASSERT_GE(count, 1);
+    EXPECT_NE(nullptr, find_thread(threads, count, getpid()));
+}
+
+TEST_F(NativeThreadsTest, MissingProcessIsAnError) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+
+    ThreadStatsNative threads[THREADS_MAX];
+    EXPECT_EQ(-1, native_threads_sample(APP_PID, threads, THREADS_MAX));
+}
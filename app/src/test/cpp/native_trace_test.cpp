@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "native_trace.h"
+#include "native_instrument.h"
+#include "native_analytics.h"
+#include "native_metrics.h"
+#include "native_paths.h"
+
+/**
+ * Tests for native span tracing: recording gate, per-thread rings,
+ * overflow and the Chrome trace-event JSON written by a flush.
+ */
+namespace {
+
+const std::string FIXTURE = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box/000000";
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int count_occurrences(const std::string& text, const std::string& needle) {
+    int count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+}  // namespace
+
+class NativeTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_trace_clear();
+        trace_path_ = "/tmp/sysmetrics_trace_" + std::to_string(getpid()) + ".json";
+    }
+
+    void TearDown() override {
+        native_trace_set_enabled(false);
+        native_instr_set_enabled(false);
+        native_trace_clear();
+        native_paths_set_root(nullptr);
+        unlink(trace_path_.c_str());
+    }
+
+    std::string trace_path_;
+};
+
+TEST_F(NativeTraceTest, NothingIsRecordedWhileDisabled) {
+    native_paths_set_root(FIXTURE.c_str());
+    CpuStats cpu;
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+
+    EXPECT_FALSE(native_trace_is_enabled());
+    EXPECT_EQ(0, native_trace_pending());
+}
+
+TEST_F(NativeTraceTest, FlushWritesChromeTraceEvents) {
+    native_paths_set_root(FIXTURE.c_str());
+    native_trace_set_enabled(true);
+
+    CpuStats cpu;
+    ASSERT_EQ(0, read_cpu_stats(&cpu));
+    int64_t twc = native_twc_create(60000);
+    native_twc_add_point(twc, 42.0f, 1000);
+    StatsResult stats;
+    native_twc_get_stats(twc, &stats);
+    native_twc_destroy(twc);
+
+    // read_cpu_stats, create, add_point + twc_rebuild, get_stats, destroy
+    EXPECT_EQ(6, native_trace_pending());
+    ASSERT_EQ(6, native_trace_flush(trace_path_.c_str()));
+    EXPECT_EQ(0, native_trace_pending());
+
+    std::string json = read_file(trace_path_);
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"read_cpu_stats\",\"cat\":\"collector\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"twc_rebuild\",\"cat\":\"analytics\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"thread_name\",\"ph\":\"M\""));
+    EXPECT_EQ(6, count_occurrences(json, "\"ph\":\"X\""));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+
+    // A second flush only carries spans recorded since the first
+    ASSERT_EQ(0, native_trace_flush(trace_path_.c_str()));
+    EXPECT_EQ(0, count_occurrences(read_file(trace_path_), "\"ph\":\"X\""));
+}
+
+TEST_F(NativeTraceTest, SpansAreWrittenInCompletionOrder) {
+    native_trace_set_enabled(true);
+    {
+        NativeTraceScope outer("outer", TRACE_CAT_JNI);
+        NativeTraceScope inner("inner", TRACE_CAT_ANALYTICS);
+    }
+    ASSERT_EQ(2, native_trace_flush(trace_path_.c_str()));
+
+    // Inner closes first, so it is written first
+    std::string json = read_file(trace_path_);
+    EXPECT_LT(json.find("\"name\":\"inner\""), json.find("\"name\":\"outer\""));
+}
+
+TEST_F(NativeTraceTest, EachThreadGetsItsOwnTrack) {
+    native_trace_set_enabled(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 100; i++) {
+                NativeTraceScope trace("worker", TRACE_CAT_ANALYTICS);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    ASSERT_EQ(300, native_trace_flush(trace_path_.c_str()));
+
+    std::string json = read_file(trace_path_);
+    std::set<std::string> tids;
+    const std::string key = "\"ph\":\"M\",\"pid\":";
+    for (size_t pos = json.find(key); pos != std::string::npos; pos = json.find(key, pos + 1)) {
+        size_t tid = json.find("\"tid\":", pos);
+        tids.insert(json.substr(tid, json.find(',', tid) - tid));
+    }
+    EXPECT_EQ(3u, tids.size());
+}
+
+TEST_F(NativeTraceTest, FullRingKeepsNewestSpans) {
+    native_trace_set_enabled(true);
+    for (int i = 0; i < TRACE_RING_CAPACITY + 100; i++) {
+        native_trace_record("span", TRACE_CAT_JNI, 1000, 2000);
+    }
+
+    EXPECT_EQ(TRACE_RING_CAPACITY, native_trace_pending());
+    EXPECT_EQ(TRACE_RING_CAPACITY, native_trace_flush(trace_path_.c_str()));
+}
+
+TEST_F(NativeTraceTest, FlushToUnwritablePathFails) {
+    EXPECT_EQ(-1, native_trace_flush("/nonexistent-dir/trace.json"));
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "native_uid_traffic.h"
+#include "native_paths.h"
+
+/**
+ * Tests for the xt_qtaguid per-UID reader. fixtures/tv_box has a streaming
+ * app (10057) on eth0 across both counter sets plus a tagged breakdown of
+ * the same bytes, idle system UIDs that push the file past one read chunk,
+ * a UID that appears (10200), one that vanishes (10300) and one whose
+ * counters reset (10080) in the last snapshot.
+ */
+namespace {
+
+const std::string RECORDING = std::string(SYSMETRICS_FIXTURE_DIR) + "/tv_box";
+
+const int64_t* row(const int64_t* values, int index) {
+    return values + index * UID_TRAFFIC_FIELDS;
+}
+
+}  // namespace
+
+class NativeUidTrafficTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        native_uid_traffic_reset();
+    }
+
+    void TearDown() override {
+        native_uid_traffic_reset();
+        native_replay_close();
+        native_paths_set_root(nullptr);
+    }
+
+    int64_t values_[UID_TOP_MAX * UID_TRAFFIC_FIELDS];
+};
+
+TEST_F(NativeUidTrafficTest, FirstSampleOnlyEstablishesBaseline) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+
+    EXPECT_EQ(0, native_uid_traffic_sample(values_, UID_TOP_MAX));
+    // Every UID, including the padding line split across the first read chunk
+    EXPECT_EQ(65, native_uid_traffic_uid_count());
+}
+
+TEST_F(NativeUidTrafficTest, RanksUidsByRateIgnoringTaggedLines) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+    native_uid_traffic_sample(values_, UID_TOP_MAX);
+
+    native_replay_step();
+    ASSERT_EQ(4, native_uid_traffic_sample(values_, UID_TOP_MAX));
+
+    // Both counter sets summed; the tagged 0x3e8 line is not added on top
+    EXPECT_EQ(10057, row(values_, 0)[0]);
+    EXPECT_EQ(5000000, row(values_, 0)[1]);
+    EXPECT_EQ(100000, row(values_, 0)[2]);
+    EXPECT_EQ(55000000, row(values_, 0)[3]);
+    EXPECT_EQ(1100000, row(values_, 0)[4]);
+    EXPECT_EQ(5000000, row(values_, 0)[5]);
+
+    EXPECT_EQ(10080, row(values_, 1)[0]);
+    EXPECT_EQ(1013, row(values_, 2)[0]);
+    EXPECT_EQ(300000, row(values_, 2)[1]);
+    EXPECT_EQ(10123, row(values_, 3)[0]);
+    EXPECT_EQ(8000, row(values_, 3)[2]);
+
+    // 10300 vanished, 10200 appeared without a rate yet
+    EXPECT_EQ(65, native_uid_traffic_uid_count());
+}
+
+TEST_F(NativeUidTrafficTest, NewUidsGetRatesAndResetCountersDrop) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+    native_uid_traffic_sample(values_, UID_TOP_MAX);
+    native_replay_step();
+    native_uid_traffic_sample(values_, UID_TOP_MAX);
+
+    native_replay_step();
+    ASSERT_EQ(3, native_uid_traffic_sample(values_, UID_TOP_MAX));
+
+    EXPECT_EQ(10057, row(values_, 0)[0]);
+    EXPECT_EQ(7000000, row(values_, 0)[5]);  // session since the first sample
+    EXPECT_EQ(150000, row(values_, 0)[6]);
+
+    EXPECT_EQ(10200, row(values_, 1)[0]);
+    EXPECT_EQ(700000, row(values_, 1)[1]);
+    EXPECT_EQ(700000, row(values_, 1)[5]);   // session since it first appeared
+
+    EXPECT_EQ(10123, row(values_, 2)[0]);
+}
+
+TEST_F(NativeUidTrafficTest, TopNLimitsOutput) {
+    ASSERT_EQ(3, native_replay_open(RECORDING.c_str()));
+    native_uid_traffic_sample(values_, UID_TOP_MAX);
+    native_replay_step();
+
+    ASSERT_EQ(2, native_uid_traffic_sample(values_, 2));
+    EXPECT_EQ(10057, row(values_, 0)[0]);
+    EXPECT_EQ(10080, row(values_, 1)[0]);
+}
+
+TEST_F(NativeUidTrafficTest, MissingFileIsAnError) {
+    ASSERT_EQ(0, native_paths_set_root("/nonexistent/sysmetrics"));
+    EXPECT_EQ(-1, native_uid_traffic_sample(values_, UID_TOP_MAX));
+}
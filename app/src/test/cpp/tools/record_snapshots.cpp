@@ -0,0 +1,36 @@
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "native_paths.h"
+
+/**
+ * Records proc/sys snapshots from a live Linux box (or an adb shell on the
+ * device) for offline replay by the native tests and benchmarks.
+ *
+ *   sysmetrics_record <dir> [count=10] [interval_ms=1000] [root=/]
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dir> [count=10] [interval_ms=1000] [root=/]\n", argv[0]);
+        return 2;
+    }
+
+    const char* dir = argv[1];
+    int count = argc > 2 ? atoi(argv[2]) : 10;
+    int interval_ms = argc > 3 ? atoi(argv[3]) : 1000;
+    if (argc > 4 && native_paths_set_root(argv[4]) != 0) {
+        fprintf(stderr, "invalid root: %s\n", argv[4]);
+        return 2;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int files = native_record_snapshot(dir, i);
+        if (files < 0) {
+            fprintf(stderr, "snapshot %d failed\n", i);
+            return 1;
+        }
+        printf("snapshot %06d: %d files\n", i, files);
+        if (i + 1 < count) usleep(static_cast<useconds_t>(interval_ms) * 1000);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "native_analytics.h"
+#include "native_session.h"
+
+/**
+ * Replays a session log recorded on the device (native_session.h) into
+ * fresh analytics instances, prints the final per-metric stats and the
+ * engine throughput. Each repeat starts from new instances.
+ *
+ *   sysmetrics_replay <log> [repeat=1] [chart_points=60] [peak_window_ms=60000]
+ */
+static const char* const METRIC_NAMES[SNAPSHOT_METRIC_COUNT] = {
+    "cpu_percent", "ram_used_mb", "ram_total_mb", "ram_percent", "net_rx_bps",
+    "net_tx_bps", "self_cpu_percent", "self_ram_mb", "temperature_c", "gpu_percent",
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <log> [repeat=1] [chart_points=60] [peak_window_ms=60000]\n", argv[0]);
+        return 2;
+    }
+
+    const char* path = argv[1];
+    int repeat = argc > 2 ? std::max(1, atoi(argv[2])) : 1;
+    int chart_points = argc > 3 ? atoi(argv[3]) : 60;
+    int64_t peak_window_ms = argc > 4 ? atoll(argv[4]) : 60000;
+
+    ReplayStats stats = {};
+    int64_t total_ns = 0;
+    int64_t best_ns = 0;
+    for (int run = 0; run < repeat; run++) {
+        ReplayTargets targets;
+        if (native_replay_targets_create(&targets, chart_points, peak_window_ms) != 0) {
+            fprintf(stderr, "failed to create analytics instances\n");
+            return 1;
+        }
+        if (native_session_replay_file(path, &targets, &stats) != 0) {
+            fprintf(stderr, "not a session log: %s\n", path);
+            native_replay_targets_destroy(&targets);
+            return 1;
+        }
+        total_ns += stats.elapsed_ns;
+        if (run == 0 || stats.elapsed_ns < best_ns) best_ns = stats.elapsed_ns;
+
+        if (run == 0) {
+            printf("%lld samples over %.1f s%s\n", static_cast<long long>(stats.samples),
+                   stats.span_ms / 1000.0, stats.truncated ? " (truncated tail)" : "");
+            printf("%-17s %10s %10s %10s %10s %10s %10s\n",
+                   "metric", "current", "avg_5m", "min", "max", "p95", "peak");
+            for (int i = 0; i < SNAPSHOT_METRIC_COUNT; i++) {
+                StatsResult result;
+                PeakData peak;
+                native_twc_get_stats(targets.twc[i], &result);
+                native_peak_get_data(targets.peak[i], &peak);
+                if (result.count == 0) continue;
+                printf("%-17s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", METRIC_NAMES[i],
+                       result.current, result.avg_5m, result.min, result.max, result.p95, peak.peak_value);
+            }
+        }
+        native_replay_targets_destroy(&targets);
+    }
+
+    if (best_ns <= 0) best_ns = 1;
+    printf("replay: %d run(s), best %.3f ms, mean %.3f ms\n", repeat, best_ns / 1e6, total_ns / 1e6 / repeat);
+    printf("throughput: %.0f samples/s, %.0f values/s, %.0fx real time\n",
+           stats.samples * 1e9 / best_ns, stats.values * 1e9 / best_ns,
+           stats.span_ms * 1e6 / best_ns);
+    return 0;
+}